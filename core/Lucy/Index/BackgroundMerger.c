@@ -33,6 +33,7 @@
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/FSFolder.h"
 #include "Lucy/Store/Lock.h"
+#include "Lucy/Store/RateLimiter.h"
 #include "Lucy/Util/IndexFileNames.h"
 #include "Lucy/Util/Json.h"
 
@@ -56,6 +57,14 @@ S_release_write_lock(BackgroundMerger *self);
 static void
 S_release_merge_lock(BackgroundMerger *self);
 
+// Swap our RateLimiter into the Folder - if we have one.
+static void
+S_throttle(BackgroundMerger *self);
+
+// Give the Folder back its own RateLimiter - if ours is swapped in.
+static void
+S_unthrottle(BackgroundMerger *self);
+
 BackgroundMerger*
 BGMerger_new(Obj *index, IndexManager *manager) {
     BackgroundMerger *self
@@ -68,11 +77,14 @@ BGMerger_init(BackgroundMerger *self, Obj *index, IndexManager *manager) {
     Folder *folder = S_init_folder(index);
 
     // Init.
-    self->optimize      = false;
-    self->prepared      = false;
-    self->needs_commit  = false;
-    self->snapfile      = NULL;
-    self->doc_maps      = Hash_new(0);
+    self->optimize       = false;
+    self->prepared       = false;
+    self->needs_commit   = false;
+    self->throttled      = false;
+    self->snapfile       = NULL;
+    self->doc_maps       = Hash_new(0);
+    self->rate_limiter   = NULL;
+    self->folder_limiter = NULL;
 
     // Assign.
     self->folder = folder;
@@ -155,6 +167,7 @@ BGMerger_init(BackgroundMerger *self, Obj *index, IndexManager *manager) {
 
 void
 BGMerger_destroy(BackgroundMerger *self) {
+    S_unthrottle(self);
     S_release_merge_lock(self);
     S_release_write_lock(self);
     DECREF(self->schema);
@@ -169,6 +182,7 @@ BGMerger_destroy(BackgroundMerger *self) {
     DECREF(self->write_lock);
     DECREF(self->snapfile);
     DECREF(self->doc_maps);
+    DECREF(self->rate_limiter);
     SUPER_DESTROY(self, BACKGROUNDMERGER);
 }
 
@@ -200,6 +214,17 @@ BGMerger_optimize(BackgroundMerger *self) {
     self->optimize = true;
 }
 
+void
+BGMerger_set_rate_limiter(BackgroundMerger *self, RateLimiter *rate_limiter) {
+    DECREF(self->rate_limiter);
+    self->rate_limiter = (RateLimiter*)INCREF(rate_limiter);
+}
+
+RateLimiter*
+BGMerger_get_rate_limiter(BackgroundMerger *self) {
+    return self->rate_limiter;
+}
+
 static uint32_t
 S_maybe_merge(BackgroundMerger *self) {
     VArray *to_merge = IxManager_Recycle(self->manager, self->polyreader,
@@ -373,6 +398,10 @@ BGMerger_prepare_commit(BackgroundMerger *self) {
         THROW(ERR, "Can't call Prepare_Commit() more than once");
     }
 
+    // Throttle the bulk of the writing, which happens before the write lock
+    // is acquired.  If the merge throws, Destroy() unthrottles.
+    S_throttle(self);
+
     // Maybe merge existing index data.
     if (num_seg_readers) {
         segs_merged = S_maybe_merge(self);
@@ -380,6 +409,7 @@ BGMerger_prepare_commit(BackgroundMerger *self) {
 
     if (!segs_merged) {
         // Nothing merged.  Leave self->needs_commit false and bail out.
+        S_unthrottle(self);
         self->prepared = true;
         return;
     }
@@ -398,6 +428,7 @@ BGMerger_prepare_commit(BackgroundMerger *self) {
 
         // Finish the segment.
         SegWriter_Finish(self->seg_writer);
+        S_unthrottle(self);
 
         // Grab the write lock.
         S_obtain_write_lock(self);
@@ -454,6 +485,14 @@ BGMerger_prepare_commit(BackgroundMerger *self) {
 
         DECREF(latest_snapshot);
 
+        // Everything the snapshot refers to must reach stable storage before
+        // the snapshot is published.
+        VArray *to_sync = VA_new(2);
+        VA_Push(to_sync, INCREF(Seg_Get_Name(self->segment)));
+        VA_Push(to_sync, INCREF(self->snapfile));
+        IxManager_Sync_Files(self->manager, to_sync);
+        DECREF(to_sync);
+
         self->needs_commit = true;
     }
 
@@ -495,6 +534,11 @@ BGMerger_commit(BackgroundMerger *self) {
             Err_throw_mess(ERR, mess);
         }
         DECREF(temp_snapfile);
+
+        // Sync the index directory so that the new link is durable.
+        VArray *no_files = VA_new(0);
+        IxManager_Sync_Files(self->manager, no_files);
+        DECREF(no_files);
     }
 
     // Release the merge lock and remove the merge data file.
@@ -556,4 +600,24 @@ S_release_merge_lock(BackgroundMerger *self) {
     }
 }
 
+static void
+S_throttle(BackgroundMerger *self) {
+    if (self->rate_limiter && !self->throttled) {
+        self->folder_limiter = (RateLimiter*)INCREF(
+                                   Folder_Get_Rate_Limiter(self->folder));
+        Folder_Set_Rate_Limiter(self->folder, self->rate_limiter);
+        self->throttled = true;
+    }
+}
+
+static void
+S_unthrottle(BackgroundMerger *self) {
+    if (self->throttled) {
+        Folder_Set_Rate_Limiter(self->folder, self->folder_limiter);
+        DECREF(self->folder_limiter);
+        self->folder_limiter = NULL;
+        self->throttled      = false;
+    }
+}
+
 
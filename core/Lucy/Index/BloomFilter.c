@@ -0,0 +1,160 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_BLOOMFILTER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Index/BloomFilter.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Store/OutStream.h"
+
+BloomFilter*
+BloomFilter_new(uint32_t num_keys, uint32_t bits_per_key) {
+    BloomFilter *self = (BloomFilter*)VTable_Make_Obj(BLOOMFILTER);
+    return BloomFilter_init(self, num_keys, bits_per_key);
+}
+
+BloomFilter*
+BloomFilter_init(BloomFilter *self, uint32_t num_keys,
+                 uint32_t bits_per_key) {
+    if (bits_per_key == 0) { bits_per_key = 1; }
+
+    // Size the bit array, rounding up to a whole number of bytes.  Keep a
+    // small floor so that tiny filters don't saturate.
+    uint64_t num_bits = (uint64_t)num_keys * bits_per_key;
+    if (num_bits < 64) { num_bits = 64; }
+    num_bits = (num_bits + 7) & ~((uint64_t)7);
+    if (num_bits > 0xFFFFFFF8) { num_bits = 0xFFFFFFF8; }
+
+    // The optimal number of probes is bits_per_key * ln(2).
+    uint32_t num_hashes = (uint32_t)(bits_per_key * 0.69);
+    if (num_hashes < 1)  { num_hashes = 1; }
+    if (num_hashes > 30) { num_hashes = 30; }
+
+    self->num_bits   = (uint32_t)num_bits;
+    self->num_hashes = num_hashes;
+    self->bits       = (uint8_t*)CALLOCATE(self->num_bits / 8,
+                                           sizeof(uint8_t));
+
+    return self;
+}
+
+void
+BloomFilter_destroy(BloomFilter *self) {
+    FREEMEM(self->bits);
+    SUPER_DESTROY(self, BLOOMFILTER);
+}
+
+uint64_t
+BloomFilter_hash_term(CharBuf *term) {
+    const uint8_t *ptr = (const uint8_t*)CB_Get_Ptr8(term);
+    const uint8_t *const limit = ptr + CB_Get_Size(term);
+
+    // FNV-1a over the UTF-8 bytes...
+    uint64_t hash = U64_C(0xCBF29CE484222325);
+    while (ptr < limit) {
+        hash ^= *ptr++;
+        hash *= U64_C(0x100000001B3);
+    }
+
+    // ... followed by a finalizer, so that both 32-bit halves are well
+    // mixed.
+    hash ^= hash >> 33;
+    hash *= U64_C(0xFF51AFD7ED558CCD);
+    hash ^= hash >> 33;
+    hash *= U64_C(0xC4CEB9FE1A85EC53);
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+void
+BloomFilter_add(BloomFilter *self, Obj *term) {
+    if (term && Obj_Is_A(term, CHARBUF)) {
+        BloomFilter_Add_Hash(self, BloomFilter_hash_term((CharBuf*)term));
+    }
+}
+
+void
+BloomFilter_add_hash(BloomFilter *self, uint64_t hash) {
+    const uint32_t num_bits = self->num_bits;
+    uint32_t       probe    = (uint32_t)hash;
+    const uint32_t delta    = (uint32_t)(hash >> 32) | 1;
+    uint8_t *const bits     = self->bits;
+
+    for (uint32_t i = 0; i < self->num_hashes; i++) {
+        const uint32_t tick = probe % num_bits;
+        bits[tick >> 3] |= (uint8_t)(1 << (tick & 0x7));
+        probe += delta;
+    }
+}
+
+bool_t
+BloomFilter_may_contain(BloomFilter *self, Obj *term) {
+    if (!term || !Obj_Is_A(term, CHARBUF)) { return true; }
+    return BloomFilter_May_Contain_Hash(self,
+                                        BloomFilter_hash_term((CharBuf*)term));
+}
+
+bool_t
+BloomFilter_may_contain_hash(BloomFilter *self, uint64_t hash) {
+    const uint32_t num_bits = self->num_bits;
+    uint32_t       probe    = (uint32_t)hash;
+    const uint32_t delta    = (uint32_t)(hash >> 32) | 1;
+    const uint8_t *const bits = self->bits;
+
+    for (uint32_t i = 0; i < self->num_hashes; i++) {
+        const uint32_t tick = probe % num_bits;
+        if (!(bits[tick >> 3] & (1 << (tick & 0x7)))) { return false; }
+        probe += delta;
+    }
+    return true;
+}
+
+uint32_t
+BloomFilter_get_num_bits(BloomFilter *self) {
+    return self->num_bits;
+}
+
+uint32_t
+BloomFilter_get_num_hashes(BloomFilter *self) {
+    return self->num_hashes;
+}
+
+void
+BloomFilter_serialize(BloomFilter *self, OutStream *outstream) {
+    OutStream_Write_C32(outstream, self->num_hashes);
+    OutStream_Write_C32(outstream, self->num_bits);
+    OutStream_Write_Bytes(outstream, self->bits, self->num_bits / 8);
+}
+
+BloomFilter*
+BloomFilter_deserialize(BloomFilter *self, InStream *instream) {
+    uint32_t num_hashes = InStream_Read_C32(instream);
+    uint32_t num_bits   = InStream_Read_C32(instream);
+    if (num_bits == 0 || num_bits % 8 || num_hashes == 0) {
+        DECREF(self);
+        THROW(ERR, "Corrupt bloom filter in '%o': %u32 bits, %u32 hashes",
+              InStream_Get_Filename(instream), num_bits, num_hashes);
+    }
+    self->num_bits   = num_bits;
+    self->num_hashes = num_hashes;
+    self->bits       = (uint8_t*)MALLOCATE(num_bits / 8);
+    InStream_Read_Bytes(instream, (char*)self->bits, num_bits / 8);
+    return self;
+}
+
+
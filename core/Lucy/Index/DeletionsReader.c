@@ -17,6 +17,7 @@
 #define C_LUCY_DELETIONSREADER
 #define C_LUCY_POLYDELETIONSREADER
 #define C_LUCY_DEFAULTDELETIONSREADER
+#define C_LUCY_BITVECDELDOCS
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/DeletionsReader.h"
@@ -26,6 +27,7 @@
 #include "Lucy/Index/Snapshot.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Search/BitVecMatcher.h"
+#include "Lucy/Search/DocRunMatcher.h"
 #include "Lucy/Search/SeriesMatcher.h"
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/InStream.h"
@@ -47,6 +49,11 @@ DelReader_aggregator(DeletionsReader *self, VArray *readers,
     return (DeletionsReader*)PolyDelReader_new(readers, offsets);
 }
 
+void
+DelReader_warm(DeletionsReader *self) {
+    UNUSED_VAR(self);
+}
+
 PolyDeletionsReader*
 PolyDelReader_new(VArray *readers, I32Array *offsets) {
     PolyDeletionsReader *self
@@ -111,6 +118,16 @@ PolyDelReader_iterator(PolyDeletionsReader *self) {
     return (Matcher*)deletions;
 }
 
+void
+PolyDelReader_warm(PolyDeletionsReader *self) {
+    if (!self->readers) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+        DeletionsReader *reader
+            = (DeletionsReader*)VA_Fetch(self->readers, i);
+        if (reader) { DelReader_Warm(reader); }
+    }
+}
+
 DefaultDeletionsReader*
 DefDelReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                  VArray *segments, int32_t seg_tick) {
@@ -120,14 +137,19 @@ DefDelReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                              seg_tick);
 }
 
+// Locate and load this segment's deletions, leaving either self->deldocs or
+// self->del_runs set -- or neither, if there are no deletions.
+static void
+S_load_deletions(DefaultDeletionsReader *self);
+
 DefaultDeletionsReader*
 DefDelReader_init(DefaultDeletionsReader *self, Schema *schema,
                   Folder *folder, Snapshot *snapshot, VArray *segments,
                   int32_t seg_tick) {
     DelReader_init((DeletionsReader*)self, schema, folder, snapshot, segments,
                    seg_tick);
-    DefDelReader_Read_Deletions(self);
-    if (!self->deldocs) {
+    S_load_deletions(self);
+    if (!self->deldocs && !self->del_runs) {
         self->del_count = 0;
         self->deldocs   = BitVec_new(0);
     }
@@ -137,21 +159,68 @@ DefDelReader_init(DefaultDeletionsReader *self, Schema *schema,
 void
 DefDelReader_close(DefaultDeletionsReader *self) {
     DECREF(self->deldocs);
-    self->deldocs = NULL;
+    DECREF(self->del_runs);
+    self->deldocs  = NULL;
+    self->del_runs = NULL;
 }
 
 void
 DefDelReader_destroy(DefaultDeletionsReader *self) {
     DECREF(self->deldocs);
+    DECREF(self->del_runs);
     SUPER_DESTROY(self, DEFAULTDELETIONSREADER);
 }
 
-BitVector*
-DefDelReader_read_deletions(DefaultDeletionsReader *self) {
+// Decode a list of deleted doc ids, each stored as the gap from the one
+// before it.
+static I32Array*
+S_read_sparse(InStream *instream, int32_t doc_max) {
+    uint32_t  num_dels = InStream_Read_C32(instream);
+    int32_t  *runs     = (int32_t*)MALLOCATE(num_dels * 2 * sizeof(int32_t));
+    int32_t   doc_id   = 0;
+    for (uint32_t i = 0; i < num_dels; i++) {
+        doc_id += (int32_t)InStream_Read_C32(instream);
+        if (doc_id > doc_max) {
+            FREEMEM(runs);
+            THROW(ERR, "Deleted doc id %i32 > doc_max %i32 in %o", doc_id,
+                  doc_max, InStream_Get_Filename(instream));
+        }
+        runs[i * 2]     = doc_id;
+        runs[i * 2 + 1] = doc_id;
+    }
+    return I32Arr_new_steal(runs, num_dels * 2);
+}
+
+// Decode a list of runs, each stored as a gap from the end of the previous
+// run followed by a length.
+static I32Array*
+S_read_runs(InStream *instream, int32_t doc_max) {
+    uint32_t  num_runs = InStream_Read_C32(instream);
+    int32_t  *runs     = (int32_t*)MALLOCATE(num_runs * 2 * sizeof(int32_t));
+    int32_t   limit    = 0;
+    for (uint32_t i = 0; i < num_runs; i++) {
+        int32_t first = limit + (int32_t)InStream_Read_C32(instream);
+        int32_t len   = (int32_t)InStream_Read_C32(instream);
+        int32_t last  = first + len - 1;
+        if (len < 1 || last > doc_max) {
+            FREEMEM(runs);
+            THROW(ERR, "Invalid run %i32-%i32 (doc_max %i32) in %o", first,
+                  last, doc_max, InStream_Get_Filename(instream));
+        }
+        runs[i * 2]     = first;
+        runs[i * 2 + 1] = last;
+        limit = last + 1;
+    }
+    return I32Arr_new_steal(runs, num_runs * 2);
+}
+
+static void
+S_load_deletions(DefaultDeletionsReader *self) {
     VArray  *segments    = DefDelReader_Get_Segments(self);
     Segment *segment     = DefDelReader_Get_Segment(self);
     CharBuf *my_seg_name = Seg_Get_Name(segment);
     CharBuf *del_file    = NULL;
+    CharBuf *encoding    = NULL;
     int32_t  del_count   = 0;
 
     // Start with deletions files in the most recently added segments and work
@@ -174,26 +243,67 @@ DefDelReader_read_deletions(DefaultDeletionsReader *self) {
                 del_file  = (CharBuf*)CERTIFY(
                                 Hash_Fetch_Str(seg_files_data, "filename", 8),
                                 CHARBUF);
+                // Files written before format 2 lack an encoding and are
+                // always dense bitsets.
+                encoding = (CharBuf*)Hash_Fetch_Str(seg_files_data,
+                                                    "encoding", 8);
+                if (encoding) { CERTIFY(encoding, CHARBUF); }
                 break;
             }
         }
     }
 
     DECREF(self->deldocs);
-    if (del_file) {
+    DECREF(self->del_runs);
+    self->deldocs   = NULL;
+    self->del_runs  = NULL;
+    self->del_count = 0;
+    if (!del_file) { return; }
+
+    if (!encoding || CB_Equals_Str(encoding, "bitvec", 6)) {
         self->deldocs = (BitVector*)BitVecDelDocs_new(self->folder, del_file);
-        self->del_count = del_count;
     }
     else {
-        self->deldocs = NULL;
-        self->del_count = 0;
+        bool_t    sparse   = CB_Equals_Str(encoding, "sparse", 6);
+        int32_t   doc_max  = (int32_t)Seg_Get_Count(segment);
+        InStream *instream = NULL;
+        if (!sparse && !CB_Equals_Str(encoding, "runs", 4)) {
+            THROW(ERR, "Unknown deletions encoding for %o: %o", del_file,
+                  encoding);
+        }
+        instream = Folder_Open_In(self->folder, del_file);
+        if (!instream) { RETHROW(INCREF(Err_get_error())); }
+        self->del_runs = sparse
+                         ? S_read_sparse(instream, doc_max)
+                         : S_read_runs(instream, doc_max);
+        InStream_Close(instream);
+        DECREF(instream);
     }
+    self->del_count = del_count;
+}
 
+BitVector*
+DefDelReader_read_deletions(DefaultDeletionsReader *self) {
+    S_load_deletions(self);
+    if (self->del_runs) {
+        I32Array *runs     = self->del_runs;
+        uint32_t  num_runs = I32Arr_Get_Size(runs) / 2;
+        int32_t   doc_max  = (int32_t)Seg_Get_Count(DefDelReader_Get_Segment(self));
+        self->deldocs = BitVec_new((uint32_t)doc_max + 1);
+        for (uint32_t i = 0; i < num_runs; i++) {
+            BitVec_Flip_Block(self->deldocs, I32Arr_Get(runs, i * 2),
+                              I32Arr_Get(runs, i * 2 + 1)
+                              - I32Arr_Get(runs, i * 2) + 1);
+        }
+    }
     return self->deldocs;
 }
 
 Matcher*
 DefDelReader_iterator(DefaultDeletionsReader *self) {
+    if (self->del_runs) {
+        return (Matcher*)DocRunMatcher_new(self->del_runs);
+    }
     return (Matcher*)BitVecMatcher_new(self->deldocs);
 }
 
@@ -202,4 +312,16 @@ DefDelReader_del_count(DefaultDeletionsReader *self) {
     return self->del_count;
 }
 
+void
+DefDelReader_warm(DefaultDeletionsReader *self) {
+    // Sparse and run-length deletions were decoded into memory at open, but
+    // a dense bitset is mapped straight from the file.
+    if (self->deldocs && Obj_Is_A((Obj*)self->deldocs, BITVECDELDOCS)) {
+        InStream *instream = ((BitVecDelDocs*)self->deldocs)->instream;
+        if (instream) {
+            InStream_Prefetch(instream, 0, InStream_Length(instream));
+        }
+    }
+}
+
 
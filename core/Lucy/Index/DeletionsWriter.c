@@ -23,6 +23,7 @@
 #include "Lucy/Index/DeletionsWriter.h"
 #include "Lucy/Index/DeletionsReader.h"
 #include "Lucy/Index/IndexReader.h"
+#include "Lucy/Index/LexiconReader.h"
 #include "Lucy/Index/PolyReader.h"
 #include "Lucy/Index/PostingList.h"
 #include "Lucy/Index/PostingListReader.h"
@@ -66,7 +67,7 @@ DelWriter_generate_doc_map(DeletionsWriter *self, Matcher *deletions,
     return I32Arr_new_steal(doc_map, doc_max + 1);
 }
 
-int32_t DefDelWriter_current_file_format = 1;
+int32_t DefDelWriter_current_file_format = 2;
 
 DefaultDeletionsWriter*
 DefDelWriter_new(Schema *schema, Snapshot *snapshot, Segment *segment,
@@ -128,11 +129,143 @@ DefDelWriter_destroy(DefaultDeletionsWriter *self) {
     SUPER_DESTROY(self, DEFAULTDELETIONSWRITER);
 }
 
+// Encodings for deletions files.
+#define DELDOCS_BITVEC 1
+#define DELDOCS_SPARSE 2
+#define DELDOCS_RUNS   3
+
+static uint32_t
+S_c32_size(uint32_t value) {
+    if (value < 0x80)           { return 1; }
+    else if (value < 0x4000)    { return 2; }
+    else if (value < 0x200000)  { return 3; }
+    else if (value < 0x10000000) { return 4; }
+    else                        { return 5; }
+}
+
+// Bitsets at or below this size in bytes are always written as-is, since
+// the savings from a compact encoding would be negligible.
+#define MIN_COMPACT_DEL_BYTES 128
+
+// Pick whichever encoding produces the smallest file, preferring the dense
+// bitset in the event of a tie.
+static int
+S_choose_encoding(BitVector *deldocs, int32_t doc_max) {
+    uint64_t bitvec_size = (uint64_t)ceil((doc_max + 1) / 8.0);
+    if (bitvec_size <= MIN_COMPACT_DEL_BYTES) { return DELDOCS_BITVEC; }
+    uint64_t sparse_size = S_c32_size(BitVec_Count(deldocs));
+    uint64_t runs_size   = 0;
+    uint32_t num_runs    = 0;
+    int32_t  last        = 0;
+    int32_t  run_start   = 0;
+    int32_t  doc_id      = BitVec_Next_Hit(deldocs, 1);
+
+    while (doc_id != -1 && doc_id <= doc_max) {
+        sparse_size += S_c32_size(doc_id - last);
+        if (doc_id != last + 1 || !run_start) {
+            // Close the previous run and start a new one.
+            if (run_start) {
+                runs_size += S_c32_size(last - run_start + 1);
+            }
+            runs_size += S_c32_size(doc_id - (run_start ? last + 1 : 0));
+            run_start = doc_id;
+            num_runs++;
+        }
+        last   = doc_id;
+        doc_id = BitVec_Next_Hit(deldocs, doc_id + 1);
+        if (sparse_size >= bitvec_size && runs_size >= bitvec_size) {
+            return DELDOCS_BITVEC;
+        }
+    }
+    if (run_start) { runs_size += S_c32_size(last - run_start + 1); }
+    runs_size += S_c32_size(num_runs);
+
+    if (bitvec_size <= sparse_size && bitvec_size <= runs_size) {
+        return DELDOCS_BITVEC;
+    }
+    return sparse_size <= runs_size ? DELDOCS_SPARSE : DELDOCS_RUNS;
+}
+
+static const char*
+S_encoding_name(int encoding) {
+    switch (encoding) {
+        case DELDOCS_BITVEC: return "bitvec";
+        case DELDOCS_SPARSE: return "sparse";
+        case DELDOCS_RUNS:   return "runs";
+        default:
+            THROW(ERR, "Unknown deletions encoding: %i32", (int32_t)encoding);
+            UNREACHABLE_RETURN(const char*);
+    }
+}
+
 static CharBuf*
-S_del_filename(DefaultDeletionsWriter *self, SegReader *target_reader) {
+S_del_filename(DefaultDeletionsWriter *self, SegReader *target_reader,
+               int encoding) {
     Segment *target_seg = SegReader_Get_Segment(target_reader);
-    return CB_newf("%o/deletions-%o.bv", Seg_Get_Name(self->segment),
-                   Seg_Get_Name(target_seg));
+    const char *ext = encoding == DELDOCS_SPARSE ? "ids"
+                      : encoding == DELDOCS_RUNS ? "runs"
+                      : "bv";
+    return CB_newf("%o/deletions-%o.%s", Seg_Get_Name(self->segment),
+                   Seg_Get_Name(target_seg), ext);
+}
+
+static void
+S_write_bitvec(OutStream *outstream, BitVector *deldocs, int32_t doc_max) {
+    double   used      = (doc_max + 1) / 8.0;
+    uint32_t byte_size = (uint32_t)ceil(used);
+    uint32_t new_max   = byte_size * 8 - 1;
+
+    // Ensure that we have 1 bit for each doc in segment.
+    BitVec_Grow(deldocs, new_max);
+    OutStream_Write_Bytes(outstream, (char*)BitVec_Get_Raw_Bits(deldocs),
+                          byte_size);
+}
+
+// Write the number of deletions followed by the gap between each deleted
+// doc id and the one before it.
+static void
+S_write_sparse(OutStream *outstream, BitVector *deldocs, int32_t doc_max) {
+    int32_t last   = 0;
+    int32_t doc_id = BitVec_Next_Hit(deldocs, 1);
+    OutStream_Write_C32(outstream, BitVec_Count(deldocs));
+    while (doc_id != -1 && doc_id <= doc_max) {
+        OutStream_Write_C32(outstream, (uint32_t)(doc_id - last));
+        last   = doc_id;
+        doc_id = BitVec_Next_Hit(deldocs, doc_id + 1);
+    }
+}
+
+// Find the last doc id in the run of deletions beginning at
+// <code>doc_id</code>.
+static int32_t
+S_run_end(BitVector *deldocs, int32_t doc_id, int32_t doc_max) {
+    while (doc_id < doc_max && BitVec_Get(deldocs, doc_id + 1)) { doc_id++; }
+    return doc_id;
+}
+
+// Write the number of runs, followed by a (gap, length) pair for each run,
+// where the gap is measured from the doc id just past the end of the
+// previous run.
+static void
+S_write_runs(OutStream *outstream, BitVector *deldocs, int32_t doc_max) {
+    uint32_t num_runs = 0;
+    int32_t  doc_id   = BitVec_Next_Hit(deldocs, 1);
+    while (doc_id != -1 && doc_id <= doc_max) {
+        num_runs++;
+        doc_id = BitVec_Next_Hit(deldocs,
+                                 S_run_end(deldocs, doc_id, doc_max) + 1);
+    }
+
+    OutStream_Write_C32(outstream, num_runs);
+    int32_t limit = 0;
+    doc_id = BitVec_Next_Hit(deldocs, 1);
+    while (doc_id != -1 && doc_id <= doc_max) {
+        int32_t last = S_run_end(deldocs, doc_id, doc_max);
+        OutStream_Write_C32(outstream, (uint32_t)(doc_id - limit));
+        OutStream_Write_C32(outstream, (uint32_t)(last - doc_id + 1));
+        limit  = last + 1;
+        doc_id = BitVec_Next_Hit(deldocs, limit);
+    }
 }
 
 void
@@ -144,20 +277,22 @@ DefDelWriter_finish(DefaultDeletionsWriter *self) {
         if (self->updated[i]) {
             BitVector *deldocs   = (BitVector*)VA_Fetch(self->bit_vecs, i);
             int32_t    doc_max   = SegReader_Doc_Max(seg_reader);
-            double     used      = (doc_max + 1) / 8.0;
-            uint32_t   byte_size = (uint32_t)ceil(used);
-            uint32_t   new_max   = byte_size * 8 - 1;
-            CharBuf   *filename  = S_del_filename(self, seg_reader);
+            int        encoding  = S_choose_encoding(deldocs, doc_max);
+            CharBuf   *filename  = S_del_filename(self, seg_reader, encoding);
             OutStream *outstream = Folder_Open_Out(folder, filename);
             if (!outstream) { RETHROW(INCREF(Err_get_error())); }
 
-            // Ensure that we have 1 bit for each doc in segment.
-            BitVec_Grow(deldocs, new_max);
-
             // Write deletions data and clean up.
-            OutStream_Write_Bytes(outstream,
-                                  (char*)BitVec_Get_Raw_Bits(deldocs),
-                                  byte_size);
+            switch (encoding) {
+                case DELDOCS_SPARSE:
+                    S_write_sparse(outstream, deldocs, doc_max);
+                    break;
+                case DELDOCS_RUNS:
+                    S_write_runs(outstream, deldocs, doc_max);
+                    break;
+                default:
+                    S_write_bitvec(outstream, deldocs, doc_max);
+            }
             OutStream_Close(outstream);
             DECREF(outstream);
             DECREF(filename);
@@ -178,11 +313,15 @@ DefDelWriter_metadata(DefaultDeletionsWriter *self) {
         if (self->updated[i]) {
             BitVector *deldocs   = (BitVector*)VA_Fetch(self->bit_vecs, i);
             Segment   *segment   = SegReader_Get_Segment(seg_reader);
-            Hash      *mini_meta = Hash_new(2);
+            int32_t    doc_max   = SegReader_Doc_Max(seg_reader);
+            int        encoding  = S_choose_encoding(deldocs, doc_max);
+            Hash      *mini_meta = Hash_new(3);
             Hash_Store_Str(mini_meta, "count", 5,
                            (Obj*)CB_newf("%u32", (uint32_t)BitVec_Count(deldocs)));
             Hash_Store_Str(mini_meta, "filename", 8,
-                           (Obj*)S_del_filename(self, seg_reader));
+                           (Obj*)S_del_filename(self, seg_reader, encoding));
+            Hash_Store_Str(mini_meta, "encoding", 8,
+                           (Obj*)CB_newf("%s", S_encoding_name(encoding)));
             Hash_Store(files, (Obj*)Seg_Get_Name(segment), (Obj*)mini_meta);
         }
     }
@@ -242,6 +381,16 @@ DefDelWriter_delete_by_term(DefaultDeletionsWriter *self,
                             const CharBuf *field, Obj *term) {
     for (uint32_t i = 0, max = VA_Get_Size(self->seg_readers); i < max; i++) {
         SegReader *seg_reader = (SegReader*)VA_Fetch(self->seg_readers, i);
+        LexiconReader *lex_reader
+            = (LexiconReader*)SegReader_Fetch(
+                  seg_reader, VTable_Get_Name(LEXICONREADER));
+
+        // Skip segments which definitely don't hold the term, e.g. because
+        // the field's bloom filter rules it out.
+        if (lex_reader && !LexReader_May_Contain(lex_reader, field, term)) {
+            continue;
+        }
+
         PostingListReader *plist_reader
             = (PostingListReader*)SegReader_Fetch(
                   seg_reader, VTable_Get_Name(POSTINGLISTREADER));
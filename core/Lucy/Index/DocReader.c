@@ -28,6 +28,51 @@
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/InStream.h"
+#include "Lucy/Store/RAMFile.h"
+#include "Lucy/Util/BlockCodec.h"
+#include "Lucy/Util/SortUtils.h"
+
+// Number of decompressed blocks each DefaultDocReader keeps on hand.
+#define DOC_BLOCK_CACHE_SIZE 4
+
+typedef struct DocBlock {
+    int32_t    tick;       // Block number, or -1 if the slot is empty.
+    uint64_t   last_used;
+    ByteBuf   *content;
+    InStream  *instream;   // Reads from <code>content</code>.
+    uint32_t  *offsets;    // Start of each record in content, plus the end.
+    uint32_t   offsets_cap;
+} DocBlock;
+
+// Load the block index for a compressed segment into memory.
+static void
+S_read_block_index(DefaultDocReader *self);
+
+// Return the number of the block containing the doc, or -1 if the doc id
+// is out of range.
+static int32_t
+S_find_block(DefaultDocReader *self, int32_t doc_id);
+
+// Return a decompressed block, from the cache if possible.
+static DocBlock*
+S_fetch_block(DefaultDocReader *self, int32_t tick);
+
+static void
+S_clear_block(DocBlock *block);
+
+// A requested doc id and its position in the request.
+typedef struct DocRequest {
+    int32_t  doc_id;
+    uint32_t tick;
+} DocRequest;
+
+static int
+S_compare_requests(void *context, const void *va, const void *vb) {
+    const DocRequest *a = (const DocRequest*)va;
+    const DocRequest *b = (const DocRequest*)vb;
+    UNUSED_VAR(context);
+    return a->doc_id < b->doc_id ? -1 : a->doc_id > b->doc_id ? 1 : 0;
+}
 
 DocReader*
 DocReader_init(DocReader *self, Schema *schema, Folder *folder,
@@ -36,6 +81,47 @@ DocReader_init(DocReader *self, Schema *schema, Folder *folder,
                                        snapshot, segments, seg_tick);
 }
 
+HitDoc*
+DocReader_fetch_doc_fields(DocReader *self, int32_t doc_id, VArray *fields) {
+    UNUSED_VAR(fields);
+    return DocReader_Fetch_Doc(self, doc_id);
+}
+
+VArray*
+DocReader_fetch_docs(DocReader *self, I32Array *doc_ids) {
+    const uint32_t num_ids  = I32Arr_Get_Size(doc_ids);
+    VArray        *hit_docs = VA_new(num_ids);
+    DocRequest    *requests
+        = (DocRequest*)MALLOCATE(num_ids * sizeof(DocRequest) + 1);
+
+    // Doc ids increase with file position, both within a segment and from
+    // one segment to the next, so visiting them in sorted order turns the
+    // reads into a forward sweep.
+    for (uint32_t i = 0; i < num_ids; i++) {
+        requests[i].doc_id = I32Arr_Get(doc_ids, i);
+        requests[i].tick   = i;
+    }
+    Sort_quicksort(requests, num_ids, sizeof(DocRequest), S_compare_requests,
+                   NULL);
+
+    /* Decode serially: every HitDoc holds host-language field values, and
+     * neither those nor our refcounts may be touched from another thread. */
+    DocReader_Prefetch_Docs(self, doc_ids);
+    for (uint32_t i = 0; i < num_ids; i++) {
+        HitDoc *hit_doc = DocReader_Fetch_Doc(self, requests[i].doc_id);
+        VA_Store(hit_docs, requests[i].tick, (Obj*)hit_doc);
+    }
+
+    FREEMEM(requests);
+    return hit_docs;
+}
+
+void
+DocReader_prefetch_docs(DocReader *self, I32Array *doc_ids) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(doc_ids);
+}
+
 DocReader*
 DocReader_aggregator(DocReader *self, VArray *readers, I32Array *offsets) {
     UNUSED_VAR(self);
@@ -93,6 +179,49 @@ PolyDocReader_fetch_doc(PolyDocReader *self, int32_t doc_id) {
     return hit_doc;
 }
 
+HitDoc*
+PolyDocReader_fetch_doc_fields(PolyDocReader *self, int32_t doc_id,
+                               VArray *fields) {
+    uint32_t seg_tick = PolyReader_sub_tick(self->offsets, doc_id);
+    int32_t  offset   = I32Arr_Get(self->offsets, seg_tick);
+    DocReader *doc_reader = (DocReader*)VA_Fetch(self->readers, seg_tick);
+    if (!doc_reader) {
+        THROW(ERR, "Invalid doc_id: %i32", doc_id);
+    }
+    HitDoc *hit_doc
+        = DocReader_Fetch_Doc_Fields(doc_reader, doc_id - offset, fields);
+    HitDoc_Set_Doc_ID(hit_doc, doc_id);
+    return hit_doc;
+}
+
+void
+PolyDocReader_prefetch_docs(PolyDocReader *self, I32Array *doc_ids) {
+    const uint32_t num_ids = I32Arr_Get_Size(doc_ids);
+    const uint32_t num_readers = VA_Get_Size(self->readers);
+    if (!num_ids || !num_readers) { return; }
+
+    // Group the doc ids by segment, translating them to segment-local ids.
+    int32_t *local_ids = (int32_t*)MALLOCATE(num_ids * sizeof(int32_t));
+    for (uint32_t seg_tick = 0; seg_tick < num_readers; seg_tick++) {
+        DocReader *doc_reader = (DocReader*)VA_Fetch(self->readers, seg_tick);
+        int32_t    offset     = I32Arr_Get(self->offsets, seg_tick);
+        uint32_t   count      = 0;
+        if (!doc_reader) { continue; }
+        for (uint32_t i = 0; i < num_ids; i++) {
+            int32_t doc_id = I32Arr_Get(doc_ids, i);
+            if (PolyReader_sub_tick(self->offsets, doc_id) == seg_tick) {
+                local_ids[count++] = doc_id - offset;
+            }
+        }
+        if (count) {
+            I32Array *seg_ids = I32Arr_new(local_ids, count);
+            DocReader_Prefetch_Docs(doc_reader, seg_ids);
+            DECREF(seg_ids);
+        }
+    }
+    FREEMEM(local_ids);
+}
+
 DefaultDocReader*
 DefDocReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                  VArray *segments, int32_t seg_tick) {
@@ -102,8 +231,22 @@ DefDocReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                              seg_tick);
 }
 
+static void
+S_free_block_cache(DefaultDocReader *self) {
+    if (self->block_cache != NULL) {
+        DocBlock *blocks = (DocBlock*)self->block_cache;
+        for (uint32_t i = 0; i < DOC_BLOCK_CACHE_SIZE; i++) {
+            S_clear_block(&blocks[i]);
+            FREEMEM(blocks[i].offsets);
+        }
+        FREEMEM(blocks);
+        self->block_cache = NULL;
+    }
+}
+
 void
 DefDocReader_close(DefaultDocReader *self) {
+    S_free_block_cache(self);
     if (self->dat_in != NULL) {
         InStream_Close(self->dat_in);
         DECREF(self->dat_in);
@@ -118,8 +261,12 @@ DefDocReader_close(DefaultDocReader *self) {
 
 void
 DefDocReader_destroy(DefaultDocReader *self) {
+    S_free_block_cache(self);
     DECREF(self->ix_in);
     DECREF(self->dat_in);
+    DECREF(self->compressed);
+    FREEMEM(self->block_docs);
+    FREEMEM(self->block_starts);
     SUPER_DESTROY(self, DEFAULTDOCREADER);
 }
 
@@ -147,7 +294,9 @@ DefDocReader_init(DefaultDocReader *self, Schema *schema, Folder *folder,
                 THROW(ERR, "Obsolete doc storage format %i64; "
                       "Index regeneration is required", format_val);
             }
-            else if (format_val != DocWriter_current_file_format) {
+            else if (format_val != DocWriter_current_file_format
+                     && format_val != DocWriter_compressed_file_format
+                    ) {
                 THROW(ERR, "Unsupported doc storage format: %i64", format_val);
             }
         }
@@ -170,6 +319,9 @@ DefDocReader_init(DefaultDocReader *self, Schema *schema, Folder *folder,
                 DECREF(self);
                 RETHROW(error);
             }
+            if (Obj_To_I64(format) == DocWriter_compressed_file_format) {
+                S_read_block_index(self);
+            }
         }
         DECREF(ix_file);
         DECREF(dat_file);
@@ -178,9 +330,207 @@ DefDocReader_init(DefaultDocReader *self, Schema *schema, Folder *folder,
     return self;
 }
 
+static void
+S_read_block_index(DefaultDocReader *self) {
+    InStream *ix_in  = self->ix_in;
+    int64_t   len    = InStream_Length(ix_in);
+    int32_t   cap    = 16;
+    int32_t   tick   = 0;
+    int32_t   doc_id = 1;
+    int64_t   start  = 0;
+
+    // Each entry holds the number of docs in a block and the block's
+    // length; accumulate them into first doc ids and file pointers, with a
+    // sentinel entry at the end.
+    self->block_docs   = (int32_t*)MALLOCATE((cap + 1) * sizeof(int32_t));
+    self->block_starts = (int64_t*)MALLOCATE((cap + 1) * sizeof(int64_t));
+    while (InStream_Tell(ix_in) < len) {
+        if (tick == cap) {
+            cap *= 2;
+            self->block_docs = (int32_t*)REALLOCATE(
+                                   self->block_docs,
+                                   (cap + 1) * sizeof(int32_t));
+            self->block_starts = (int64_t*)REALLOCATE(
+                                     self->block_starts,
+                                     (cap + 1) * sizeof(int64_t));
+        }
+        self->block_docs[tick]   = doc_id;
+        self->block_starts[tick] = start;
+        doc_id += (int32_t)InStream_Read_C32(ix_in);
+        start  += (int64_t)InStream_Read_C64(ix_in);
+        tick++;
+    }
+    self->block_docs[tick]   = doc_id;
+    self->block_starts[tick] = start;
+    self->num_blocks         = tick;
+
+    // The index is small enough to keep in RAM, so the stream is no longer
+    // needed.
+    InStream_Close(ix_in);
+    DECREF(ix_in);
+    self->ix_in = NULL;
+
+    DocBlock *blocks
+        = (DocBlock*)CALLOCATE(DOC_BLOCK_CACHE_SIZE, sizeof(DocBlock));
+    for (uint32_t i = 0; i < DOC_BLOCK_CACHE_SIZE; i++) {
+        blocks[i].tick = -1;
+    }
+    self->block_cache = blocks;
+    self->compressed  = BB_new(0);
+}
+
+static int32_t
+S_find_block(DefaultDocReader *self, int32_t doc_id) {
+    const int32_t *block_docs = self->block_docs;
+    if (doc_id < 1 || doc_id >= block_docs[self->num_blocks]) { return -1; }
+
+    // Binary search for the last block starting at or before the doc.
+    int32_t lo = 0;
+    int32_t hi = self->num_blocks - 1;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo + 1) / 2;
+        if (block_docs[mid] <= doc_id) { lo = mid; }
+        else                           { hi = mid - 1; }
+    }
+    return lo;
+}
+
+static void
+S_clear_block(DocBlock *block) {
+    DECREF(block->instream);
+    DECREF(block->content);
+    block->instream = NULL;
+    block->content  = NULL;
+    block->tick     = -1;
+}
+
+static void
+S_load_block(DefaultDocReader *self, DocBlock *block, int32_t tick) {
+    InStream *dat_in   = self->dat_in;
+    uint32_t  num_docs = (uint32_t)(self->block_docs[tick + 1]
+                                    - self->block_docs[tick]);
+
+    // Read the compressed block.
+    InStream_Seek(dat_in, self->block_starts[tick]);
+    uint32_t raw_len  = InStream_Read_C32(dat_in);
+    int64_t  comp_len = self->block_starts[tick + 1] - InStream_Tell(dat_in);
+    if (comp_len < 0) {
+        THROW(ERR, "Corrupt block %i32 in %o", tick,
+              InStream_Get_Filename(dat_in));
+    }
+    char *comp = BB_Grow(self->compressed, (size_t)comp_len);
+    InStream_Read_Bytes(dat_in, comp, (size_t)comp_len);
+
+    // Decompress, leaving zeroed slack at the end so that decoding a
+    // truncated header can't run off the buffer.
+    S_clear_block(block);
+    ByteBuf *content = BB_new(raw_len + C32_MAX_BYTES);
+    char    *raw     = BB_Get_Buf(content);
+    memset(raw + raw_len, 0, C32_MAX_BYTES);
+    if (!BlockCodec_decompress(comp, (size_t)comp_len, raw, raw_len)) {
+        DECREF(content);
+        THROW(ERR, "Corrupt block %i32 in %o", tick,
+              InStream_Get_Filename(dat_in));
+    }
+    BB_Set_Size(content, raw_len);
+
+    // Turn the header of record lengths into offsets.
+    if (num_docs + 1 > block->offsets_cap) {
+        block->offsets_cap = num_docs + 1;
+        block->offsets = (uint32_t*)REALLOCATE(
+                             block->offsets,
+                             block->offsets_cap * sizeof(uint32_t));
+    }
+    uint32_t *offsets = block->offsets;
+    char     *ptr     = raw;
+    char     *limit   = raw + raw_len;
+    for (uint32_t i = 1; i <= num_docs; i++) {
+        // The slack only covers a single length begun inside the block.
+        if (ptr >= limit) {
+            DECREF(content);
+            THROW(ERR, "Corrupt block %i32 in %o", tick,
+                  InStream_Get_Filename(dat_in));
+        }
+        offsets[i] = NumUtil_decode_c32(&ptr);
+    }
+    uint64_t end = (uint64_t)(ptr - raw);
+    offsets[0] = (uint32_t)end;
+    for (uint32_t i = 1; i <= num_docs; i++) {
+        end += offsets[i];
+        offsets[i] = offsets[i - 1] + offsets[i];
+    }
+    if (end != raw_len) {
+        DECREF(content);
+        THROW(ERR, "Corrupt block %i32 in %o", tick,
+              InStream_Get_Filename(dat_in));
+    }
+
+    RAMFile *file = RAMFile_new(content, true);
+    block->instream = InStream_open((Obj*)file);
+    DECREF(file);
+    if (!block->instream) {
+        DECREF(content);
+        RETHROW(INCREF(Err_get_error()));
+    }
+    block->content = content;
+    block->tick    = tick;
+}
+
+static DocBlock*
+S_fetch_block(DefaultDocReader *self, int32_t tick) {
+    DocBlock *blocks = (DocBlock*)self->block_cache;
+    DocBlock *victim = blocks;
+    self->cache_clock++;
+
+    for (uint32_t i = 0; i < DOC_BLOCK_CACHE_SIZE; i++) {
+        if (blocks[i].tick == tick) {
+            blocks[i].last_used = self->cache_clock;
+            return &blocks[i];
+        }
+        if (blocks[i].last_used < victim->last_used) {
+            victim = &blocks[i];
+        }
+    }
+
+    S_load_block(self, victim, tick);
+    victim->last_used = self->cache_clock;
+    return victim;
+}
+
+InStream*
+DefDocReader_seek_doc(DefaultDocReader *self, int32_t doc_id) {
+    if (self->block_docs) {
+        int32_t tick = S_find_block(self, doc_id);
+        if (tick < 0) { THROW(ERR, "Invalid doc_id: %i32", doc_id); }
+        DocBlock *block = S_fetch_block(self, tick);
+        uint32_t  local = (uint32_t)(doc_id - self->block_docs[tick]);
+        InStream_Seek(block->instream, block->offsets[local]);
+        return block->instream;
+    }
+    else {
+        InStream_Seek(self->ix_in, (int64_t)doc_id * 8);
+        int64_t start = InStream_Read_I64(self->ix_in);
+        InStream_Seek(self->dat_in, start);
+        return self->dat_in;
+    }
+}
+
 void
 DefDocReader_read_record(DefaultDocReader *self, ByteBuf *buffer,
                          int32_t doc_id) {
+    if (self->block_docs) {
+        int32_t tick = S_find_block(self, doc_id);
+        if (tick < 0) { THROW(ERR, "Invalid doc_id: %i32", doc_id); }
+        DocBlock *block = S_fetch_block(self, tick);
+        uint32_t  local = (uint32_t)(doc_id - self->block_docs[tick]);
+        uint32_t  start = block->offsets[local];
+        size_t    size  = block->offsets[local + 1] - start;
+        char     *buf   = BB_Grow(buffer, size);
+        memcpy(buf, BB_Get_Buf(block->content) + start, size);
+        BB_Set_Size(buffer, size);
+        return;
+    }
+
     // Find start and length of variable length record.
     InStream_Seek(self->ix_in, (int64_t)doc_id * 8);
     int64_t start = InStream_Read_I64(self->ix_in);
@@ -194,4 +544,62 @@ DefDocReader_read_record(DefaultDocReader *self, ByteBuf *buffer,
     BB_Set_Size(buffer, size);
 }
 
+void
+DefDocReader_prefetch_docs(DefaultDocReader *self, I32Array *doc_ids) {
+    const uint32_t num_ids = I32Arr_Get_Size(doc_ids);
+    if (!self->dat_in) { return; }
+
+    if (self->block_docs) {
+        // Hint each distinct block once.
+        int32_t last_tick = -1;
+        for (uint32_t i = 0; i < num_ids; i++) {
+            int32_t tick = S_find_block(self, I32Arr_Get(doc_ids, i));
+            if (tick < 0 || tick == last_tick) { continue; }
+            int64_t start = self->block_starts[tick];
+            InStream_Prefetch(self->dat_in, start,
+                              self->block_starts[tick + 1] - start);
+            last_tick = tick;
+        }
+        return;
+    }
+
+    // Hint all the index entries, then read them in file order, so that the
+    // reads overlap rather than each waiting on the one before.
+    const int64_t  ix_len   = InStream_Length(self->ix_in);
+    DocRequest    *requests
+        = (DocRequest*)MALLOCATE(num_ids * sizeof(DocRequest) + 1);
+    for (uint32_t i = 0; i < num_ids; i++) {
+        requests[i].doc_id = I32Arr_Get(doc_ids, i);
+        requests[i].tick   = i;
+        InStream_Prefetch(self->ix_in, (int64_t)requests[i].doc_id * 8, 16);
+    }
+    Sort_quicksort(requests, num_ids, sizeof(DocRequest), S_compare_requests,
+                   NULL);
+
+    // Hint the records the entries point to, merging neighbours.
+    int64_t run_start = 0;
+    int64_t run_end   = 0;
+    for (uint32_t i = 0; i < num_ids; i++) {
+        const int64_t doc_id = requests[i].doc_id;
+        if (doc_id < 1 || doc_id * 8 + 16 > ix_len) { continue; }
+        if (i && doc_id == requests[i - 1].doc_id) { continue; }
+        InStream_Seek(self->ix_in, doc_id * 8);
+        const int64_t start = InStream_Read_I64(self->ix_in);
+        const int64_t end   = InStream_Read_I64(self->ix_in);
+        if (start != run_end) {
+            if (run_end > run_start) {
+                InStream_Prefetch(self->dat_in, run_start,
+                                  run_end - run_start);
+            }
+            run_start = start;
+        }
+        run_end = end;
+    }
+    if (run_end > run_start) {
+        InStream_Prefetch(self->dat_in, run_start, run_end - run_start);
+    }
+
+    FREEMEM(requests);
+}
+
 
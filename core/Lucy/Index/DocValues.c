@@ -0,0 +1,206 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_DOCVALUES
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Index/DocValues.h"
+#include "Lucy/Plan/FieldType.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Util/NumberUtils.h"
+
+DocValues*
+DocValues_new(const CharBuf *field, FieldType *type, int32_t doc_max,
+              int32_t count, int64_t min, int32_t bits, InStream *instream) {
+    DocValues *self = (DocValues*)VTable_Make_Obj(DOCVALUES);
+    return DocValues_init(self, field, type, doc_max, count, min, bits,
+                          instream);
+}
+
+DocValues*
+DocValues_init(DocValues *self, const CharBuf *field, FieldType *type,
+               int32_t doc_max, int32_t count, int64_t min, int32_t bits,
+               InStream *instream) {
+    // Assign.
+    self->field    = CB_Clone(field);
+    self->type     = (FieldType*)INCREF(type);
+    self->instream = (InStream*)INCREF(instream);
+    self->doc_max  = doc_max;
+    self->count    = count;
+    self->min      = min;
+    self->bits     = bits;
+    self->prim_id  = FType_Primitive_ID(type) & FType_PRIMITIVE_ID_MASK;
+    self->presence = NULL;
+    self->packed   = NULL;
+    self->bytes    = NULL;
+
+    // Validate.
+    if (doc_max < 0 || bits < 0 || bits > 64) {
+        DECREF(self);
+        THROW(ERR, "Invalid doc values params for '%o': doc_max %i32, "
+              "bits %i32", field, doc_max, bits);
+    }
+    bool_t  var_width    = self->prim_id == FType_TEXT
+                           || self->prim_id == FType_BLOB;
+    int64_t slots        = (int64_t)doc_max + 1;
+    int64_t presence_len = (slots + 7) / 8;
+    int64_t num_entries  = var_width ? slots + 1 : slots;
+    int64_t packed_len   = DocValues_packed_size(num_entries, bits);
+    int64_t file_len     = InStream_Length(instream);
+    if (file_len < presence_len + packed_len) {
+        DECREF(self);
+        THROW(ERR, "Doc values file for '%o' too short: %i64 < %i64", field,
+              file_len, presence_len + packed_len);
+    }
+
+    // Mmap the whole file.
+    char *buf = InStream_Buf(instream, (size_t)file_len);
+    self->presence = (uint8_t*)buf;
+    self->packed   = (uint8_t*)buf + presence_len;
+    if (var_width) {
+        int64_t bytes_len
+            = (int64_t)NumUtil_packed_get(self->packed, (uint32_t)slots, bits);
+        if (file_len < presence_len + packed_len + bytes_len) {
+            DECREF(self);
+            THROW(ERR, "Doc values file for '%o' too short: %i64 < %i64",
+                  field, file_len, presence_len + packed_len + bytes_len);
+        }
+        self->bytes = buf + presence_len + packed_len;
+    }
+
+    return self;
+}
+
+void
+DocValues_destroy(DocValues *self) {
+    DECREF(self->field);
+    DECREF(self->type);
+    if (self->instream) {
+        InStream_Close(self->instream);
+        InStream_Dec_RefCount(self->instream);
+    }
+    SUPER_DESTROY(self, DOCVALUES);
+}
+
+int64_t
+DocValues_packed_size(int64_t num_entries, int32_t bits) {
+    return (num_entries * bits + 7) / 8;
+}
+
+bool_t
+DocValues_has_value(DocValues *self, int32_t doc_id) {
+    if (doc_id < 1 || doc_id > self->doc_max) { return false; }
+    return NumUtil_u1get(self->presence, (uint32_t)doc_id);
+}
+
+int64_t
+DocValues_i64_value(DocValues *self, int32_t doc_id) {
+    if (self->prim_id != FType_INT32 && self->prim_id != FType_INT64) {
+        THROW(ERR, "'%o' isn't an integer field", self->field);
+    }
+    if (!DocValues_Has_Value(self, doc_id)) { return 0; }
+    uint64_t delta
+        = NumUtil_packed_get(self->packed, (uint32_t)doc_id, self->bits);
+    return (int64_t)((uint64_t)self->min + delta);
+}
+
+double
+DocValues_f64_value(DocValues *self, int32_t doc_id) {
+    if (!DocValues_Has_Value(self, doc_id)) { return 0.0; }
+    switch (self->prim_id) {
+        case FType_INT32:
+        case FType_INT64:
+            return (double)DocValues_I64_Value(self, doc_id);
+        case FType_FLOAT32: {
+                union { float f; uint32_t u32; } duo;
+                duo.u32 = (uint32_t)NumUtil_packed_get(self->packed,
+                                                       (uint32_t)doc_id, 32);
+                return duo.f;
+            }
+        case FType_FLOAT64: {
+                union { double d; uint64_t u64; } duo;
+                duo.u64 = NumUtil_packed_get(self->packed, (uint32_t)doc_id,
+                                             64);
+                return duo.d;
+            }
+        default:
+            THROW(ERR, "'%o' isn't a numeric field", self->field);
+            UNREACHABLE_RETURN(double);
+    }
+}
+
+const char*
+DocValues_bytes_value(DocValues *self, int32_t doc_id, size_t *size) {
+    if (!self->bytes) {
+        THROW(ERR, "'%o' isn't a text or blob field", self->field);
+    }
+    if (!DocValues_Has_Value(self, doc_id)) {
+        *size = 0;
+        return NULL;
+    }
+    uint64_t start
+        = NumUtil_packed_get(self->packed, (uint32_t)doc_id, self->bits);
+    uint64_t end
+        = NumUtil_packed_get(self->packed, (uint32_t)doc_id + 1, self->bits);
+    *size = (size_t)(end - start);
+    return self->bytes + start;
+}
+
+Obj*
+DocValues_value(DocValues *self, int32_t doc_id) {
+    if (!DocValues_Has_Value(self, doc_id)) { return NULL; }
+    switch (self->prim_id) {
+        case FType_TEXT: {
+                size_t size;
+                const char *ptr = DocValues_Bytes_Value(self, doc_id, &size);
+                return (Obj*)CB_new_from_utf8(ptr, size);
+            }
+        case FType_BLOB: {
+                size_t size;
+                const char *ptr = DocValues_Bytes_Value(self, doc_id, &size);
+                return (Obj*)BB_new_bytes(ptr, size);
+            }
+        case FType_INT32:
+            return (Obj*)Int32_new((int32_t)DocValues_I64_Value(self, doc_id));
+        case FType_INT64:
+            return (Obj*)Int64_new(DocValues_I64_Value(self, doc_id));
+        case FType_FLOAT32:
+            return (Obj*)Float32_new((float)DocValues_F64_Value(self, doc_id));
+        case FType_FLOAT64:
+            return (Obj*)Float64_new(DocValues_F64_Value(self, doc_id));
+        default:
+            THROW(ERR, "Unexpected primitive id for '%o': %i32", self->field,
+                  (int32_t)self->prim_id);
+            UNREACHABLE_RETURN(Obj*);
+    }
+}
+
+CharBuf*
+DocValues_get_field(DocValues *self) {
+    return self->field;
+}
+
+int32_t
+DocValues_get_doc_max(DocValues *self) {
+    return self->doc_max;
+}
+
+int32_t
+DocValues_get_count(DocValues *self) {
+    return self->count;
+}
+
+
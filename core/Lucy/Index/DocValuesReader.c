@@ -0,0 +1,236 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_DOCVALUESREADER
+#define C_LUCY_POLYDOCVALUESREADER
+#define C_LUCY_DEFAULTDOCVALUESREADER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Index/DocValuesReader.h"
+#include "Lucy/Index/DocValues.h"
+#include "Lucy/Index/DocValuesWriter.h"
+#include "Lucy/Index/PolyReader.h"
+#include "Lucy/Index/Segment.h"
+#include "Lucy/Index/Snapshot.h"
+#include "Lucy/Plan/FieldType.h"
+#include "Lucy/Plan/Schema.h"
+#include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
+
+DocValuesReader*
+DocValuesReader_init(DocValuesReader *self, Schema *schema, Folder *folder,
+                     Snapshot *snapshot, VArray *segments, int32_t seg_tick) {
+    DataReader_init((DataReader*)self, schema, folder, snapshot, segments,
+                    seg_tick);
+    ABSTRACT_CLASS_CHECK(self, DOCVALUESREADER);
+    return self;
+}
+
+DataReader*
+DocValuesReader_aggregator(DocValuesReader *self, VArray *readers,
+                           I32Array *offsets) {
+    UNUSED_VAR(self);
+    return (DataReader*)PolyDocValuesReader_new(readers, offsets);
+}
+
+PolyDocValuesReader*
+PolyDocValuesReader_new(VArray *readers, I32Array *offsets) {
+    PolyDocValuesReader *self
+        = (PolyDocValuesReader*)VTable_Make_Obj(POLYDOCVALUESREADER);
+    return PolyDocValuesReader_init(self, readers, offsets);
+}
+
+PolyDocValuesReader*
+PolyDocValuesReader_init(PolyDocValuesReader *self, VArray *readers,
+                         I32Array *offsets) {
+    DocValuesReader_init((DocValuesReader*)self, NULL, NULL, NULL, NULL, -1);
+    for (uint32_t i = 0, max = VA_Get_Size(readers); i < max; i++) {
+        Obj *reader = VA_Fetch(readers, i);
+        if (reader) { CERTIFY(reader, DOCVALUESREADER); }
+    }
+    self->readers = (VArray*)INCREF(readers);
+    self->offsets = (I32Array*)INCREF(offsets);
+    return self;
+}
+
+void
+PolyDocValuesReader_close(PolyDocValuesReader *self) {
+    if (self->readers) {
+        for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+            DocValuesReader *reader
+                = (DocValuesReader*)VA_Fetch(self->readers, i);
+            if (reader) { DocValuesReader_Close(reader); }
+        }
+        VA_Clear(self->readers);
+    }
+}
+
+void
+PolyDocValuesReader_destroy(PolyDocValuesReader *self) {
+    DECREF(self->readers);
+    DECREF(self->offsets);
+    SUPER_DESTROY(self, POLYDOCVALUESREADER);
+}
+
+DocValues*
+PolyDocValuesReader_fetch_doc_values(PolyDocValuesReader *self,
+                                     const CharBuf *field) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(field);
+    return NULL;
+}
+
+Obj*
+PolyDocValuesReader_value(PolyDocValuesReader *self, const CharBuf *field,
+                          int32_t doc_id) {
+    uint32_t seg_tick = PolyReader_sub_tick(self->offsets, doc_id);
+    int32_t  offset   = I32Arr_Get(self->offsets, seg_tick);
+    DocValuesReader *reader
+        = (DocValuesReader*)VA_Fetch(self->readers, seg_tick);
+    if (!reader) { return NULL; }
+    return DocValuesReader_Value(reader, field, doc_id - offset);
+}
+
+DefaultDocValuesReader*
+DefDocValuesReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
+                       VArray *segments, int32_t seg_tick) {
+    DefaultDocValuesReader *self
+        = (DefaultDocValuesReader*)VTable_Make_Obj(DEFAULTDOCVALUESREADER);
+    return DefDocValuesReader_init(self, schema, folder, snapshot, segments,
+                                   seg_tick);
+}
+
+DefaultDocValuesReader*
+DefDocValuesReader_init(DefaultDocValuesReader *self, Schema *schema,
+                        Folder *folder, Snapshot *snapshot, VArray *segments,
+                        int32_t seg_tick) {
+    DocValuesReader_init((DocValuesReader*)self, schema, folder, snapshot,
+                         segments, seg_tick);
+    Segment *segment  = DefDocValuesReader_Get_Segment(self);
+    Hash    *metadata
+        = (Hash*)Seg_Fetch_Metadata_Str(segment, "doc_values", 10);
+
+    self->columns = Hash_new(0);
+    self->fields  = NULL;
+
+    if (metadata) {
+        CERTIFY(metadata, HASH);
+
+        // Check format.
+        Obj *format = Hash_Fetch_Str(metadata, "format", 6);
+        if (!format) { THROW(ERR, "Missing 'format' var"); }
+        else {
+            int32_t format_val = (int32_t)Obj_To_I64(format);
+            if (format_val != DocValuesWriter_current_file_format) {
+                THROW(ERR, "Unsupported doc values format: %i32",
+                      format_val);
+            }
+        }
+
+        Hash *fields = (Hash*)Hash_Fetch_Str(metadata, "fields", 6);
+        self->fields = (Hash*)INCREF(CERTIFY(fields, HASH));
+    }
+    else {
+        self->fields = Hash_new(0);
+    }
+
+    return self;
+}
+
+void
+DefDocValuesReader_close(DefaultDocValuesReader *self) {
+    if (self->columns) {
+        Hash_Dec_RefCount(self->columns);
+        self->columns = NULL;
+    }
+    if (self->fields) {
+        Hash_Dec_RefCount(self->fields);
+        self->fields = NULL;
+    }
+}
+
+void
+DefDocValuesReader_destroy(DefaultDocValuesReader *self) {
+    DECREF(self->columns);
+    DECREF(self->fields);
+    SUPER_DESTROY(self, DEFAULTDOCVALUESREADER);
+}
+
+static DocValues*
+S_lazy_init_column(DefaultDocValuesReader *self, const CharBuf *field) {
+    // See if we have any values.
+    Hash *stats = (Hash*)Hash_Fetch(self->fields, (Obj*)field);
+    if (!stats) { return NULL; }
+    CERTIFY(stats, HASH);
+
+    // Get a FieldType and sanity check that the field has doc values.
+    Schema    *schema = DefDocValuesReader_Get_Schema(self);
+    FieldType *type   = Schema_Fetch_Type(schema, field);
+    if (!type || !FType_Doc_Values(type)) {
+        THROW(ERR, "'%o' isn't a doc values field", field);
+    }
+
+    Obj *count_obj = CERTIFY(Hash_Fetch_Str(stats, "count", 5), OBJ);
+    Obj *min_obj   = CERTIFY(Hash_Fetch_Str(stats, "min", 3), OBJ);
+    Obj *bits_obj  = CERTIFY(Hash_Fetch_Str(stats, "bits", 4), OBJ);
+
+    // Open stream.
+    Folder   *folder    = DefDocValuesReader_Get_Folder(self);
+    Segment  *segment   = DefDocValuesReader_Get_Segment(self);
+    int32_t   field_num = Seg_Field_Num(segment, field);
+    CharBuf  *path      = CB_newf("%o/docvalues-%i32.dat",
+                                  Seg_Get_Name(segment), field_num);
+    InStream *instream  = Folder_Open_In(folder, path);
+    DECREF(path);
+    if (!instream) {
+        THROW(ERR, "Error opening doc values for '%o': %o", field,
+              Err_get_error());
+    }
+
+    DocValues *column
+        = DocValues_new(field, type, (int32_t)Seg_Get_Count(segment),
+                        (int32_t)Obj_To_I64(count_obj), Obj_To_I64(min_obj),
+                        (int32_t)Obj_To_I64(bits_obj), instream);
+    Hash_Store(self->columns, (Obj*)field, (Obj*)column);
+    DECREF(instream);
+
+    return column;
+}
+
+DocValues*
+DefDocValuesReader_fetch_doc_values(DefaultDocValuesReader *self,
+                                    const CharBuf *field) {
+    DocValues *column = NULL;
+
+    if (field) {
+        if (!self->columns) { THROW(ERR, "Can't fetch after Close()"); }
+        column = (DocValues*)Hash_Fetch(self->columns, (Obj*)field);
+        if (!column) {
+            column = S_lazy_init_column(self, field);
+        }
+    }
+
+    return column;
+}
+
+Obj*
+DefDocValuesReader_value(DefaultDocValuesReader *self, const CharBuf *field,
+                         int32_t doc_id) {
+    DocValues *column = DefDocValuesReader_Fetch_Doc_Values(self, field);
+    return column ? DocValues_Value(column, doc_id) : NULL;
+}
+
+
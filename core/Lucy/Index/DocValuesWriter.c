@@ -0,0 +1,403 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_DOCVALUESWRITER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Index/DocValuesWriter.h"
+#include "Lucy/Index/DocValues.h"
+#include "Lucy/Index/DocValuesReader.h"
+#include "Lucy/Index/Inverter.h"
+#include "Lucy/Index/PolyReader.h"
+#include "Lucy/Index/Segment.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Index/Snapshot.h"
+#include "Lucy/Plan/FieldType.h"
+#include "Lucy/Plan/Schema.h"
+#include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Store/OutStream.h"
+#include "Lucy/Util/NumberUtils.h"
+
+int32_t DocValuesWriter_current_file_format = 1;
+
+// Per-field spooling state.
+typedef struct lucy_DVColumn {
+    OutStream *spool;
+    int64_t    min;
+    int64_t    max;
+    int64_t    total_len;
+    int32_t    count;
+    int32_t    last_doc;
+    int8_t     prim_id;
+} lucy_DVColumn;
+
+DocValuesWriter*
+DocValuesWriter_new(Schema *schema, Snapshot *snapshot, Segment *segment,
+                    PolyReader *polyreader) {
+    DocValuesWriter *self
+        = (DocValuesWriter*)VTable_Make_Obj(DOCVALUESWRITER);
+    return DocValuesWriter_init(self, schema, snapshot, segment, polyreader);
+}
+
+DocValuesWriter*
+DocValuesWriter_init(DocValuesWriter *self, Schema *schema,
+                     Snapshot *snapshot, Segment *segment,
+                     PolyReader *polyreader) {
+    DataWriter_init((DataWriter*)self, schema, snapshot, segment, polyreader);
+    self->columns     = NULL;
+    self->num_columns = 0;
+    self->stats       = Hash_new(0);
+    return self;
+}
+
+void
+DocValuesWriter_destroy(DocValuesWriter *self) {
+    lucy_DVColumn *columns = (lucy_DVColumn*)self->columns;
+    for (uint32_t i = 0; i < self->num_columns; i++) {
+        DECREF(columns[i].spool);
+    }
+    FREEMEM(self->columns);
+    DECREF(self->stats);
+    SUPER_DESTROY(self, DOCVALUESWRITER);
+}
+
+static CharBuf*
+S_spool_path(DocValuesWriter *self, int32_t field_num) {
+    return CB_newf("%o/docvalues-%i32.temp", Seg_Get_Name(self->segment),
+                   field_num);
+}
+
+static lucy_DVColumn*
+S_lazy_init_column(DocValuesWriter *self, int32_t field_num,
+                   FieldType *type) {
+    if ((uint32_t)field_num >= self->num_columns) {
+        uint32_t new_size = (uint32_t)field_num + 1;
+        self->columns = REALLOCATE(self->columns,
+                                   new_size * sizeof(lucy_DVColumn));
+        memset((lucy_DVColumn*)self->columns + self->num_columns, 0,
+               (new_size - self->num_columns) * sizeof(lucy_DVColumn));
+        self->num_columns = new_size;
+    }
+    lucy_DVColumn *column = (lucy_DVColumn*)self->columns + field_num;
+    if (!column->spool) {
+        CharBuf *path = S_spool_path(self, field_num);
+        column->spool = Folder_Open_Out(self->folder, path);
+        DECREF(path);
+        if (!column->spool) { RETHROW(INCREF(Err_get_error())); }
+        column->prim_id = FType_Primitive_ID(type) & FType_PRIMITIVE_ID_MASK;
+    }
+    return column;
+}
+
+static void
+S_start_record(lucy_DVColumn *column, int32_t doc_id) {
+    if (doc_id <= column->last_doc) {
+        THROW(ERR, "Doc ids out of order: %i32 after %i32", doc_id,
+              column->last_doc);
+    }
+    OutStream_Write_C32(column->spool, (uint32_t)doc_id);
+    column->last_doc = doc_id;
+    column->count++;
+}
+
+static void
+S_add_i64(lucy_DVColumn *column, int32_t doc_id, int64_t value) {
+    S_start_record(column, doc_id);
+    OutStream_Write_U64(column->spool, (uint64_t)value);
+    if (column->count == 1 || value < column->min) { column->min = value; }
+    if (column->count == 1 || value > column->max) { column->max = value; }
+}
+
+static void
+S_add_f64(lucy_DVColumn *column, int32_t doc_id, double value) {
+    S_start_record(column, doc_id);
+    if (column->prim_id == FType_FLOAT32) {
+        union { float f; uint32_t u32; } duo;
+        duo.f = (float)value;
+        OutStream_Write_U32(column->spool, duo.u32);
+    }
+    else {
+        union { double d; uint64_t u64; } duo;
+        duo.d = value;
+        OutStream_Write_U64(column->spool, duo.u64);
+    }
+}
+
+static void
+S_add_bytes(lucy_DVColumn *column, int32_t doc_id, const char *ptr,
+            size_t size) {
+    S_start_record(column, doc_id);
+    OutStream_Write_C32(column->spool, (uint32_t)size);
+    OutStream_Write_Bytes(column->spool, ptr, size);
+    column->total_len += (int64_t)size;
+}
+
+static void
+S_add_value(lucy_DVColumn *column, int32_t doc_id, Obj *value) {
+    switch (column->prim_id) {
+        case FType_TEXT: {
+                CharBuf *string = (CharBuf*)CERTIFY(value, CHARBUF);
+                S_add_bytes(column, doc_id, (char*)CB_Get_Ptr8(string),
+                            CB_Get_Size(string));
+            }
+            break;
+        case FType_BLOB: {
+                ByteBuf *bytebuf = (ByteBuf*)CERTIFY(value, BYTEBUF);
+                S_add_bytes(column, doc_id, BB_Get_Buf(bytebuf),
+                            BB_Get_Size(bytebuf));
+            }
+            break;
+        case FType_INT32:
+        case FType_INT64:
+            S_add_i64(column, doc_id, Obj_To_I64(value));
+            break;
+        case FType_FLOAT32:
+        case FType_FLOAT64:
+            S_add_f64(column, doc_id, Obj_To_F64(value));
+            break;
+        default:
+            THROW(ERR, "Unrecognized primitive id: %i32",
+                  (int32_t)column->prim_id);
+    }
+}
+
+void
+DocValuesWriter_add_inverted_doc(DocValuesWriter *self, Inverter *inverter,
+                                 int32_t doc_id) {
+    int32_t field_num;
+
+    Inverter_Iterate(inverter);
+    while (0 != (field_num = Inverter_Next(inverter))) {
+        FieldType *type = Inverter_Get_Type(inverter);
+        if (FType_Doc_Values(type)) {
+            Obj *value = Inverter_Get_Value(inverter);
+            if (value) {
+                lucy_DVColumn *column
+                    = S_lazy_init_column(self, field_num, type);
+                S_add_value(column, doc_id, value);
+            }
+        }
+    }
+}
+
+void
+DocValuesWriter_add_segment(DocValuesWriter *self, SegReader *reader,
+                            I32Array *doc_map) {
+    int32_t doc_max = SegReader_Doc_Max(reader);
+    if (doc_max == 0) { return; }
+    DocValuesReader *dv_reader = (DocValuesReader*)SegReader_Fetch(
+                                     reader, VTable_Get_Name(DOCVALUESREADER));
+    if (!dv_reader) { return; }
+
+    int32_t  base   = (int32_t)Seg_Get_Count(self->segment);
+    VArray  *fields = Schema_All_Fields(self->schema);
+
+    // Proceed field-at-a-time, rather than doc-at-a-time.
+    for (uint32_t i = 0, max = VA_Get_Size(fields); i < max; i++) {
+        CharBuf   *field = (CharBuf*)VA_Fetch(fields, i);
+        FieldType *type  = Schema_Fetch_Type(self->schema, field);
+        if (!FType_Doc_Values(type)) { continue; }
+        DocValues *source = DocValuesReader_Fetch_Doc_Values(dv_reader, field);
+        if (!source) { continue; }
+
+        int32_t field_num = Seg_Field_Num(self->segment, field);
+        lucy_DVColumn *column = S_lazy_init_column(self, field_num, type);
+        for (int32_t orig = 1; orig <= doc_max; orig++) {
+            int32_t doc_id = doc_map ? I32Arr_Get(doc_map, orig) : base + orig;
+            if (!doc_id || !DocValues_Has_Value(source, orig)) { continue; }
+            switch (column->prim_id) {
+                case FType_TEXT:
+                case FType_BLOB: {
+                        size_t size;
+                        const char *ptr
+                            = DocValues_Bytes_Value(source, orig, &size);
+                        S_add_bytes(column, doc_id, ptr, size);
+                    }
+                    break;
+                case FType_INT32:
+                case FType_INT64:
+                    S_add_i64(column, doc_id,
+                              DocValues_I64_Value(source, orig));
+                    break;
+                default:
+                    S_add_f64(column, doc_id,
+                              DocValues_F64_Value(source, orig));
+            }
+        }
+    }
+
+    DECREF(fields);
+}
+
+static int32_t
+S_bits_needed(uint64_t max_value) {
+    int32_t bits = 0;
+    while (max_value) {
+        bits++;
+        max_value >>= 1;
+    }
+    return bits;
+}
+
+static void
+S_finish_column(DocValuesWriter *self, lucy_DVColumn *column,
+                int32_t field_num, int32_t doc_max) {
+    bool_t   var_width = column->prim_id == FType_TEXT
+                         || column->prim_id == FType_BLOB;
+    int64_t  min       = 0;
+    int32_t  bits;
+    switch (column->prim_id) {
+        case FType_INT32:
+        case FType_INT64:
+            min  = column->min;
+            bits = S_bits_needed((uint64_t)column->max - (uint64_t)min);
+            break;
+        case FType_FLOAT32:
+            bits = 32;
+            break;
+        case FType_FLOAT64:
+            bits = 64;
+            break;
+        default:
+            bits = S_bits_needed((uint64_t)column->total_len);
+    }
+
+    // Build the presence bitmap and the packed array in RAM.
+    uint32_t  slots        = (uint32_t)doc_max + 1;
+    size_t    presence_len = (slots + 7) / 8;
+    uint32_t  num_entries  = var_width ? slots + 1 : slots;
+    size_t    packed_len
+        = (size_t)DocValues_packed_size(num_entries, bits);
+    uint8_t  *presence     = (uint8_t*)CALLOCATE(presence_len, 1);
+    uint8_t  *packed       = (uint8_t*)CALLOCATE(packed_len + 1, 1); // >0
+    CharBuf  *spool_path   = S_spool_path(self, field_num);
+    InStream *spool_in     = Folder_Open_In(self->folder, spool_path);
+    if (!spool_in) { RETHROW(INCREF(Err_get_error())); }
+    uint32_t  next_slot    = 0;
+    uint64_t  offset       = 0;
+    for (int32_t i = 0; i < column->count; i++) {
+        uint32_t doc_id = InStream_Read_C32(spool_in);
+        NumUtil_u1set(presence, doc_id);
+        switch (column->prim_id) {
+            case FType_TEXT:
+            case FType_BLOB: {
+                    // Docs without values get empty ranges.
+                    uint32_t size = InStream_Read_C32(spool_in);
+                    while (next_slot <= doc_id) {
+                        NumUtil_packed_set(packed, next_slot++, bits, offset);
+                    }
+                    offset += size;
+                    InStream_Seek(spool_in, InStream_Tell(spool_in) + size);
+                }
+                break;
+            case FType_FLOAT32:
+                NumUtil_packed_set(packed, doc_id, bits,
+                                   InStream_Read_U32(spool_in));
+                break;
+            case FType_FLOAT64:
+                NumUtil_packed_set(packed, doc_id, bits,
+                                   InStream_Read_U64(spool_in));
+                break;
+            default:
+                NumUtil_packed_set(packed, doc_id, bits,
+                                   InStream_Read_U64(spool_in)
+                                   - (uint64_t)min);
+        }
+    }
+    if (var_width) {
+        while (next_slot <= slots) {
+            NumUtil_packed_set(packed, next_slot++, bits, offset);
+        }
+    }
+
+    // Write the column.
+    CharBuf *path = CB_newf("%o/docvalues-%i32.dat",
+                            Seg_Get_Name(self->segment), field_num);
+    OutStream *outstream = Folder_Open_Out(self->folder, path);
+    DECREF(path);
+    if (!outstream) { RETHROW(INCREF(Err_get_error())); }
+    OutStream_Write_Bytes(outstream, presence, presence_len);
+    OutStream_Write_Bytes(outstream, packed, packed_len);
+    if (var_width) {
+        // Second pass over the spool to copy the values themselves.
+        ByteBuf *buffer = BB_new(0);
+        InStream_Seek(spool_in, 0);
+        for (int32_t i = 0; i < column->count; i++) {
+            InStream_Read_C32(spool_in);
+            uint32_t size = InStream_Read_C32(spool_in);
+            char *buf = BB_Grow(buffer, size);
+            InStream_Read_Bytes(spool_in, buf, size);
+            OutStream_Write_Bytes(outstream, buf, size);
+        }
+        DECREF(buffer);
+    }
+    OutStream_Close(outstream);
+    DECREF(outstream);
+    InStream_Close(spool_in);
+    DECREF(spool_in);
+    FREEMEM(presence);
+    FREEMEM(packed);
+
+    // Clean up the spool.
+    Folder_Delete(self->folder, spool_path);
+    DECREF(spool_path);
+
+    // Record stats.
+    Hash *stats = Hash_new(3);
+    Hash_Store_Str(stats, "count", 5, (Obj*)CB_newf("%i32", column->count));
+    Hash_Store_Str(stats, "min", 3, (Obj*)CB_newf("%i64", min));
+    Hash_Store_Str(stats, "bits", 4, (Obj*)CB_newf("%i32", bits));
+    Hash_Store(self->stats, (Obj*)Seg_Field_Name(self->segment, field_num),
+               (Obj*)stats);
+}
+
+void
+DocValuesWriter_finish(DocValuesWriter *self) {
+    lucy_DVColumn *columns = (lucy_DVColumn*)self->columns;
+    int32_t doc_max = (int32_t)Seg_Get_Count(self->segment);
+
+    // If we have no data, bail out.
+    if (!self->num_columns) { return; }
+
+    for (uint32_t i = 1; i < self->num_columns; i++) {
+        lucy_DVColumn *column = columns + i;
+        if (!column->spool) { continue; }
+        OutStream_Close(column->spool);
+        DECREF(column->spool);
+        column->spool = NULL;
+        S_finish_column(self, column, (int32_t)i, doc_max);
+    }
+
+    // Store metadata.
+    Seg_Store_Metadata_Str(self->segment, "doc_values", 10,
+                           (Obj*)DocValuesWriter_Metadata(self));
+}
+
+Hash*
+DocValuesWriter_metadata(DocValuesWriter *self) {
+    Hash *const metadata = DataWriter_metadata((DataWriter*)self);
+    Hash_Store_Str(metadata, "fields", 6, INCREF(self->stats));
+    return metadata;
+}
+
+int32_t
+DocValuesWriter_format(DocValuesWriter *self) {
+    UNUSED_VAR(self);
+    return DocValuesWriter_current_file_format;
+}
+
+
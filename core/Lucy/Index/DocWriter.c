@@ -15,6 +15,7 @@
  */
 
 #define C_LUCY_DOCWRITER
+#define C_LUCY_DEFAULTDOCREADER
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/DocWriter.h"
@@ -25,15 +26,44 @@
 #include "Lucy/Index/Segment.h"
 #include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/Snapshot.h"
+#include "Lucy/Plan/Architecture.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
 #include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RAMFile.h"
+#include "Lucy/Util/BlockCodec.h"
 
 static OutStream*
 S_lazy_init(DocWriter *self);
 
-int32_t DocWriter_current_file_format = 2;
+// Return the stream that the next record should be serialized into.
+static OutStream*
+S_record_out(DocWriter *self);
+
+// Account for a record which began at <code>start</code> in the stream
+// returned by S_record_out().
+static void
+S_finish_record(DocWriter *self, int64_t start);
+
+// Compress the buffered records and write them out as one block.
+static void
+S_flush_block(DocWriter *self);
+
+// Copy the records for the run of live docs from <code>first</code> up to
+// but not including <code>limit</code>.
+static void
+S_copy_run(DocWriter *self, DefaultDocReader *reader, int32_t first,
+           int32_t limit, ByteBuf *buffer);
+
+// Copy a single record, re-encoding it if necessary.
+static void
+S_copy_record(DocWriter *self, DefaultDocReader *reader, int32_t doc_id,
+              ByteBuf *buffer);
+
+int32_t DocWriter_current_file_format    = 2;
+int32_t DocWriter_compressed_file_format = 3;
 
 DocWriter*
 DocWriter_new(Schema *schema, Snapshot *snapshot, Segment *segment,
@@ -46,6 +76,13 @@ DocWriter*
 DocWriter_init(DocWriter *self, Schema *schema, Snapshot *snapshot,
                Segment *segment, PolyReader *polyreader) {
     DataWriter_init((DataWriter*)self, schema, snapshot, segment, polyreader);
+    Architecture *arch = Schema_Get_Architecture(schema);
+    self->block_size = Arch_Doc_Block_Size(arch);
+    if (self->block_size < 0) {
+        int32_t block_size = self->block_size;
+        DECREF(self);
+        THROW(ERR, "Invalid Doc_Block_Size: %i32", block_size);
+    }
     return self;
 }
 
@@ -53,6 +90,10 @@ void
 DocWriter_destroy(DocWriter *self) {
     DECREF(self->dat_out);
     DECREF(self->ix_out);
+    DECREF(self->block_out);
+    DECREF(self->block_file);
+    DECREF(self->block_buf);
+    DECREF(self->compressed);
     SUPER_DESTROY(self, DOCWRITER);
 }
 
@@ -72,25 +113,97 @@ S_lazy_init(DocWriter *self) {
         DECREF(dat_file);
         if (!self->dat_out) { RETHROW(INCREF(Err_get_error())); }
 
-        // Go past non-doc #0.
-        OutStream_Write_I64(self->ix_out, 0);
+        if (self->block_size) {
+            self->block_buf  = BB_new(self->block_size);
+            self->compressed = BB_new(0);
+        }
+        else {
+            // Go past non-doc #0.
+            OutStream_Write_I64(self->ix_out, 0);
+        }
     }
 
     return self->dat_out;
 }
 
+static OutStream*
+S_record_out(DocWriter *self) {
+    OutStream *dat_out = S_lazy_init(self);
+    if (!self->block_size) { return dat_out; }
+    if (!self->block_out) {
+        self->block_file = RAMFile_new(NULL, false);
+        self->block_out  = OutStream_open((Obj*)self->block_file);
+        if (!self->block_out) { RETHROW(INCREF(Err_get_error())); }
+    }
+    return self->block_out;
+}
+
+static void
+S_finish_record(DocWriter *self, int64_t start) {
+    self->doc_count++;
+    if (self->block_size) {
+        // Note the record's length in the block header.
+        int64_t  end  = OutStream_Tell(self->block_out);
+        size_t   size = BB_Get_Size(self->block_buf);
+        char    *buf  = BB_Grow(self->block_buf, size + C32_MAX_BYTES);
+        char    *dest = buf + size;
+        NumUtil_encode_c32((uint32_t)(end - start), &dest);
+        BB_Set_Size(self->block_buf, (size_t)(dest - buf));
+        self->block_docs++;
+        if (end >= self->block_size) { S_flush_block(self); }
+    }
+    else {
+        // Write file pointer.
+        OutStream_Write_I64(self->ix_out, start);
+    }
+}
+
+static void
+S_flush_block(DocWriter *self) {
+    if (!self->block_docs) { return; }
+    OutStream *dat_out = self->dat_out;
+    OutStream *ix_out  = self->ix_out;
+
+    // Append the records to the header of record lengths.
+    OutStream_Close(self->block_out);
+    ByteBuf *records = RAMFile_Get_Contents(self->block_file);
+    BB_Cat(self->block_buf, records);
+    DECREF(self->block_out);
+    DECREF(self->block_file);
+    self->block_out  = NULL;
+    self->block_file = NULL;
+
+    // Compress and write the block, prefixed by its uncompressed size.
+    char   *raw     = BB_Get_Buf(self->block_buf);
+    size_t  raw_len = BB_Get_Size(self->block_buf);
+    char   *dest    = BB_Grow(self->compressed,
+                              BlockCodec_max_compressed_size(raw_len));
+    size_t  comp_len = BlockCodec_compress(raw, raw_len, dest);
+    int64_t start    = OutStream_Tell(dat_out);
+    OutStream_Write_C32(dat_out, (uint32_t)raw_len);
+    OutStream_Write_Bytes(dat_out, dest, comp_len);
+
+    // The index records only the number of docs in each block and the
+    // block's length, from which the reader derives doc ids and file
+    // pointers.
+    OutStream_Write_C32(ix_out, self->block_docs);
+    OutStream_Write_C64(ix_out, (uint64_t)(OutStream_Tell(dat_out) - start));
+
+    BB_Set_Size(self->block_buf, 0);
+    self->block_docs = 0;
+}
+
 void
 DocWriter_add_inverted_doc(DocWriter *self, Inverter *inverter,
                            int32_t doc_id) {
-    OutStream *dat_out    = S_lazy_init(self);
-    OutStream *ix_out     = self->ix_out;
+    OutStream *out        = S_record_out(self);
     uint32_t   num_stored = 0;
-    int64_t    start      = OutStream_Tell(dat_out);
-    int64_t    expected   = OutStream_Tell(ix_out) / 8;
+    int64_t    start      = OutStream_Tell(out);
+    int32_t    expected   = self->doc_count + 1;
 
     // Verify doc id.
     if (doc_id != expected) {
-        THROW(ERR, "Expected doc id %i64 but got %i32", expected, doc_id);
+        THROW(ERR, "Expected doc id %i32 but got %i32", expected, doc_id);
     }
 
     // Write the number of stored fields.
@@ -99,7 +212,7 @@ DocWriter_add_inverted_doc(DocWriter *self, Inverter *inverter,
         FieldType *type = Inverter_Get_Type(inverter);
         if (FType_Stored(type)) { num_stored++; }
     }
-    OutStream_Write_C32(dat_out, num_stored);
+    OutStream_Write_C32(out, num_stored);
 
     Inverter_Iterate(inverter);
     while (Inverter_Next(inverter)) {
@@ -108,13 +221,12 @@ DocWriter_add_inverted_doc(DocWriter *self, Inverter *inverter,
         if (FType_Stored(type)) {
             CharBuf *field = Inverter_Get_Field_Name(inverter);
             Obj *value = Inverter_Get_Value(inverter);
-            CB_Serialize(field, dat_out);
-            Obj_Serialize(value, dat_out);
+            CB_Serialize(field, out);
+            Obj_Serialize(value, out);
         }
     }
 
-    // Write file pointer.
-    OutStream_Write_I64(ix_out, start);
+    S_finish_record(self, start);
 }
 
 void
@@ -127,40 +239,121 @@ DocWriter_add_segment(DocWriter *self, SegReader *reader,
         return;
     }
     else {
-        OutStream *const dat_out = S_lazy_init(self);
-        OutStream *const ix_out  = self->ix_out;
         ByteBuf   *const buffer  = BB_new(0);
         DefaultDocReader *const doc_reader
             = (DefaultDocReader*)CERTIFY(
                   SegReader_Obtain(reader, VTable_Get_Name(DOCREADER)),
                   DEFAULTDOCREADER);
 
-        for (int32_t i = 1, max = SegReader_Doc_Max(reader); i <= max; i++) {
-            if (I32Arr_Get(doc_map, i)) {
-                int64_t  start = OutStream_Tell(dat_out);
+        // Deleted docs break the segment into runs of live docs, each of
+        // which is copied as a unit.
+        int32_t i = 1;
+        while (i <= doc_max) {
+            if (!I32Arr_Get(doc_map, i)) {
+                i++;
+                continue;
+            }
+            int32_t limit = i + 1;
+            while (limit <= doc_max && I32Arr_Get(doc_map, limit)) {
+                limit++;
+            }
+            S_copy_run(self, doc_reader, i, limit, buffer);
+            i = limit;
+        }
 
-                // Copy record over.
-                DefDocReader_Read_Record(doc_reader, buffer, i);
-                char *buf   = BB_Get_Buf(buffer);
-                size_t size = BB_Get_Size(buffer);
-                OutStream_Write_Bytes(dat_out, buf, size);
+        DECREF(buffer);
+    }
+}
+
+static void
+S_copy_run(DocWriter *self, DefaultDocReader *reader, int32_t first,
+           int32_t limit, ByteBuf *buffer) {
+    OutStream *dat_out = S_lazy_init(self);
+    OutStream *ix_out  = self->ix_out;
+    int32_t    doc_id  = first;
+
+    if (!self->block_size && !reader->block_docs) {
+        // Both sides are uncompressed: copy the run's data in one go, and
+        // rebase its file pointers by the difference in position.
+        InStream *ix_in = reader->ix_in;
+        InStream_Seek(ix_in, (int64_t)first * 8);
+        const int64_t in_start  = InStream_Read_I64(ix_in);
+        const int64_t out_start = OutStream_Tell(dat_out);
+        int64_t       pointer   = in_start;
+        for (; doc_id < limit; doc_id++) {
+            OutStream_Write_I64(ix_out, pointer - in_start + out_start);
+            pointer = InStream_Read_I64(ix_in);
+        }
+        OutStream_Absorb_Range(dat_out, reader->dat_in, in_start,
+                               pointer - in_start);
+        self->doc_count += limit - first;
+        return;
+    }
 
-                // Write file pointer.
-                OutStream_Write_I64(ix_out, start);
+    if (self->block_size && reader->block_docs) {
+        // Both sides are compressed: blocks which lie wholly within the run
+        // are copied without being decompressed.  Blocks need not be the
+        // same size throughout a segment, so this is safe even if the two
+        // Architectures disagree on Doc_Block_Size().
+        const int32_t *block_docs   = reader->block_docs;
+        const int64_t *block_starts = reader->block_starts;
+        int32_t lo = 0;
+        int32_t hi = reader->num_blocks - 1;
+        while (lo < hi) {
+            int32_t mid = lo + (hi - lo + 1) / 2;
+            if (block_docs[mid] <= first) { lo = mid; }
+            else                          { hi = mid - 1; }
+        }
+        for (int32_t tick = lo; doc_id < limit; tick++) {
+            const int32_t block_end = block_docs[tick + 1];
+            if (doc_id == block_docs[tick] && block_end <= limit) {
+                const int64_t start = block_starts[tick];
+                const int64_t len   = block_starts[tick + 1] - start;
+                S_flush_block(self);
+                OutStream_Absorb_Range(dat_out, reader->dat_in, start, len);
+                OutStream_Write_C32(ix_out, (uint32_t)(block_end - doc_id));
+                OutStream_Write_C64(ix_out, (uint64_t)len);
+                self->doc_count += block_end - doc_id;
+                doc_id = block_end;
+            }
+            else {
+                const int32_t end = block_end < limit ? block_end : limit;
+                for (; doc_id < end; doc_id++) {
+                    S_copy_record(self, reader, doc_id, buffer);
+                }
             }
         }
+        return;
+    }
 
-        DECREF(buffer);
+    // The formats differ, so each record must be copied individually.
+    for (; doc_id < limit; doc_id++) {
+        S_copy_record(self, reader, doc_id, buffer);
     }
 }
 
+static void
+S_copy_record(DocWriter *self, DefaultDocReader *reader, int32_t doc_id,
+              ByteBuf *buffer) {
+    OutStream *out   = S_record_out(self);
+    int64_t    start = OutStream_Tell(out);
+    DefDocReader_Read_Record(reader, buffer, doc_id);
+    OutStream_Write_Bytes(out, BB_Get_Buf(buffer), BB_Get_Size(buffer));
+    S_finish_record(self, start);
+}
+
 void
 DocWriter_finish(DocWriter *self) {
     if (self->dat_out) {
-        // Write one final file pointer, so that we can derive the length of
-        // the last record.
-        int64_t end = OutStream_Tell(self->dat_out);
-        OutStream_Write_I64(self->ix_out, end);
+        if (self->block_size) {
+            S_flush_block(self);
+        }
+        else {
+            // Write one final file pointer, so that we can derive the length
+            // of the last record.
+            int64_t end = OutStream_Tell(self->dat_out);
+            OutStream_Write_I64(self->ix_out, end);
+        }
 
         // Close down output streams.
         OutStream_Close(self->dat_out);
@@ -172,8 +365,9 @@ DocWriter_finish(DocWriter *self) {
 
 int32_t
 DocWriter_format(DocWriter *self) {
-    UNUSED_VAR(self);
-    return DocWriter_current_file_format;
+    return self->block_size
+           ? DocWriter_compressed_file_format
+           : DocWriter_current_file_format;
 }
 
 
@@ -46,6 +46,11 @@ HLReader_aggregator(HighlightReader *self, VArray *readers,
     return (HighlightReader*)PolyHLReader_new(readers, offsets);
 }
 
+void
+HLReader_warm(HighlightReader *self) {
+    UNUSED_VAR(self);
+}
+
 PolyHighlightReader*
 PolyHLReader_new(VArray *readers, I32Array *offsets) {
     PolyHighlightReader *self
@@ -97,6 +102,16 @@ PolyHLReader_fetch_doc_vec(PolyHighlightReader *self, int32_t doc_id) {
     return HLReader_Fetch_Doc_Vec(sub_reader, doc_id - offset);
 }
 
+void
+PolyHLReader_warm(PolyHighlightReader *self) {
+    if (!self->readers) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+        HighlightReader *reader
+            = (HighlightReader*)VA_Fetch(self->readers, i);
+        if (reader) { HLReader_Warm(reader); }
+    }
+}
+
 DefaultHighlightReader*
 DefHLReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                 VArray *segments, int32_t seg_tick) {
@@ -221,4 +236,14 @@ DefHLReader_read_record(DefaultHighlightReader *self, int32_t doc_id,
     BB_Set_Size(target, size);
 }
 
+void
+DefHLReader_warm(DefaultHighlightReader *self) {
+    if (self->ix_in) {
+        InStream_Prefetch(self->ix_in, 0, InStream_Length(self->ix_in));
+    }
+    if (self->dat_in) {
+        InStream_Prefetch(self->dat_in, 0, InStream_Length(self->dat_in));
+    }
+}
+
 
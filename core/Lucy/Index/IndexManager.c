@@ -19,6 +19,7 @@
 
 #include "Lucy/Index/IndexManager.h"
 #include "Lucy/Index/DeletionsWriter.h"
+#include "Lucy/Index/MergePolicy.h"
 #include "Lucy/Index/PolyReader.h"
 #include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/Segment.h"
@@ -45,12 +46,15 @@ IxManager_init(IndexManager *self, const CharBuf *host,
                                 : CB_new_from_trusted_utf8("", 0);
     self->lock_factory        = (LockFactory*)INCREF(lock_factory);
     self->folder              = NULL;
+    self->merge_policy        = NULL;
     self->write_lock_timeout  = 1000;
     self->write_lock_interval = 100;
     self->merge_lock_timeout  = 0;
     self->merge_lock_interval = 1000;
     self->deletion_lock_timeout  = 1000;
     self->deletion_lock_interval = 100;
+    self->del_ratio              = 0.1;
+    self->durable                = false;
 
     return self;
 }
@@ -60,6 +64,7 @@ IxManager_destroy(IndexManager *self) {
     DECREF(self->host);
     DECREF(self->folder);
     DECREF(self->lock_factory);
+    DECREF(self->merge_policy);
     SUPER_DESTROY(self, INDEXMANAGER);
 }
 
@@ -137,6 +142,11 @@ VArray*
 IxManager_recycle(IndexManager *self, PolyReader *reader,
                   DeletionsWriter *del_writer, int64_t cutoff,
                   bool_t optimize) {
+    if (self->merge_policy) {
+        return MergePolicy_Recycle(self->merge_policy, reader, del_writer,
+                                   cutoff, optimize);
+    }
+
     VArray *seg_readers = PolyReader_Get_Seg_Readers(reader);
     VArray *candidates  = VA_Gather(seg_readers, S_check_cutoff, &cutoff);
     VArray *recyclables = VA_new(VA_Get_Size(candidates));
@@ -164,14 +174,14 @@ IxManager_recycle(IndexManager *self, PolyReader *reader,
         VA_Store(recyclables, i, VA_Delete(candidates, i));
     }
 
-    // Find segments where at least 10% of all docs have been deleted.
+    // Find segments where enough docs have been deleted to reclaim them.
     for (uint32_t i = threshold; i < num_candidates; i++) {
         SegReader *seg_reader = (SegReader*)VA_Delete(candidates, i);
         CharBuf   *seg_name   = SegReader_Get_Seg_Name(seg_reader);
         double doc_max = SegReader_Doc_Max(seg_reader);
         double num_deletions = DelWriter_Seg_Del_Count(del_writer, seg_name);
         double del_proportion = num_deletions / doc_max;
-        if (del_proportion >= 0.1) {
+        if (del_proportion >= self->del_ratio) {
             VA_Push(recyclables, (Obj*)seg_reader);
         }
         else {
@@ -324,6 +334,30 @@ IxManager_get_host(IndexManager *self) {
     return self->host;
 }
 
+void
+IxManager_set_merge_policy(IndexManager *self, MergePolicy *merge_policy) {
+    DECREF(self->merge_policy);
+    self->merge_policy = (MergePolicy*)INCREF(merge_policy);
+}
+
+MergePolicy*
+IxManager_get_merge_policy(IndexManager *self) {
+    return self->merge_policy;
+}
+
+void
+IxManager_set_del_ratio(IndexManager *self, double del_ratio) {
+    if (del_ratio <= 0.0 || del_ratio > 1.0) {
+        THROW(ERR, "Invalid value for del_ratio: %f64", del_ratio);
+    }
+    self->del_ratio = del_ratio;
+}
+
+double
+IxManager_get_del_ratio(IndexManager *self) {
+    return self->del_ratio;
+}
+
 uint32_t
 IxManager_get_write_lock_timeout(IndexManager *self) {
     return self->write_lock_timeout;
@@ -384,4 +418,35 @@ IxManager_set_deletion_lock_interval(IndexManager *self, uint32_t interval) {
     self->deletion_lock_interval = interval;
 }
 
+void
+IxManager_set_durable(IndexManager *self, bool_t durable) {
+    self->durable = durable;
+}
+
+bool_t
+IxManager_get_durable(IndexManager *self) {
+    return self->durable;
+}
+
+void
+IxManager_sync_files(IndexManager *self, VArray *paths) {
+    if (!self->durable) { return; }
+    Folder *folder = self->folder;
+    if (!folder) { THROW(ERR, "Can't sync files: no Folder"); }
+
+    VArray *existing = VA_new(VA_Get_Size(paths));
+    for (uint32_t i = 0, max = VA_Get_Size(paths); i < max; i++) {
+        CharBuf *path = (CharBuf*)VA_Fetch(paths, i);
+        if (Folder_Exists(folder, path)) {
+            VA_Push(existing, INCREF(path));
+        }
+    }
+    /* Each commit syncs its own files.  The write lock admits one committer
+     * per index at a time, so there are never concurrent commits whose
+     * syncs could be coalesced into a shared batch. */
+    bool_t success = Folder_Sync(folder, existing);
+    DECREF(existing);
+    if (!success) { RETHROW(INCREF(Err_get_error())); }
+}
+
 
@@ -44,6 +44,16 @@
 int32_t Indexer_CREATE   = 0x00000001;
 int32_t Indexer_TRUNCATE = 0x00000002;
 
+// Finish the segment in progress without publishing it, open a SegReader
+// for it, and start a new segment for subsequent documents.
+static void
+S_flush_segment(Indexer *self, bool_t flush_deletions);
+
+// Return the number of deletions in existing segments, including those not
+// yet written.
+static int64_t
+S_pending_del_count(Indexer *self);
+
 // Release the write lock - if it's there.
 static void
 S_release_write_lock(Indexer *self);
@@ -83,6 +93,10 @@ Indexer_init(Indexer *self, Schema *schema, Obj *index,
     self->needs_commit  = false;
     self->snapfile      = NULL;
     self->merge_lock    = NULL;
+    self->nrt_base      = NULL;
+    self->nrt_flushed   = NULL;
+    self->nrt_del_count = 0;
+    self->nrt_shared    = false;
 
     // Assign.
     self->folder       = folder;
@@ -235,6 +249,8 @@ Indexer_destroy(Indexer *self) {
     DECREF(self->file_purger);
     DECREF(self->write_lock);
     DECREF(self->snapfile);
+    DECREF(self->nrt_base);
+    DECREF(self->nrt_flushed);
     SUPER_DESTROY(self, INDEXER);
 }
 
@@ -477,9 +493,31 @@ Indexer_prepare_commit(Indexer *self) {
         THROW(ERR, "Can't call Prepare_Commit() more than once");
     }
 
+    // Fold in segments flushed for near-real-time readers.
+    if (self->nrt_flushed) {
+        VArray *flushed = self->nrt_flushed;
+        for (uint32_t i = 0, max = VA_Get_Size(flushed); i < max; i++) {
+            SegReader *seg_reader = (SegReader*)VA_Fetch(flushed, i);
+            if (!SegReader_Doc_Max(seg_reader)) {
+                // Flushed only to publish deletions, which the current
+                // DeletionsWriter has inherited.
+                Snapshot_Delete_Entry(self->snapshot,
+                                      SegReader_Get_Seg_Name(seg_reader));
+                continue;
+            }
+            I32Array *doc_map = DelWriter_Generate_Doc_Map(
+                                    self->del_writer, NULL,
+                                    SegReader_Doc_Max(seg_reader),
+                                    (int32_t)Seg_Get_Count(self->segment));
+            SegWriter_Merge_Segment(self->seg_writer, seg_reader, doc_map);
+            merge_happened = true;
+            DECREF(doc_map);
+        }
+    }
+
     // Merge existing index data.
-    if (num_seg_readers) {
-        merge_happened = S_maybe_merge(self, seg_readers);
+    if (num_seg_readers && S_maybe_merge(self, seg_readers)) {
+        merge_happened = true;
     }
 
     // Add a new segment and write a new snapshot file if...
@@ -509,17 +547,29 @@ Indexer_prepare_commit(Indexer *self) {
             Snapshot_Delete_Entry(snapshot, old_schema_name);
         }
         Snapshot_Add_Entry(snapshot, new_schema_name);
-        DECREF(new_schema_name);
 
         // Write temporary snapshot file.
         Folder_Delete(folder, self->snapfile);
         Snapshot_Write_File(snapshot, folder, self->snapfile);
 
+        // Everything the snapshot refers to must reach stable storage before
+        // the snapshot is published.
+        VArray *to_sync = VA_new(3);
+        VA_Push(to_sync, INCREF(Seg_Get_Name(self->segment)));
+        VA_Push(to_sync, INCREF(new_schema_name));
+        VA_Push(to_sync, INCREF(self->snapfile));
+        IxManager_Sync_Files(self->manager, to_sync);
+        DECREF(to_sync);
+        DECREF(new_schema_name);
+
         self->needs_commit = true;
     }
 
-    // Close reader, so that we can delete its files if appropriate.
-    PolyReader_Close(self->polyreader);
+    // Close reader, so that we can delete its files if appropriate -- unless
+    // near-real-time readers are sharing its SegReaders.
+    if (!self->nrt_shared) {
+        PolyReader_Close(self->polyreader);
+    }
 
     self->prepared = true;
 }
@@ -546,6 +596,11 @@ Indexer_commit(Indexer *self) {
         DECREF(temp_snapfile);
         if (!success) { RETHROW(INCREF(Err_get_error())); }
 
+        // Sync the index directory so that the rename itself is durable.
+        VArray *no_files = VA_new(0);
+        IxManager_Sync_Files(self->manager, no_files);
+        DECREF(no_files);
+
         // Purge obsolete files.
         FilePurger_Purge(self->file_purger);
     }
@@ -555,6 +610,132 @@ Indexer_commit(Indexer *self) {
     S_release_write_lock(self);
 }
 
+PolyReader*
+Indexer_open_reader(Indexer *self) {
+    if (!self->write_lock || self->prepared) {
+        THROW(ERR, "Can't call Open_Reader() after Prepare_Commit()");
+    }
+    if (!self->nrt_base) {
+        self->nrt_base      = PolyReader_Seg_Readers(self->polyreader);
+        self->nrt_flushed   = VA_new(0);
+        self->nrt_del_count = PolyReader_Del_Count(self->polyreader);
+    }
+
+    // Flush if anything has changed since the last reader was opened.
+    int64_t del_count = S_pending_del_count(self);
+    if (Seg_Get_Count(self->segment) || del_count != self->nrt_del_count) {
+        S_flush_segment(self, del_count != self->nrt_del_count);
+        self->nrt_del_count = del_count;
+    }
+
+    VArray *sub_readers = VA_Shallow_Copy(self->nrt_base);
+    VA_Push_VArray(sub_readers, self->nrt_flushed);
+    PolyReader *reader = PolyReader_new(self->schema, self->folder, NULL,
+                                        NULL, sub_readers);
+    DECREF(sub_readers);
+    self->nrt_shared = true;
+    return reader;
+}
+
+static void
+S_flush_segment(Indexer *self, bool_t flush_deletions) {
+    Schema          *schema      = self->schema;
+    Folder          *folder      = self->folder;
+    Segment         *segment     = self->segment;
+    DeletionsWriter *del_writer  = self->del_writer;
+    PolyReader      *polyreader  = self->polyreader;
+    VArray          *seg_readers = PolyReader_Get_Seg_Readers(polyreader);
+    uint32_t         num_base    = VA_Get_Size(self->nrt_base);
+    uint32_t         num_flushed = VA_Get_Size(self->nrt_flushed);
+
+    // Finish the segment as Prepare_Commit() would, but skip syncing it and
+    // writing a snapshot file.
+    if (flush_deletions) {
+        DelWriter_Finish(del_writer);
+    }
+    SegWriter_Finish(self->seg_writer);
+
+    // Open a SegReader for the flushed segment.  SegReaders for existing
+    // segments whose deletions were just written must be reopened to see
+    // them; the rest are shared.
+    VArray *segments = VA_new(num_base + num_flushed + 1);
+    for (uint32_t i = 0; i < num_base; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(self->nrt_base, i);
+        VA_Push(segments, INCREF(SegReader_Get_Segment(seg_reader)));
+    }
+    for (uint32_t i = 0; i < num_flushed; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(self->nrt_flushed, i);
+        VA_Push(segments, INCREF(SegReader_Get_Segment(seg_reader)));
+    }
+    VA_Push(segments, INCREF(segment));
+    if (flush_deletions) {
+        for (uint32_t i = 0; i < num_base; i++) {
+            SegReader *seg_reader = (SegReader*)VA_Fetch(self->nrt_base, i);
+            CharBuf   *seg_name   = SegReader_Get_Seg_Name(seg_reader);
+            if (DelWriter_Seg_Del_Count(del_writer, seg_name)
+                != SegReader_Del_Count(seg_reader)
+               ) {
+                SegReader *fresh
+                    = SegReader_new(schema, folder, NULL, segments, i);
+                VA_Store(self->nrt_base, i, (Obj*)fresh);
+            }
+        }
+    }
+    VA_Push(self->nrt_flushed,
+            (Obj*)SegReader_new(schema, folder, NULL, segments,
+                                num_base + num_flushed));
+    DECREF(segments);
+
+    // Start a new segment for subsequent documents.
+    Segment *new_segment = Seg_new(Seg_Get_Number(segment) + 1);
+    VArray *fields = Schema_All_Fields(schema);
+    for (uint32_t i = 0, max = VA_Get_Size(fields); i < max; i++) {
+        Seg_Add_Field(new_segment, (CharBuf*)VA_Fetch(fields, i));
+    }
+    DECREF(fields);
+    SegWriter *new_seg_writer = SegWriter_new(schema, self->snapshot,
+                                              new_segment, polyreader);
+    SegWriter_Prep_Seg_Dir(new_seg_writer);
+
+    // Carry pending deletions over to the new segment's DeletionsWriter, so
+    // that Commit() writes them all out again.
+    DeletionsWriter *new_del_writer
+        = SegWriter_Get_Del_Writer(new_seg_writer);
+    I32Array *offsets = PolyReader_Offsets(polyreader);
+    for (uint32_t i = 0, max = VA_Get_Size(seg_readers); i < max; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
+        Matcher *deletions = DelWriter_Seg_Deletions(del_writer, seg_reader);
+        if (deletions) {
+            int32_t offset = I32Arr_Get(offsets, i);
+            int32_t doc_id;
+            while (0 != (doc_id = Matcher_Next(deletions))) {
+                DelWriter_Delete_By_Doc_ID(new_del_writer, offset + doc_id);
+            }
+            DECREF(deletions);
+        }
+    }
+    DECREF(offsets);
+
+    DECREF(self->segment);
+    DECREF(self->seg_writer);
+    DECREF(self->del_writer);
+    self->segment    = new_segment;
+    self->seg_writer = new_seg_writer;
+    self->del_writer = (DeletionsWriter*)INCREF(new_del_writer);
+}
+
+static int64_t
+S_pending_del_count(Indexer *self) {
+    VArray  *seg_readers = PolyReader_Get_Seg_Readers(self->polyreader);
+    int64_t  del_count   = 0;
+    for (uint32_t i = 0, max = VA_Get_Size(seg_readers); i < max; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
+        CharBuf   *seg_name   = SegReader_Get_Seg_Name(seg_reader);
+        del_count += DelWriter_Seg_Del_Count(self->del_writer, seg_name);
+    }
+    return del_count;
+}
+
 Schema*
 Indexer_get_schema(Indexer *self) {
     return self->schema;
@@ -117,6 +117,12 @@ LexIndex_get_term_info(LexIndex *self) {
     return self->tinfo;
 }
 
+void
+LexIndex_warm(LexIndex *self) {
+    InStream_Prefetch(self->ixix_in, 0, InStream_Length(self->ixix_in));
+    InStream_Prefetch(self->ix_in, 0, InStream_Length(self->ix_in));
+}
+
 static void
 S_read_entry(LexIndex *self) {
     InStream *ix_in  = self->ix_in;
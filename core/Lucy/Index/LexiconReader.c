@@ -17,9 +17,12 @@
 #define C_LUCY_LEXICONREADER
 #define C_LUCY_POLYLEXICONREADER
 #define C_LUCY_DEFAULTLEXICONREADER
+#define C_LUCY_SEGLEXICON
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/LexiconReader.h"
+#include "Lucy/Index/BloomFilter.h"
+#include "Lucy/Index/LexIndex.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Index/PolyLexicon.h"
@@ -28,6 +31,7 @@
 #include "Lucy/Index/Snapshot.h"
 #include "Lucy/Index/TermInfo.h"
 #include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
 
 LexiconReader*
 LexReader_init(LexiconReader *self, Schema *schema, Folder *folder,
@@ -38,6 +42,19 @@ LexReader_init(LexiconReader *self, Schema *schema, Folder *folder,
     return self;
 }
 
+bool_t
+LexReader_may_contain(LexiconReader *self, const CharBuf *field, Obj *term) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(field);
+    UNUSED_VAR(term);
+    return true;
+}
+
+void
+LexReader_warm(LexiconReader *self) {
+    UNUSED_VAR(self);
+}
+
 LexiconReader*
 LexReader_aggregator(LexiconReader *self, VArray *readers, I32Array *offsets) {
     UNUSED_VAR(self);
@@ -119,6 +136,27 @@ PolyLexReader_doc_freq(PolyLexiconReader *self, const CharBuf *field,
     return doc_freq;
 }
 
+bool_t
+PolyLexReader_may_contain(PolyLexiconReader *self, const CharBuf *field,
+                          Obj *term) {
+    for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+        LexiconReader *reader = (LexiconReader*)VA_Fetch(self->readers, i);
+        if (reader && LexReader_May_Contain(reader, field, term)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+PolyLexReader_warm(PolyLexiconReader *self) {
+    if (!self->readers) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+        LexiconReader *reader = (LexiconReader*)VA_Fetch(self->readers, i);
+        if (reader) { LexReader_Warm(reader); }
+    }
+}
+
 DefaultLexiconReader*
 DefLexReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                  VArray *segments, int32_t seg_tick) {
@@ -150,6 +188,27 @@ S_has_data(Schema *schema, Folder *folder, Segment *segment, CharBuf *field) {
     }
 }
 
+// Load the bloom filter for a field, if LexiconWriter wrote one.
+static BloomFilter*
+S_load_bloom_filter(Folder *folder, Segment *segment, int32_t field_num) {
+    CharBuf *seg_name = Seg_Get_Name(segment);
+    CharBuf *file = CB_newf("%o/lexicon-%i32.bloom", seg_name, field_num);
+    BloomFilter *filter = NULL;
+    if (Folder_Exists(folder, file)) {
+        InStream *instream = Folder_Open_In(folder, file);
+        if (!instream) {
+            DECREF(file);
+            RETHROW(INCREF(Err_get_error()));
+        }
+        filter = BloomFilter_Deserialize(
+                     (BloomFilter*)VTable_Make_Obj(BLOOMFILTER), instream);
+        InStream_Close(instream);
+        DECREF(instream);
+    }
+    DECREF(file);
+    return filter;
+}
+
 DefaultLexiconReader*
 DefLexReader_init(DefaultLexiconReader *self, Schema *schema, Folder *folder,
                   Snapshot *snapshot, VArray *segments, int32_t seg_tick) {
@@ -159,13 +218,20 @@ DefLexReader_init(DefaultLexiconReader *self, Schema *schema, Folder *folder,
                    seg_tick);
     Segment *segment = DefLexReader_Get_Segment(self);
 
-    // Build an array of SegLexicon objects.
+    // Build an array of SegLexicon objects, plus any bloom filters.
     self->lexicons = VA_new(Schema_Num_Fields(schema));
+    self->blooms   = VA_new(0);
     for (uint32_t i = 1, max = Schema_Num_Fields(schema) + 1; i < max; i++) {
         CharBuf *field = Seg_Field_Name(segment, i);
         if (field && S_has_data(schema, folder, segment, field)) {
             SegLexicon *lexicon = SegLex_new(schema, folder, segment, field);
             VA_Store(self->lexicons, i, (Obj*)lexicon);
+            FieldType *type = Schema_Fetch_Type(schema, field);
+            if (FType_Bloom_Filter(type)) {
+                BloomFilter *filter
+                    = S_load_bloom_filter(folder, segment, (int32_t)i);
+                if (filter) { VA_Store(self->blooms, i, (Obj*)filter); }
+            }
         }
     }
 
@@ -175,12 +241,15 @@ DefLexReader_init(DefaultLexiconReader *self, Schema *schema, Folder *folder,
 void
 DefLexReader_close(DefaultLexiconReader *self) {
     DECREF(self->lexicons);
+    DECREF(self->blooms);
     self->lexicons = NULL;
+    self->blooms   = NULL;
 }
 
 void
 DefLexReader_destroy(DefaultLexiconReader *self) {
     DECREF(self->lexicons);
+    DECREF(self->blooms);
     SUPER_DESTROY(self, DEFAULTLEXICONREADER);
 }
 
@@ -206,6 +275,13 @@ S_find_tinfo(DefaultLexiconReader *self, const CharBuf *field, Obj *target) {
         int32_t field_num = Seg_Field_Num(self->segment, field);
         SegLexicon *lexicon
             = (SegLexicon*)VA_Fetch(self->lexicons, field_num);
+        BloomFilter *filter
+            = (BloomFilter*)VA_Fetch(self->blooms, field_num);
+
+        // Skip the lexicon seek if the term definitely isn't here.
+        if (filter && !BloomFilter_May_Contain(filter, target)) {
+            return NULL;
+        }
 
         if (lexicon) {
             // Iterate until the result is ge the term.
@@ -235,4 +311,26 @@ DefLexReader_doc_freq(DefaultLexiconReader *self, const CharBuf *field,
     return tinfo ? TInfo_Get_Doc_Freq(tinfo) : 0;
 }
 
+bool_t
+DefLexReader_may_contain(DefaultLexiconReader *self, const CharBuf *field,
+                         Obj *term) {
+    if (field == NULL || term == NULL) { return true; }
+    int32_t field_num = Seg_Field_Num(self->segment, field);
+    if (!VA_Fetch(self->lexicons, field_num)) {
+        // No terms at all for this field in this segment.
+        return false;
+    }
+    BloomFilter *filter = (BloomFilter*)VA_Fetch(self->blooms, field_num);
+    return filter ? BloomFilter_May_Contain(filter, term) : true;
+}
+
+void
+DefLexReader_warm(DefaultLexiconReader *self) {
+    if (!self->lexicons) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(self->lexicons); i < max; i++) {
+        SegLexicon *lexicon = (SegLexicon*)VA_Fetch(self->lexicons, i);
+        if (lexicon) { LexIndex_Warm(lexicon->lex_index); }
+    }
+}
+
 
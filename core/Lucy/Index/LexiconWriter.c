@@ -18,6 +18,7 @@
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/LexiconWriter.h"
+#include "Lucy/Index/BloomFilter.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Index/PolyReader.h"
@@ -62,6 +63,7 @@ LexWriter_init(LexiconWriter *self, Schema *schema, Snapshot *snapshot,
     self->ixix_file          = CB_new(30);
     self->counts             = Hash_new(0);
     self->ix_counts          = Hash_new(0);
+    self->bloom_hashes       = NULL;
     self->temp_mode          = false;
     self->term_stepper       = NULL;
     self->tinfo_stepper      = (TermStepper*)MatchTInfoStepper_new(schema);
@@ -81,6 +83,7 @@ LexWriter_destroy(LexiconWriter *self) {
     DECREF(self->ixix_out);
     DECREF(self->counts);
     DECREF(self->ix_counts);
+    DECREF(self->bloom_hashes);
     SUPER_DESTROY(self, LEXICONWRITER);
 }
 
@@ -113,6 +116,13 @@ LexWriter_add_term(LexiconWriter* self, CharBuf* term_text, TermInfo* tinfo) {
     TermStepper_Write_Delta(self->term_stepper, dat_out, (Obj*)term_text);
     TermStepper_Write_Delta(self->tinfo_stepper, dat_out, (Obj*)tinfo);
 
+    // Remember the term's hash for the bloom filter.  The filter can't be
+    // sized until the field's term count is known.
+    if (self->bloom_hashes && !self->temp_mode) {
+        uint64_t hash = BloomFilter_hash_term(term_text);
+        BB_Cat_Bytes(self->bloom_hashes, &hash, sizeof(uint64_t));
+    }
+
     // Track number of terms.
     self->count++;
 }
@@ -142,6 +152,33 @@ LexWriter_start_field(LexiconWriter *self, int32_t field_num) {
     self->ix_count = 0;
     self->term_stepper = FType_Make_Term_Stepper(type);
     TermStepper_Reset(self->tinfo_stepper);
+
+    // Collect term hashes if the field wants a bloom filter.
+    DECREF(self->bloom_hashes);
+    self->bloom_hashes = FType_Bloom_Filter(type) ? BB_new(0) : NULL;
+}
+
+static void
+S_write_bloom_filter(LexiconWriter *self, int32_t field_num) {
+    Folder   *const folder   = LexWriter_Get_Folder(self);
+    CharBuf  *const seg_name = Seg_Get_Name(self->segment);
+    uint64_t *hashes   = (uint64_t*)BB_Get_Buf(self->bloom_hashes);
+    size_t    num_keys = BB_Get_Size(self->bloom_hashes) / sizeof(uint64_t);
+    CharBuf  *filename = CB_newf("%o/lexicon-%i32.bloom", seg_name,
+                                 field_num);
+    BloomFilter *filter = BloomFilter_new((uint32_t)num_keys, 10);
+
+    for (size_t i = 0; i < num_keys; i++) {
+        BloomFilter_Add_Hash(filter, hashes[i]);
+    }
+    OutStream *outstream = Folder_Open_Out(folder, filename);
+    if (!outstream) { RETHROW(INCREF(Err_get_error())); }
+    BloomFilter_Serialize(filter, outstream);
+    OutStream_Close(outstream);
+
+    DECREF(outstream);
+    DECREF(filter);
+    DECREF(filename);
 }
 
 void
@@ -168,6 +205,13 @@ LexWriter_finish_field(LexiconWriter *self, int32_t field_num) {
     // Close term stepper.
     DECREF(self->term_stepper);
     self->term_stepper = NULL;
+
+    // Write the bloom filter, if any.
+    if (self->bloom_hashes) {
+        S_write_bloom_filter(self, field_num);
+        DECREF(self->bloom_hashes);
+        self->bloom_hashes = NULL;
+    }
 }
 
 void
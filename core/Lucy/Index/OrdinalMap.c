@@ -0,0 +1,259 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_ORDINALMAP
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Index/OrdinalMap.h"
+#include "Lucy/Index/SortCache.h"
+#include "Lucy/Plan/FieldType.h"
+
+// Walk all segments' sorted values in parallel, assigning a global ordinal
+// to each unique value.
+static void
+S_merge_ords(OrdinalMap *self);
+
+OrdinalMap*
+OrdMap_new(const CharBuf *field, FieldType *type, VArray *caches) {
+    OrdinalMap *self = (OrdinalMap*)VTable_Make_Obj(ORDINALMAP);
+    return OrdMap_init(self, field, type, caches);
+}
+
+OrdinalMap*
+OrdMap_init(OrdinalMap *self, const CharBuf *field, FieldType *type,
+            VArray *caches) {
+    // Validate.
+    if (!type || !FType_Sortable(type)) {
+        DECREF(self);
+        THROW(ERR, "'%o' isn't a sortable field", field);
+    }
+    for (uint32_t i = 0, max = VA_Get_Size(caches); i < max; i++) {
+        Obj *cache = VA_Fetch(caches, i);
+        if (cache) { CERTIFY(cache, SORTCACHE); }
+    }
+
+    // Assign.
+    self->field        = CB_Clone(field);
+    self->type         = (FieldType*)INCREF(type);
+    self->caches       = (VArray*)INCREF(caches);
+
+    // Init.
+    self->num_segs     = VA_Get_Size(caches);
+    self->seg_maps     = (int32_t**)CALLOCATE(self->num_segs, sizeof(int32_t*));
+    self->global_ticks = NULL;
+    self->global_ords  = NULL;
+    self->cardinality  = 0;
+    self->null_ord     = 0;
+
+    S_merge_ords(self);
+
+    return self;
+}
+
+void
+OrdMap_destroy(OrdinalMap *self) {
+    if (self->seg_maps) {
+        for (uint32_t i = 0; i < self->num_segs; i++) {
+            FREEMEM(self->seg_maps[i]);
+        }
+        FREEMEM(self->seg_maps);
+    }
+    FREEMEM(self->global_ticks);
+    FREEMEM(self->global_ords);
+    DECREF(self->field);
+    DECREF(self->type);
+    DECREF(self->caches);
+    SUPER_DESTROY(self, ORDINALMAP);
+}
+
+static void
+S_merge_ords(OrdinalMap *self) {
+    FieldType  *const type     = self->type;
+    const uint32_t    num_segs = self->num_segs;
+    SortCache **caches   = (SortCache**)CALLOCATE(num_segs, sizeof(SortCache*));
+    Obj       **blanks   = (Obj**)CALLOCATE(num_segs, sizeof(Obj*));
+    Obj       **values   = (Obj**)CALLOCATE(num_segs, sizeof(Obj*));
+    int32_t    *cursors  = (int32_t*)CALLOCATE(num_segs, sizeof(int32_t));
+    int32_t    *ords_max = (int32_t*)CALLOCATE(num_segs, sizeof(int32_t));
+    uint32_t   *ties     = (uint32_t*)CALLOCATE(num_segs, sizeof(uint32_t));
+    size_t      cap      = 0;
+    bool_t      has_null = false;
+
+    // Prime each segment with its lowest-sorting value.
+    for (uint32_t i = 0; i < num_segs; i++) {
+        SortCache *cache = (SortCache*)VA_Fetch(self->caches, i);
+        int32_t    card  = cache ? SortCache_Get_Cardinality(cache) : 0;
+        caches[i]   = cache;
+        ords_max[i] = card;
+        if (card > 0) {
+            size_t card_size  = (size_t)card;
+            self->seg_maps[i] = (int32_t*)MALLOCATE(card_size * sizeof(int32_t));
+            blanks[i]         = SortCache_Make_Blank(cache);
+            values[i]         = SortCache_Value(cache, 0, blanks[i]);
+        }
+    }
+
+    while (1) {
+        // Find the lowest-sorting value among all segments, noting which
+        // segments share it.
+        uint32_t num_ties = 0;
+        Obj     *min_val  = NULL;
+        for (uint32_t i = 0; i < num_segs; i++) {
+            if (cursors[i] >= ords_max[i]) { continue; }
+            if (num_ties == 0) {
+                min_val = values[i];
+                ties[num_ties++] = i;
+            }
+            else {
+                int32_t comparison
+                    = FType_null_back_compare_values(type, values[i],
+                                                     min_val);
+                if (comparison < 0) {
+                    min_val  = values[i];
+                    num_ties = 0;
+                    ties[num_ties++] = i;
+                }
+                else if (comparison == 0) {
+                    ties[num_ties++] = i;
+                }
+            }
+        }
+        if (num_ties == 0) { break; }
+
+        // Assign the next global ordinal, remembering one segment which can
+        // produce its value.
+        int32_t global_ord = self->cardinality++;
+        if ((size_t)self->cardinality > cap) {
+            cap = Memory_oversize((size_t)self->cardinality, sizeof(int32_t));
+            self->global_ticks = (int32_t*)REALLOCATE(
+                                     self->global_ticks, cap * sizeof(int32_t));
+            self->global_ords  = (int32_t*)REALLOCATE(
+                                     self->global_ords, cap * sizeof(int32_t));
+        }
+        self->global_ticks[global_ord] = (int32_t)ties[0];
+        self->global_ords[global_ord]  = cursors[ties[0]];
+        if (min_val == NULL) {
+            has_null       = true;
+            self->null_ord = global_ord;
+        }
+
+        // Map local ordinals and advance the tied segments.
+        for (uint32_t j = 0; j < num_ties; j++) {
+            uint32_t tick = ties[j];
+            self->seg_maps[tick][cursors[tick]] = global_ord;
+            if (++cursors[tick] < ords_max[tick]) {
+                values[tick] = SortCache_Value(caches[tick], cursors[tick],
+                                               blanks[tick]);
+            }
+        }
+    }
+
+    // If there were no NULL values, reserve an ordinal past the end for
+    // segments which lack a SortCache entirely.
+    if (!has_null) {
+        self->null_ord = self->cardinality;
+    }
+
+    for (uint32_t i = 0; i < num_segs; i++) {
+        DECREF(blanks[i]);
+    }
+    FREEMEM(caches);
+    FREEMEM(blanks);
+    FREEMEM(values);
+    FREEMEM(cursors);
+    FREEMEM(ords_max);
+    FREEMEM(ties);
+}
+
+int32_t
+OrdMap_seg_tick(OrdinalMap *self, SortCache *cache) {
+    if (cache) {
+        for (uint32_t i = 0; i < self->num_segs; i++) {
+            if ((SortCache*)VA_Fetch(self->caches, i) == cache) {
+                return (int32_t)i;
+            }
+        }
+    }
+    return -1;
+}
+
+int32_t*
+OrdMap_seg_map(OrdinalMap *self, uint32_t seg_tick) {
+    if (seg_tick >= self->num_segs) {
+        THROW(ERR, "Out of range: %u32 >= %u32", seg_tick, self->num_segs);
+    }
+    return self->seg_maps[seg_tick];
+}
+
+int32_t
+OrdMap_global_ord(OrdinalMap *self, uint32_t seg_tick, int32_t ord) {
+    int32_t *seg_map = OrdMap_Seg_Map(self, seg_tick);
+    SortCache *cache = (SortCache*)VA_Fetch(self->caches, seg_tick);
+    if (!seg_map) {
+        return self->null_ord;
+    }
+    if ((uint32_t)ord >= (uint32_t)SortCache_Get_Cardinality(cache)) {
+        THROW(ERR, "Ordinal out of range for field %o: %i32", self->field,
+              ord);
+    }
+    return seg_map[ord];
+}
+
+Obj*
+OrdMap_value(OrdinalMap *self, int32_t global_ord, Obj *blank) {
+    if (global_ord == self->null_ord) {
+        return NULL;
+    }
+    if ((uint32_t)global_ord >= (uint32_t)self->cardinality) {
+        THROW(ERR, "Global ordinal out of range for field %o: %i32",
+              self->field, global_ord);
+    }
+    uint32_t   tick  = (uint32_t)self->global_ticks[global_ord];
+    SortCache *cache = (SortCache*)VA_Fetch(self->caches, tick);
+    return SortCache_Value(cache, self->global_ords[global_ord], blank);
+}
+
+Obj*
+OrdMap_make_blank(OrdinalMap *self) {
+    for (uint32_t i = 0; i < self->num_segs; i++) {
+        SortCache *cache = (SortCache*)VA_Fetch(self->caches, i);
+        if (cache) { return SortCache_Make_Blank(cache); }
+    }
+    THROW(ERR, "No SortCaches for field %o", self->field);
+    UNREACHABLE_RETURN(Obj*);
+}
+
+int32_t
+OrdMap_get_cardinality(OrdinalMap *self) {
+    return self->cardinality;
+}
+
+int32_t
+OrdMap_get_null_ord(OrdinalMap *self) {
+    return self->null_ord;
+}
+
+CharBuf*
+OrdMap_get_field(OrdinalMap *self) {
+    return self->field;
+}
+
+FieldType*
+OrdMap_get_type(OrdinalMap *self) {
+    return self->type;
+}
+
+
@@ -26,6 +26,8 @@
 #include "Lucy/Index/Snapshot.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
+#include "Lucy/Search/IndexSearcher.h"
+#include "Lucy/Search/Warmer.h"
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/FSFolder.h"
 #include "Lucy/Store/Lock.h"
@@ -166,9 +168,82 @@ void
 PolyReader_destroy(PolyReader *self) {
     DECREF(self->sub_readers);
     DECREF(self->offsets);
+    DECREF(self->prior);
     SUPER_DESTROY(self, POLYREADER);
 }
 
+// Find the deletions entry which DefaultDeletionsReader would use for the
+// named segment: the one in the most recently added segment which mentions it.
+static Hash*
+S_deletions_entry(VArray *segments, const CharBuf *seg_name) {
+    for (int32_t i = VA_Get_Size(segments) - 1; i >= 0; i--) {
+        Segment *segment = (Segment*)VA_Fetch(segments, i);
+        Hash *metadata
+            = (Hash*)Seg_Fetch_Metadata_Str(segment, "deletions", 9);
+        if (metadata) {
+            Hash *files = (Hash*)CERTIFY(
+                              Hash_Fetch_Str(metadata, "files", 5), HASH);
+            Hash *entry = (Hash*)Hash_Fetch(files, (Obj*)seg_name);
+            if (entry) { return entry; }
+        }
+    }
+    return NULL;
+}
+
+// Match up the prior reader's SegReaders with the segments about to be
+// opened.  Returns NULL if nothing can be reused.
+static VArray*
+S_reusable_seg_readers(PolyReader *self, VArray *segments) {
+    VArray   *prior_readers = self->prior->sub_readers;
+    uint32_t  num_segs      = VA_Get_Size(segments);
+    VArray   *reusable      = NULL;
+
+    // Existing SegReaders were set up using the prior Schema.
+    Hash *dump       = Schema_Dump(self->schema);
+    Hash *prior_dump = Schema_Dump(PolyReader_Get_Schema(self->prior));
+    bool_t same_schema = Hash_Equals(dump, (Obj*)prior_dump);
+    DECREF(dump);
+    DECREF(prior_dump);
+    if (!same_schema) { return NULL; }
+
+    Hash *by_name = Hash_new(VA_Get_Size(prior_readers));
+    for (uint32_t i = 0, max = VA_Get_Size(prior_readers); i < max; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(prior_readers, i);
+        Hash_Store(by_name, (Obj*)SegReader_Get_Seg_Name(seg_reader),
+                   INCREF(seg_reader));
+    }
+
+    for (uint32_t i = 0; i < num_segs; i++) {
+        Segment   *segment  = (Segment*)VA_Fetch(segments, i);
+        CharBuf   *seg_name = Seg_Get_Name(segment);
+        SegReader *seg_reader
+            = (SegReader*)Hash_Fetch(by_name, (Obj*)seg_name);
+        if (!seg_reader
+            || SegReader_Doc_Max(seg_reader) != (int32_t)Seg_Get_Count(segment)
+           ) {
+            continue;
+        }
+
+        // Deletions files are written afresh by each commit which touches
+        // them, so an unchanged entry means unchanged deletions.
+        Hash *dels = S_deletions_entry(segments, seg_name);
+        Hash *prior_dels
+            = S_deletions_entry(SegReader_Get_Segments(seg_reader), seg_name);
+        if (dels == NULL || prior_dels == NULL
+            ? dels != prior_dels
+            : !Hash_Equals(dels, (Obj*)prior_dels)
+           ) {
+            continue;
+        }
+
+        if (!reusable) { reusable = VA_new(num_segs); }
+        VA_Store(reusable, i, INCREF(seg_reader));
+    }
+
+    DECREF(by_name);
+    return reusable;
+}
+
 Obj*
 S_try_open_elements(PolyReader *self) {
     VArray   *files             = Snapshot_List(self->snapshot);
@@ -248,7 +323,11 @@ S_try_open_elements(PolyReader *self) {
     // Sort the segments by age.
     VA_Sort(segments, NULL, NULL);
 
-    Obj *result = PolyReader_Try_Open_SegReaders(self, segments);
+    VArray *reusable = self->prior
+                       ? S_reusable_seg_readers(self, segments)
+                       : NULL;
+    Obj *result = PolyReader_Try_Open_SegReaders(self, segments, reusable);
+    DECREF(reusable);
     DECREF(segments);
     DECREF(files);
     return result;
@@ -373,6 +452,58 @@ PolyReader_do_open(PolyReader *self, Obj *index, Snapshot *snapshot,
     return self;
 }
 
+PolyReader*
+PolyReader_reopen(PolyReader *self, Snapshot *snapshot,
+                  IndexManager *manager, Warmer *warmer) {
+    Folder *folder = PolyReader_Get_Folder(self);
+
+    // Bail out early if nothing has been committed since we were opened.
+    if (!snapshot) {
+        CharBuf *latest  = IxFileNames_latest_snapshot(folder);
+        CharBuf *current = self->snapshot
+                           ? Snapshot_Get_Path(self->snapshot)
+                           : NULL;
+        bool_t unchanged = latest && current
+                           ? CB_Equals(latest, (Obj*)current)
+                           : latest == current;
+        DECREF(latest);
+        if (unchanged) { return (PolyReader*)INCREF(self); }
+    }
+
+    PolyReader *fresh = (PolyReader*)VTable_Make_Obj(POLYREADER);
+    fresh->prior = (PolyReader*)INCREF(self);
+    PolyReader_do_open(fresh, (Obj*)folder, snapshot, manager);
+    DECREF(fresh->prior);
+    fresh->prior = NULL;
+
+    if (warmer) {
+        // Shared SegReaders were warmed when they were first opened.
+        for (uint32_t i = 0, max = VA_Get_Size(fresh->sub_readers);
+             i < max;
+             i++
+            ) {
+            SegReader *seg_reader
+                = (SegReader*)VA_Fetch(fresh->sub_readers, i);
+            bool_t shared = false;
+            for (uint32_t j = 0, limit = VA_Get_Size(self->sub_readers);
+                 j < limit;
+                 j++
+                ) {
+                if (VA_Fetch(self->sub_readers, j) == (Obj*)seg_reader) {
+                    shared = true;
+                    break;
+                }
+            }
+            if (!shared) { Warmer_Warm_Seg_Reader(warmer, seg_reader); }
+        }
+        IndexSearcher *searcher = IxSearcher_new((Obj*)fresh);
+        Warmer_Warm_Searcher(warmer, (Searcher*)searcher);
+        DECREF(searcher);
+    }
+
+    return fresh;
+}
+
 static Folder*
 S_derive_folder(Obj *index) {
     Folder *folder = NULL;
@@ -25,10 +25,24 @@
 #include "Lucy/Index/Segment.h"
 #include "Lucy/Index/SegPostingList.h"
 #include "Lucy/Index/Snapshot.h"
+#include "Lucy/Index/TermInfo.h"
 #include "Lucy/Plan/Architecture.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
+
+// Rough estimate of the encoded size of one posting in the stock formats,
+// used to estimate how much of the postings file a term occupies.
+#define PREFETCH_BYTES_PER_POSTING 8
+
+// Rough upper bound on the encoded size of one skip record.
+#define PREFETCH_BYTES_PER_SKIP 16
+
+// Open the streams used for prefetching on first use.  Returns the field's
+// postings stream, or NULL if the segment has no postings for it.
+static InStream*
+S_prefetch_stream(DefaultPostingListReader *self, const CharBuf *field);
 
 PostingListReader*
 PListReader_init(PostingListReader *self, Schema *schema, Folder *folder,
@@ -39,6 +53,14 @@ PListReader_init(PostingListReader *self, Schema *schema, Folder *folder,
     return self;
 }
 
+void
+PListReader_prefetch_term(PostingListReader *self, const CharBuf *field,
+                          Obj *term) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(field);
+    UNUSED_VAR(term);
+}
+
 PostingListReader*
 PListReader_aggregator(PostingListReader *self, VArray *readers,
                        I32Array *offsets) {
@@ -66,6 +88,10 @@ DefPListReader_init(DefaultPostingListReader *self, Schema *schema,
                      segments, seg_tick);
     Segment *segment = DefPListReader_Get_Segment(self);
 
+    // Init.
+    self->post_streams = Hash_new(0);
+    self->skip_stream  = NULL;
+
     // Derive.
     self->lex_reader = (LexiconReader*)INCREF(lex_reader);
 
@@ -96,11 +122,29 @@ DefPListReader_close(DefaultPostingListReader *self) {
         DECREF(self->lex_reader);
         self->lex_reader = NULL;
     }
+    if (self->post_streams) {
+        CharBuf  *field;
+        InStream *instream;
+        Hash_Iterate(self->post_streams);
+        while (Hash_Next(self->post_streams, (Obj**)&field,
+                         (Obj**)&instream)) {
+            InStream_Close(instream);
+        }
+        DECREF(self->post_streams);
+        self->post_streams = NULL;
+    }
+    if (self->skip_stream) {
+        InStream_Close(self->skip_stream);
+        DECREF(self->skip_stream);
+        self->skip_stream = NULL;
+    }
 }
 
 void
 DefPListReader_destroy(DefaultPostingListReader *self) {
     DECREF(self->lex_reader);
+    DECREF(self->post_streams);
+    DECREF(self->skip_stream);
     SUPER_DESTROY(self, DEFAULTPOSTINGLISTREADER);
 }
 
@@ -125,3 +169,59 @@ DefPListReader_get_lex_reader(DefaultPostingListReader *self) {
     return self->lex_reader;
 }
 
+void
+DefPListReader_prefetch_term(DefaultPostingListReader *self,
+                             const CharBuf *field, Obj *term) {
+    if (!self->lex_reader || !term) { return; }
+    FieldType *type = Schema_Fetch_Type(self->schema, field);
+    if (type == NULL || !FType_Indexed(type)) { return; }
+
+    TermInfo *tinfo = LexReader_Fetch_Term_Info(self->lex_reader, field,
+                                                term);
+    if (!tinfo) { return; }
+    InStream *post_stream = S_prefetch_stream(self, field);
+    if (post_stream) {
+        Architecture *arch = Schema_Get_Architecture(self->schema);
+        const int64_t doc_freq  = TInfo_Get_Doc_Freq(tinfo);
+        const int64_t num_skips = doc_freq / Arch_Skip_Interval(arch);
+        InStream_Prefetch(post_stream, TInfo_Get_Post_FilePos(tinfo),
+                          doc_freq * PREFETCH_BYTES_PER_POSTING);
+        if (num_skips) {
+            InStream_Prefetch(self->skip_stream,
+                              TInfo_Get_Skip_FilePos(tinfo),
+                              num_skips * PREFETCH_BYTES_PER_SKIP);
+        }
+    }
+    DECREF(tinfo);
+}
+
+static InStream*
+S_prefetch_stream(DefaultPostingListReader *self, const CharBuf *field) {
+    InStream *post_stream
+        = (InStream*)Hash_Fetch(self->post_streams, (Obj*)field);
+    if (post_stream) { return post_stream; }
+
+    CharBuf *seg_name  = Seg_Get_Name(self->segment);
+    int32_t  field_num = Seg_Field_Num(self->segment, field);
+    CharBuf *post_file = CB_newf("%o/postings-%i32.dat", seg_name,
+                                 field_num);
+    if (Folder_Exists(self->folder, post_file)) {
+        if (!self->skip_stream) {
+            CharBuf *skip_file = CB_newf("%o/postings.skip", seg_name);
+            self->skip_stream = Folder_Open_In(self->folder, skip_file);
+            DECREF(skip_file);
+        }
+        // Prefetching is only a hint, so skip what won't open.
+        if (self->skip_stream) {
+            post_stream = Folder_Open_In(self->folder, post_file);
+            if (post_stream) {
+                Hash_Store(self->post_streams, (Obj*)field,
+                           (Obj*)post_stream);
+            }
+        }
+    }
+    DECREF(post_file);
+    return post_stream;
+}
+
+
@@ -15,19 +15,33 @@
  */
 
 #define C_LUCY_POSTINGLISTWRITER
+#define C_LUCY_MATCHPOSTINGWRITER
+#define C_LUCY_RAWPOSTING
+#define C_LUCY_SKIPSTEPPER
+#define C_LUCY_TERMINFO
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/PostingListWriter.h"
 #include "Lucy/Analysis/Inversion.h"
 #include "Lucy/Index/Inverter.h"
+#include "Lucy/Index/Lexicon.h"
+#include "Lucy/Index/LexiconReader.h"
 #include "Lucy/Index/PolyReader.h"
 #include "Lucy/Index/Posting.h"
+#include "Lucy/Index/Posting/MatchPosting.h"
+#include "Lucy/Index/Posting/RawPosting.h"
+#include "Lucy/Index/PostingList.h"
+#include "Lucy/Index/PostingListReader.h"
 #include "Lucy/Index/PostingPool.h"
 #include "Lucy/Index/Segment.h"
+#include "Lucy/Index/SegLexicon.h"
+#include "Lucy/Index/SegPostingList.h"
 #include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/Similarity.h"
+#include "Lucy/Index/SkipStepper.h"
 #include "Lucy/Index/LexiconWriter.h"
 #include "Lucy/Index/Snapshot.h"
+#include "Lucy/Index/TermInfo.h"
 #include "Lucy/Plan/Architecture.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
@@ -40,6 +54,44 @@ static size_t default_mem_thresh = 0x1000000;
 
 int32_t PListWriter_current_file_format = 1;
 
+// A segment passed to Add_Segment(), held until Finish().
+typedef struct lucy_PListMergeSource {
+    SegReader *reader;
+    I32Array  *doc_map;
+    int32_t    doc_base;
+    int32_t    offset;     // new doc id = old doc id + offset, if contiguous
+    int32_t    first_doc;  // lowest remapped doc id, 0 if all deleted
+    int32_t    last_doc;   // highest remapped doc id
+    bool_t     contiguous; // no deletions, so only an offset is applied
+    bool_t     ascending;  // remapped doc ids preserve the original order
+} lucy_PListMergeSource;
+
+// Iteration state for one source while merging a single field.
+typedef struct lucy_PListMergeCursor {
+    lucy_PListMergeSource *source;
+    Lexicon               *lexicon;
+    PostingList           *plist;
+    bool_t                 live;
+} lucy_PListMergeCursor;
+
+// Output state while merging a single field.
+typedef struct lucy_PListMergeState {
+    PostingListWriter *writer;
+    int32_t            field_num;
+    PostingWriter     *post_writer;
+    TermInfo          *tinfo;
+    TermInfo          *skip_tinfo;
+    SkipStepper       *skip_stepper;
+    int32_t            skip_interval;
+    bool_t             can_copy;
+    // The term info and skip data of the source currently being copied.
+    TermInfo          *src_tinfo;
+    SkipStepper       *src_skip_stepper;
+    int32_t           *src_skip_docs;
+    int64_t           *src_skip_fileposes;
+    uint32_t           src_skip_cap;
+} lucy_PListMergeState;
+
 // Open streams only if content gets added.
 static void
 S_lazy_init(PostingListWriter *self);
@@ -48,6 +100,21 @@ S_lazy_init(PostingListWriter *self);
 static PostingPool*
 S_lazy_init_posting_pool(PostingListWriter *self, int32_t field_num);
 
+// Feed all held segments to a PostingPool as runs.
+static void
+S_add_segments_to_pool(PostingListWriter *self, PostingPool *pool);
+
+// Return true if the held segments cover ascending, non-overlapping ranges
+// of doc ids, the precondition for merging term by term.
+static bool_t
+S_sources_in_order(PostingListWriter *self);
+
+// Merge the postings for one field term by term directly from the held
+// segments.  Return false without writing anything if the sources can't be
+// streamed, in which case the caller must fall back to a PostingPool.
+static bool_t
+S_merge_postings(PostingListWriter *self, int32_t field_num);
+
 PostingListWriter*
 PListWriter_new(Schema *schema, Snapshot *snapshot, Segment *segment,
                 PolyReader *polyreader, LexiconWriter *lex_writer) {
@@ -72,6 +139,8 @@ PListWriter_init(PostingListWriter *self, Schema *schema, Snapshot *snapshot,
     self->mem_pool       = MemPool_new(0);
     self->lex_temp_out   = NULL;
     self->post_temp_out  = NULL;
+    self->merge_sources     = NULL;
+    self->num_merge_sources = 0;
 
     return self;
 }
@@ -115,6 +184,13 @@ S_lazy_init_posting_pool(PostingListWriter *self, int32_t field_num) {
 
 void
 PListWriter_destroy(PostingListWriter *self) {
+    lucy_PListMergeSource *sources
+        = (lucy_PListMergeSource*)self->merge_sources;
+    for (uint32_t i = 0; i < self->num_merge_sources; i++) {
+        DECREF(sources[i].reader);
+        DECREF(sources[i].doc_map);
+    }
+    FREEMEM(self->merge_sources);
     DECREF(self->lex_writer);
     DECREF(self->mem_pool);
     DECREF(self->pools);
@@ -177,6 +253,7 @@ PListWriter_add_segment(PostingListWriter *self, SegReader *reader,
     Schema  *schema        = self->schema;
     Segment *segment       = self->segment;
     VArray  *all_fields    = Schema_All_Fields(schema);
+    bool_t   has_postings  = false;
     S_lazy_init(self);
 
     for (uint32_t i = 0, max = VA_Get_Size(all_fields); i < max; i++) {
@@ -190,14 +267,50 @@ PListWriter_add_segment(PostingListWriter *self, SegReader *reader,
         if (!new_field_num) {
             THROW(ERR, "Unrecognized field: %o", field);
         }
-
-        PostingPool *pool = S_lazy_init_posting_pool(self, new_field_num);
-        PostPool_Add_Segment(pool, reader, doc_map,
-                             (int32_t)Seg_Get_Count(segment));
+        has_postings = true;
     }
-
-    // Clean up.
     DECREF(all_fields);
+    if (!has_postings) { return; }
+
+    // Hold the segment until Finish(), noting how its doc ids get remapped.
+    uint32_t num_sources = self->num_merge_sources + 1;
+    self->merge_sources
+        = REALLOCATE(self->merge_sources,
+                     num_sources * sizeof(lucy_PListMergeSource));
+    self->num_merge_sources = num_sources;
+    lucy_PListMergeSource *source
+        = (lucy_PListMergeSource*)self->merge_sources + num_sources - 1;
+    int32_t doc_max     = SegReader_Doc_Max(reader);
+    source->reader      = (SegReader*)INCREF(reader);
+    source->doc_map     = (I32Array*)INCREF(doc_map);
+    source->doc_base    = (int32_t)Seg_Get_Count(segment);
+    source->contiguous  = true;
+    source->ascending   = true;
+    if (!doc_map) {
+        source->offset    = source->doc_base;
+        source->first_doc = doc_max ? source->doc_base + 1 : 0;
+        source->last_doc  = source->doc_base + doc_max;
+    }
+    else {
+        source->offset    = doc_max ? I32Arr_Get(doc_map, 1) - 1 : 0;
+        source->first_doc = 0;
+        source->last_doc  = 0;
+        for (int32_t i = 1; i <= doc_max; i++) {
+            int32_t remapped = I32Arr_Get(doc_map, i);
+            if (!remapped) {
+                source->contiguous = false;
+                continue;
+            }
+            if (remapped != i + source->offset) {
+                source->contiguous = false;
+            }
+            if (remapped <= source->last_doc) {
+                source->ascending = false;
+            }
+            if (!source->first_doc) { source->first_doc = remapped; }
+            source->last_doc = remapped;
+        }
+    }
 }
 
 void
@@ -221,17 +334,28 @@ PListWriter_finish(PostingListWriter *self) {
     }
 
     // Write postings for each field.
-    for (uint32_t i = 0, max = VA_Get_Size(self->pools); i < max; i++) {
-        PostingPool *pool = (PostingPool*)VA_Delete(self->pools, i);
-        if (pool) {
-            // Write out content for each PostingPool.  Let each PostingPool
-            // use more RAM while finishing.  (This is a little dicy, because if
-            // Shrink() was ineffective, we may double the RAM footprint.)
-            PostPool_Set_Mem_Thresh(pool, self->mem_thresh);
-            PostPool_Flip(pool);
-            PostPool_Finish(pool);
-            DECREF(pool);
+    bool_t in_order = S_sources_in_order(self);
+    for (int32_t field_num = 1;
+         Seg_Field_Name(self->segment, field_num) != NULL;
+         field_num++
+        ) {
+        PostingPool *pool = (PostingPool*)VA_Fetch(self->pools, field_num);
+        if (!pool) {
+            // Fields which got no freshly inverted content can be merged
+            // term by term, skipping the PostingPool entirely.
+            if (in_order && S_merge_postings(self, field_num)) { continue; }
+            pool = S_lazy_init_posting_pool(self, field_num);
         }
+        S_add_segments_to_pool(self, pool);
+        pool = (PostingPool*)VA_Delete(self->pools, field_num);
+
+        // Write out content for each PostingPool.  Let each PostingPool
+        // use more RAM while finishing.  (This is a little dicy, because if
+        // Shrink() was ineffective, we may double the RAM footprint.)
+        PostPool_Set_Mem_Thresh(pool, self->mem_thresh);
+        PostPool_Flip(pool);
+        PostPool_Finish(pool);
+        DECREF(pool);
     }
 
     // Store metadata.
@@ -255,4 +379,376 @@ PListWriter_finish(PostingListWriter *self) {
     LexWriter_Finish(self->lex_writer);
 }
 
+static void
+S_add_segments_to_pool(PostingListWriter *self, PostingPool *pool) {
+    lucy_PListMergeSource *sources
+        = (lucy_PListMergeSource*)self->merge_sources;
+    for (uint32_t i = 0; i < self->num_merge_sources; i++) {
+        PostPool_Add_Segment(pool, sources[i].reader, sources[i].doc_map,
+                             sources[i].doc_base);
+    }
+}
+
+static bool_t
+S_sources_in_order(PostingListWriter *self) {
+    lucy_PListMergeSource *sources
+        = (lucy_PListMergeSource*)self->merge_sources;
+    int32_t last_doc = 0;
+    for (uint32_t i = 0; i < self->num_merge_sources; i++) {
+        lucy_PListMergeSource *source = sources + i;
+        if (!source->ascending) { return false; }
+        if (!source->first_doc) { continue; } // all deleted
+        if (source->first_doc <= last_doc) { return false; }
+        last_doc = source->last_doc;
+    }
+    return true;
+}
+
+// Prepare to write postings for a new term, opening the field's output
+// lazily so that a field whose documents were all deleted leaves no files.
+static void
+S_start_term(lucy_PListMergeState *state) {
+    PostingListWriter *writer = state->writer;
+    if (!state->post_writer) {
+        CharBuf    *field = Seg_Field_Name(writer->segment, state->field_num);
+        Similarity *sim   = Schema_Fetch_Sim(writer->schema, field);
+        state->post_writer
+            = Sim_Make_Posting_Writer(sim, writer->schema, writer->snapshot,
+                                      writer->segment, writer->polyreader,
+                                      state->field_num);
+        state->can_copy = Obj_Get_VTable((Obj*)state->post_writer)
+                          == MATCHPOSTINGWRITER;
+        LexWriter_Start_Field(writer->lex_writer, state->field_num);
+    }
+    TInfo_Reset(state->tinfo);
+    PostWriter_Start_Term(state->post_writer, state->tinfo);
+    state->skip_stepper->doc_id  = 0;
+    state->skip_stepper->filepos = state->tinfo->post_filepos;
+}
+
+// Write a skip record pointing just past the posting for
+// <code>doc_id</code>, which ends at <code>filepos</code>.
+static void
+S_write_skip(lucy_PListMergeState *state, int32_t doc_id, int64_t filepos) {
+    TermInfo    *const tinfo        = state->tinfo;
+    SkipStepper *const skip_stepper = state->skip_stepper;
+    OutStream   *const skip_stream  = state->writer->skip_out;
+
+    // If first skip group, save skip stream pos for term info.  S_start_term
+    // zeroes the stepper's doc id, and real doc ids start at 1.
+    if (skip_stepper->doc_id == 0) {
+        tinfo->skip_filepos = OutStream_Tell(skip_stream);
+    }
+    int32_t last_skip_doc     = skip_stepper->doc_id;
+    int64_t last_skip_filepos = skip_stepper->filepos;
+    skip_stepper->doc_id  = doc_id;
+    skip_stepper->filepos = filepos;
+    SkipStepper_Write_Record(skip_stepper, skip_stream, last_skip_doc,
+                             last_skip_filepos);
+}
+
+// Write one posting, plus a skip record if one is due.
+static void
+S_write_posting(lucy_PListMergeState *state, RawPosting *posting) {
+    TermInfo *const tinfo = state->tinfo;
+
+    PostWriter_Write_Posting(state->post_writer, posting);
+    tinfo->doc_freq++;
+
+    if (tinfo->doc_freq % state->skip_interval == 0) {
+        PostWriter_Update_Skip_Info(state->post_writer, state->skip_tinfo);
+        S_write_skip(state, posting->doc_id,
+                     state->skip_tinfo->post_filepos);
+    }
+}
+
+// Decode one source's postings for the current term, remap the doc ids and
+// write them back out one at a time.
+static void
+S_reencode_postings(lucy_PListMergeState *state,
+                    lucy_PListMergeCursor *cursor, int32_t doc_freq,
+                    CharBuf *term_text, MemoryPool *mem_pool) {
+    lucy_PListMergeSource *source = cursor->source;
+    int32_t last_doc_id = 0;
+    for (int32_t i = 0; i < doc_freq; i++) {
+        RawPosting *posting = PList_Read_Raw(cursor->plist, last_doc_id,
+                                             term_text, mem_pool);
+        last_doc_id = posting->doc_id;
+        int32_t remapped = source->doc_map
+                           ? I32Arr_Get(source->doc_map, last_doc_id)
+                           : last_doc_id + source->doc_base;
+        if (remapped) {
+            if (state->tinfo->doc_freq == 0) { S_start_term(state); }
+            posting->doc_id = remapped;
+            S_write_posting(state, posting);
+        }
+        MemPool_Release_All(mem_pool);
+    }
+}
+
+// Read one source's skip records for the current term, converting them to
+// absolute doc ids and file positions.
+static void
+S_load_src_skips(lucy_PListMergeState *state, lucy_PListMergeCursor *cursor,
+                 TermInfo *src_tinfo) {
+    const uint32_t num_skips
+        = (uint32_t)(src_tinfo->doc_freq / state->skip_interval);
+    if (!num_skips) { return; }
+    if (num_skips > state->src_skip_cap) {
+        state->src_skip_docs
+            = (int32_t*)REALLOCATE(state->src_skip_docs,
+                                   num_skips * sizeof(int32_t));
+        state->src_skip_fileposes
+            = (int64_t*)REALLOCATE(state->src_skip_fileposes,
+                                   num_skips * sizeof(int64_t));
+        state->src_skip_cap = num_skips;
+    }
+    SkipStepper *stepper = state->src_skip_stepper;
+    InStream *skip_stream
+        = SegPList_Get_Skip_Stream((SegPostingList*)cursor->plist);
+    SkipStepper_Set_ID_And_Filepos(stepper, 0, src_tinfo->post_filepos);
+    InStream_Seek(skip_stream, src_tinfo->skip_filepos);
+    for (uint32_t i = 0; i < num_skips; i++) {
+        SkipStepper_Read_Record(stepper, skip_stream);
+        state->src_skip_docs[i]      = stepper->doc_id;
+        state->src_skip_fileposes[i] = stepper->filepos;
+    }
+}
+
+// Return the doc id of a source's <code>count</code>th posting for the
+// current term, and set <code>filepos</code> to the position just past it.
+// Starts from the nearest skip record, so at most skip_interval - 1 postings
+// get read.
+static int32_t
+S_locate_src_posting(lucy_PListMergeState *state,
+                     lucy_PListMergeCursor *cursor, TermInfo *src_tinfo,
+                     int32_t count, int64_t *filepos, CharBuf *term_text,
+                     MemoryPool *mem_pool) {
+    InStream *instream
+        = SegPList_Get_Post_Stream((SegPostingList*)cursor->plist);
+    const int32_t skip_num = count / state->skip_interval;
+    int32_t doc_id = 0;
+    *filepos = src_tinfo->post_filepos;
+    if (skip_num) {
+        doc_id   = state->src_skip_docs[skip_num - 1];
+        *filepos = state->src_skip_fileposes[skip_num - 1];
+    }
+    InStream_Seek(instream, *filepos);
+    for (int32_t i = skip_num * state->skip_interval; i < count; i++) {
+        RawPosting *posting = PList_Read_Raw(cursor->plist, doc_id,
+                                             term_text, mem_pool);
+        doc_id = posting->doc_id;
+    }
+    MemPool_Release_All(mem_pool);
+    *filepos = InStream_Tell(instream);
+    return doc_id;
+}
+
+// Copy one source's postings for the current term verbatim, rebasing only
+// the leading doc delta.  The skip records due inside the copied range are
+// derived from the source's own skip data.
+static void
+S_copy_postings(lucy_PListMergeState *state, lucy_PListMergeCursor *cursor,
+                TermInfo *src_tinfo, int64_t end, bool_t is_last,
+                CharBuf *term_text, MemoryPool *mem_pool) {
+    MatchPostingWriter *post_writer = (MatchPostingWriter*)state->post_writer;
+    OutStream *outstream = post_writer->outstream;
+    InStream  *instream
+        = SegPList_Get_Post_Stream((SegPostingList*)cursor->plist);
+    const int32_t  offset    = cursor->source->offset;
+    const int32_t  doc_freq  = src_tinfo->doc_freq;
+    const int32_t  prior     = state->tinfo->doc_freq;
+    InStream_Seek(instream, src_tinfo->post_filepos);
+    const uint32_t doc_code  = InStream_Read_C32(instream);
+    const int32_t  doc_id    = (int32_t)(doc_code >> 1) + offset;
+    const uint32_t delta_doc = doc_id - post_writer->last_doc_id;
+    OutStream_Write_C32(outstream, (delta_doc << 1) | (doc_code & 1));
+
+    // Past the leading doc delta, every byte moves by the same amount.
+    const int64_t start = InStream_Tell(instream);
+    const int64_t shift = OutStream_Tell(outstream) - start;
+    OutStream_Absorb_Range(outstream, instream, start, end - start);
+    state->tinfo->doc_freq += doc_freq;
+
+    // Write the skip records for the merged postings which fall in this
+    // range.  When the source starts on a skip boundary they line up with
+    // its own records and only need rebasing.
+    S_load_src_skips(state, cursor, src_tinfo);
+    int64_t filepos;
+    for (int32_t count = state->skip_interval - prior % state->skip_interval;
+         count <= doc_freq;
+         count += state->skip_interval
+        ) {
+        int32_t skip_doc = S_locate_src_posting(state, cursor, src_tinfo,
+                                                count, &filepos, term_text,
+                                                mem_pool);
+        S_write_skip(state, skip_doc + offset, filepos + shift);
+    }
+
+    // The next source's leading delta is relative to this source's last doc.
+    if (!is_last) {
+        post_writer->last_doc_id
+            = S_locate_src_posting(state, cursor, src_tinfo, doc_freq,
+                                   &filepos, term_text, mem_pool) + offset;
+    }
+}
+
+static bool_t
+S_merge_postings(PostingListWriter *self, int32_t field_num) {
+    lucy_PListMergeSource *sources
+        = (lucy_PListMergeSource*)self->merge_sources;
+    CharBuf   *field = Seg_Field_Name(self->segment, field_num);
+    FieldType *type  = Schema_Fetch_Type(self->schema, field);
+    if (!self->num_merge_sources || !type || !FType_Indexed(type)) {
+        return true;
+    }
+
+    // Open a Lexicon and a PostingList for each source with content.
+    lucy_PListMergeCursor *cursors
+        = (lucy_PListMergeCursor*)CALLOCATE(self->num_merge_sources,
+                                            sizeof(lucy_PListMergeCursor));
+    uint32_t num_cursors = 0;
+    bool_t   streamable  = true;
+    for (uint32_t i = 0; i < self->num_merge_sources; i++) {
+        SegReader *reader = sources[i].reader;
+        if (!Seg_Field_Num(SegReader_Get_Segment(reader), field)) {
+            continue;
+        }
+        LexiconReader *lex_reader
+            = (LexiconReader*)SegReader_Fetch(
+                  reader, VTable_Get_Name(LEXICONREADER));
+        Lexicon *lexicon = lex_reader
+                           ? LexReader_Lexicon(lex_reader, field, NULL)
+                           : NULL;
+        if (!lexicon) { continue; }
+        PostingListReader *plist_reader
+            = (PostingListReader*)SegReader_Fetch(
+                  reader, VTable_Get_Name(POSTINGLISTREADER));
+        PostingList *plist
+            = plist_reader
+              ? PListReader_Posting_List(plist_reader, field, NULL)
+              : NULL;
+        if (!plist) {
+            DECREF(lexicon);
+            THROW(ERR, "Got a Lexicon but no PostingList for '%o' in '%o'",
+                  field, SegReader_Get_Seg_Name(reader));
+        }
+        lucy_PListMergeCursor *cursor = cursors + num_cursors++;
+        cursor->source  = sources + i;
+        cursor->lexicon = lexicon;
+        cursor->plist   = plist;
+        if (!Obj_Is_A((Obj*)lexicon, SEGLEXICON)
+            || !Obj_Is_A((Obj*)plist, SEGPOSTINGLIST)
+            || !SegPList_Get_Post_Stream((SegPostingList*)plist)
+            || !SegPList_Get_Skip_Stream((SegPostingList*)plist)
+           ) {
+            streamable = false;
+        }
+    }
+
+    if (streamable && num_cursors) {
+        lucy_PListMergeState state;
+        state.writer        = self;
+        state.field_num     = field_num;
+        state.post_writer   = NULL;
+        state.tinfo         = TInfo_new(0);
+        state.skip_tinfo    = TInfo_new(0);
+        state.skip_stepper  = SkipStepper_new();
+        state.skip_interval
+            = Arch_Skip_Interval(Schema_Get_Architecture(self->schema));
+        state.can_copy      = false;
+        state.src_tinfo          = TInfo_new(0);
+        state.src_skip_stepper   = SkipStepper_new();
+        state.src_skip_docs      = NULL;
+        state.src_skip_fileposes = NULL;
+        state.src_skip_cap       = 0;
+        CharBuf    *term_text = CB_new(0);
+        MemoryPool *mem_pool  = MemPool_new(0);
+        uint32_t   *matches
+            = (uint32_t*)MALLOCATE(num_cursors * sizeof(uint32_t));
+
+        for (uint32_t i = 0; i < num_cursors; i++) {
+            cursors[i].live = Lex_Next(cursors[i].lexicon);
+        }
+
+        while (1) {
+            // Find the lowest term, and every source which contains it.
+            // Sources stay in doc id order, so each term's postings are the
+            // concatenation of the matching sources' postings.
+            CharBuf *lowest = NULL;
+            uint32_t num_matches = 0;
+            for (uint32_t i = 0; i < num_cursors; i++) {
+                if (!cursors[i].live) { continue; }
+                CharBuf *term = (CharBuf*)Lex_Get_Term(cursors[i].lexicon);
+                int32_t comparison
+                    = lowest ? CB_Compare_To(term, (Obj*)lowest) : -1;
+                if (comparison < 0) {
+                    lowest      = term;
+                    num_matches = 0;
+                }
+                if (comparison <= 0) { matches[num_matches++] = i; }
+            }
+            if (!lowest) { break; }
+            CB_Mimic(term_text, (Obj*)lowest);
+            state.tinfo->doc_freq = 0;
+
+            for (uint32_t m = 0; m < num_matches; m++) {
+                lucy_PListMergeCursor *cursor = cursors + matches[m];
+                SegLexicon *lexicon = (SegLexicon*)cursor->lexicon;
+                TermInfo   *src_tinfo = state.src_tinfo;
+                TInfo_Mimic(src_tinfo, (Obj*)SegLex_Get_Term_Info(lexicon));
+                InStream   *instream  = SegPList_Get_Post_Stream(
+                                            (SegPostingList*)cursor->plist);
+                cursor->live = Lex_Next(cursor->lexicon);
+
+                // A source's postings can be copied as a byte range when no
+                // doc ids inside it change.
+                if (cursor->source->contiguous) {
+                    if (state.tinfo->doc_freq == 0) { S_start_term(&state); }
+                    if (state.can_copy) {
+                        int64_t end = InStream_Length(instream);
+                        if (cursor->live) {
+                            end = SegLex_Get_Term_Info(lexicon)->post_filepos;
+                        }
+                        S_copy_postings(&state, cursor, src_tinfo, end,
+                                        m == num_matches - 1, term_text,
+                                        mem_pool);
+                        continue;
+                    }
+                }
+                InStream_Seek(instream, src_tinfo->post_filepos);
+                S_reencode_postings(&state, cursor, src_tinfo->doc_freq,
+                                    term_text, mem_pool);
+            }
+
+            if (state.tinfo->doc_freq) {
+                LexWriter_Add_Term(self->lex_writer, term_text, state.tinfo);
+            }
+        }
+
+        if (state.post_writer) {
+            LexWriter_Finish_Field(self->lex_writer, field_num);
+            DECREF(state.post_writer);
+        }
+        FREEMEM(matches);
+        FREEMEM(state.src_skip_fileposes);
+        FREEMEM(state.src_skip_docs);
+        DECREF(state.src_skip_stepper);
+        DECREF(state.src_tinfo);
+        DECREF(mem_pool);
+        DECREF(term_text);
+        DECREF(state.skip_stepper);
+        DECREF(state.skip_tinfo);
+        DECREF(state.tinfo);
+    }
+
+    for (uint32_t i = 0; i < num_cursors; i++) {
+        DECREF(cursors[i].lexicon);
+        DECREF(cursors[i].plist);
+    }
+    FREEMEM(cursors);
+
+    return streamable;
+}
+
 
@@ -152,6 +152,11 @@ SegPList_get_post_stream(SegPostingList *self) {
     return self->post_stream;
 }
 
+InStream*
+SegPList_get_skip_stream(SegPostingList *self) {
+    return self->skip_stream;
+}
+
 int32_t
 SegPList_next(SegPostingList *self) {
     InStream *const post_stream = self->post_stream;
@@ -91,9 +91,11 @@ SegWriter_prep_seg_dir(SegWriter *self) {
         }
     }
 
-    // Create the segment directory.
+    // Create the segment directory, and have data files written straight
+    // into its compound file where possible.
     bool_t result = Folder_MkDir(folder, seg_name);
     if (!result) { RETHROW(INCREF(Err_get_error())); }
+    Folder_Stream_Compound(folder, seg_name);
 }
 
 void
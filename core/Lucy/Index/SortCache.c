@@ -26,6 +26,7 @@ SortCache_init(SortCache *self, const CharBuf *field, FieldType *type,
                int32_t ord_width) {
     // Init.
     self->native_ords = false;
+    self->owns_ords   = false;
 
     // Assign.
     if (!FType_Sortable(type)) {
@@ -45,6 +46,7 @@ SortCache_init(SortCache *self, const CharBuf *field, FieldType *type,
 
 void
 SortCache_destroy(SortCache *self) {
+    if (self->owns_ords) { FREEMEM(self->ords); }
     DECREF(self->field);
     DECREF(self->type);
     SUPER_DESTROY(self, SORTCACHE);
@@ -60,6 +62,37 @@ SortCache_set_native_ords(SortCache *self, bool_t native_ords) {
     self->native_ords = native_ords;
 }
 
+void
+SortCache_swap_ords(SortCache *self) {
+    const size_t num_ords = (size_t)self->doc_max + 1;
+    if (self->ord_width == 16) {
+        uint8_t  *source = (uint8_t*)self->ords;
+        uint16_t *ints   = (uint16_t*)MALLOCATE(num_ords * sizeof(uint16_t));
+        for (size_t i = 0; i < num_ords; i++, source += sizeof(uint16_t)) {
+            ints[i] = (uint16_t)((source[1] << 8) | source[0]);
+        }
+        if (self->owns_ords) { FREEMEM(self->ords); }
+        self->ords = ints;
+    }
+    else if (self->ord_width == 32) {
+        uint8_t  *source = (uint8_t*)self->ords;
+        uint32_t *ints   = (uint32_t*)MALLOCATE(num_ords * sizeof(uint32_t));
+        for (size_t i = 0; i < num_ords; i++, source += sizeof(uint32_t)) {
+            ints[i] = ((uint32_t)source[3] << 24)
+                      | ((uint32_t)source[2] << 16)
+                      | ((uint32_t)source[1] << 8)
+                      | (uint32_t)source[0];
+        }
+        if (self->owns_ords) { FREEMEM(self->ords); }
+        self->ords = ints;
+    }
+    else {
+        return;
+    }
+    self->owns_ords   = true;
+    self->native_ords = true;
+}
+
 int32_t
 SortCache_ordinal(SortCache *self, int32_t doc_id) {
     if ((uint32_t)doc_id > (uint32_t)self->doc_max) {
@@ -64,6 +64,13 @@ TextSortCache_init(TextSortCache *self, const CharBuf *field,
     self->ix_in  = (InStream*)INCREF(ix_in);
     self->dat_in = (InStream*)INCREF(dat_in);
 
+    // Memory map the file pointers and character data.  Pages are faulted
+    // in lazily as values are requested.
+    self->ix_len  = InStream_Length(ix_in);
+    self->dat_len = InStream_Length(dat_in);
+    self->ix      = InStream_Buf(ix_in, (size_t)self->ix_len);
+    self->dat     = InStream_Buf(dat_in, (size_t)self->dat_len);
+
     return self;
 }
 
@@ -86,32 +93,43 @@ TextSortCache_destroy(TextSortCache *self) {
 
 #define NULL_SENTINEL -1
 
+static INLINE int64_t
+SI_file_pointer(TextSortCache *self, int32_t ord) {
+    const int64_t pos = (int64_t)ord * (int64_t)sizeof(int64_t);
+    if (pos < 0 || pos + (int64_t)sizeof(int64_t) > self->ix_len) {
+        THROW(ERR, "Ordinal %i32 out of range for %o", ord,
+              InStream_Get_Filename(self->ix_in));
+    }
+    return (int64_t)NumUtil_decode_bigend_u64(self->ix + pos);
+}
+
 Obj*
 TextSortCache_value(TextSortCache *self, int32_t ord, Obj *blank) {
     if (ord == self->null_ord) {
         return NULL;
     }
-    InStream_Seek(self->ix_in, ord * sizeof(int64_t));
-    int64_t offset = InStream_Read_I64(self->ix_in);
+    int64_t offset = SI_file_pointer(self, ord);
     if (offset == NULL_SENTINEL) {
         return NULL;
     }
     else {
-        uint32_t next_ord = ord + 1;
+        int32_t next_ord = ord + 1;
         int64_t next_offset;
         while (1) {
-            InStream_Seek(self->ix_in, next_ord * sizeof(int64_t));
-            next_offset = InStream_Read_I64(self->ix_in);
+            next_offset = SI_file_pointer(self, next_ord);
             if (next_offset != NULL_SENTINEL) { break; }
             next_ord++;
         }
+        if (offset > next_offset || next_offset > self->dat_len) {
+            THROW(ERR, "Bad file pointers %i64 and %i64 in %o", offset,
+                  next_offset, InStream_Get_Filename(self->ix_in));
+        }
 
-        // Read character data into CharBuf.
+        // Copy character data into CharBuf.
         CERTIFY(blank, CHARBUF);
         int64_t len = next_offset - offset;
         char *ptr = CB_Grow((CharBuf*)blank, (size_t)len);
-        InStream_Seek(self->dat_in, offset);
-        InStream_Read_Bytes(self->dat_in, ptr, (size_t)len);
+        memcpy(ptr, self->dat + offset, (size_t)len);
         ptr[len] = '\0';
         if (!StrHelp_utf8_valid(ptr, (size_t)len)) {
             CB_Set_Size((CharBuf*)blank, 0);
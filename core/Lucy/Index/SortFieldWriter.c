@@ -233,16 +233,16 @@ S_write_ord(void *ords, int32_t width, int32_t doc_id, int32_t ord) {
                 ints[doc_id] = ord;
             }
             break;
+        // Wide ords are written in native byte order so that readers can
+        // use the memory-mapped file directly; see SortWriter.
         case 16: {
-                uint8_t *bytes = (uint8_t*)ords;
-                bytes += doc_id * sizeof(uint16_t);
-                NumUtil_encode_bigend_u16(ord, &bytes);
+                uint16_t *ints = (uint16_t*)ords;
+                ints[doc_id] = (uint16_t)ord;
             }
             break;
         case 32: {
-                uint8_t *bytes = (uint8_t*)ords;
-                bytes += doc_id * sizeof(uint32_t);
-                NumUtil_encode_bigend_u32(ord, &bytes);
+                uint32_t *ints = (uint32_t*)ords;
+                ints[doc_id] = (uint32_t)ord;
             }
             break;
         default:
@@ -703,6 +703,9 @@ S_flip_run(SortFieldWriter *run, size_t sub_thresh, InStream *ord_in,
             THROW(ERR, "No SortCache class for %o", run->type);
     }
 
+    // Temp files always use the byte order of the machine writing them.
+    SortCache_Set_Native_Ords(run->sort_cache, true);
+
     DECREF(ord_in_dupe);
     DECREF(ix_in_dupe);
     DECREF(dat_in_dupe);
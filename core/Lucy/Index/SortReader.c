@@ -15,10 +15,12 @@
  */
 
 #define C_LUCY_SORTREADER
+#define C_LUCY_POLYSORTREADER
 #define C_LUCY_DEFAULTSORTREADER
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Index/SortReader.h"
+#include "Lucy/Index/OrdinalMap.h"
 #include "Lucy/Index/Segment.h"
 #include "Lucy/Index/Snapshot.h"
 #include "Lucy/Index/SortCache/NumericSortCache.h"
@@ -38,14 +40,115 @@ SortReader_init(SortReader *self, Schema *schema, Folder *folder,
     return self;
 }
 
+void
+SortReader_warm(SortReader *self) {
+    UNUSED_VAR(self);
+}
+
 DataReader*
 SortReader_aggregator(SortReader *self, VArray *readers, I32Array *offsets) {
     UNUSED_VAR(self);
-    UNUSED_VAR(readers);
-    UNUSED_VAR(offsets);
+    return (DataReader*)PolySortReader_new(readers, offsets);
+}
+
+PolySortReader*
+PolySortReader_new(VArray *readers, I32Array *offsets) {
+    PolySortReader *self = (PolySortReader*)VTable_Make_Obj(POLYSORTREADER);
+    return PolySortReader_init(self, readers, offsets);
+}
+
+PolySortReader*
+PolySortReader_init(PolySortReader *self, VArray *readers,
+                    I32Array *offsets) {
+    SortReader_init((SortReader*)self, NULL, NULL, NULL, NULL, -1);
+    for (uint32_t i = 0, max = VA_Get_Size(readers); i < max; i++) {
+        Obj *reader = VA_Fetch(readers, i);
+        if (reader) { CERTIFY(reader, SORTREADER); }
+    }
+    self->readers  = (VArray*)INCREF(readers);
+    self->offsets  = (I32Array*)INCREF(offsets);
+    self->ord_maps = Hash_new(0);
+    return self;
+}
+
+void
+PolySortReader_close(PolySortReader *self) {
+    if (self->ord_maps) {
+        Hash_Dec_RefCount(self->ord_maps);
+        self->ord_maps = NULL;
+    }
+    if (self->readers) {
+        for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+            SortReader *reader = (SortReader*)VA_Fetch(self->readers, i);
+            if (reader) { SortReader_Close(reader); }
+        }
+        VA_Clear(self->readers);
+    }
+}
+
+void
+PolySortReader_destroy(PolySortReader *self) {
+    DECREF(self->readers);
+    DECREF(self->offsets);
+    DECREF(self->ord_maps);
+    SUPER_DESTROY(self, POLYSORTREADER);
+}
+
+SortCache*
+PolySortReader_fetch_sort_cache(PolySortReader *self, const CharBuf *field) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(field);
     return NULL;
 }
 
+OrdinalMap*
+PolySortReader_fetch_ord_map(PolySortReader *self, const CharBuf *field) {
+    if (!field || !self->ord_maps) { return NULL; }
+
+    OrdinalMap *ord_map = (OrdinalMap*)Hash_Fetch(self->ord_maps, (Obj*)field);
+    if (!ord_map) {
+        uint32_t   num_readers = VA_Get_Size(self->readers);
+        VArray    *caches      = VA_new(num_readers);
+        FieldType *type        = NULL;
+        bool_t     has_values  = false;
+
+        // Gather one SortCache per segment, leaving gaps for segments
+        // without values.
+        for (uint32_t i = 0; i < num_readers; i++) {
+            SortReader *reader = (SortReader*)VA_Fetch(self->readers, i);
+            SortCache  *cache  = reader
+                                 ? SortReader_Fetch_Sort_Cache(reader, field)
+                                 : NULL;
+            if (cache) {
+                VA_Store(caches, i, INCREF(cache));
+                has_values = true;
+            }
+            if (reader && !type) {
+                Schema *schema = SortReader_Get_Schema(reader);
+                type = Schema_Fetch_Type(schema, field);
+            }
+        }
+
+        if (has_values) {
+            VA_Resize(caches, num_readers);
+            ord_map = OrdMap_new(field, type, caches);
+            Hash_Store(self->ord_maps, (Obj*)field, (Obj*)ord_map);
+        }
+        DECREF(caches);
+    }
+
+    return ord_map;
+}
+
+void
+PolySortReader_warm(PolySortReader *self) {
+    if (!self->readers) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(self->readers); i < max; i++) {
+        SortReader *reader = (SortReader*)VA_Fetch(self->readers, i);
+        if (reader) { SortReader_Warm(reader); }
+    }
+}
+
 DefaultSortReader*
 DefSortReader_new(Schema *schema, Folder *folder, Snapshot *snapshot,
                   VArray *segments, int32_t seg_tick) {
@@ -72,13 +175,29 @@ DefSortReader_init(DefaultSortReader *self, Schema *schema, Folder *folder,
         if (!format) { THROW(ERR, "Missing 'format' var"); }
         else {
             self->format = (int32_t)Obj_To_I64(format);
-            if (self->format < 2 || self->format > 3) {
+            if (self->format < 2 || self->format > 4) {
                 THROW(ERR, "Unsupported sort cache format: %i32",
                       self->format);
             }
         }
     }
 
+    // Starting with format 4, ords are written in the byte order of the
+    // machine which created the segment.
+    self->little_end_ords = false;
+    self->warm            = false;
+    if (self->format >= 4) {
+        CharBuf *byte_order
+            = (CharBuf*)CERTIFY(Hash_Fetch_Str(metadata, "byte_order", 10),
+                                CHARBUF);
+        if (CB_Equals_Str(byte_order, "little", 6)) {
+            self->little_end_ords = true;
+        }
+        else if (!CB_Equals_Str(byte_order, "big", 3)) {
+            THROW(ERR, "Unknown sort cache byte order: %o", byte_order);
+        }
+    }
+
     // Init.
     self->caches = Hash_new(0);
 
@@ -203,6 +322,15 @@ S_lazy_init_sort_cache(DefaultSortReader *self, const CharBuf *field) {
     }
     DECREF(path);
 
+    /* Warming only issues the readahead hints; the kernel pages the files
+     * in asynchronously, so the caller goes on while the I/O proceeds and
+     * there's nothing left for a background thread to do. */
+    if (self->warm) {
+        InStream_Prefetch(ord_in, 0, InStream_Length(ord_in));
+        if (ix_in) { InStream_Prefetch(ix_in, 0, InStream_Length(ix_in)); }
+        InStream_Prefetch(dat_in, 0, InStream_Length(dat_in));
+    }
+
     Obj     *null_ord_obj = Hash_Fetch(self->null_ords, (Obj*)field);
     int32_t  null_ord = null_ord_obj ? (int32_t)Obj_To_I64(null_ord_obj) : -1;
     Obj     *ord_width_obj = Hash_Fetch(self->ord_widths, (Obj*)field);
@@ -246,6 +374,16 @@ S_lazy_init_sort_cache(DefaultSortReader *self, const CharBuf *field) {
     if (self->format == 2) { // bug compatibility
         SortCache_Set_Native_Ords(cache, true);
     }
+    else if (self->format >= 4) {
+#ifdef BIG_END
+        if (self->little_end_ords) { SortCache_Swap_Ords(cache); }
+        else                       { SortCache_Set_Native_Ords(cache, true); }
+#else
+        // Big-endian ords from a foreign machine are decoded on the fly,
+        // just as with format 3.
+        if (self->little_end_ords) { SortCache_Set_Native_Ords(cache, true); }
+#endif
+    }
 
     DECREF(ord_in);
     DECREF(ix_in);
@@ -268,4 +406,20 @@ DefSortReader_fetch_sort_cache(DefaultSortReader *self, const CharBuf *field) {
     return cache;
 }
 
+void
+DefSortReader_warm(DefaultSortReader *self) {
+    if (!self->counts) { return; }
+    Schema  *schema = DefSortReader_Get_Schema(self);
+    CharBuf *field;
+    Obj     *count;
+    self->warm = true;
+    Hash_Iterate(self->counts);
+    while (Hash_Next(self->counts, (Obj**)&field, &count)) {
+        FieldType *type = Schema_Fetch_Type(schema, field);
+        if (type && FType_Sortable(type)) {
+            DefSortReader_Fetch_Sort_Cache(self, field);
+        }
+    }
+}
+
 
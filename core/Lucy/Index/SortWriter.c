@@ -36,7 +36,7 @@
 #include "Lucy/Util/MemoryPool.h"
 #include "Lucy/Util/SortUtils.h"
 
-int32_t SortWriter_current_file_format = 3;
+int32_t SortWriter_current_file_format = 4;
 
 static size_t default_mem_thresh = 0x400000; // 4 MB
 
@@ -251,6 +251,11 @@ SortWriter_metadata(SortWriter *self) {
     Hash_Store_Str(metadata, "counts", 6, INCREF(self->counts));
     Hash_Store_Str(metadata, "null_ords", 9, INCREF(self->null_ords));
     Hash_Store_Str(metadata, "ord_widths", 10, INCREF(self->ord_widths));
+#ifdef BIG_END
+    Hash_Store_Str(metadata, "byte_order", 10, (Obj*)CB_newf("big"));
+#else
+    Hash_Store_Str(metadata, "byte_order", 10, (Obj*)CB_newf("little"));
+#endif
     return metadata;
 }
 
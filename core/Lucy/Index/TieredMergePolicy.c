@@ -0,0 +1,383 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_TIEREDMERGEPOLICY
+#include "Lucy/Util/ToolSet.h"
+
+#include <math.h>
+
+#include "Lucy/Index/TieredMergePolicy.h"
+#include "Lucy/Index/DeletionsWriter.h"
+#include "Lucy/Index/PolyReader.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Util/SortUtils.h"
+
+// Sum the sizes of the files belonging to a segment.
+static int64_t
+S_seg_bytes(Folder *folder, const CharBuf *seg_name);
+
+// Sort segment indexes by descending live size.
+static int
+S_compare_live_bytes(void *context, const void *va, const void *vb);
+
+TieredMergePolicy*
+TieredMP_new() {
+    TieredMergePolicy *self
+        = (TieredMergePolicy*)VTable_Make_Obj(TIEREDMERGEPOLICY);
+    return TieredMP_init(self);
+}
+
+TieredMergePolicy*
+TieredMP_init(TieredMergePolicy *self) {
+    MergePolicy_init((MergePolicy*)self);
+    self->segs_per_tier        = 10;
+    self->max_merge_at_once    = 10;
+    self->max_merged_seg_bytes = I64_C(5) * 1024 * 1024 * 1024;
+    self->floor_seg_bytes      = I64_C(2) * 1024 * 1024;
+    self->max_del_ratio        = 0.33;
+    self->num_decisions        = 0;
+    self->num_merges           = 0;
+    self->segs_merged          = 0;
+    self->bytes_merged         = 0;
+    self->docs_reclaimed       = 0;
+    self->last_num_candidates  = 0;
+    self->last_allowed         = 0;
+    self->last_num_chosen      = 0;
+    self->last_bytes           = 0;
+    self->last_score           = 0.0;
+    return self;
+}
+
+VArray*
+TieredMP_recycle(TieredMergePolicy *self, PolyReader *reader,
+                 DeletionsWriter *del_writer, int64_t cutoff,
+                 bool_t optimize) {
+    VArray *seg_readers = PolyReader_Get_Seg_Readers(reader);
+    Folder *folder      = PolyReader_Get_Folder(reader);
+    VArray *candidates  = VA_new(VA_Get_Size(seg_readers));
+    for (uint32_t i = 0, max = VA_Get_Size(seg_readers); i < max; i++) {
+        SegReader *seg_reader
+            = (SegReader*)CERTIFY(VA_Fetch(seg_readers, i), SEGREADER);
+        if (SegReader_Get_Seg_Num(seg_reader) > cutoff) {
+            VA_Push(candidates, INCREF(seg_reader));
+        }
+    }
+
+    // Measure each candidate.
+    const uint32_t num_candidates = VA_Get_Size(candidates);
+    int64_t *seg_bytes
+        = (int64_t*)MALLOCATE((num_candidates + 1) * sizeof(int64_t));
+    double  *live_ratios
+        = (double*)MALLOCATE((num_candidates + 1) * sizeof(double));
+    int32_t *del_counts
+        = (int32_t*)MALLOCATE((num_candidates + 1) * sizeof(int32_t));
+    for (uint32_t i = 0; i < num_candidates; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(candidates, i);
+        CharBuf   *seg_name   = SegReader_Get_Seg_Name(seg_reader);
+        int32_t    doc_max    = SegReader_Doc_Max(seg_reader);
+        seg_bytes[i]   = S_seg_bytes(folder, seg_name);
+        del_counts[i]  = DelWriter_Seg_Del_Count(del_writer, seg_name);
+        live_ratios[i] = doc_max
+                         ? (double)(doc_max - del_counts[i]) / doc_max
+                         : 1.0;
+    }
+
+    // Optimizing means merging everything.
+    I32Array *chosen;
+    if (optimize) {
+        int32_t *all
+            = (int32_t*)MALLOCATE((num_candidates + 1) * sizeof(int32_t));
+        for (uint32_t i = 0; i < num_candidates; i++) { all[i] = i; }
+        chosen = I32Arr_new_steal(all, num_candidates);
+        self->last_num_candidates = num_candidates;
+        self->last_allowed        = 1;
+        self->last_num_chosen     = num_candidates;
+        self->last_score          = 0.0;
+    }
+    else {
+        chosen = TieredMP_Choose_Merge(self, seg_bytes, live_ratios,
+                                       num_candidates);
+    }
+
+    // Gather the chosen segments and keep statistics.
+    const uint32_t num_chosen = I32Arr_Get_Size(chosen);
+    VArray *recyclables = VA_new(num_chosen);
+    int64_t bytes = 0;
+    for (uint32_t i = 0; i < num_chosen; i++) {
+        int32_t tick = I32Arr_Get(chosen, i);
+        VA_Push(recyclables, INCREF(VA_Fetch(candidates, tick)));
+        bytes += seg_bytes[tick];
+        self->docs_reclaimed += del_counts[tick];
+    }
+    self->last_bytes = bytes;
+    self->num_decisions++;
+    if (num_chosen) {
+        self->num_merges++;
+        self->segs_merged  += num_chosen;
+        self->bytes_merged += bytes;
+    }
+
+    DECREF(chosen);
+    FREEMEM(del_counts);
+    FREEMEM(live_ratios);
+    FREEMEM(seg_bytes);
+    DECREF(candidates);
+    return recyclables;
+}
+
+I32Array*
+TieredMP_choose_merge(TieredMergePolicy *self, int64_t *seg_bytes,
+                      double *live_ratios, uint32_t num_segs) {
+    const double max_bytes   = (double)self->max_merged_seg_bytes;
+    const double floor_bytes = self->floor_seg_bytes > 0
+                               ? (double)self->floor_seg_bytes
+                               : 1.0;
+    const uint32_t max_merge = self->max_merge_at_once;
+    double  *live  = (double*)MALLOCATE((num_segs + 1) * sizeof(double));
+    int32_t *order = (int32_t*)MALLOCATE((num_segs + 1) * sizeof(int32_t));
+    int32_t *candidate
+        = (int32_t*)MALLOCATE((max_merge + 1) * sizeof(int32_t));
+    int32_t *best
+        = (int32_t*)MALLOCATE((max_merge + 1) * sizeof(int32_t));
+    uint32_t num_best     = 0;
+    double   best_score   = 0.0;
+    uint32_t num_eligible = 0;
+    double   total_live   = 0.0;
+
+    // Segments too large to take part in a merge don't count against the
+    // budget either.
+    for (uint32_t i = 0; i < num_segs; i++) {
+        live[i] = (double)seg_bytes[i] * live_ratios[i];
+        if (live[i] > max_bytes / 2) { continue; }
+        order[num_eligible++] = (int32_t)i;
+        total_live += live[i];
+    }
+    Sort_quicksort(order, num_eligible, sizeof(int32_t), S_compare_live_bytes,
+                   live);
+
+    // Budget Segs_Per_Tier segments at each tier, starting from the smallest
+    // segment and growing by a factor of Max_Merge_At_Once per tier.
+    double allowed    = 0.0;
+    double level_size = floor_bytes;
+    if (num_eligible && live[order[num_eligible - 1]] > level_size) {
+        level_size = live[order[num_eligible - 1]];
+    }
+    double bytes_left = total_live;
+    while (1) {
+        double segs_at_level = bytes_left / level_size;
+        if (segs_at_level < self->segs_per_tier) {
+            allowed += ceil(segs_at_level);
+            break;
+        }
+        allowed    += self->segs_per_tier;
+        bytes_left -= self->segs_per_tier * level_size;
+        level_size *= max_merge;
+    }
+    if (allowed < self->segs_per_tier) { allowed = self->segs_per_tier; }
+
+    // Over budget: score every run of similarly sized segments, starting from
+    // each position in descending order of size.  Lower scores are better.
+    if (num_eligible > allowed) {
+        for (uint32_t start = 0; start < num_eligible; start++) {
+            uint32_t num_candidate = 0;
+            double   bytes_before  = 0.0;
+            double   bytes_after   = 0.0;
+            double   floored       = 0.0;
+            double   largest       = 0.0;
+            for (uint32_t i = start;
+                 i < num_eligible && num_candidate < max_merge;
+                 i++
+                ) {
+                int32_t tick = order[i];
+                if (bytes_after + live[tick] > max_bytes) { continue; }
+                double size = live[tick] > floor_bytes
+                              ? live[tick]
+                              : floor_bytes;
+                candidate[num_candidate++] = tick;
+                bytes_before += (double)seg_bytes[tick];
+                bytes_after  += live[tick];
+                floored      += size;
+                if (size > largest) { largest = size; }
+            }
+            if (num_candidate < 2) { continue; }
+
+            // Penalize lopsided merges, big merges, and merges which don't
+            // reclaim deletions.
+            double skew      = largest / floored;
+            double live_frac = bytes_before > 0.0
+                               ? bytes_after / bytes_before
+                               : 1.0;
+            double score     = skew
+                               * pow(bytes_after > 1.0 ? bytes_after : 1.0,
+                                     0.05)
+                               * live_frac * live_frac;
+            if (!num_best || score < best_score) {
+                memcpy(best, candidate, num_candidate * sizeof(int32_t));
+                num_best   = num_candidate;
+                best_score = score;
+            }
+        }
+    }
+
+    // Within budget: rewrite the segment with the most deletions, if any
+    // segment has enough to be worth it.
+    if (!num_best) {
+        double most_deleted = self->max_del_ratio;
+        for (uint32_t i = 0; i < num_segs; i++) {
+            double del_ratio = 1.0 - live_ratios[i];
+            if (del_ratio >= most_deleted
+                && del_ratio > 0.0
+                && live[i] <= max_bytes
+               ) {
+                best[0]      = (int32_t)i;
+                num_best     = 1;
+                best_score   = live_ratios[i] * live_ratios[i];
+                most_deleted = del_ratio;
+            }
+        }
+    }
+
+    self->last_num_candidates = num_segs;
+    self->last_allowed        = (uint32_t)allowed;
+    self->last_num_chosen     = num_best;
+    self->last_score          = num_best ? best_score : 0.0;
+
+    FREEMEM(candidate);
+    FREEMEM(order);
+    FREEMEM(live);
+    return I32Arr_new_steal(best, num_best);
+}
+
+Hash*
+TieredMP_stats(TieredMergePolicy *self) {
+    Hash *stats = Hash_new(0);
+    Hash_Store_Str(stats, "decisions", 9,
+                   (Obj*)Int64_new(self->num_decisions));
+    Hash_Store_Str(stats, "merges", 6, (Obj*)Int64_new(self->num_merges));
+    Hash_Store_Str(stats, "segments_merged", 15,
+                   (Obj*)Int64_new(self->segs_merged));
+    Hash_Store_Str(stats, "bytes_merged", 12,
+                   (Obj*)Int64_new(self->bytes_merged));
+    Hash_Store_Str(stats, "docs_reclaimed", 14,
+                   (Obj*)Int64_new(self->docs_reclaimed));
+    Hash_Store_Str(stats, "last_candidates", 15,
+                   (Obj*)Int64_new(self->last_num_candidates));
+    Hash_Store_Str(stats, "last_allowed", 12,
+                   (Obj*)Int64_new(self->last_allowed));
+    Hash_Store_Str(stats, "last_chosen", 11,
+                   (Obj*)Int64_new(self->last_num_chosen));
+    Hash_Store_Str(stats, "last_bytes", 10,
+                   (Obj*)Int64_new(self->last_bytes));
+    Hash_Store_Str(stats, "last_score", 10,
+                   (Obj*)Float64_new(self->last_score));
+    return stats;
+}
+
+static int64_t
+S_seg_bytes(Folder *folder, const CharBuf *seg_name) {
+    int64_t  total = 0;
+    VArray  *files = Folder_List(folder, seg_name);
+    if (!files) { return 0; }
+    for (uint32_t i = 0, max = VA_Get_Size(files); i < max; i++) {
+        CharBuf *file = (CharBuf*)VA_Fetch(files, i);
+        // The files within a compound file are listed individually.
+        if (CB_Equals_Str(file, "cf.dat", 6)
+            || CB_Equals_Str(file, "cfmeta.json", 11)
+           ) {
+            continue;
+        }
+        CharBuf  *path     = CB_newf("%o/%o", seg_name, file);
+        InStream *instream = Folder_Open_In(folder, path);
+        if (instream) {
+            total += InStream_Length(instream);
+            DECREF(instream);
+        }
+        DECREF(path);
+    }
+    DECREF(files);
+    return total;
+}
+
+static int
+S_compare_live_bytes(void *context, const void *va, const void *vb) {
+    double *live = (double*)context;
+    double  a    = live[*(int32_t*)va];
+    double  b    = live[*(int32_t*)vb];
+    return a < b ? 1 : a > b ? -1 : 0;
+}
+
+void
+TieredMP_set_segs_per_tier(TieredMergePolicy *self, uint32_t segs_per_tier) {
+    if (segs_per_tier < 1) {
+        THROW(ERR, "Invalid value for segs_per_tier: %u32", segs_per_tier);
+    }
+    self->segs_per_tier = segs_per_tier;
+}
+
+uint32_t
+TieredMP_get_segs_per_tier(TieredMergePolicy *self) {
+    return self->segs_per_tier;
+}
+
+void
+TieredMP_set_max_merge_at_once(TieredMergePolicy *self,
+                               uint32_t max_merge_at_once) {
+    if (max_merge_at_once < 2) {
+        THROW(ERR, "Invalid value for max_merge_at_once: %u32",
+              max_merge_at_once);
+    }
+    self->max_merge_at_once = max_merge_at_once;
+}
+
+uint32_t
+TieredMP_get_max_merge_at_once(TieredMergePolicy *self) {
+    return self->max_merge_at_once;
+}
+
+void
+TieredMP_set_max_merged_seg_bytes(TieredMergePolicy *self,
+                                  int64_t max_bytes) {
+    self->max_merged_seg_bytes = max_bytes;
+}
+
+int64_t
+TieredMP_get_max_merged_seg_bytes(TieredMergePolicy *self) {
+    return self->max_merged_seg_bytes;
+}
+
+void
+TieredMP_set_floor_seg_bytes(TieredMergePolicy *self, int64_t floor_bytes) {
+    self->floor_seg_bytes = floor_bytes;
+}
+
+int64_t
+TieredMP_get_floor_seg_bytes(TieredMergePolicy *self) {
+    return self->floor_seg_bytes;
+}
+
+void
+TieredMP_set_max_del_ratio(TieredMergePolicy *self, double max_del_ratio) {
+    self->max_del_ratio = max_del_ratio;
+}
+
+double
+TieredMP_get_max_del_ratio(TieredMergePolicy *self) {
+    return self->max_del_ratio;
+}
+
+
@@ -27,6 +27,12 @@
 static void
 S_do_or_or_xor(BitVector *self, const BitVector *other, int operation);
 
+// Return a BitVector with a flat bit array holding the same bits as
+// <code>other</code>, which may be <code>other</code> itself.  Subclasses
+// such as RoaringBitmap do not store their bits contiguously.
+static BitVector*
+S_flatten(const BitVector *other);
+
 // Number of 1 bits given a u8 value.
 static const uint32_t BYTE_COUNTS[256] = {
     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
@@ -103,7 +109,7 @@ BitVec_get_capacity(BitVector *self) {
 
 void
 BitVec_mimic(BitVector *self, Obj *other) {
-    BitVector *twin = (BitVector*)CERTIFY(other, BITVECTOR);
+    BitVector *twin = S_flatten((BitVector*)CERTIFY(other, BITVECTOR));
     const uint32_t my_byte_size = (uint32_t)ceil(self->cap / 8.0);
     const uint32_t twin_byte_size = (uint32_t)ceil(twin->cap / 8.0);
     if (my_byte_size > twin_byte_size) {
@@ -114,6 +120,7 @@ BitVec_mimic(BitVector *self, Obj *other) {
         BitVec_Grow(self, twin->cap - 1);
     }
     memcpy(self->bits, twin->bits, twin_byte_size);
+    DECREF(twin);
 }
 
 void
@@ -204,11 +211,12 @@ BitVec_next_hit(BitVector *self, uint32_t tick) {
 
 void
 BitVec_and(BitVector *self, const BitVector *other) {
+    BitVector *flat = S_flatten(other);
     uint8_t *bits_a = self->bits;
-    uint8_t *bits_b = other->bits;
-    const uint32_t min_cap = self->cap < other->cap
+    uint8_t *bits_b = flat->bits;
+    const uint32_t min_cap = self->cap < flat->cap
                              ? self->cap
-                             : other->cap;
+                             : flat->cap;
     const size_t byte_size = (size_t)ceil(min_cap / 8.0);
     uint8_t *const limit = bits_a + byte_size;
 
@@ -223,16 +231,22 @@ BitVec_and(BitVector *self, const BitVector *other) {
         const size_t self_byte_size = (size_t)ceil(self->cap / 8.0);
         memset(bits_a, 0, self_byte_size - byte_size);
     }
+
+    DECREF(flat);
 }
 
 void
 BitVec_or(BitVector *self, const BitVector *other) {
-    S_do_or_or_xor(self, other, DO_OR);
+    BitVector *flat = S_flatten(other);
+    S_do_or_or_xor(self, flat, DO_OR);
+    DECREF(flat);
 }
 
 void
 BitVec_xor(BitVector *self, const BitVector *other) {
-    S_do_or_or_xor(self, other, DO_XOR);
+    BitVector *flat = S_flatten(other);
+    S_do_or_or_xor(self, flat, DO_XOR);
+    DECREF(flat);
 }
 
 static void
@@ -286,11 +300,12 @@ S_do_or_or_xor(BitVector *self, const BitVector *other, int operation) {
 
 void
 BitVec_and_not(BitVector *self, const BitVector *other) {
+    BitVector *flat = S_flatten(other);
     uint8_t *bits_a = self->bits;
-    uint8_t *bits_b = other->bits;
-    const uint32_t min_cap = self->cap < other->cap
+    uint8_t *bits_b = flat->bits;
+    const uint32_t min_cap = self->cap < flat->cap
                              ? self->cap
-                             : other->cap;
+                             : flat->cap;
     const size_t byte_size = (size_t)ceil(min_cap / 8.0);
     uint8_t *const limit = bits_a + byte_size;
 
@@ -299,6 +314,25 @@ BitVec_and_not(BitVector *self, const BitVector *other) {
         *bits_a &= ~(*bits_b);
         bits_a++, bits_b++;
     }
+
+    DECREF(flat);
+}
+
+static BitVector*
+S_flatten(const BitVector *other) {
+    if (other->bits || !other->cap) {
+        return (BitVector*)INCREF((BitVector*)other);
+    }
+    else {
+        BitVector *source = (BitVector*)other;
+        BitVector *flat   = BitVec_new(BitVec_Get_Capacity(source));
+        int32_t    tick   = BitVec_Next_Hit(source, 0);
+        while (tick != -1) {
+            BitVec_Set(flat, (uint32_t)tick);
+            tick = BitVec_Next_Hit(source, (uint32_t)tick + 1);
+        }
+        return flat;
+    }
 }
 
 void
@@ -0,0 +1,809 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_ROARINGBITMAP
+#define C_LUCY_BITVECTOR
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Object/RoaringBitmap.h"
+
+// Container types.
+#define CONT_ARRAY  1
+#define CONT_BITMAP 2
+#define CONT_RUN    3
+
+// Array containers are converted to bitmaps once they would exceed the size
+// of a bitmap: 4096 16-bit values occupy 8 kB, same as 65536 bits.
+#define ARRAY_MAX    4096
+#define BITMAP_WORDS 1024
+
+// Operations for S_binary_op.
+#define OP_AND     1
+#define OP_OR      2
+#define OP_XOR     3
+#define OP_AND_NOT 4
+
+/* One chunk of 65536 ticks, all sharing the same high 16 bits ("key").
+ *
+ *   CONT_ARRAY:  <data> is a sorted uint16_t array of <size> values.
+ *   CONT_BITMAP: <data> is an array of BITMAP_WORDS uint64_t words.
+ *   CONT_RUN:    <data> is a uint16_t array of <size> inclusive
+ *                (first, last) pairs, sorted and non-adjacent.
+ */
+typedef struct {
+    uint16_t  key;
+    uint8_t   type;
+    uint32_t  card;
+    uint32_t  size;
+    uint32_t  cap;
+    void     *data;
+} Container;
+
+static INLINE uint32_t
+SI_popcount64(uint64_t word) {
+#ifdef __GNUC__
+    return (uint32_t)__builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & U64_C(0x5555555555555555));
+    word = (word & U64_C(0x3333333333333333))
+           + ((word >> 2) & U64_C(0x3333333333333333));
+    word = (word + (word >> 4)) & U64_C(0x0F0F0F0F0F0F0F0F);
+    return (uint32_t)((word * U64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+// Return the index of the lowest set bit in a non-zero word.
+static INLINE uint32_t
+SI_ctz64(uint64_t word) {
+#ifdef __GNUC__
+    return (uint32_t)__builtin_ctzll(word);
+#else
+    uint32_t count = 0;
+    while (!(word & 1)) { word >>= 1; count++; }
+    return count;
+#endif
+}
+
+static uint32_t
+S_popcount_words(const uint64_t *words) {
+    uint32_t card = 0;
+    for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+        card += SI_popcount64(words[i]);
+    }
+    return card;
+}
+
+/***************************** Containers ********************************/
+
+static void
+S_cont_init(Container *cont, uint16_t key) {
+    cont->key  = key;
+    cont->type = CONT_ARRAY;
+    cont->card = 0;
+    cont->size = 0;
+    cont->cap  = 0;
+    cont->data = NULL;
+}
+
+static void
+S_cont_free(Container *cont) {
+    FREEMEM(cont->data);
+    cont->data = NULL;
+}
+
+static void
+S_cont_copy(Container *dest, const Container *source) {
+    size_t bytes = 0;
+    *dest = *source;
+    switch (source->type) {
+        case CONT_ARRAY:  bytes = source->size * sizeof(uint16_t);     break;
+        case CONT_BITMAP: bytes = BITMAP_WORDS * sizeof(uint64_t);     break;
+        case CONT_RUN:    bytes = source->size * 2 * sizeof(uint16_t); break;
+    }
+    dest->cap  = source->type == CONT_BITMAP ? 0 : source->size;
+    dest->data = bytes ? MALLOCATE(bytes) : NULL;
+    if (bytes) { memcpy(dest->data, source->data, bytes); }
+}
+
+// OR the container's values into a bitmap.
+static void
+S_cont_fill_words(const Container *cont, uint64_t *words) {
+    if (cont->type == CONT_BITMAP) {
+        const uint64_t *source = (const uint64_t*)cont->data;
+        for (uint32_t i = 0; i < BITMAP_WORDS; i++) { words[i] |= source[i]; }
+    }
+    else if (cont->type == CONT_ARRAY) {
+        const uint16_t *vals = (const uint16_t*)cont->data;
+        for (uint32_t i = 0; i < cont->size; i++) {
+            words[vals[i] >> 6] |= U64_C(1) << (vals[i] & 63);
+        }
+    }
+    else {
+        const uint16_t *runs = (const uint16_t*)cont->data;
+        for (uint32_t i = 0; i < cont->size; i++) {
+            for (uint32_t val = runs[i * 2]; val <= runs[i * 2 + 1]; val++) {
+                words[val >> 6] |= U64_C(1) << (val & 63);
+            }
+        }
+    }
+}
+
+// Replace the container's contents with the supplied bitmap, picking an
+// array or a bitmap depending on cardinality.
+static void
+S_cont_set_words(Container *cont, const uint64_t *words) {
+    const uint32_t card = S_popcount_words(words);
+    S_cont_free(cont);
+    cont->card = card;
+    if (card > ARRAY_MAX) {
+        cont->type = CONT_BITMAP;
+        cont->size = 0;
+        cont->cap  = 0;
+        cont->data = MALLOCATE(BITMAP_WORDS * sizeof(uint64_t));
+        memcpy(cont->data, words, BITMAP_WORDS * sizeof(uint64_t));
+    }
+    else {
+        uint16_t *vals = card
+                         ? (uint16_t*)MALLOCATE(card * sizeof(uint16_t))
+                         : NULL;
+        uint32_t  num  = 0;
+        for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+            uint64_t word = words[i];
+            while (word) {
+                vals[num++] = (uint16_t)((i << 6) + SI_ctz64(word));
+                word &= word - 1;
+            }
+        }
+        cont->type = CONT_ARRAY;
+        cont->size = card;
+        cont->cap  = card;
+        cont->data = vals;
+    }
+}
+
+// Convert a run container to an array or bitmap so that it may be modified.
+static void
+S_cont_unrun(Container *cont) {
+    if (cont->type == CONT_RUN) {
+        uint64_t words[BITMAP_WORDS];
+        memset(words, 0, sizeof(words));
+        S_cont_fill_words(cont, words);
+        S_cont_set_words(cont, words);
+    }
+}
+
+// Binary search a sorted uint16_t array.  Return the index of the value if
+// found, or -(insertion point) - 1 if not.
+static int32_t
+S_search_u16(const uint16_t *vals, uint32_t size, uint16_t target) {
+    int32_t lo = 0;
+    int32_t hi = (int32_t)size - 1;
+    while (lo <= hi) {
+        const int32_t mid = lo + ((hi - lo) / 2);
+        if (vals[mid] < target)      { lo = mid + 1; }
+        else if (vals[mid] > target) { hi = mid - 1; }
+        else                         { return mid; }
+    }
+    return -(lo + 1);
+}
+
+static bool_t
+S_cont_get(const Container *cont, uint16_t low) {
+    if (cont->type == CONT_BITMAP) {
+        const uint64_t *words = (const uint64_t*)cont->data;
+        return (words[low >> 6] >> (low & 63)) & 1 ? true : false;
+    }
+    else if (cont->type == CONT_ARRAY) {
+        return S_search_u16((const uint16_t*)cont->data, cont->size, low) >= 0
+               ? true : false;
+    }
+    else {
+        const uint16_t *runs = (const uint16_t*)cont->data;
+        int32_t lo = 0;
+        int32_t hi = (int32_t)cont->size - 1;
+        while (lo <= hi) {
+            const int32_t mid = lo + ((hi - lo) / 2);
+            if (runs[mid * 2 + 1] < low)  { lo = mid + 1; }
+            else if (runs[mid * 2] > low) { hi = mid - 1; }
+            else                          { return true; }
+        }
+        return false;
+    }
+}
+
+// Add a value.  Return true if it was not already present.
+static bool_t
+S_cont_add(Container *cont, uint16_t low) {
+    if (S_cont_get(cont, low)) { return false; }
+    S_cont_unrun(cont);
+    if (cont->type == CONT_ARRAY && cont->card == ARRAY_MAX) {
+        uint64_t words[BITMAP_WORDS];
+        memset(words, 0, sizeof(words));
+        S_cont_fill_words(cont, words);
+        S_cont_free(cont);
+        cont->type = CONT_BITMAP;
+        cont->size = 0;
+        cont->cap  = 0;
+        cont->data = MALLOCATE(sizeof(words));
+        memcpy(cont->data, words, sizeof(words));
+    }
+    if (cont->type == CONT_BITMAP) {
+        uint64_t *words = (uint64_t*)cont->data;
+        words[low >> 6] |= U64_C(1) << (low & 63);
+    }
+    else {
+        int32_t pos = -(S_search_u16((uint16_t*)cont->data, cont->size, low)
+                        + 1);
+        if (cont->size == cont->cap) {
+            cont->cap  = cont->cap ? cont->cap * 2 : 4;
+            if (cont->cap > ARRAY_MAX) { cont->cap = ARRAY_MAX; }
+            cont->data = REALLOCATE(cont->data, cont->cap * sizeof(uint16_t));
+        }
+        uint16_t *vals = (uint16_t*)cont->data;
+        memmove(vals + pos + 1, vals + pos,
+                (cont->size - pos) * sizeof(uint16_t));
+        vals[pos] = low;
+        cont->size++;
+    }
+    cont->card++;
+    return true;
+}
+
+// Remove a value.  Return true if it was present.
+static bool_t
+S_cont_remove(Container *cont, uint16_t low) {
+    if (!S_cont_get(cont, low)) { return false; }
+    S_cont_unrun(cont);
+    if (cont->type == CONT_BITMAP) {
+        uint64_t *words = (uint64_t*)cont->data;
+        words[low >> 6] &= ~(U64_C(1) << (low & 63));
+        if (--cont->card <= ARRAY_MAX / 2) {
+            uint64_t copy[BITMAP_WORDS];
+            memcpy(copy, words, sizeof(copy));
+            S_cont_set_words(cont, copy);
+        }
+    }
+    else {
+        uint16_t *vals = (uint16_t*)cont->data;
+        int32_t   pos  = S_search_u16(vals, cont->size, low);
+        memmove(vals + pos, vals + pos + 1,
+                (cont->size - pos - 1) * sizeof(uint16_t));
+        cont->size--;
+        cont->card--;
+    }
+    return true;
+}
+
+// Return the lowest value in the container which is >= <code>low</code>, or
+// -1 if there is none.
+static int32_t
+S_cont_next(const Container *cont, uint32_t low) {
+    if (low > 0xFFFF) { return -1; }
+    if (cont->type == CONT_BITMAP) {
+        const uint64_t *words = (const uint64_t*)cont->data;
+        uint32_t tick = low >> 6;
+        uint64_t word = words[tick] & (~U64_C(0) << (low & 63));
+        while (1) {
+            if (word) { return (int32_t)((tick << 6) + SI_ctz64(word)); }
+            if (++tick == BITMAP_WORDS) { return -1; }
+            word = words[tick];
+        }
+    }
+    else if (cont->type == CONT_ARRAY) {
+        const uint16_t *vals = (const uint16_t*)cont->data;
+        int32_t pos = S_search_u16(vals, cont->size, (uint16_t)low);
+        if (pos < 0) { pos = -(pos + 1); }
+        return (uint32_t)pos < cont->size ? vals[pos] : -1;
+    }
+    else {
+        const uint16_t *runs = (const uint16_t*)cont->data;
+        for (uint32_t i = 0; i < cont->size; i++) {
+            if (runs[i * 2 + 1] >= low) {
+                return runs[i * 2] > low ? runs[i * 2] : (int32_t)low;
+            }
+        }
+        return -1;
+    }
+}
+
+// Count the runs of consecutive values in the container.
+static uint32_t
+S_cont_count_runs(const Container *cont) {
+    uint32_t num_runs = 0;
+    if (cont->type == CONT_RUN) {
+        num_runs = cont->size;
+    }
+    else if (cont->type == CONT_ARRAY) {
+        const uint16_t *vals = (const uint16_t*)cont->data;
+        for (uint32_t i = 0; i < cont->size; i++) {
+            if (i == 0 || vals[i] != vals[i - 1] + 1) { num_runs++; }
+        }
+    }
+    else {
+        const uint64_t *words = (const uint64_t*)cont->data;
+        uint64_t carry = 0;
+        for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+            // A run starts wherever a set bit follows a clear bit.
+            num_runs += SI_popcount64(words[i] & ~((words[i] << 1) | carry));
+            carry = words[i] >> 63;
+        }
+    }
+    return num_runs;
+}
+
+static void
+S_cont_to_runs(Container *cont, uint32_t num_runs) {
+    uint16_t *runs = (uint16_t*)MALLOCATE(num_runs * 2 * sizeof(uint16_t));
+    uint32_t  size = 0;
+    int32_t   val  = S_cont_next(cont, 0);
+    while (val != -1) {
+        int32_t last = val;
+        int32_t next;
+        while ((next = S_cont_next(cont, (uint32_t)last + 1)) == last + 1) {
+            last = next;
+        }
+        runs[size * 2]     = (uint16_t)val;
+        runs[size * 2 + 1] = (uint16_t)last;
+        size++;
+        val = next;
+    }
+    S_cont_free(cont);
+    cont->type = CONT_RUN;
+    cont->size = size;
+    cont->cap  = size;
+    cont->data = runs;
+}
+
+static uint64_t
+S_cont_bytes(const Container *cont) {
+    switch (cont->type) {
+        case CONT_ARRAY:  return (uint64_t)cont->cap * sizeof(uint16_t);
+        case CONT_BITMAP: return BITMAP_WORDS * sizeof(uint64_t);
+        default:          return (uint64_t)cont->cap * 2 * sizeof(uint16_t);
+    }
+}
+
+// Combine container <code>b</code> into <code>a</code>.
+static void
+S_cont_op(Container *a, const Container *b, int op) {
+    if ((op == OP_AND || op == OP_AND_NOT) && a->type == CONT_ARRAY) {
+        // Probe the other container for each of our values.
+        uint16_t *vals = (uint16_t*)a->data;
+        uint32_t  num  = 0;
+        for (uint32_t i = 0; i < a->size; i++) {
+            bool_t in_b = S_cont_get(b, vals[i]);
+            if (op == OP_AND ? in_b : !in_b) { vals[num++] = vals[i]; }
+        }
+        a->size = num;
+        a->card = num;
+    }
+    else if (op == OP_AND && b->type == CONT_ARRAY) {
+        const uint16_t *b_vals = (const uint16_t*)b->data;
+        uint16_t *vals = b->size
+                         ? (uint16_t*)MALLOCATE(b->size * sizeof(uint16_t))
+                         : NULL;
+        uint32_t  num  = 0;
+        for (uint32_t i = 0; i < b->size; i++) {
+            if (S_cont_get(a, b_vals[i])) { vals[num++] = b_vals[i]; }
+        }
+        S_cont_free(a);
+        a->type = CONT_ARRAY;
+        a->data = vals;
+        a->size = num;
+        a->cap  = b->size;
+        a->card = num;
+    }
+    else {
+        // General case: operate on whole bitmaps, a word at a time.
+        uint64_t words_a[BITMAP_WORDS];
+        uint64_t words_b[BITMAP_WORDS];
+        memset(words_a, 0, sizeof(words_a));
+        memset(words_b, 0, sizeof(words_b));
+        S_cont_fill_words(a, words_a);
+        S_cont_fill_words(b, words_b);
+        switch (op) {
+            case OP_AND:
+                for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+                    words_a[i] &= words_b[i];
+                }
+                break;
+            case OP_OR:
+                for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+                    words_a[i] |= words_b[i];
+                }
+                break;
+            case OP_XOR:
+                for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+                    words_a[i] ^= words_b[i];
+                }
+                break;
+            case OP_AND_NOT:
+                for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+                    words_a[i] &= ~words_b[i];
+                }
+                break;
+            default:
+                THROW(ERR, "Unrecognized operation: %i32", (int32_t)op);
+        }
+        S_cont_set_words(a, words_a);
+    }
+}
+
+/**************************** RoaringBitmap ******************************/
+
+// Find the container for <code>key</code>.  Return its index if found, or
+// -(insertion point) - 1 if not.
+static int32_t
+S_find_container(RoaringBitmap *self, uint16_t key) {
+    Container *conts = (Container*)self->containers;
+    int32_t lo = 0;
+    int32_t hi = (int32_t)self->num_containers - 1;
+    while (lo <= hi) {
+        const int32_t mid = lo + ((hi - lo) / 2);
+        if (conts[mid].key < key)      { lo = mid + 1; }
+        else if (conts[mid].key > key) { hi = mid - 1; }
+        else                           { return mid; }
+    }
+    return -(lo + 1);
+}
+
+static void
+S_grow_containers(RoaringBitmap *self, uint32_t min_size) {
+    if (min_size > self->max_containers) {
+        size_t amount = Memory_oversize(min_size, sizeof(Container));
+        self->containers = REALLOCATE(self->containers,
+                                      amount * sizeof(Container));
+        self->max_containers = (uint32_t)amount;
+    }
+}
+
+// Return the container for <code>key</code>, creating it if necessary.
+static Container*
+S_fetch_or_create(RoaringBitmap *self, uint16_t key) {
+    int32_t pos = S_find_container(self, key);
+    if (pos < 0) {
+        pos = -(pos + 1);
+        S_grow_containers(self, self->num_containers + 1);
+        Container *conts = (Container*)self->containers;
+        memmove(conts + pos + 1, conts + pos,
+                (self->num_containers - pos) * sizeof(Container));
+        S_cont_init(conts + pos, key);
+        self->num_containers++;
+    }
+    return (Container*)self->containers + pos;
+}
+
+static void
+S_remove_container(RoaringBitmap *self, uint32_t pos) {
+    Container *conts = (Container*)self->containers;
+    S_cont_free(conts + pos);
+    memmove(conts + pos, conts + pos + 1,
+            (self->num_containers - pos - 1) * sizeof(Container));
+    self->num_containers--;
+}
+
+static void
+S_bump_cap(RoaringBitmap *self, uint32_t tick) {
+    if (tick >= self->cap) { self->cap = tick + 1; }
+}
+
+RoaringBitmap*
+Roaring_new() {
+    RoaringBitmap *self = (RoaringBitmap*)VTable_Make_Obj(ROARINGBITMAP);
+    return Roaring_init(self);
+}
+
+RoaringBitmap*
+Roaring_init(RoaringBitmap *self) {
+    BitVec_init((BitVector*)self, 0);
+    self->containers     = NULL;
+    self->num_containers = 0;
+    self->max_containers = 0;
+    return self;
+}
+
+void
+Roaring_destroy(RoaringBitmap *self) {
+    Roaring_Clear_All(self);
+    FREEMEM(self->containers);
+    SUPER_DESTROY(self, ROARINGBITMAP);
+}
+
+RoaringBitmap*
+Roaring_clone(RoaringBitmap *self) {
+    RoaringBitmap *twin = Roaring_new();
+    Roaring_Mimic(twin, (Obj*)self);
+    return twin;
+}
+
+uint8_t*
+Roaring_get_raw_bits(RoaringBitmap *self) {
+    UNUSED_VAR(self);
+    return NULL;
+}
+
+void
+Roaring_grow(RoaringBitmap *self, uint32_t capacity) {
+    if (capacity > self->cap) { self->cap = capacity; }
+}
+
+bool_t
+Roaring_get(RoaringBitmap *self, uint32_t tick) {
+    int32_t pos = S_find_container(self, (uint16_t)(tick >> 16));
+    if (pos < 0) { return false; }
+    return S_cont_get((Container*)self->containers + pos,
+                      (uint16_t)(tick & 0xFFFF));
+}
+
+void
+Roaring_set(RoaringBitmap *self, uint32_t tick) {
+    Container *cont = S_fetch_or_create(self, (uint16_t)(tick >> 16));
+    S_cont_add(cont, (uint16_t)(tick & 0xFFFF));
+    S_bump_cap(self, tick);
+}
+
+void
+Roaring_clear(RoaringBitmap *self, uint32_t tick) {
+    int32_t pos = S_find_container(self, (uint16_t)(tick >> 16));
+    if (pos >= 0) {
+        Container *cont = (Container*)self->containers + pos;
+        S_cont_remove(cont, (uint16_t)(tick & 0xFFFF));
+        if (!cont->card) { S_remove_container(self, (uint32_t)pos); }
+    }
+}
+
+void
+Roaring_clear_all(RoaringBitmap *self) {
+    Container *conts = (Container*)self->containers;
+    for (uint32_t i = 0; i < self->num_containers; i++) {
+        S_cont_free(conts + i);
+    }
+    self->num_containers = 0;
+}
+
+void
+Roaring_flip(RoaringBitmap *self, uint32_t tick) {
+    if (Roaring_Get(self, tick)) { Roaring_Clear(self, tick); }
+    else                         { Roaring_Set(self, tick); }
+}
+
+void
+Roaring_flip_block(RoaringBitmap *self, uint32_t offset, uint32_t length) {
+    if (!length) { return; }
+    const uint32_t last = offset + length - 1;
+    uint32_t first = offset;
+    while (1) {
+        const uint16_t key        = (uint16_t)(first >> 16);
+        const uint32_t chunk_last = (last >> 16) == key
+                                    ? (last & 0xFFFF)
+                                    : 0xFFFF;
+        Container *cont = S_fetch_or_create(self, key);
+        uint64_t   words[BITMAP_WORDS];
+        memset(words, 0, sizeof(words));
+        S_cont_fill_words(cont, words);
+        for (uint32_t val = first & 0xFFFF; val <= chunk_last; val++) {
+            words[val >> 6] ^= U64_C(1) << (val & 63);
+        }
+        S_cont_set_words(cont, words);
+        if (!cont->card) {
+            S_remove_container(self, (uint32_t)S_find_container(self, key));
+        }
+        if ((last >> 16) == key) { break; }
+        first = ((uint32_t)key + 1) << 16;
+    }
+    S_bump_cap(self, last);
+}
+
+int32_t
+Roaring_next_hit(RoaringBitmap *self, uint32_t tick) {
+    Container *conts = (Container*)self->containers;
+    int32_t    pos   = S_find_container(self, (uint16_t)(tick >> 16));
+    uint32_t   low   = tick & 0xFFFF;
+    if (pos < 0) {
+        pos = -(pos + 1);
+        low = 0;
+    }
+    for (uint32_t i = (uint32_t)pos; i < self->num_containers; i++) {
+        int32_t val = S_cont_next(conts + i, low);
+        if (val != -1) {
+            return (int32_t)(((uint32_t)conts[i].key << 16) | (uint32_t)val);
+        }
+        low = 0;
+    }
+    return -1;
+}
+
+uint32_t
+Roaring_count(RoaringBitmap *self) {
+    Container *conts = (Container*)self->containers;
+    uint32_t   count = 0;
+    for (uint32_t i = 0; i < self->num_containers; i++) {
+        count += conts[i].card;
+    }
+    return count;
+}
+
+I32Array*
+Roaring_to_array(RoaringBitmap *self) {
+    uint32_t  count = Roaring_Count(self);
+    int32_t  *ints  = (int32_t*)MALLOCATE((count ? count : 1)
+                                          * sizeof(int32_t));
+    uint32_t  num   = 0;
+    int32_t   tick  = Roaring_Next_Hit(self, 0);
+    while (tick != -1 && num < count) {
+        ints[num++] = tick;
+        tick = Roaring_Next_Hit(self, (uint32_t)tick + 1);
+    }
+    return I32Arr_new_steal(ints, num);
+}
+
+void
+Roaring_mimic(RoaringBitmap *self, Obj *other) {
+    BitVector *bit_vec = (BitVector*)CERTIFY(other, BITVECTOR);
+    if ((Obj*)self == other) { return; }
+    Roaring_Clear_All(self);
+    self->cap = BitVec_Get_Capacity(bit_vec);
+
+    if (Obj_Is_A(other, ROARINGBITMAP)) {
+        RoaringBitmap *twin = (RoaringBitmap*)other;
+        S_grow_containers(self, twin->num_containers);
+        Container *conts      = (Container*)self->containers;
+        Container *twin_conts = (Container*)twin->containers;
+        for (uint32_t i = 0; i < twin->num_containers; i++) {
+            S_cont_copy(conts + i, twin_conts + i);
+        }
+        self->num_containers = twin->num_containers;
+    }
+    else {
+        // Read the flat bit array one chunk at a time.  Bit N lives in byte
+        // N / 8 of the array.
+        const uint8_t *bits      = BitVec_Get_Raw_Bits(bit_vec);
+        const uint32_t byte_size = (BitVec_Get_Capacity(bit_vec) + 7) / 8;
+        for (uint32_t start = 0; bits && start < byte_size; start += 8192) {
+            uint64_t words[BITMAP_WORDS];
+            uint32_t end = start + 8192 < byte_size ? start + 8192 : byte_size;
+            bool_t   any = false;
+            memset(words, 0, sizeof(words));
+            for (uint32_t i = start; i < end; i++) {
+                if (bits[i]) {
+                    const uint32_t offset = i - start;
+                    words[offset >> 3]
+                        |= (uint64_t)bits[i] << ((offset & 7) * 8);
+                    any = true;
+                }
+            }
+            if (any) {
+                Container *cont = S_fetch_or_create(self,
+                                                    (uint16_t)(start >> 13));
+                S_cont_set_words(cont, words);
+            }
+        }
+    }
+}
+
+// Produce a RoaringBitmap version of <code>other</code>, which may be
+// <code>other</code> itself unless it is also <code>self</code>.
+static RoaringBitmap*
+S_roaring_version(RoaringBitmap *self, const BitVector *other) {
+    if ((const BitVector*)self == other) {
+        return Roaring_Clone(self);
+    }
+    else if (Obj_Is_A((Obj*)other, ROARINGBITMAP)) {
+        return (RoaringBitmap*)INCREF((BitVector*)other);
+    }
+    else {
+        RoaringBitmap *twin = Roaring_new();
+        Roaring_Mimic(twin, (Obj*)other);
+        return twin;
+    }
+}
+
+static void
+S_binary_op(RoaringBitmap *self, const BitVector *other_bv, int op) {
+    RoaringBitmap *other      = S_roaring_version(self, other_bv);
+    Container     *a_conts    = (Container*)self->containers;
+    Container     *b_conts    = (Container*)other->containers;
+    uint32_t       num_a      = self->num_containers;
+    uint32_t       num_b      = other->num_containers;
+    uint32_t       max_result = num_a + num_b;
+    Container     *result
+        = (Container*)MALLOCATE((max_result ? max_result : 1)
+                                * sizeof(Container));
+    uint32_t       num_result = 0;
+    uint32_t       i = 0, j = 0;
+
+    while (i < num_a || j < num_b) {
+        if (j == num_b || (i < num_a && a_conts[i].key < b_conts[j].key)) {
+            // Key present only in self.
+            if (op == OP_AND) { S_cont_free(a_conts + i); }
+            else              { result[num_result++] = a_conts[i]; }
+            i++;
+        }
+        else if (i == num_a || b_conts[j].key < a_conts[i].key) {
+            // Key present only in other.
+            if (op == OP_OR || op == OP_XOR) {
+                S_cont_copy(result + num_result++, b_conts + j);
+            }
+            j++;
+        }
+        else {
+            Container cont = a_conts[i];
+            S_cont_op(&cont, b_conts + j, op);
+            if (cont.card) { result[num_result++] = cont; }
+            else           { S_cont_free(&cont); }
+            i++, j++;
+        }
+    }
+
+    FREEMEM(self->containers);
+    self->containers     = result;
+    self->num_containers = num_result;
+    self->max_containers = max_result ? max_result : 1;
+    if (op == OP_OR || op == OP_XOR) {
+        uint32_t other_cap = BitVec_Get_Capacity((BitVector*)other_bv);
+        if (other_cap > self->cap) { self->cap = other_cap; }
+    }
+    DECREF(other);
+}
+
+void
+Roaring_and(RoaringBitmap *self, const BitVector *other) {
+    S_binary_op(self, other, OP_AND);
+}
+
+void
+Roaring_or(RoaringBitmap *self, const BitVector *other) {
+    S_binary_op(self, other, OP_OR);
+}
+
+void
+Roaring_xor(RoaringBitmap *self, const BitVector *other) {
+    S_binary_op(self, other, OP_XOR);
+}
+
+void
+Roaring_and_not(RoaringBitmap *self, const BitVector *other) {
+    S_binary_op(self, other, OP_AND_NOT);
+}
+
+void
+Roaring_run_optimize(RoaringBitmap *self) {
+    Container *conts = (Container*)self->containers;
+    for (uint32_t i = 0; i < self->num_containers; i++) {
+        Container *cont = conts + i;
+        if (cont->type == CONT_RUN) { continue; }
+        uint32_t num_runs  = S_cont_count_runs(cont);
+        uint64_t run_bytes = (uint64_t)num_runs * 2 * sizeof(uint16_t);
+        uint64_t cur_bytes = cont->type == CONT_BITMAP
+                             ? BITMAP_WORDS * sizeof(uint64_t)
+                             : (uint64_t)cont->card * sizeof(uint16_t);
+        if (run_bytes < cur_bytes) {
+            S_cont_to_runs(cont, num_runs);
+        }
+    }
+}
+
+uint64_t
+Roaring_memory_usage(RoaringBitmap *self) {
+    Container *conts = (Container*)self->containers;
+    uint64_t   bytes = (uint64_t)self->max_containers * sizeof(Container);
+    for (uint32_t i = 0; i < self->num_containers; i++) {
+        bytes += S_cont_bytes(conts + i);
+    }
+    return bytes;
+}
+
+
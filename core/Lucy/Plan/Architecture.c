@@ -22,6 +22,8 @@
 #include "Lucy/Index/DeletionsWriter.h"
 #include "Lucy/Index/DocReader.h"
 #include "Lucy/Index/DocWriter.h"
+#include "Lucy/Index/DocValuesReader.h"
+#include "Lucy/Index/DocValuesWriter.h"
 #include "Lucy/Index/HighlightReader.h"
 #include "Lucy/Index/HighlightWriter.h"
 #include "Lucy/Index/LexiconReader.h"
@@ -63,6 +65,7 @@ Arch_init_seg_writer(Architecture *self, SegWriter *writer) {
     Arch_Register_Lexicon_Writer(self, writer);
     Arch_Register_Posting_List_Writer(self, writer);
     Arch_Register_Sort_Writer(self, writer);
+    Arch_Register_Doc_Values_Writer(self, writer);
     Arch_Register_Doc_Writer(self, writer);
     Arch_Register_Highlight_Writer(self, writer);
     Arch_Register_Deletions_Writer(self, writer);
@@ -131,6 +134,20 @@ Arch_register_sort_writer(Architecture *self, SegWriter *writer) {
     SegWriter_Add_Writer(writer, (DataWriter*)INCREF(sort_writer));
 }
 
+void
+Arch_register_doc_values_writer(Architecture *self, SegWriter *writer) {
+    Schema     *schema     = SegWriter_Get_Schema(writer);
+    Snapshot   *snapshot   = SegWriter_Get_Snapshot(writer);
+    Segment    *segment    = SegWriter_Get_Segment(writer);
+    PolyReader *polyreader = SegWriter_Get_PolyReader(writer);
+    DocValuesWriter *dv_writer
+        = DocValuesWriter_new(schema, snapshot, segment, polyreader);
+    UNUSED_VAR(self);
+    SegWriter_Register(writer, VTable_Get_Name(DOCVALUESWRITER),
+                       (DataWriter*)dv_writer);
+    SegWriter_Add_Writer(writer, (DataWriter*)INCREF(dv_writer));
+}
+
 void
 Arch_register_highlight_writer(Architecture *self, SegWriter *writer) {
     Schema     *schema     = SegWriter_Get_Schema(writer);
@@ -165,6 +182,7 @@ Arch_init_seg_reader(Architecture *self, SegReader *reader) {
     Arch_Register_Lexicon_Reader(self, reader);
     Arch_Register_Posting_List_Reader(self, reader);
     Arch_Register_Sort_Reader(self, reader);
+    Arch_Register_Doc_Values_Reader(self, reader);
     Arch_Register_Highlight_Reader(self, reader);
     Arch_Register_Deletions_Reader(self, reader);
 }
@@ -228,6 +246,21 @@ Arch_register_sort_reader(Architecture *self, SegReader *reader) {
                        (DataReader*)sort_reader);
 }
 
+void
+Arch_register_doc_values_reader(Architecture *self, SegReader *reader) {
+    Schema     *schema   = SegReader_Get_Schema(reader);
+    Folder     *folder   = SegReader_Get_Folder(reader);
+    VArray     *segments = SegReader_Get_Segments(reader);
+    Snapshot   *snapshot = SegReader_Get_Snapshot(reader);
+    int32_t     seg_tick = SegReader_Get_Seg_Tick(reader);
+    DefaultDocValuesReader *dv_reader
+        = DefDocValuesReader_new(schema, folder, snapshot, segments,
+                                 seg_tick);
+    UNUSED_VAR(self);
+    SegReader_Register(reader, VTable_Get_Name(DOCVALUESREADER),
+                       (DataReader*)dv_reader);
+}
+
 void
 Arch_register_highlight_reader(Architecture *self, SegReader *reader) {
     Schema     *schema   = SegReader_Get_Schema(reader);
@@ -274,4 +307,10 @@ Arch_skip_interval(Architecture *self) {
     return 16;
 }
 
+int32_t
+Arch_doc_block_size(Architecture *self) {
+    UNUSED_VAR(self);
+    return 0;
+}
+
 
@@ -80,6 +80,9 @@ BlobType_dump_for_schema(BlobType *self) {
     if (self->stored) {
         Hash_Store_Str(dump, "stored", 6, (Obj*)CFISH_TRUE);
     }
+    if (self->doc_values) {
+        Hash_Store_Str(dump, "doc_values", 10, (Obj*)CFISH_TRUE);
+    }
 
     return dump;
 }
@@ -105,12 +108,14 @@ BlobType_load(BlobType *self, Obj *dump) {
     Obj *boost_dump      = Hash_Fetch_Str(source, "boost", 5);
     Obj *indexed_dump    = Hash_Fetch_Str(source, "indexed", 7);
     Obj *stored_dump     = Hash_Fetch_Str(source, "stored", 6);
+    Obj *dv_dump         = Hash_Fetch_Str(source, "doc_values", 10);
     UNUSED_VAR(self);
 
     BlobType_init(loaded, false);
     if (boost_dump)   { loaded->boost   = (float)Obj_To_F64(boost_dump);    }
     if (indexed_dump) { loaded->indexed = Obj_To_Bool(indexed_dump); }
     if (stored_dump)  { loaded->stored  = Obj_To_Bool(stored_dump);  }
+    if (dv_dump)      { loaded->doc_values = Obj_To_Bool(dv_dump);   }
 
     return loaded;
 }
@@ -24,16 +24,18 @@
 
 FieldType*
 FType_init(FieldType *self) {
-    return FType_init2(self, 1.0f, false, false, false);
+    return FType_init2(self, 1.0f, false, false, false, false, false);
 }
 
 FieldType*
 FType_init2(FieldType *self, float boost, bool_t indexed, bool_t stored,
-            bool_t sortable) {
+            bool_t sortable, bool_t doc_values, bool_t bloom_filter) {
     self->boost              = boost;
     self->indexed            = indexed;
     self->stored             = stored;
     self->sortable           = sortable;
+    self->doc_values         = doc_values;
+    self->bloom_filter       = bloom_filter;
     ABSTRACT_CLASS_CHECK(self, FIELDTYPE);
     return self;
 }
@@ -58,6 +60,16 @@ FType_set_sortable(FieldType *self, bool_t sortable) {
     self->sortable = !!sortable;
 }
 
+void
+FType_set_doc_values(FieldType *self, bool_t doc_values) {
+    self->doc_values = !!doc_values;
+}
+
+void
+FType_set_bloom_filter(FieldType *self, bool_t bloom_filter) {
+    self->bloom_filter = !!bloom_filter;
+}
+
 float
 FType_get_boost(FieldType *self) {
     return self->boost;
@@ -78,6 +90,16 @@ FType_sortable(FieldType *self) {
     return self->sortable;
 }
 
+bool_t
+FType_doc_values(FieldType *self) {
+    return self->doc_values;
+}
+
+bool_t
+FType_bloom_filter(FieldType *self) {
+    return self->bloom_filter;
+}
+
 bool_t
 FType_binary(FieldType *self) {
     UNUSED_VAR(self);
@@ -105,6 +127,8 @@ FType_equals(FieldType *self, Obj *other) {
     if (!!self->indexed    != !!twin->indexed)            { return false; }
     if (!!self->stored     != !!twin->stored)             { return false; }
     if (!!self->sortable   != !!twin->sortable)           { return false; }
+    if (!!self->doc_values != !!twin->doc_values)         { return false; }
+    if (!!self->bloom_filter != !!twin->bloom_filter)     { return false; }
     if (!!FType_Binary(self) != !!FType_Binary(twin))     { return false; }
     return true;
 }
@@ -30,13 +30,15 @@ FullTextType_new(Analyzer *analyzer) {
 
 FullTextType*
 FullTextType_init(FullTextType *self, Analyzer *analyzer) {
-    return FullTextType_init2(self, analyzer, 1.0, true, true, false, false);
+    return FullTextType_init2(self, analyzer, 1.0, true, true, false, false,
+                              false, false);
 }
 
 FullTextType*
 FullTextType_init2(FullTextType *self, Analyzer *analyzer, float boost,
                    bool_t indexed, bool_t stored, bool_t sortable,
-                   bool_t highlightable) {
+                   bool_t highlightable, bool_t doc_values,
+                   bool_t bloom_filter) {
     FType_init((FieldType*)self);
 
     /* Assign */
@@ -45,6 +47,8 @@ FullTextType_init2(FullTextType *self, Analyzer *analyzer, float boost,
     self->stored        = stored;
     self->sortable      = sortable;
     self->highlightable = highlightable;
+    self->doc_values    = doc_values;
+    self->bloom_filter  = bloom_filter;
     self->analyzer      = (Analyzer*)INCREF(analyzer);
 
     return self;
@@ -91,6 +95,12 @@ FullTextType_dump_for_schema(FullTextType *self) {
     if (self->highlightable) {
         Hash_Store_Str(dump, "highlightable", 13, (Obj*)CFISH_TRUE);
     }
+    if (self->doc_values) {
+        Hash_Store_Str(dump, "doc_values", 10, (Obj*)CFISH_TRUE);
+    }
+    if (self->bloom_filter) {
+        Hash_Store_Str(dump, "bloom_filter", 12, (Obj*)CFISH_TRUE);
+    }
 
     return dump;
 }
@@ -127,10 +137,14 @@ FullTextType_load(FullTextType *self, Obj *dump) {
     Obj *stored_dump  = Hash_Fetch_Str(source, "stored", 6);
     Obj *sort_dump    = Hash_Fetch_Str(source, "sortable", 8);
     Obj *hl_dump      = Hash_Fetch_Str(source, "highlightable", 13);
+    Obj *dv_dump      = Hash_Fetch_Str(source, "doc_values", 10);
+    Obj *bloom_dump   = Hash_Fetch_Str(source, "bloom_filter", 12);
     bool_t indexed  = indexed_dump ? Obj_To_Bool(indexed_dump) : true;
     bool_t stored   = stored_dump  ? Obj_To_Bool(stored_dump)  : true;
     bool_t sortable = sort_dump    ? Obj_To_Bool(sort_dump)    : false;
     bool_t hl       = hl_dump      ? Obj_To_Bool(hl_dump)      : false;
+    bool_t dv       = dv_dump      ? Obj_To_Bool(dv_dump)      : false;
+    bool_t bloom    = bloom_dump   ? Obj_To_Bool(bloom_dump)   : false;
 
     // Extract an Analyzer.
     Obj *analyzer_dump = Hash_Fetch_Str(source, "analyzer", 8);
@@ -153,6 +167,8 @@ FullTextType_load(FullTextType *self, Obj *dump) {
     if (stored_dump)  { loaded->stored        = stored;   }
     if (sort_dump)    { loaded->sortable      = sortable; }
     if (hl_dump)      { loaded->highlightable = hl;       }
+    if (dv_dump)      { loaded->doc_values    = dv;       }
+    if (bloom_dump)   { loaded->bloom_filter  = bloom;    }
 
     return loaded;
 }
@@ -21,17 +21,18 @@
 
 NumericType*
 NumType_init(NumericType *self) {
-    return NumType_init2(self, 1.0, true, true, false);
+    return NumType_init2(self, 1.0, true, true, false, false);
 }
 
 NumericType*
 NumType_init2(NumericType *self, float boost, bool_t indexed, bool_t stored,
-              bool_t sortable) {
+              bool_t sortable, bool_t doc_values) {
     FType_init((FieldType*)self);
     self->boost      = boost;
     self->indexed    = indexed;
     self->stored     = stored;
     self->sortable   = sortable;
+    self->doc_values = doc_values;
     return self;
 }
 
@@ -59,6 +60,9 @@ NumType_dump_for_schema(NumericType *self) {
     if (self->sortable) {
         Hash_Store_Str(dump, "sortable", 8, (Obj*)CFISH_TRUE);
     }
+    if (self->doc_values) {
+        Hash_Store_Str(dump, "doc_values", 10, (Obj*)CFISH_TRUE);
+    }
 
     return dump;
 }
@@ -112,11 +116,14 @@ NumType_load(NumericType *self, Obj *dump) {
     Obj *indexed_dump = Hash_Fetch_Str(source, "indexed", 7);
     Obj *stored_dump  = Hash_Fetch_Str(source, "stored", 6);
     Obj *sort_dump    = Hash_Fetch_Str(source, "sortable", 8);
-    bool_t indexed  = indexed_dump ? Obj_To_Bool(indexed_dump) : true;
-    bool_t stored   = stored_dump  ? Obj_To_Bool(stored_dump)  : true;
-    bool_t sortable = sort_dump    ? Obj_To_Bool(sort_dump)    : false;
-
-    return NumType_init2(loaded, boost, indexed, stored, sortable);
+    Obj *dv_dump      = Hash_Fetch_Str(source, "doc_values", 10);
+    bool_t indexed    = indexed_dump ? Obj_To_Bool(indexed_dump) : true;
+    bool_t stored     = stored_dump  ? Obj_To_Bool(stored_dump)  : true;
+    bool_t sortable   = sort_dump    ? Obj_To_Bool(sort_dump)    : false;
+    bool_t doc_values = dv_dump      ? Obj_To_Bool(dv_dump)      : false;
+
+    return NumType_init2(loaded, boost, indexed, stored, sortable,
+                         doc_values);
 }
 
 /****************************************************************************/
@@ -129,14 +136,14 @@ Float64Type_new() {
 
 Float64Type*
 Float64Type_init(Float64Type *self) {
-    return Float64Type_init2(self, 1.0, true, true, false);
+    return Float64Type_init2(self, 1.0, true, true, false, false);
 }
 
 Float64Type*
 Float64Type_init2(Float64Type *self, float boost, bool_t indexed,
-                  bool_t stored, bool_t sortable) {
+                  bool_t stored, bool_t sortable, bool_t doc_values) {
     return (Float64Type*)NumType_init2((NumericType*)self, boost, indexed,
-                                       stored, sortable);
+                                       stored, sortable, doc_values);
 }
 
 CharBuf*
@@ -171,14 +178,14 @@ Float32Type_new() {
 
 Float32Type*
 Float32Type_init(Float32Type *self) {
-    return Float32Type_init2(self, 1.0, true, true, false);
+    return Float32Type_init2(self, 1.0, true, true, false, false);
 }
 
 Float32Type*
 Float32Type_init2(Float32Type *self, float boost, bool_t indexed,
-                  bool_t stored, bool_t sortable) {
+                  bool_t stored, bool_t sortable, bool_t doc_values) {
     return (Float32Type*)NumType_init2((NumericType*)self, boost, indexed,
-                                       stored, sortable);
+                                       stored, sortable, doc_values);
 }
 
 CharBuf*
@@ -213,14 +220,14 @@ Int32Type_new() {
 
 Int32Type*
 Int32Type_init(Int32Type *self) {
-    return Int32Type_init2(self, 1.0, true, true, false);
+    return Int32Type_init2(self, 1.0, true, true, false, false);
 }
 
 Int32Type*
 Int32Type_init2(Int32Type *self, float boost, bool_t indexed,
-                bool_t stored, bool_t sortable) {
+                bool_t stored, bool_t sortable, bool_t doc_values) {
     return (Int32Type*)NumType_init2((NumericType*)self, boost, indexed,
-                                     stored, sortable);
+                                     stored, sortable, doc_values);
 }
 
 CharBuf*
@@ -255,14 +262,14 @@ Int64Type_new() {
 
 Int64Type*
 Int64Type_init(Int64Type *self) {
-    return Int64Type_init2(self, 1.0, true, true, false);
+    return Int64Type_init2(self, 1.0, true, true, false, false);
 }
 
 Int64Type*
 Int64Type_init2(Int64Type *self, float boost, bool_t indexed,
-                bool_t stored, bool_t sortable) {
+                bool_t stored, bool_t sortable, bool_t doc_values) {
     return (Int64Type*)NumType_init2((NumericType*)self, boost, indexed,
-                                     stored, sortable);
+                                     stored, sortable, doc_values);
 }
 
 CharBuf*
@@ -29,17 +29,20 @@ StringType_new() {
 
 StringType*
 StringType_init(StringType *self) {
-    return StringType_init2(self, 1.0, true, true, false);
+    return StringType_init2(self, 1.0, true, true, false, false, false);
 }
 
 StringType*
 StringType_init2(StringType *self, float boost, bool_t indexed,
-                 bool_t stored, bool_t sortable) {
+                 bool_t stored, bool_t sortable, bool_t doc_values,
+                 bool_t bloom_filter) {
     FType_init((FieldType*)self);
-    self->boost      = boost;
-    self->indexed    = indexed;
-    self->stored     = stored;
-    self->sortable   = sortable;
+    self->boost        = boost;
+    self->indexed      = indexed;
+    self->stored       = stored;
+    self->sortable     = sortable;
+    self->doc_values   = doc_values;
+    self->bloom_filter = bloom_filter;
     return self;
 }
 
@@ -69,6 +72,12 @@ StringType_dump_for_schema(StringType *self) {
     if (self->sortable) {
         Hash_Store_Str(dump, "sortable", 8, (Obj*)CFISH_TRUE);
     }
+    if (self->doc_values) {
+        Hash_Store_Str(dump, "doc_values", 10, (Obj*)CFISH_TRUE);
+    }
+    if (self->bloom_filter) {
+        Hash_Store_Str(dump, "bloom_filter", 12, (Obj*)CFISH_TRUE);
+    }
 
     return dump;
 }
@@ -95,6 +104,8 @@ StringType_load(StringType *self, Obj *dump) {
     Obj *indexed_dump    = Hash_Fetch_Str(source, "indexed", 7);
     Obj *stored_dump     = Hash_Fetch_Str(source, "stored", 6);
     Obj *sortable_dump   = Hash_Fetch_Str(source, "sortable", 8);
+    Obj *dv_dump         = Hash_Fetch_Str(source, "doc_values", 10);
+    Obj *bloom_dump      = Hash_Fetch_Str(source, "bloom_filter", 12);
     UNUSED_VAR(self);
 
     StringType_init(loaded);
@@ -102,6 +113,8 @@ StringType_load(StringType *self, Obj *dump) {
     if (indexed_dump)  { loaded->indexed  = Obj_To_Bool(indexed_dump); }
     if (stored_dump)   { loaded->stored   = Obj_To_Bool(stored_dump); }
     if (sortable_dump) { loaded->sortable = Obj_To_Bool(sortable_dump); }
+    if (dv_dump)       { loaded->doc_values = Obj_To_Bool(dv_dump); }
+    if (bloom_dump)    { loaded->bloom_filter = Obj_To_Bool(bloom_dump); }
 
     return loaded;
 }
@@ -0,0 +1,378 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_FACETCOLLECTOR
+#define C_LUCY_FACETCOUNT
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Search/Collector/FacetCollector.h"
+#include "Lucy/Index/IndexReader.h"
+#include "Lucy/Index/OrdinalMap.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Index/SortCache.h"
+#include "Lucy/Index/SortReader.h"
+#include "Lucy/Plan/FieldType.h"
+#include "Lucy/Plan/Schema.h"
+#include "Lucy/Search/Matcher.h"
+#include "Lucy/Util/SortUtils.h"
+
+// Fold the counts for the current segment into the running totals, then
+// zero them.
+static void
+S_flush_seg_counts(FacetCollector *self);
+
+// Return the index of `field` within self->fields, or throw.
+static uint32_t
+S_field_tick(FacetCollector *self, const CharBuf *field);
+
+FacetCollector*
+FacetColl_new(Schema *schema, VArray *fields, IndexReader *reader,
+              Collector *collector) {
+    FacetCollector *self = (FacetCollector*)VTable_Make_Obj(FACETCOLLECTOR);
+    return FacetColl_init(self, schema, fields, reader, collector);
+}
+
+FacetCollector*
+FacetColl_init(FacetCollector *self, Schema *schema, VArray *fields,
+               IndexReader *reader, Collector *collector) {
+    uint32_t num_fields = VA_Get_Size(fields);
+
+    // Validate.
+    Coll_init((Collector*)self);
+    for (uint32_t i = 0; i < num_fields; i++) {
+        CharBuf   *field = (CharBuf*)CERTIFY(VA_Fetch(fields, i), CHARBUF);
+        FieldType *type  = Schema_Fetch_Type(schema, field);
+        if (!type || !FType_Sortable(type)) {
+            DECREF(self);
+            THROW(ERR, "'%o' isn't a sortable field", field);
+        }
+    }
+
+    // Assign.
+    self->schema        = (Schema*)INCREF(schema);
+    self->fields        = VA_Shallow_Copy(fields);
+    self->inner_coll    = (Collector*)INCREF(collector);
+    self->num_fields    = num_fields;
+
+    // Init.
+    self->total_hits    = 0;
+    self->caches        = (SortCache**)CALLOCATE(num_fields,
+                                                 sizeof(SortCache*));
+    self->seg_counts    = (uint32_t**)CALLOCATE(num_fields, sizeof(uint32_t*));
+    self->ord_maps      = (OrdinalMap**)CALLOCATE(num_fields,
+                                                  sizeof(OrdinalMap*));
+    self->seg_ord_maps  = (int32_t**)CALLOCATE(num_fields, sizeof(int32_t*));
+    self->global_counts = (uint32_t**)CALLOCATE(num_fields,
+                                                sizeof(uint32_t*));
+    self->value_counts  = (Hash**)CALLOCATE(num_fields, sizeof(Hash*));
+
+    // Use global ordinals if the reader can supply them.  Otherwise, fall
+    // back to merging counts by value.
+    SortReader *sort_reader = reader
+                              ? (SortReader*)IxReader_Fetch(
+                                    reader, VTable_Get_Name(SORTREADER))
+                              : NULL;
+    for (uint32_t i = 0; i < num_fields; i++) {
+        CharBuf    *field   = (CharBuf*)VA_Fetch(fields, i);
+        OrdinalMap *ord_map = NULL;
+        if (sort_reader && SortReader_Is_A(sort_reader, POLYSORTREADER)) {
+            ord_map = PolySortReader_Fetch_Ord_Map(
+                          (PolySortReader*)sort_reader, field);
+        }
+        if (ord_map) {
+            // Leave room for a NULL ordinal past the end.
+            size_t num_ords = (size_t)OrdMap_Get_Cardinality(ord_map) + 1;
+            self->ord_maps[i]      = (OrdinalMap*)INCREF(ord_map);
+            self->global_counts[i] = (uint32_t*)CALLOCATE(num_ords,
+                                                          sizeof(uint32_t));
+        }
+        else {
+            self->value_counts[i] = Hash_new(0);
+        }
+    }
+
+    return self;
+}
+
+void
+FacetColl_destroy(FacetCollector *self) {
+    for (uint32_t i = 0; i < self->num_fields; i++) {
+        if (self->seg_counts)    { FREEMEM(self->seg_counts[i]); }
+        if (self->global_counts) { FREEMEM(self->global_counts[i]); }
+        if (self->ord_maps)      { DECREF(self->ord_maps[i]); }
+        if (self->value_counts)  { DECREF(self->value_counts[i]); }
+    }
+    FREEMEM(self->caches);
+    FREEMEM(self->seg_counts);
+    FREEMEM(self->ord_maps);
+    FREEMEM(self->seg_ord_maps);
+    FREEMEM(self->global_counts);
+    FREEMEM(self->value_counts);
+    DECREF(self->schema);
+    DECREF(self->fields);
+    DECREF(self->inner_coll);
+    SUPER_DESTROY(self, FACETCOLLECTOR);
+}
+
+void
+FacetColl_set_reader(FacetCollector *self, SegReader *reader) {
+    SortReader *sort_reader = reader
+                              ? (SortReader*)SegReader_Fetch(
+                                    reader, VTable_Get_Name(SORTREADER))
+                              : NULL;
+
+    S_flush_seg_counts(self);
+
+    // Obtain sort caches and allocate per-ordinal counters for this segment.
+    for (uint32_t i = 0; i < self->num_fields; i++) {
+        CharBuf   *field = (CharBuf*)VA_Fetch(self->fields, i);
+        SortCache *cache = sort_reader
+                           ? SortReader_Fetch_Sort_Cache(sort_reader, field)
+                           : NULL;
+        FREEMEM(self->seg_counts[i]);
+        self->seg_counts[i]   = NULL;
+        self->caches[i]       = cache;
+        self->seg_ord_maps[i] = NULL;
+        if (cache) {
+            size_t cardinality = (size_t)SortCache_Get_Cardinality(cache);
+            self->seg_counts[i] = (uint32_t*)CALLOCATE(cardinality,
+                                                       sizeof(uint32_t));
+            if (self->ord_maps[i]) {
+                int32_t seg_tick = OrdMap_Seg_Tick(self->ord_maps[i], cache);
+                if (seg_tick < 0) {
+                    THROW(ERR, "SortCache for '%o' not found in OrdinalMap",
+                          field);
+                }
+                self->seg_ord_maps[i]
+                    = OrdMap_Seg_Map(self->ord_maps[i], (uint32_t)seg_tick);
+            }
+        }
+    }
+
+    Coll_set_reader((Collector*)self, reader);
+    if (self->inner_coll) {
+        Coll_Set_Reader(self->inner_coll, reader);
+    }
+}
+
+void
+FacetColl_set_base(FacetCollector *self, int32_t base) {
+    Coll_set_base((Collector*)self, base);
+    if (self->inner_coll) {
+        Coll_Set_Base(self->inner_coll, base);
+    }
+}
+
+void
+FacetColl_set_matcher(FacetCollector *self, Matcher *matcher) {
+    Coll_set_matcher((Collector*)self, matcher);
+    if (self->inner_coll) {
+        Coll_Set_Matcher(self->inner_coll, matcher);
+    }
+}
+
+bool_t
+FacetColl_need_score(FacetCollector *self) {
+    return self->inner_coll ? Coll_Need_Score(self->inner_coll) : false;
+}
+
+uint32_t
+FacetColl_get_total_hits(FacetCollector *self) {
+    return self->total_hits;
+}
+
+void
+FacetColl_collect(FacetCollector *self, int32_t doc_id) {
+    self->total_hits++;
+
+    for (uint32_t i = 0; i < self->num_fields; i++) {
+        SortCache *cache = self->caches[i];
+        if (cache) {
+            int32_t ord = SortCache_Ordinal(cache, doc_id);
+            self->seg_counts[i][ord]++;
+        }
+    }
+
+    if (self->inner_coll) {
+        Coll_Collect(self->inner_coll, doc_id);
+    }
+}
+
+static void
+S_flush_seg_counts(FacetCollector *self) {
+    for (uint32_t i = 0; i < self->num_fields; i++) {
+        uint32_t  *seg_counts = self->seg_counts[i];
+        SortCache *cache      = self->caches[i];
+        if (!seg_counts) { continue; }
+
+        int32_t cardinality = SortCache_Get_Cardinality(cache);
+        int32_t null_ord    = SortCache_Get_Null_Ord(cache);
+        if (self->seg_ord_maps[i]) {
+            // Translate local ordinals to global ordinals.
+            int32_t  *seg_map       = self->seg_ord_maps[i];
+            uint32_t *global_counts = self->global_counts[i];
+            for (int32_t ord = 0; ord < cardinality; ord++) {
+                if (seg_counts[ord] && ord != null_ord) {
+                    global_counts[seg_map[ord]] += seg_counts[ord];
+                }
+            }
+        }
+        else {
+            // Materialize each counted value and merge by value.
+            Hash *value_counts = self->value_counts[i];
+            Obj  *blank        = SortCache_Make_Blank(cache);
+            for (int32_t ord = 0; ord < cardinality; ord++) {
+                if (!seg_counts[ord] || ord == null_ord) { continue; }
+                Obj *value = SortCache_Value(cache, ord, blank);
+                if (!value) { continue; }
+                Integer32 *count = (Integer32*)Hash_Fetch(value_counts, value);
+                if (count) {
+                    int32_t sum = Int32_Get_Value(count)
+                                  + (int32_t)seg_counts[ord];
+                    Int32_Set_Value(count, sum);
+                }
+                else {
+                    Hash_Store(value_counts, value,
+                               (Obj*)Int32_new((int32_t)seg_counts[ord]));
+                }
+            }
+            DECREF(blank);
+        }
+
+        memset(seg_counts, 0, (size_t)cardinality * sizeof(uint32_t));
+    }
+}
+
+static uint32_t
+S_field_tick(FacetCollector *self, const CharBuf *field) {
+    for (uint32_t i = 0; i < self->num_fields; i++) {
+        CharBuf *candidate = (CharBuf*)VA_Fetch(self->fields, i);
+        if (CB_Equals(candidate, (Obj*)field)) { return i; }
+    }
+    THROW(ERR, "'%o' isn't a facet field", field);
+    UNREACHABLE_RETURN(uint32_t);
+}
+
+// Order global ordinals by descending count.  Since global ordinals sort in
+// value order, ties go to the lower ordinal.
+static int
+S_compare_global_ords(void *context, const void *va, const void *vb) {
+    uint32_t *counts = (uint32_t*)context;
+    int32_t   a      = *(int32_t*)va;
+    int32_t   b      = *(int32_t*)vb;
+    if (counts[a] > counts[b])      { return -1; }
+    else if (counts[a] < counts[b]) { return 1; }
+    return a - b;
+}
+
+// Order FacetCounts by descending count, then ascending value.
+static int
+S_compare_facet_counts(void *context, const void *va, const void *vb) {
+    FieldType  *type = (FieldType*)context;
+    FacetCount *a    = *(FacetCount**)va;
+    FacetCount *b    = *(FacetCount**)vb;
+    if (a->count > b->count)      { return -1; }
+    else if (a->count < b->count) { return 1; }
+    return FType_null_back_compare_values(type, a->value, b->value);
+}
+
+VArray*
+FacetColl_top_values(FacetCollector *self, const CharBuf *field,
+                     uint32_t num_wanted) {
+    uint32_t  tick    = S_field_tick(self, field);
+    VArray   *retval  = VA_new(num_wanted);
+
+    S_flush_seg_counts(self);
+
+    if (self->ord_maps[tick]) {
+        OrdinalMap *ord_map     = self->ord_maps[tick];
+        uint32_t   *counts      = self->global_counts[tick];
+        int32_t     cardinality = OrdMap_Get_Cardinality(ord_map);
+        int32_t     null_ord    = OrdMap_Get_Null_Ord(ord_map);
+        int32_t    *ords        = (int32_t*)MALLOCATE(
+                                      ((size_t)cardinality + 1)
+                                      * sizeof(int32_t));
+        uint32_t    num_ords    = 0;
+
+        // Rank the ordinals which have hits, and materialize only the
+        // values which make the cut.
+        for (int32_t ord = 0; ord < cardinality; ord++) {
+            if (counts[ord] && ord != null_ord) { ords[num_ords++] = ord; }
+        }
+        Sort_quicksort(ords, num_ords, sizeof(int32_t),
+                       S_compare_global_ords, counts);
+        if (num_ords > num_wanted) { num_ords = num_wanted; }
+        for (uint32_t i = 0; i < num_ords; i++) {
+            Obj *blank = OrdMap_Make_Blank(ord_map);
+            Obj *value = OrdMap_Value(ord_map, ords[i], blank);
+            if (value) {
+                VA_Push(retval, (Obj*)FacetCount_new(value, counts[ords[i]]));
+            }
+            DECREF(blank);
+        }
+        FREEMEM(ords);
+    }
+    else {
+        Hash    *value_counts = self->value_counts[tick];
+        Obj     *value;
+        Obj     *count;
+        Hash_Iterate(value_counts);
+        while (Hash_Next(value_counts, &value, &count)) {
+            uint32_t num = (uint32_t)Int32_Get_Value((Integer32*)count);
+            VA_Push(retval, (Obj*)FacetCount_new(value, num));
+        }
+        FieldType *type = Schema_Fetch_Type(self->schema, field);
+        VA_Sort(retval, S_compare_facet_counts, type);
+        if (VA_Get_Size(retval) > num_wanted) {
+            VA_Resize(retval, num_wanted);
+        }
+    }
+
+    return retval;
+}
+
+/***************************************************************************/
+
+FacetCount*
+FacetCount_new(Obj *value, uint32_t count) {
+    FacetCount *self = (FacetCount*)VTable_Make_Obj(FACETCOUNT);
+    return FacetCount_init(self, value, count);
+}
+
+FacetCount*
+FacetCount_init(FacetCount *self, Obj *value, uint32_t count) {
+    self->value = INCREF(value);
+    self->count = count;
+    return self;
+}
+
+void
+FacetCount_destroy(FacetCount *self) {
+    DECREF(self->value);
+    SUPER_DESTROY(self, FACETCOUNT);
+}
+
+Obj*
+FacetCount_get_value(FacetCount *self) {
+    return self->value;
+}
+
+uint32_t
+FacetCount_get_count(FacetCount *self) {
+    return self->count;
+}
+
+
@@ -19,6 +19,7 @@
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Search/Collector/SortCollector.h"
+#include "Lucy/Index/OrdinalMap.h"
 #include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/SortCache.h"
 #include "Lucy/Index/SortCache/NumericSortCache.h"
@@ -112,6 +113,9 @@ SortColl_init(SortCollector *self, Schema *schema, SortSpec *sort_spec,
     self->num_rules     = num_rules;
     self->sort_caches   = (SortCache**)CALLOCATE(num_rules, sizeof(SortCache*));
     self->ord_arrays    = (void**)CALLOCATE(num_rules, sizeof(void*));
+    self->ord_maps      = (OrdinalMap**)CALLOCATE(num_rules,
+                                                  sizeof(OrdinalMap*));
+    self->seg_ord_maps  = (int32_t**)CALLOCATE(num_rules, sizeof(int32_t*));
     self->actions       = (uint8_t*)CALLOCATE(num_rules, sizeof(uint8_t));
 
     // Build up an array of "actions" which we will execute during each call
@@ -166,8 +170,15 @@ SortColl_destroy(SortCollector *self) {
     DECREF(self->hit_q);
     DECREF(self->rules);
     DECREF(self->bumped);
+    if (self->ord_maps) {
+        for (uint32_t i = 0; i < self->num_rules; i++) {
+            DECREF(self->ord_maps[i]);
+        }
+        FREEMEM(self->ord_maps);
+    }
     FREEMEM(self->sort_caches);
     FREEMEM(self->ord_arrays);
+    FREEMEM(self->seg_ord_maps);
     FREEMEM(self->auto_actions);
     FREEMEM(self->derived_actions);
     SUPER_DESTROY(self, SORTCOLLECTOR);
@@ -243,15 +254,83 @@ SortColl_set_reader(SortCollector *self, SegReader *reader) {
             self->derived_actions[i] = S_derive_action(rule, cache);
             if (cache) { self->ord_arrays[i] = SortCache_Get_Ords(cache); }
             else       { self->ord_arrays[i] = NULL; }
+
+            // Find the segment's local-to-global ordinal mapping.
+            OrdinalMap *ord_map = self->ord_maps[i];
+            self->seg_ord_maps[i] = NULL;
+            if (ord_map && cache) {
+                int32_t seg_tick = OrdMap_Seg_Tick(ord_map, cache);
+                if (seg_tick < 0) {
+                    THROW(ERR, "SortCache for '%o' not found in OrdinalMap",
+                          field);
+                }
+                self->seg_ord_maps[i]
+                    = OrdMap_Seg_Map(ord_map, (uint32_t)seg_tick);
+            }
         }
     }
     self->seg_doc_max = reader ? SegReader_Doc_Max(reader) : 0;
     Coll_set_reader((Collector*)self, reader);
 }
 
+void
+SortColl_set_poly_sort_reader(SortCollector *self, PolySortReader *reader) {
+    if (self->total_hits) {
+        THROW(ERR, "Can't supply a PolySortReader after collecting hits");
+    }
+    if (!self->need_values || !reader) { return; }
+
+    for (uint32_t i = 0, max = self->num_rules; i < max; i++) {
+        SortRule *rule  = (SortRule*)VA_Fetch(self->rules, i);
+        CharBuf  *field = SortRule_Get_Field(rule);
+        if (!field) { continue; }
+
+        // Only text values are costly enough to materialize that building
+        // an OrdinalMap pays off.
+        OrdinalMap *ord_map = PolySortReader_Fetch_Ord_Map(reader, field);
+        if (ord_map) {
+            FieldType *type = OrdMap_Get_Type(ord_map);
+            int8_t prim_id = FType_Primitive_ID(type) & FType_PRIMITIVE_ID_MASK;
+            if (prim_id == FType_TEXT) {
+                DECREF(self->ord_maps[i]);
+                self->ord_maps[i] = (OrdinalMap*)INCREF(ord_map);
+                HitQ_Compare_Ords(self->hit_q, i);
+            }
+        }
+    }
+}
+
+// Replace the global ordinals stored in each MatchDoc's values with the
+// actual field values.
+static void
+S_materialize_values(SortCollector *self, VArray *match_docs) {
+    for (uint32_t i = 0, max = self->num_rules; i < max; i++) {
+        OrdinalMap *ord_map = self->ord_maps[i];
+        if (!ord_map) { continue; }
+        for (uint32_t j = 0, num = VA_Get_Size(match_docs); j < num; j++) {
+            MatchDoc  *match_doc = (MatchDoc*)VA_Fetch(match_docs, j);
+            VArray    *values    = match_doc->values;
+            Integer32 *ord_obj   = (Integer32*)VA_Fetch(values, i);
+            if (!ord_obj) { continue; }
+            int32_t global_ord = Int32_Get_Value(ord_obj);
+            Obj *blank = OrdMap_Make_Blank(ord_map);
+            Obj *val   = OrdMap_Value(ord_map, global_ord, blank);
+            if (val) { VA_Store(values, i, val); }
+            else {
+                DECREF(blank);
+                VA_Store(values, i, NULL);
+            }
+        }
+    }
+}
+
 VArray*
 SortColl_pop_match_docs(SortCollector *self) {
-    return HitQ_Pop_All(self->hit_q);
+    VArray *match_docs = HitQ_Pop_All(self->hit_q);
+    if (self->need_values) {
+        S_materialize_values(self, match_docs);
+    }
+    return match_docs;
 }
 
 uint32_t
@@ -285,7 +364,18 @@ SortColl_collect(SortCollector *self, int32_t doc_id) {
             for (uint32_t i = 0, max = self->num_rules; i < max; i++) {
                 SortCache *cache   = self->sort_caches[i];
                 Obj       *old_val = (Obj*)VA_Delete(values, i);
-                if (cache) {
+                if (self->ord_maps[i]) {
+                    // Store a global ordinal rather than the value itself.
+                    int32_t global_ord = cache
+                        ? self->seg_ord_maps[i][SortCache_Ordinal(cache, doc_id)]
+                        : OrdMap_Get_Null_Ord(self->ord_maps[i]);
+                    Integer32 *ord_obj = old_val
+                                         ? (Integer32*)old_val
+                                         : Int32_new(global_ord);
+                    Int32_Set_Value(ord_obj, global_ord);
+                    VA_Store(values, i, (Obj*)ord_obj);
+                }
+                else if (cache) {
                     int32_t ord = SortCache_Ordinal(cache, doc_id);
                     Obj *blank = old_val
                                  ? old_val
@@ -294,6 +384,9 @@ SortColl_collect(SortCollector *self, int32_t doc_id) {
                     if (val) { VA_Store(values, i, (Obj*)val); }
                     else     { DECREF(blank); }
                 }
+                else {
+                    DECREF(old_val);
+                }
             }
         }
 
@@ -71,6 +71,12 @@ Compiler_sum_of_squared_weights(Compiler *self) {
     return 1.0f;
 }
 
+void
+Compiler_prefetch(Compiler *self, SegReader *reader) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(reader);
+}
+
 void
 Compiler_apply_norm_factor(Compiler *self, float factor) {
     UNUSED_VAR(self);
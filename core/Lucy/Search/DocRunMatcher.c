@@ -0,0 +1,84 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_DOCRUNMATCHER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Search/DocRunMatcher.h"
+
+DocRunMatcher*
+DocRunMatcher_new(I32Array *runs) {
+    DocRunMatcher *self = (DocRunMatcher*)VTable_Make_Obj(DOCRUNMATCHER);
+    return DocRunMatcher_init(self, runs);
+}
+
+DocRunMatcher*
+DocRunMatcher_init(DocRunMatcher *self, I32Array *runs) {
+    Matcher_init((Matcher*)self);
+    if (I32Arr_Get_Size(runs) % 2) {
+        DECREF(self);
+        THROW(ERR, "Odd number of run boundaries: %u32",
+              I32Arr_Get_Size(runs));
+    }
+    self->runs     = (I32Array*)INCREF(runs);
+    self->num_runs = I32Arr_Get_Size(runs) / 2;
+    self->tick     = 0;
+    self->doc_id   = 0;
+    return self;
+}
+
+void
+DocRunMatcher_destroy(DocRunMatcher *self) {
+    DECREF(self->runs);
+    SUPER_DESTROY(self, DOCRUNMATCHER);
+}
+
+int32_t
+DocRunMatcher_next(DocRunMatcher *self) {
+    if (self->tick == self->num_runs) { return 0; } // Exhausted.
+    return DocRunMatcher_advance(self, self->doc_id + 1);
+}
+
+int32_t
+DocRunMatcher_advance(DocRunMatcher *self, int32_t target) {
+    I32Array *const runs = self->runs;
+    uint32_t lo = self->tick;
+    uint32_t hi = self->num_runs;
+
+    // Find the first run whose last doc is at or beyond the target.
+    while (lo < hi) {
+        const uint32_t mid = lo + ((hi - lo) / 2);
+        if (I32Arr_Get(runs, mid * 2 + 1) < target) { lo = mid + 1; }
+        else                                        { hi = mid; }
+    }
+    self->tick = lo;
+
+    if (lo == self->num_runs) {
+        return 0;
+    }
+    else {
+        const int32_t first = I32Arr_Get(runs, lo * 2);
+        self->doc_id = target > first ? target : first;
+        return self->doc_id;
+    }
+}
+
+int32_t
+DocRunMatcher_get_doc_id(DocRunMatcher *self) {
+    return self->doc_id;
+}
+
+
@@ -34,6 +34,8 @@
 #define COMPARE_BY_DOC_ID_REV 4
 #define COMPARE_BY_VALUE      5
 #define COMPARE_BY_VALUE_REV  6
+#define COMPARE_BY_ORD        7
+#define COMPARE_BY_ORD_REV    8
 #define ACTIONS_MASK          0xF
 
 HitQueue*
@@ -135,6 +137,34 @@ SI_compare_by_value(HitQueue *self, uint32_t tick, MatchDoc *a, MatchDoc *b) {
     return FType_null_back_compare_values(field_type, a_val, b_val);
 }
 
+void
+HitQ_compare_ords(HitQueue *self, uint32_t tick) {
+    if (tick >= self->num_actions) {
+        THROW(ERR, "Out of range: %u32 >= %u32", tick, self->num_actions);
+    }
+    switch (self->actions[tick] & ACTIONS_MASK) {
+        case COMPARE_BY_VALUE:
+        case COMPARE_BY_ORD:
+            self->actions[tick] = COMPARE_BY_ORD;
+            break;
+        case COMPARE_BY_VALUE_REV:
+        case COMPARE_BY_ORD_REV:
+            self->actions[tick] = COMPARE_BY_ORD_REV;
+            break;
+        default:
+            THROW(ERR, "Sort rule %u32 doesn't compare field values", tick);
+    }
+}
+
+static INLINE int32_t
+SI_compare_by_ord(uint32_t tick, MatchDoc *a, MatchDoc *b) {
+    Integer32 *a_ord = (Integer32*)VA_Fetch(a->values, tick);
+    Integer32 *b_ord = (Integer32*)VA_Fetch(b->values, tick);
+    int32_t a_val = Int32_Get_Value(a_ord);
+    int32_t b_val = Int32_Get_Value(b_ord);
+    return a_val < b_val ? -1 : a_val > b_val ? 1 : 0;
+}
+
 bool_t
 HitQ_less_than(HitQueue *self, Obj *obj_a, Obj *obj_b) {
     MatchDoc *const a = (MatchDoc*)obj_a;
@@ -174,6 +204,18 @@ HitQ_less_than(HitQueue *self, Obj *obj_a, Obj *obj_b) {
                     else if (comparison < 0) { return false; }
                 }
                 break;
+            case COMPARE_BY_ORD: {
+                    int32_t comparison = SI_compare_by_ord(i, a, b);
+                    if (comparison > 0)      { return true;  }
+                    else if (comparison < 0) { return false; }
+                }
+                break;
+            case COMPARE_BY_ORD_REV: {
+                    int32_t comparison = SI_compare_by_ord(i, b, a);
+                    if (comparison > 0)      { return true;  }
+                    else if (comparison < 0) { return false; }
+                }
+                break;
             default:
                 THROW(ERR, "Unexpected action %u8", actions[i]);
         }
@@ -25,6 +25,13 @@
 #include "Lucy/Search/Searcher.h"
 #include "Lucy/Search/TopDocs.h"
 
+// Maximum number of HitDocs to fetch from the Searcher at once.
+#define HITS_BATCH_SIZE 100
+
+// Fetch the HitDocs for the next batch of MatchDocs.
+static void
+S_fetch_batch(Hits *self);
+
 Hits*
 Hits_new(Searcher *searcher, TopDocs *top_docs, uint32_t offset) {
     Hits *self = (Hits*)VTable_Make_Obj(HITS);
@@ -33,10 +40,12 @@ Hits_new(Searcher *searcher, TopDocs *top_docs, uint32_t offset) {
 
 Hits*
 Hits_init(Hits *self, Searcher *searcher, TopDocs *top_docs, uint32_t offset) {
-    self->searcher   = (Searcher*)INCREF(searcher);
-    self->top_docs   = (TopDocs*)INCREF(top_docs);
-    self->match_docs = (VArray*)INCREF(TopDocs_Get_Match_Docs(top_docs));
-    self->offset     = offset;
+    self->searcher    = (Searcher*)INCREF(searcher);
+    self->top_docs    = (TopDocs*)INCREF(top_docs);
+    self->match_docs  = (VArray*)INCREF(TopDocs_Get_Match_Docs(top_docs));
+    self->offset      = offset;
+    self->hit_docs    = NULL;
+    self->batch_start = offset;
     return self;
 }
 
@@ -45,6 +54,7 @@ Hits_destroy(Hits *self) {
     DECREF(self->searcher);
     DECREF(self->top_docs);
     DECREF(self->match_docs);
+    DECREF(self->hit_docs);
     SUPER_DESTROY(self, HITS);
 }
 
@@ -59,14 +69,34 @@ Hits_next(Hits *self) {
         return NULL;
     }
     else {
-        // Lazily fetch HitDoc, set score.
-        HitDoc *hit_doc = Searcher_Fetch_Doc(self->searcher,
-                                             match_doc->doc_id);
+        // Lazily fetch HitDocs a batch at a time, set score.
+        uint32_t tick = self->offset - 1 - self->batch_start;
+        if (!self->hit_docs || tick >= VA_Get_Size(self->hit_docs)) {
+            self->batch_start = self->offset - 1;
+            S_fetch_batch(self);
+            tick = 0;
+        }
+        HitDoc *hit_doc = (HitDoc*)VA_Delete(self->hit_docs, tick);
         HitDoc_Set_Score(hit_doc, match_doc->score);
         return hit_doc;
     }
 }
 
+static void
+S_fetch_batch(Hits *self) {
+    uint32_t num_docs = VA_Get_Size(self->match_docs) - self->batch_start;
+    if (num_docs > HITS_BATCH_SIZE) { num_docs = HITS_BATCH_SIZE; }
+    I32Array *doc_ids = I32Arr_new_blank(num_docs);
+    for (uint32_t i = 0; i < num_docs; i++) {
+        MatchDoc *match_doc
+            = (MatchDoc*)VA_Fetch(self->match_docs, self->batch_start + i);
+        I32Arr_Set(doc_ids, i, match_doc->doc_id);
+    }
+    DECREF(self->hit_docs);
+    self->hit_docs = Searcher_Fetch_Docs(self->searcher, doc_ids);
+    DECREF(doc_ids);
+}
+
 uint32_t
 Hits_total_hits(Hits *self) {
     return TopDocs_Get_Total_Hits(self->top_docs);
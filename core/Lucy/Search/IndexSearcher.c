@@ -27,6 +27,7 @@
 #include "Lucy/Index/LexiconReader.h"
 #include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/SortCache.h"
+#include "Lucy/Index/SortReader.h"
 #include "Lucy/Index/HighlightReader.h"
 #include "Lucy/Plan/FieldType.h"
 #include "Lucy/Plan/Schema.h"
@@ -40,6 +41,7 @@
 #include "Lucy/Search/SortSpec.h"
 #include "Lucy/Search/TopDocs.h"
 #include "Lucy/Search/Compiler.h"
+#include "Lucy/Search/Warmer.h"
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/FSFolder.h"
 
@@ -49,8 +51,19 @@ IxSearcher_new(Obj *index) {
     return IxSearcher_init(self, index);
 }
 
+IndexSearcher*
+IxSearcher_new_warmed(Obj *index, Warmer *warmer) {
+    IndexSearcher *self = (IndexSearcher*)VTable_Make_Obj(INDEXSEARCHER);
+    return IxSearcher_init2(self, index, warmer);
+}
+
 IndexSearcher*
 IxSearcher_init(IndexSearcher *self, Obj *index) {
+    return IxSearcher_init2(self, index, NULL);
+}
+
+IndexSearcher*
+IxSearcher_init2(IndexSearcher *self, Obj *index, Warmer *warmer) {
     if (Obj_Is_A(index, INDEXREADER)) {
         self->reader = (IndexReader*)INCREF(index);
     }
@@ -67,6 +80,18 @@ IxSearcher_init(IndexSearcher *self, Obj *index) {
     if (self->doc_reader) { INCREF(self->doc_reader); }
     if (self->hl_reader)  { INCREF(self->hl_reader); }
 
+    if (warmer) {
+        for (uint32_t i = 0, max = VA_Get_Size(self->seg_readers);
+             i < max;
+             i++
+            ) {
+            SegReader *seg_reader
+                = (SegReader*)VA_Fetch(self->seg_readers, i);
+            Warmer_Warm_Seg_Reader(warmer, seg_reader);
+        }
+        Warmer_Warm_Searcher(warmer, (Searcher*)self);
+    }
+
     return self;
 }
 
@@ -86,6 +111,26 @@ IxSearcher_fetch_doc(IndexSearcher *self, int32_t doc_id) {
     return DocReader_Fetch_Doc(self->doc_reader, doc_id);
 }
 
+HitDoc*
+IxSearcher_fetch_doc_fields(IndexSearcher *self, int32_t doc_id,
+                            VArray *fields) {
+    if (!self->doc_reader) { THROW(ERR, "No DocReader"); }
+    return DocReader_Fetch_Doc_Fields(self->doc_reader, doc_id, fields);
+}
+
+VArray*
+IxSearcher_fetch_docs(IndexSearcher *self, I32Array *doc_ids) {
+    if (!self->doc_reader) { THROW(ERR, "No DocReader"); }
+    return DocReader_Fetch_Docs(self->doc_reader, doc_ids);
+}
+
+void
+IxSearcher_prefetch_docs(IndexSearcher *self, I32Array *doc_ids) {
+    if (self->doc_reader) {
+        DocReader_Prefetch_Docs(self->doc_reader, doc_ids);
+    }
+}
+
 DocVector*
 IxSearcher_fetch_doc_vec(IndexSearcher *self, int32_t doc_id) {
     if (!self->hl_reader) { THROW(ERR, "No HighlightReader"); }
@@ -112,6 +157,18 @@ IxSearcher_top_docs(IndexSearcher *self, Query *query, uint32_t num_wanted,
     uint32_t       doc_max   = IxSearcher_Doc_Max(self);
     uint32_t       wanted    = num_wanted > doc_max ? doc_max : num_wanted;
     SortCollector *collector = SortColl_new(schema, sort_spec, wanted);
+
+    // Compare sort values across segments using global ordinals.
+    if (sort_spec && VA_Get_Size(self->seg_readers) > 1) {
+        SortReader *sort_reader
+            = (SortReader*)IxReader_Fetch(self->reader,
+                                          VTable_Get_Name(SORTREADER));
+        if (sort_reader && SortReader_Is_A(sort_reader, POLYSORTREADER)) {
+            SortColl_Set_Poly_Sort_Reader(collector,
+                                          (PolySortReader*)sort_reader);
+        }
+    }
+
     IxSearcher_Collect(self, query, (Collector*)collector);
     VArray  *match_docs = SortColl_Pop_Match_Docs(collector);
     int32_t  total_hits = SortColl_Get_Total_Hits(collector);
@@ -131,15 +188,24 @@ IxSearcher_collect(IndexSearcher *self, Query *query, Collector *collector) {
                          : Query_Make_Compiler(query, (Searcher*)self,
                                                Query_Get_Boost(query), false);
 
+    // Hint the data the query will read in every segment before matching
+    // any of them, so that the reads for later segments overlap with
+    // scoring of earlier ones.
+    const uint32_t num_segs = VA_Get_Size(seg_readers);
+    for (uint32_t i = 0; i < num_segs; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
+        Compiler_Prefetch(compiler, seg_reader);
+    }
+
     // Accumulate hits into the Collector.
-    for (uint32_t i = 0, max = VA_Get_Size(seg_readers); i < max; i++) {
+    for (uint32_t i = 0; i < num_segs; i++) {
         SegReader *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
-        DeletionsReader *del_reader = (DeletionsReader*)SegReader_Fetch(
-                                          seg_reader,
-                                          VTable_Get_Name(DELETIONSREADER));
         Matcher *matcher
             = Compiler_Make_Matcher(compiler, seg_reader, need_score);
         if (matcher) {
+            DeletionsReader *del_reader
+                = (DeletionsReader*)SegReader_Fetch(
+                      seg_reader, VTable_Get_Name(DELETIONSREADER));
             int32_t  seg_start = I32Arr_Get(seg_starts, i);
             Matcher *deletions = DelReader_Iterator(del_reader);
             Coll_Set_Reader(collector, seg_reader);
@@ -292,6 +292,19 @@ PhraseCompiler_make_matcher(PhraseCompiler *self, SegReader *reader,
     return retval;
 }
 
+void
+PhraseCompiler_prefetch(PhraseCompiler *self, SegReader *reader) {
+    PhraseQuery *const parent = (PhraseQuery*)self->parent;
+    PostingListReader *const plist_reader
+        = (PostingListReader*)SegReader_Fetch(
+              reader, VTable_Get_Name(POSTINGLISTREADER));
+    if (!plist_reader) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(parent->terms); i < max; i++) {
+        Obj *term = VA_Fetch(parent->terms, i);
+        PListReader_Prefetch_Term(plist_reader, parent->field, term);
+    }
+}
+
 VArray*
 PhraseCompiler_highlight_spans(PhraseCompiler *self, Searcher *searcher,
                                DocVector *doc_vec, const CharBuf *field) {
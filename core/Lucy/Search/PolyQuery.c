@@ -20,6 +20,7 @@
 
 #include "Lucy/Search/PolyQuery.h"
 #include "Lucy/Index/DocVector.h"
+#include "Lucy/Index/SegReader.h"
 #include "Lucy/Index/Similarity.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Search/Searcher.h"
@@ -149,6 +150,14 @@ PolyCompiler_apply_norm_factor(PolyCompiler *self, float factor) {
     }
 }
 
+void
+PolyCompiler_prefetch(PolyCompiler *self, SegReader *reader) {
+    for (uint32_t i = 0, max = VA_Get_Size(self->children); i < max; i++) {
+        Compiler *child = (Compiler*)VA_Fetch(self->children, i);
+        Compiler_Prefetch(child, reader);
+    }
+}
+
 VArray*
 PolyCompiler_highlight_spans(PolyCompiler *self, Searcher *searcher,
                              DocVector *doc_vec, const CharBuf *field) {
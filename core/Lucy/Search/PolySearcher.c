@@ -86,6 +86,91 @@ PolySearcher_fetch_doc(PolySearcher *self, int32_t doc_id) {
     return hit_doc;
 }
 
+HitDoc*
+PolySearcher_fetch_doc_fields(PolySearcher *self, int32_t doc_id,
+                              VArray *fields) {
+    uint32_t  tick     = PolyReader_sub_tick(self->starts, doc_id);
+    Searcher *searcher = (Searcher*)VA_Fetch(self->searchers, tick);
+    int32_t   offset   = I32Arr_Get(self->starts, tick);
+    if (!searcher) { THROW(ERR, "Invalid doc id: %i32", doc_id); }
+    HitDoc *hit_doc
+        = Searcher_Fetch_Doc_Fields(searcher, doc_id - offset, fields);
+    HitDoc_Set_Doc_ID(hit_doc, doc_id);
+    return hit_doc;
+}
+
+VArray*
+PolySearcher_fetch_docs(PolySearcher *self, I32Array *doc_ids) {
+    const uint32_t num_ids       = I32Arr_Get_Size(doc_ids);
+    const uint32_t num_searchers = VA_Get_Size(self->searchers);
+    VArray   *hit_docs  = VA_new(num_ids);
+    int32_t  *local_ids = (int32_t*)MALLOCATE(num_ids * sizeof(int32_t) + 1);
+    uint32_t *ticks     = (uint32_t*)MALLOCATE(num_ids * sizeof(uint32_t) + 1);
+
+    // Hand each sub-searcher one batch holding all of its docs, then put
+    // the results back in the requested order.
+    for (uint32_t tick = 0; tick < num_searchers; tick++) {
+        Searcher *searcher = (Searcher*)VA_Fetch(self->searchers, tick);
+        int32_t   start    = I32Arr_Get(self->starts, tick);
+        uint32_t  count    = 0;
+        if (!searcher) { continue; }
+        for (uint32_t i = 0; i < num_ids; i++) {
+            int32_t doc_id = I32Arr_Get(doc_ids, i);
+            if (PolyReader_sub_tick(self->starts, doc_id) == tick) {
+                local_ids[count] = doc_id - start;
+                ticks[count]     = i;
+                count++;
+            }
+        }
+        if (!count) { continue; }
+        I32Array *sub_ids  = I32Arr_new(local_ids, count);
+        VArray   *sub_docs = Searcher_Fetch_Docs(searcher, sub_ids);
+        for (uint32_t i = 0; i < count; i++) {
+            HitDoc *hit_doc = (HitDoc*)VA_Delete(sub_docs, i);
+            HitDoc_Set_Doc_ID(hit_doc, local_ids[i] + start);
+            VA_Store(hit_docs, ticks[i], (Obj*)hit_doc);
+        }
+        DECREF(sub_docs);
+        DECREF(sub_ids);
+    }
+
+    FREEMEM(local_ids);
+    FREEMEM(ticks);
+    for (uint32_t i = 0; i < num_ids; i++) {
+        if (!VA_Fetch(hit_docs, i)) {
+            DECREF(hit_docs);
+            THROW(ERR, "Invalid doc id: %i32", I32Arr_Get(doc_ids, i));
+        }
+    }
+    return hit_docs;
+}
+
+void
+PolySearcher_prefetch_docs(PolySearcher *self, I32Array *doc_ids) {
+    const uint32_t num_ids = I32Arr_Get_Size(doc_ids);
+    const uint32_t num_searchers = VA_Get_Size(self->searchers);
+    if (!num_ids) { return; }
+    int32_t *local_ids = (int32_t*)MALLOCATE(num_ids * sizeof(int32_t));
+    for (uint32_t tick = 0; tick < num_searchers; tick++) {
+        Searcher *searcher = (Searcher*)VA_Fetch(self->searchers, tick);
+        int32_t   start    = I32Arr_Get(self->starts, tick);
+        uint32_t  count    = 0;
+        if (!searcher) { continue; }
+        for (uint32_t i = 0; i < num_ids; i++) {
+            int32_t doc_id = I32Arr_Get(doc_ids, i);
+            if (PolyReader_sub_tick(self->starts, doc_id) == tick) {
+                local_ids[count++] = doc_id - start;
+            }
+        }
+        if (count) {
+            I32Array *sub_ids = I32Arr_new(local_ids, count);
+            Searcher_Prefetch_Docs(searcher, sub_ids);
+            DECREF(sub_ids);
+        }
+    }
+    FREEMEM(local_ids);
+}
+
 DocVector*
 PolySearcher_fetch_doc_vec(PolySearcher *self, int32_t doc_id) {
     uint32_t  tick     = PolyReader_sub_tick(self->starts, doc_id);
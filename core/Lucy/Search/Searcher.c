@@ -19,6 +19,7 @@
 
 #include "Lucy/Search/Searcher.h"
 
+#include "Lucy/Document/HitDoc.h"
 #include "Lucy/Index/DocVector.h"
 #include "Lucy/Plan/Schema.h"
 #include "Lucy/Search/Collector.h"
@@ -90,6 +91,30 @@ Searcher_get_schema(Searcher *self) {
     return self->schema;
 }
 
+HitDoc*
+Searcher_fetch_doc_fields(Searcher *self, int32_t doc_id, VArray *fields) {
+    UNUSED_VAR(fields);
+    return Searcher_Fetch_Doc(self, doc_id);
+}
+
+VArray*
+Searcher_fetch_docs(Searcher *self, I32Array *doc_ids) {
+    const uint32_t num_ids  = I32Arr_Get_Size(doc_ids);
+    VArray        *hit_docs = VA_new(num_ids);
+    Searcher_Prefetch_Docs(self, doc_ids);
+    for (uint32_t i = 0; i < num_ids; i++) {
+        HitDoc *hit_doc = Searcher_Fetch_Doc(self, I32Arr_Get(doc_ids, i));
+        VA_Push(hit_docs, (Obj*)hit_doc);
+    }
+    return hit_docs;
+}
+
+void
+Searcher_prefetch_docs(Searcher *self, I32Array *doc_ids) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(doc_ids);
+}
+
 void
 Searcher_close(Searcher *self) {
     UNUSED_VAR(self);
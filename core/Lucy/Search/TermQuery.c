@@ -240,6 +240,18 @@ TermCompiler_make_matcher(TermCompiler *self, SegReader *reader,
     }
 }
 
+void
+TermCompiler_prefetch(TermCompiler *self, SegReader *reader) {
+    TermQuery *tparent = (TermQuery*)self->parent;
+    PostingListReader *plist_reader
+        = (PostingListReader*)SegReader_Fetch(
+              reader, VTable_Get_Name(POSTINGLISTREADER));
+    if (plist_reader) {
+        PListReader_Prefetch_Term(plist_reader, tparent->field,
+                                  tparent->term);
+    }
+}
+
 VArray*
 TermCompiler_highlight_spans(TermCompiler *self, Searcher *searcher,
                              DocVector *doc_vec, const CharBuf *field) {
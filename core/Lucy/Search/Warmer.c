@@ -0,0 +1,175 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_WARMER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Search/Warmer.h"
+#include "Lucy/Document/HitDoc.h"
+#include "Lucy/Index/DeletionsReader.h"
+#include "Lucy/Index/HighlightReader.h"
+#include "Lucy/Index/LexiconReader.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Index/SortReader.h"
+#include "Lucy/Search/Hits.h"
+#include "Lucy/Search/Searcher.h"
+#include "Lucy/Search/SortSpec.h"
+#include "Lucy/Store/Folder.h"
+#include "Lucy/Store/InStream.h"
+
+Warmer*
+Warmer_new() {
+    Warmer *self = (Warmer*)VTable_Make_Obj(WARMER);
+    return Warmer_init(self);
+}
+
+Warmer*
+Warmer_init(Warmer *self) {
+    self->queries     = VA_new(0);
+    self->sort_specs  = VA_new(0);
+    self->suffixes    = VA_new(0);
+    self->num_wanted  = 10;
+    self->sort_caches    = true;
+    self->highlight_data = true;
+    return self;
+}
+
+void
+Warmer_destroy(Warmer *self) {
+    DECREF(self->queries);
+    DECREF(self->sort_specs);
+    DECREF(self->suffixes);
+    SUPER_DESTROY(self, WARMER);
+}
+
+void
+Warmer_add_query(Warmer *self, Obj *query, SortSpec *sort_spec) {
+    uint32_t tick = VA_Get_Size(self->queries);
+    VA_Push(self->queries, INCREF(query));
+    if (sort_spec) {
+        VA_Store(self->sort_specs, tick, INCREF(sort_spec));
+    }
+}
+
+void
+Warmer_add_prefetch_suffix(Warmer *self, const CharBuf *suffix) {
+    VA_Push(self->suffixes, (Obj*)CB_Clone(suffix));
+}
+
+void
+Warmer_set_sort_caches(Warmer *self, bool_t sort_caches) {
+    self->sort_caches = sort_caches;
+}
+
+bool_t
+Warmer_get_sort_caches(Warmer *self) {
+    return self->sort_caches;
+}
+
+void
+Warmer_set_highlight_data(Warmer *self, bool_t highlight_data) {
+    self->highlight_data = highlight_data;
+}
+
+bool_t
+Warmer_get_highlight_data(Warmer *self) {
+    return self->highlight_data;
+}
+
+void
+Warmer_set_num_wanted(Warmer *self, uint32_t num_wanted) {
+    self->num_wanted = num_wanted;
+}
+
+uint32_t
+Warmer_get_num_wanted(Warmer *self) {
+    return self->num_wanted;
+}
+
+static void
+S_prefetch_files(Warmer *self, SegReader *seg_reader) {
+    Folder  *folder   = SegReader_Get_Folder(seg_reader);
+    CharBuf *seg_name = SegReader_Get_Seg_Name(seg_reader);
+    VArray  *entries  = Folder_List(folder, seg_name);
+    if (!entries) { return; }
+
+    CharBuf *path = CB_new(40);
+    for (uint32_t i = 0, max = VA_Get_Size(entries); i < max; i++) {
+        CharBuf *entry = (CharBuf*)VA_Fetch(entries, i);
+        for (uint32_t j = 0, limit = VA_Get_Size(self->suffixes);
+             j < limit;
+             j++
+            ) {
+            CharBuf *suffix = (CharBuf*)VA_Fetch(self->suffixes, j);
+            if (CB_Ends_With(entry, suffix)) {
+                CB_setf(path, "%o/%o", seg_name, entry);
+                InStream *instream = Folder_Open_In(folder, path);
+                // Warming is best-effort, so skip what won't open.
+                if (instream) {
+                    InStream_Prefetch(instream, 0, InStream_Length(instream));
+                    InStream_Close(instream);
+                    DECREF(instream);
+                }
+                break;
+            }
+        }
+    }
+    DECREF(path);
+    DECREF(entries);
+}
+
+void
+Warmer_warm_seg_reader(Warmer *self, SegReader *seg_reader) {
+    LexiconReader *lex_reader
+        = (LexiconReader*)SegReader_Fetch(seg_reader,
+                                          VTable_Get_Name(LEXICONREADER));
+    if (lex_reader) { LexReader_Warm(lex_reader); }
+    DeletionsReader *del_reader
+        = (DeletionsReader*)SegReader_Fetch(seg_reader,
+                                            VTable_Get_Name(DELETIONSREADER));
+    if (del_reader) { DelReader_Warm(del_reader); }
+    if (self->highlight_data) {
+        HighlightReader *hl_reader
+            = (HighlightReader*)SegReader_Fetch(
+                  seg_reader, VTable_Get_Name(HIGHLIGHTREADER));
+        if (hl_reader) { HLReader_Warm(hl_reader); }
+    }
+    if (self->sort_caches) {
+        SortReader *sort_reader = (SortReader*)SegReader_Fetch(
+                                      seg_reader, VTable_Get_Name(SORTREADER));
+        if (sort_reader) { SortReader_Warm(sort_reader); }
+    }
+    if (VA_Get_Size(self->suffixes)) {
+        S_prefetch_files(self, seg_reader);
+    }
+}
+
+void
+Warmer_warm_searcher(Warmer *self, Searcher *searcher) {
+    for (uint32_t i = 0, max = VA_Get_Size(self->queries); i < max; i++) {
+        Obj      *query     = VA_Fetch(self->queries, i);
+        SortSpec *sort_spec = (SortSpec*)VA_Fetch(self->sort_specs, i);
+        Hits     *hits      = Searcher_Hits(searcher, query, 0,
+                                            self->num_wanted, sort_spec);
+        HitDoc   *hit;
+        while (NULL != (hit = Hits_Next(hits))) {
+            DECREF(hit);
+        }
+        DECREF(hits);
+    }
+}
+
+
@@ -0,0 +1,311 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_ARENAFOLDER
+#define C_LUCY_ARENAMAPPING
+#define C_LUCY_RAMFOLDER
+#define C_LUCY_FILEWINDOW
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Store/ArenaFolder.h"
+#include "Lucy/Store/CompoundFileReader.h"
+#include "Lucy/Store/FileWindow.h"
+#include "Lucy/Store/FSFileHandle.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RAMFile.h"
+#include "Lucy/Util/IndexFileNames.h"
+#include "Lucy/Util/Json.h"
+#include "Lucy/Util/NumberUtils.h"
+
+#define ARENA_MAGIC       "LUCYARNA"
+#define ARENA_MAGIC_LEN   8
+#define ARENA_TRAILER_LEN (8 + ARENA_MAGIC_LEN)
+
+// Start each file on a cache line, and on a boundary at least as strict as
+// malloc's so that code which maps ints directly out of file contents works.
+#define ARENA_ALIGN 64
+
+// Touch stride when populating.  Pages are never smaller than this.
+#define ARENA_PAGE_SIZE 4096
+
+int32_t ArenaFolder_current_file_format = 1;
+
+// Load the arena's directory and create a RAMFile for each file.
+static Err*
+S_load_entries(ArenaFolder *self);
+
+// Return true for the container files of a consolidated segment, which are
+// written out as the virtual files they hold.
+static bool_t
+S_is_compound_container(Folder *folder, const CharBuf *path);
+
+ArenaFolder*
+ArenaFolder_open(const CharBuf *path, bool_t populate) {
+    ArenaFolder *self = (ArenaFolder*)VTable_Make_Obj(ARENAFOLDER);
+    return ArenaFolder_do_open(self, path, populate);
+}
+
+ArenaFolder*
+ArenaFolder_do_open(ArenaFolder *self, const CharBuf *path,
+                    bool_t populate) {
+    RAMFolder_init((RAMFolder*)self, NULL);
+
+    FileHandle *fh = (FileHandle*)FSFH_open(path, FH_READ_ONLY);
+    if (!fh) {
+        ERR_ADD_FRAME(Err_get_error());
+        DECREF(self);
+        return NULL;
+    }
+    self->mapping = ArenaMap_new(fh);
+    DECREF(fh);
+    if (!self->mapping) {
+        ERR_ADD_FRAME(Err_get_error());
+        DECREF(self);
+        return NULL;
+    }
+
+    Err *error = S_load_entries(self);
+    if (error) {
+        Err_set_error(error);
+        DECREF(self);
+        return NULL;
+    }
+
+    if (populate) {
+        char    *buf = ArenaMap_Get_Buf(self->mapping);
+        int64_t  len = ArenaMap_Get_Len(self->mapping);
+        volatile char sink = 0;
+        FH_Prefetch(self->mapping->file_handle, 0, len);
+        for (int64_t i = 0; i < len; i += ARENA_PAGE_SIZE) {
+            sink ^= buf[i];
+        }
+        UNUSED_VAR(sink);
+    }
+
+    return self;
+}
+
+void
+ArenaFolder_destroy(ArenaFolder *self) {
+    DECREF(self->mapping);
+    SUPER_DESTROY(self, ARENAFOLDER);
+}
+
+static Err*
+S_load_entries(ArenaFolder *self) {
+    char    *buf = ArenaMap_Get_Buf(self->mapping);
+    int64_t  len = ArenaMap_Get_Len(self->mapping);
+    CharBuf *path = FH_Get_Path(self->mapping->file_handle);
+
+    // Validate header and trailer, then find the directory.
+    if (len < ARENA_MAGIC_LEN + ARENA_TRAILER_LEN
+        || memcmp(buf, ARENA_MAGIC, ARENA_MAGIC_LEN) != 0
+        || memcmp(buf + len - ARENA_MAGIC_LEN, ARENA_MAGIC,
+                  ARENA_MAGIC_LEN) != 0
+       ) {
+        return Err_new(CB_newf("Not an arena file: '%o'", path));
+    }
+    int64_t meta_start
+        = (int64_t)NumUtil_decode_bigend_u64(buf + len - ARENA_TRAILER_LEN);
+    int64_t meta_end = len - ARENA_TRAILER_LEN;
+    if (meta_start < ARENA_MAGIC_LEN || meta_start > meta_end) {
+        return Err_new(CB_newf("Corrupt arena file '%o': bad directory "
+                               "offset %i64", path, meta_start));
+    }
+    CharBuf *json = CB_new_from_utf8(buf + meta_start,
+                                     (size_t)(meta_end - meta_start));
+    Hash *metadata = (Hash*)Json_from_json(json);
+    DECREF(json);
+    if (!metadata || !Hash_Is_A(metadata, HASH)) {
+        DECREF(metadata);
+        return Err_new(CB_newf("Corrupt arena file '%o': can't parse "
+                               "directory", path));
+    }
+
+    Obj    *format = Hash_Fetch_Str(metadata, "format", 6);
+    Hash   *files  = (Hash*)Hash_Fetch_Str(metadata, "files", 5);
+    VArray *dirs   = (VArray*)Hash_Fetch_Str(metadata, "dirs", 4);
+    int32_t format_num = format ? (int32_t)Obj_To_I64(format) : 0;
+    Err    *error  = NULL;
+    if (format_num < 1 || format_num > ArenaFolder_current_file_format) {
+        error = Err_new(CB_newf("Unsupported arena file format: %i32 "
+                                "(current = %i32)", format_num,
+                                ArenaFolder_current_file_format));
+    }
+    else if (!files || !Hash_Is_A(files, HASH)
+             || !dirs || !VA_Is_A(dirs, VARRAY)
+            ) {
+        error = Err_new(CB_newf("Corrupt arena file '%o': missing 'files' "
+                                "or 'dirs'", path));
+    }
+
+    // Directories were recorded parents first.
+    for (uint32_t i = 0, max = error ? 0 : VA_Get_Size(dirs);
+         i < max && !error;
+         i++
+        ) {
+        CharBuf *dir = (CharBuf*)CERTIFY(VA_Fetch(dirs, i), CHARBUF);
+        if (!ArenaFolder_MkDir(self, dir)) {
+            error = (Err*)INCREF(Err_get_error());
+        }
+    }
+
+    if (!error) {
+        CharBuf *file_path;
+        Hash    *record;
+        Hash_Iterate(files);
+        while (Hash_Next(files, (Obj**)&file_path, (Obj**)&record)) {
+            Obj *offset_obj = Hash_Fetch_Str(record, "offset", 6);
+            Obj *length_obj = Hash_Fetch_Str(record, "length", 6);
+            int64_t offset = offset_obj ? Obj_To_I64(offset_obj) : -1;
+            int64_t length = length_obj ? Obj_To_I64(length_obj) : -1;
+            if (offset < ARENA_MAGIC_LEN || length < 0
+                || offset + length > meta_start
+               ) {
+                error = Err_new(CB_newf("Corrupt arena file '%o': bad "
+                                        "record for '%o'", path, file_path));
+                break;
+            }
+            RAMFolder *enclosing = (RAMFolder*)ArenaFolder_Enclosing_Folder(
+                                       self, file_path);
+            if (!enclosing) {
+                error = Err_new(CB_newf("Corrupt arena file '%o': no "
+                                        "directory for '%o'", path,
+                                        file_path));
+                break;
+            }
+            ZombieCharBuf *name
+                = IxFileNames_local_part(file_path, ZCB_BLANK());
+            ViewByteBuf *contents = ViewBB_new(buf + offset, (size_t)length);
+            RAMFile *file = RAMFile_new((ByteBuf*)contents, true);
+            RAMFile_Set_Backing(file, (Obj*)self->mapping);
+            Hash_Store(enclosing->entries, (Obj*)name, (Obj*)file);
+            DECREF(contents);
+        }
+    }
+
+    DECREF(metadata);
+    return error;
+}
+
+void
+ArenaFolder_write_arena(Folder *folder, const CharBuf *path) {
+    OutStream *outstream = OutStream_open((Obj*)path);
+    if (!outstream) { RETHROW(INCREF(Err_get_error())); }
+    VArray *entries  = Folder_List_R(folder, NULL);
+    VArray *dirs     = VA_new(0);
+    Hash   *files    = Hash_new(0);
+    Hash   *metadata = Hash_new(3);
+
+    // Sorting puts each directory ahead of its contents.
+    VA_Sort(entries, NULL, NULL);
+    OutStream_Write_Bytes(outstream, ARENA_MAGIC, ARENA_MAGIC_LEN);
+    for (uint32_t i = 0, max = VA_Get_Size(entries); i < max; i++) {
+        CharBuf *entry = (CharBuf*)VA_Fetch(entries, i);
+        if (Folder_Is_Directory(folder, entry)) {
+            VA_Push(dirs, INCREF(entry));
+            continue;
+        }
+        if (S_is_compound_container(folder, entry)) { continue; }
+
+        InStream *instream = Folder_Open_In(folder, entry);
+        if (!instream) { RETHROW(INCREF(Err_get_error())); }
+        int64_t offset = OutStream_Align(outstream, ARENA_ALIGN);
+        OutStream_Absorb(outstream, instream);
+        Hash *record = Hash_new(2);
+        Hash_Store_Str(record, "offset", 6, (Obj*)CB_newf("%i64", offset));
+        Hash_Store_Str(record, "length", 6,
+                       (Obj*)CB_newf("%i64", InStream_Length(instream)));
+        Hash_Store(files, (Obj*)entry, (Obj*)record);
+        InStream_Close(instream);
+        DECREF(instream);
+    }
+
+    // Append the directory, followed by its offset.
+    Hash_Store_Str(metadata, "format", 6,
+                   (Obj*)CB_newf("%i32", ArenaFolder_current_file_format));
+    Hash_Store_Str(metadata, "files", 5, (Obj*)files);
+    Hash_Store_Str(metadata, "dirs", 4, (Obj*)dirs);
+    CharBuf *json = Json_to_json((Obj*)metadata);
+    if (!json) { RETHROW(INCREF(Err_get_error())); }
+    int64_t meta_start = OutStream_Tell(outstream);
+    OutStream_Write_Bytes(outstream, CB_Get_Ptr8(json), CB_Get_Size(json));
+    OutStream_Write_U64(outstream, (uint64_t)meta_start);
+    OutStream_Write_Bytes(outstream, ARENA_MAGIC, ARENA_MAGIC_LEN);
+    OutStream_Close(outstream);
+
+    DECREF(json);
+    DECREF(metadata);
+    DECREF(entries);
+    DECREF(outstream);
+}
+
+static bool_t
+S_is_compound_container(Folder *folder, const CharBuf *path) {
+    ZombieCharBuf *name = IxFileNames_local_part(path, ZCB_BLANK());
+    if (!ZCB_Equals_Str(name, "cf.dat", 6)
+        && !ZCB_Equals_Str(name, "cfmeta.json", 11)
+       ) {
+        return false;
+    }
+    Folder *enclosing = Folder_Enclosing_Folder(folder, path);
+    return enclosing && Folder_Is_A(enclosing, COMPOUNDFILEREADER)
+           ? true : false;
+}
+
+/***************************************************************************/
+
+ArenaMapping*
+ArenaMap_new(FileHandle *file_handle) {
+    ArenaMapping *self = (ArenaMapping*)VTable_Make_Obj(ARENAMAPPING);
+    return ArenaMap_init(self, file_handle);
+}
+
+ArenaMapping*
+ArenaMap_init(ArenaMapping *self, FileHandle *file_handle) {
+    int64_t len = FH_Length(file_handle);
+    self->file_handle = (FileHandle*)INCREF(file_handle);
+    self->window      = FileWindow_new();
+    if (len < 0 || !FH_Window(file_handle, self->window, 0, len)) {
+        ERR_ADD_FRAME(Err_get_error());
+        DECREF(self);
+        return NULL;
+    }
+    return self;
+}
+
+void
+ArenaMap_destroy(ArenaMapping *self) {
+    if (self->window && self->window->buf) {
+        FH_Release_Window(self->file_handle, self->window);
+    }
+    DECREF(self->window);
+    DECREF(self->file_handle);
+    SUPER_DESTROY(self, ARENAMAPPING);
+}
+
+char*
+ArenaMap_get_buf(ArenaMapping *self) {
+    return self->window->buf;
+}
+
+int64_t
+ArenaMap_get_len(ArenaMapping *self) {
+    return self->window->len;
+}
+
+
@@ -0,0 +1,327 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_BLOCKCACHE
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Store/BlockCache.h"
+#include "Lucy/Store/FileHandle.h"
+
+// The highest priority which may be assigned to a block.
+#define MAX_PRIORITY 3
+
+// Upper limit on the number of blocks, so that slot ticks fit in an int32_t.
+#define MAX_BLOCKS 0x10000000
+
+/* A slot in the cache.  Slots holding a block are chained together via
+ * <next> within their hash bucket; empty slots have a <file_id> of 0, no
+ * <data>, and are chained together via <next> on the free list.
+ */
+typedef struct {
+    int64_t  file_id;
+    int64_t  block_num;
+    char    *data;
+    int32_t  len;
+    int32_t  pins;
+    int32_t  credit;
+    int32_t  next;
+} Block;
+
+static INLINE uint32_t
+SI_bucket(BlockCache *self, int64_t file_id, int64_t block_num) {
+    uint64_t hash = (uint64_t)file_id * U64_C(0x9E3779B97F4A7C15)
+                    ^ (uint64_t)block_num * U64_C(0xC2B2AE3D27D4EB4F);
+    return (uint32_t)(hash >> 32) & self->bucket_mask;
+}
+
+// Return the tick of the slot holding a block, or -1 if it isn't cached.
+static int32_t
+S_find(BlockCache *self, int64_t file_id, int64_t block_num);
+
+// Remove a slot from its hash bucket.
+static void
+S_unlink(BlockCache *self, int32_t tick);
+
+// Empty a slot, free its data, and add it to the free list.
+static void
+S_release_slot(BlockCache *self, int32_t tick);
+
+// Return the tick of a slot with a block-sized buffer, not linked into any
+// hash bucket, evicting a block if necessary.
+static int32_t
+S_claim_slot(BlockCache *self);
+
+// Double the number of slots, adding the new ones to the free list.
+static void
+S_grow_slots(BlockCache *self);
+
+BlockCache*
+BlockCache_new(int64_t capacity, int32_t block_size) {
+    BlockCache *self = (BlockCache*)VTable_Make_Obj(BLOCKCACHE);
+    return BlockCache_init(self, capacity, block_size);
+}
+
+BlockCache*
+BlockCache_init(BlockCache *self, int64_t capacity, int32_t block_size) {
+    if (block_size < 512 || (block_size & (block_size - 1))) {
+        DECREF(self);
+        THROW(ERR, "block_size must be a power of 2 no smaller than 512: %i32",
+              block_size);
+    }
+    int64_t max_blocks = capacity / block_size;
+    if (max_blocks < 1)          { max_blocks = 1; }
+    if (max_blocks > MAX_BLOCKS) { max_blocks = MAX_BLOCKS; }
+
+    // Size the hash table at twice the number of blocks, rounded up to a
+    // power of two.
+    uint32_t num_buckets = 1;
+    while (num_buckets < max_blocks * 2) { num_buckets <<= 1; }
+
+    self->capacity      = capacity;
+    self->block_size    = block_size;
+    self->max_blocks    = (uint32_t)max_blocks;
+    self->num_slots     = 0;
+    self->num_allocated = 0;
+    self->blocks        = NULL;
+    self->free_list     = -1;
+    self->hand          = 0;
+    self->bucket_mask   = num_buckets - 1;
+    self->buckets       = (int32_t*)MALLOCATE(num_buckets * sizeof(int32_t));
+    for (uint32_t i = 0; i < num_buckets; i++) { self->buckets[i] = -1; }
+    self->next_file_id  = 1;
+    self->hits          = 0;
+    self->misses        = 0;
+    self->evictions     = 0;
+
+    S_grow_slots(self);
+    while (self->num_slots < self->max_blocks) { S_grow_slots(self); }
+
+    return self;
+}
+
+void
+BlockCache_destroy(BlockCache *self) {
+    Block *blocks = (Block*)self->blocks;
+    for (uint32_t i = 0; i < self->num_slots; i++) {
+        FREEMEM(blocks[i].data);
+    }
+    FREEMEM(self->blocks);
+    FREEMEM(self->buckets);
+    SUPER_DESTROY(self, BLOCKCACHE);
+}
+
+int64_t
+BlockCache_next_file_id(BlockCache *self) {
+    return self->next_file_id++;
+}
+
+char*
+BlockCache_pin(BlockCache *self, int64_t file_id, int64_t block_num,
+               FileHandle *source, int32_t len, int32_t priority) {
+    int32_t tick = S_find(self, file_id, block_num);
+    Block *block;
+
+    if (tick != -1) {
+        block = (Block*)self->blocks + tick;
+        self->hits++;
+    }
+    else if (len < 0 || len > self->block_size) {
+        Err_set_error(Err_new(CB_newf("Invalid block length %i32 for block "
+                                      "size %i32", len, self->block_size)));
+        return NULL;
+    }
+    else {
+        const int64_t offset = block_num * self->block_size;
+        tick  = S_claim_slot(self);
+        block = (Block*)self->blocks + tick;
+        if (!FH_Read(source, block->data, offset, (size_t)len)) {
+            S_release_slot(self, tick);
+            return NULL;
+        }
+        uint32_t bucket  = SI_bucket(self, file_id, block_num);
+        block->file_id   = file_id;
+        block->block_num = block_num;
+        block->len       = len;
+        block->pins      = 0;
+        block->next      = self->buckets[bucket];
+        self->buckets[bucket] = tick;
+        self->misses++;
+    }
+
+    if (priority < 0)            { priority = 0; }
+    if (priority > MAX_PRIORITY) { priority = MAX_PRIORITY; }
+    block->credit = priority + 1;
+    block->pins++;
+    return block->data;
+}
+
+void
+BlockCache_unpin(BlockCache *self, int64_t file_id, int64_t block_num) {
+    int32_t tick = S_find(self, file_id, block_num);
+    Block *block = tick == -1 ? NULL : (Block*)self->blocks + tick;
+    if (!block || !block->pins) {
+        THROW(ERR, "Block %i64 of file %i64 isn't pinned", block_num,
+              file_id);
+    }
+    block->pins--;
+
+    // Give back memory claimed while every block was pinned.
+    if (!block->pins && self->num_allocated > self->max_blocks) {
+        S_unlink(self, tick);
+        S_release_slot(self, tick);
+    }
+}
+
+void
+BlockCache_purge(BlockCache *self, int64_t file_id) {
+    Block *blocks = (Block*)self->blocks;
+    for (uint32_t i = 0; i < self->num_slots; i++) {
+        if (blocks[i].file_id == file_id && !blocks[i].pins) {
+            S_unlink(self, (int32_t)i);
+            S_release_slot(self, (int32_t)i);
+        }
+    }
+}
+
+int64_t
+BlockCache_get_hits(BlockCache *self) {
+    return self->hits;
+}
+
+int64_t
+BlockCache_get_misses(BlockCache *self) {
+    return self->misses;
+}
+
+int64_t
+BlockCache_get_evictions(BlockCache *self) {
+    return self->evictions;
+}
+
+int64_t
+BlockCache_get_capacity(BlockCache *self) {
+    return self->capacity;
+}
+
+int32_t
+BlockCache_get_block_size(BlockCache *self) {
+    return self->block_size;
+}
+
+int64_t
+BlockCache_memory_usage(BlockCache *self) {
+    return (int64_t)self->num_allocated * self->block_size;
+}
+
+static int32_t
+S_find(BlockCache *self, int64_t file_id, int64_t block_num) {
+    Block *blocks = (Block*)self->blocks;
+    int32_t tick = self->buckets[SI_bucket(self, file_id, block_num)];
+    while (tick != -1) {
+        Block *block = blocks + tick;
+        if (block->file_id == file_id && block->block_num == block_num) {
+            return tick;
+        }
+        tick = block->next;
+    }
+    return -1;
+}
+
+static void
+S_unlink(BlockCache *self, int32_t tick) {
+    Block   *blocks = (Block*)self->blocks;
+    Block   *block  = blocks + tick;
+    int32_t *link   = self->buckets + SI_bucket(self, block->file_id,
+                                                block->block_num);
+    while (*link != tick) {
+        link = &blocks[*link].next;
+    }
+    *link = block->next;
+}
+
+static void
+S_release_slot(BlockCache *self, int32_t tick) {
+    Block *block = (Block*)self->blocks + tick;
+    FREEMEM(block->data);
+    block->data    = NULL;
+    block->file_id = 0;
+    block->pins    = 0;
+    block->next    = self->free_list;
+    self->free_list = tick;
+    self->num_allocated--;
+}
+
+static int32_t
+S_claim_slot(BlockCache *self) {
+    Block *blocks = (Block*)self->blocks;
+    int32_t tick;
+
+    // Allocate a fresh block if we're within budget.
+    if (self->num_allocated < self->max_blocks && self->free_list != -1) {
+        tick = self->free_list;
+    }
+    else {
+        // Sweep the clock, evicting the first unpinned block whose credit
+        // has run out.  Every block runs out within MAX_PRIORITY + 1
+        // revolutions unless it's pinned.
+        const uint32_t max_steps = self->num_slots * (MAX_PRIORITY + 2);
+        for (uint32_t i = 0; i < max_steps; i++) {
+            Block *block = blocks + self->hand;
+            tick = (int32_t)self->hand;
+            self->hand = (self->hand + 1) % self->num_slots;
+            if (!block->file_id || block->pins) {
+                continue;
+            }
+            else if (block->credit) {
+                block->credit--;
+            }
+            else {
+                S_unlink(self, tick);
+                self->evictions++;
+                return tick;
+            }
+        }
+
+        // Every block is pinned, so exceed the budget.
+        if (self->free_list == -1) { S_grow_slots(self); }
+        tick = self->free_list;
+    }
+
+    Block *block = (Block*)self->blocks + tick;
+    self->free_list = block->next;
+    block->data = (char*)MALLOCATE(self->block_size);
+    self->num_allocated++;
+    return tick;
+}
+
+static void
+S_grow_slots(BlockCache *self) {
+    uint32_t old_size = self->num_slots;
+    uint32_t new_size = old_size ? old_size * 2 : 1;
+    if (new_size > MAX_BLOCKS) {
+        THROW(ERR, "Too many pinned blocks in BlockCache: %u32", old_size);
+    }
+    self->blocks = REALLOCATE(self->blocks, new_size * sizeof(Block));
+    Block *blocks = (Block*)self->blocks;
+    memset(blocks + old_size, 0, (new_size - old_size) * sizeof(Block));
+    for (uint32_t i = new_size; i-- > old_size;) {
+        blocks[i].next  = self->free_list;
+        self->free_list = (int32_t)i;
+    }
+    self->num_slots = new_size;
+}
+
+
@@ -0,0 +1,254 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_CACHEDFILEHANDLE
+#define C_LUCY_FILEHANDLE
+#define C_LUCY_FILEWINDOW
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Store/CachedFileHandle.h"
+#include "Lucy/Store/BlockCache.h"
+#include "Lucy/Store/FileWindow.h"
+#include "Lucy/Util/IndexFileNames.h"
+
+// Verify that a read of <len> bytes at <offset> lies within the file.
+static bool_t
+S_check_range(CachedFileHandle *self, int64_t offset, int64_t len);
+
+// Return the length of a block, which is shorter than the block size only
+// for the last block of the file.
+static INLINE int32_t
+SI_block_len(CachedFileHandle *self, int64_t block_num, int64_t block_size) {
+    const int64_t remaining = self->len - block_num * block_size;
+    return (int32_t)(remaining < block_size ? remaining : block_size);
+}
+
+CachedFileHandle*
+CachedFH_open(FileHandle *inner, BlockCache *cache) {
+    CachedFileHandle *self
+        = (CachedFileHandle*)VTable_Make_Obj(CACHEDFILEHANDLE);
+    return CachedFH_do_open(self, inner, cache);
+}
+
+CachedFileHandle*
+CachedFH_do_open(CachedFileHandle *self, FileHandle *inner,
+                 BlockCache *cache) {
+    CharBuf *path = FH_Get_Path(inner);
+    FH_do_open((FileHandle*)self, path, FH_READ_ONLY);
+    self->inner    = (FileHandle*)INCREF(inner);
+    self->cache    = (BlockCache*)INCREF(cache);
+    self->parent   = NULL;
+    self->file_id  = BlockCache_Next_File_ID(cache);
+    self->priority = CachedFH_priority(path);
+    self->len      = FH_Length(inner);
+
+    if (!(inner->flags & FH_READ_ONLY)) {
+        Err_set_error(Err_new(CB_newf("Can't cache writable file '%o'",
+                                      path)));
+        DECREF(self);
+        return NULL;
+    }
+    if (self->len == -1) {
+        ERR_ADD_FRAME(Err_get_error());
+        DECREF(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+void
+CachedFH_destroy(CachedFileHandle *self) {
+    // Blocks are shared with derived handles, which keep their parent alive.
+    if (!self->parent && self->cache) {
+        BlockCache_Purge(self->cache, self->file_id);
+    }
+    DECREF(self->parent);
+    DECREF(self->inner);
+    DECREF(self->cache);
+    SUPER_DESTROY(self, CACHEDFILEHANDLE);
+}
+
+CachedFileHandle*
+CachedFH_derive(CachedFileHandle *self, const CharBuf *path) {
+    CachedFileHandle *twin
+        = (CachedFileHandle*)VTable_Make_Obj(CACHEDFILEHANDLE);
+    FH_do_open((FileHandle*)twin, self->path, FH_READ_ONLY);
+    twin->inner    = (FileHandle*)INCREF(self->inner);
+    twin->cache    = (BlockCache*)INCREF(self->cache);
+    twin->parent   = (CachedFileHandle*)INCREF(self->parent
+                                                ? (Obj*)self->parent
+                                                : (Obj*)self);
+    twin->file_id  = self->file_id;
+    twin->priority = CachedFH_priority(path);
+    twin->len      = self->len;
+    return twin;
+}
+
+int32_t
+CachedFH_priority(const CharBuf *path) {
+    ZombieCharBuf *name = IxFileNames_local_part(path, ZCB_BLANK());
+    if (ZCB_Starts_With_Str(name, "lexicon", 7)
+        || ZCB_Ends_With_Str(name, ".skip", 5)
+        || ZCB_Ends_With_Str(name, ".ixix", 5)
+       ) {
+        return 3;
+    }
+    else if (ZCB_Ends_With_Str(name, ".ix", 3)
+             || ZCB_Starts_With_Str(name, "postings", 8)
+             || ZCB_Starts_With_Str(name, "sort", 4)
+            ) {
+        return 2;
+    }
+    else if (ZCB_Equals_Str(name, "documents.dat", 13)
+             || ZCB_Equals_Str(name, "highlight.dat", 13)
+            ) {
+        return 0;
+    }
+    return 1;
+}
+
+bool_t
+CachedFH_window(CachedFileHandle *self, FileWindow *window, int64_t offset,
+                int64_t len) {
+    const int64_t block_size  = BlockCache_Get_Block_Size(self->cache);
+    const int64_t block_num   = offset / block_size;
+    const int64_t block_start = block_num * block_size;
+
+    if (!S_check_range(self, offset, len)) { return false; }
+    CachedFH_Release_Window(self, window);
+
+    if (!len) {
+        FileWindow_Set_Window(window, NULL, offset, 0);
+    }
+    else if (offset + len <= block_start + block_size) {
+        // Expose the whole block, so that the InStream can keep reading
+        // from it without asking for another window.
+        const int32_t block_len = SI_block_len(self, block_num, block_size);
+        char *buf = BlockCache_Pin(self->cache, self->file_id, block_num,
+                                   self->inner, block_len, self->priority);
+        if (!buf) { return false; }
+        FileWindow_Set_Window(window, buf, block_start, block_len);
+    }
+    else if (len > block_size) {
+        // Large windows, such as whole-file maps, bypass the cache rather
+        // than being copied outside its budget.
+        return FH_Window(self->inner, window, offset, len);
+    }
+    else {
+        // A straddling window no bigger than a block is copied.
+        char *buf = (char*)MALLOCATE((size_t)len);
+        if (!CachedFH_Read(self, buf, offset, (size_t)len)) {
+            FREEMEM(buf);
+            return false;
+        }
+        FileWindow_Set_Window(window, buf, offset, len);
+    }
+
+    return true;
+}
+
+bool_t
+CachedFH_release_window(CachedFileHandle *self, FileWindow *window) {
+    if (window->buf != NULL) {
+        // Windows onto a cached block always start on a block boundary and
+        // never exceed a block.  Larger windows belong to the inner handle,
+        // and anything else is a private buffer.
+        const int64_t block_size = BlockCache_Get_Block_Size(self->cache);
+        if (window->len > block_size) {
+            return FH_Release_Window(self->inner, window);
+        }
+        else if (window->offset % block_size) {
+            FREEMEM(window->buf);
+        }
+        else {
+            BlockCache_Unpin(self->cache, self->file_id,
+                             window->offset / block_size);
+        }
+    }
+    FileWindow_Set_Window(window, NULL, 0, 0);
+    return true;
+}
+
+bool_t
+CachedFH_read(CachedFileHandle *self, char *dest, int64_t offset,
+              size_t len) {
+    const int64_t block_size = BlockCache_Get_Block_Size(self->cache);
+
+    if (!S_check_range(self, offset, (int64_t)len)) { return false; }
+
+    while (len) {
+        const int64_t block_num = offset / block_size;
+        const int64_t skip      = offset - block_num * block_size;
+        const int32_t block_len = SI_block_len(self, block_num, block_size);
+        size_t to_copy = (size_t)(block_len - skip);
+        if (to_copy > len) { to_copy = len; }
+
+        char *buf = BlockCache_Pin(self->cache, self->file_id, block_num,
+                                   self->inner, block_len, self->priority);
+        if (!buf) { return false; }
+        memcpy(dest, buf + skip, to_copy);
+        BlockCache_Unpin(self->cache, self->file_id, block_num);
+
+        dest   += to_copy;
+        offset += (int64_t)to_copy;
+        len    -= to_copy;
+    }
+
+    return true;
+}
+
+bool_t
+CachedFH_write(CachedFileHandle *self, const void *data, size_t len) {
+    UNUSED_VAR(data);
+    UNUSED_VAR(len);
+    Err_set_error(Err_new(CB_newf("Can't write to read-only file '%o'",
+                                  self->path)));
+    return false;
+}
+
+int64_t
+CachedFH_length(CachedFileHandle *self) {
+    return self->len;
+}
+
+bool_t
+CachedFH_prefetch(CachedFileHandle *self, int64_t offset, int64_t len) {
+    return FH_Prefetch(self->inner, offset, len);
+}
+
+bool_t
+CachedFH_close(CachedFileHandle *self) {
+    UNUSED_VAR(self);
+    return true;
+}
+
+static bool_t
+S_check_range(CachedFileHandle *self, int64_t offset, int64_t len) {
+    if (offset < 0) {
+        Err_set_error(Err_new(CB_newf("Can't read from negative offset %i64",
+                                      offset)));
+        return false;
+    }
+    else if (offset + len > self->len) {
+        Err_set_error(Err_new(CB_newf("Tried to read past EOF: offset %i64 + request %i64 > len %i64",
+                                      offset, len, self->len)));
+        return false;
+    }
+    return true;
+}
+
+
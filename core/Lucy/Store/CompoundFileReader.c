@@ -16,9 +16,12 @@
 
 #define C_LUCY_COMPOUNDFILEREADER
 #define C_LUCY_CFREADERDIRHANDLE
+#define C_LUCY_INSTREAM
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Store/CompoundFileReader.h"
+#include "Lucy/Store/BlockCache.h"
+#include "Lucy/Store/CachedFileHandle.h"
 #include "Lucy/Store/CompoundFileWriter.h"
 #include "Lucy/Store/FileHandle.h"
 #include "Lucy/Store/InStream.h"
@@ -26,6 +29,12 @@
 #include "Lucy/Util/Json.h"
 #include "Lucy/Util/StringHelper.h"
 
+// Open an InStream for the virtual file <name>, which occupies <len> bytes
+// at <offset> within cf.dat.
+static InStream*
+S_open_virtual(CompoundFileReader *self, const CharBuf *name,
+               const CharBuf *filename, int64_t offset, int64_t len);
+
 CompoundFileReader*
 CFReader_open(Folder *folder) {
     CompoundFileReader *self
@@ -40,6 +49,7 @@ CFReader_do_open(CompoundFileReader *self, Folder *folder) {
     Err *error = NULL;
 
     Folder_init((Folder*)self, Folder_Get_Path(folder));
+    self->block_cache = (BlockCache*)INCREF(Folder_Get_Block_Cache(folder));
 
     // Parse metadata file.
     if (!metadata || !Hash_Is_A(metadata, HASH)) {
@@ -193,18 +203,45 @@ CFReader_local_open_in(CompoundFileReader *self, const CharBuf *name) {
         }
         else if (CB_Get_Size(self->path)) {
             CharBuf *fullpath = CB_newf("%o/%o", self->path, name);
-            InStream *instream = InStream_Reopen(self->instream, fullpath,
-                                                 Obj_To_I64(offset), Obj_To_I64(len));
+            InStream *instream = S_open_virtual(self, name, fullpath,
+                                                Obj_To_I64(offset),
+                                                Obj_To_I64(len));
             DECREF(fullpath);
             return instream;
         }
         else {
-            return InStream_Reopen(self->instream, name, Obj_To_I64(offset),
-                                   Obj_To_I64(len));
+            return S_open_virtual(self, name, name, Obj_To_I64(offset),
+                                  Obj_To_I64(len));
         }
     }
 }
 
+static InStream*
+S_open_virtual(CompoundFileReader *self, const CharBuf *name,
+               const CharBuf *filename, int64_t offset, int64_t len) {
+    FileHandle *file_handle = self->instream->file_handle;
+    if (file_handle && FH_Is_A(file_handle, CACHEDFILEHANDLE)) {
+        // Share cf.dat's cached blocks, but give them the priority of the
+        // virtual file.
+        CachedFileHandle *sub_fh
+            = CachedFH_Derive((CachedFileHandle*)file_handle, name);
+        InStream *outer    = InStream_open((Obj*)sub_fh);
+        InStream *instream = InStream_Reopen(outer, filename, offset, len);
+        DECREF(outer);
+        DECREF(sub_fh);
+        return instream;
+    }
+    return InStream_Reopen(self->instream, filename, offset, len);
+}
+
+void
+CFReader_set_block_cache(CompoundFileReader *self, BlockCache *block_cache) {
+    Folder_set_block_cache((Folder*)self, block_cache);
+    if (self->real_folder) {
+        Folder_Set_Block_Cache(self->real_folder, block_cache);
+    }
+}
+
 bool_t
 CFReader_local_exists(CompoundFileReader *self, const CharBuf *name) {
     if (Hash_Fetch(self->records, (Obj*)name))        { return true; }
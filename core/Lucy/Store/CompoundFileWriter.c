@@ -15,12 +15,18 @@
  */
 
 #define C_LUCY_COMPOUNDFILEWRITER
+#define C_LUCY_COMPOUNDFILESTREAM
+#define C_LUCY_CFSTREAMFILEHANDLE
+#define C_LUCY_FOLDER
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Store/CompoundFileWriter.h"
+#include "Lucy/Store/FileHandle.h"
+#include "Lucy/Store/FileWindow.h"
 #include "Lucy/Store/Folder.h"
 #include "Lucy/Store/InStream.h"
 #include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/ThrottledFileHandle.h"
 #include "Lucy/Util/IndexFileNames.h"
 #include "Lucy/Util/Json.h"
 
@@ -72,7 +78,10 @@ S_clean_up_old_temp_files(CompoundFileWriter *self) {
     CharBuf *cfmeta_temp = (CharBuf*)ZCB_WRAP_STR("cfmeta.json.temp", 16);
     CharBuf *cf_file     = (CharBuf*)ZCB_WRAP_STR("cf.dat", 6);
 
-    if (Folder_Exists(folder, cf_file)) {
+    // Leave cf.dat alone if sub-files are being streamed into it.
+    bool_t streaming = folder->cf_stream && folder->cf_stream->file_handle
+                       ? true : false;
+    if (!streaming && Folder_Exists(folder, cf_file)) {
         if (!Folder_Delete(folder, cf_file)) {
             THROW(ERR, "Can't delete '%o'", cf_file);
         }
@@ -88,57 +97,69 @@ static void
 S_do_consolidate(CompoundFileWriter *self) {
     Folder    *folder       = self->folder;
     Hash      *metadata     = Hash_new(0);
-    Hash      *sub_files    = Hash_new(0);
     VArray    *files        = Folder_List(folder, NULL);
     VArray    *merged       = VA_new(VA_Get_Size(files));
     CharBuf   *cf_file      = (CharBuf*)ZCB_WRAP_STR("cf.dat", 6);
-    OutStream *outstream    = Folder_Open_Out(folder, (CharBuf*)cf_file);
     bool_t     rename_success;
 
-    if (!outstream) { RETHROW(INCREF(Err_get_error())); }
+    // Pick up where streaming left off, or start a fresh cf.dat.
+    CompoundFileStream *stream
+        = folder->cf_stream
+          ? (CompoundFileStream*)INCREF(folder->cf_stream)
+          : CFStream_new();
+    if (stream->active) {
+        THROW(ERR, "Can't consolidate %o while '%o' is still open",
+              Folder_Get_Path(folder), stream->active);
+    }
+    if (!CFStream_Open_File(stream, folder)) {
+        RETHROW(INCREF(Err_get_error()));
+    }
 
     // Start metadata.
-    Hash_Store_Str(metadata, "files", 5, INCREF(sub_files));
+    Hash_Store_Str(metadata, "files", 5, INCREF(stream->records));
     Hash_Store_Str(metadata, "format", 6,
                    (Obj*)CB_newf("%i32", CFWriter_current_file_format));
 
-    CharBuf *infilepath = CB_new(30);
-    size_t base_len = 0;
+    // Copy in every file which wasn't streamed.
     VA_Sort(files, NULL, NULL);
     for (uint32_t i = 0, max = VA_Get_Size(files); i < max; i++) {
         CharBuf *infilename = (CharBuf*)VA_Fetch(files, i);
 
-        if (!CB_Ends_With_Str(infilename, ".json", 5)) {
-            InStream *instream   = Folder_Open_In(folder, infilename);
-            Hash     *file_data  = Hash_new(2);
-            int64_t   offset, len;
-
+        if (!CB_Ends_With_Str(infilename, ".json", 5)
+            && !CB_Equals(infilename, (Obj*)cf_file)
+           ) {
+            if (Hash_Fetch(stream->records, (Obj*)infilename)) {
+                THROW(ERR, "Duplicate file '%o' in %o", infilename,
+                      Folder_Get_Path(folder));
+            }
+            InStream   *instream = Folder_Open_In(folder, infilename);
             if (!instream) { RETHROW(INCREF(Err_get_error())); }
+            FileHandle *fh = CFStream_Open_Sub_File(stream, folder,
+                                                    infilename);
+            if (!fh) { RETHROW(INCREF(Err_get_error())); }
+            if (folder->rate_limiter) {
+                FileHandle *throttled_fh
+                    = (FileHandle*)ThrottledFH_open(fh, folder->rate_limiter);
+                DECREF(fh);
+                fh = throttled_fh;
+                if (!fh) { RETHROW(INCREF(Err_get_error())); }
+            }
+            OutStream  *outstream = OutStream_open((Obj*)fh);
+            DECREF(fh);
+            if (!outstream) { RETHROW(INCREF(Err_get_error())); }
 
-            // Absorb the file.
-            offset = OutStream_Tell(outstream);
+            // Absorb the file.  Closing the OutStream records offset and
+            // length and aligns the next sub-file on a multiple of 8.
             OutStream_Absorb(outstream, instream);
-            len = OutStream_Tell(outstream) - offset;
-
-            // Record offset and length.
-            Hash_Store_Str(file_data, "offset", 6,
-                           (Obj*)CB_newf("%i64", offset));
-            Hash_Store_Str(file_data, "length", 6,
-                           (Obj*)CB_newf("%i64", len));
-            CB_Set_Size(infilepath, base_len);
-            CB_Cat(infilepath, infilename);
-            Hash_Store(sub_files, (Obj*)infilepath, (Obj*)file_data);
+            OutStream_Close(outstream);
             VA_Push(merged, INCREF(infilename));
 
-            // Add filler NULL bytes so that every sub-file begins on a file
-            // position multiple of 8.
-            OutStream_Align(outstream, 8);
-
+            DECREF(outstream);
             InStream_Close(instream);
             DECREF(instream);
         }
     }
-    DECREF(infilepath);
+    if (!CFStream_Close(stream)) { RETHROW(INCREF(Err_get_error())); }
 
     // Write metadata to cfmeta file.
     CharBuf *cfmeta_temp = (CharBuf*)ZCB_WRAP_STR("cfmeta.json.temp", 16);
@@ -148,23 +169,11 @@ S_do_consolidate(CompoundFileWriter *self) {
     if (!rename_success) { RETHROW(INCREF(Err_get_error())); }
 
     // Clean up.
-    OutStream_Close(outstream);
-    DECREF(outstream);
+    DECREF(folder->cf_stream);
+    folder->cf_stream = NULL;
+    DECREF(stream);
     DECREF(files);
     DECREF(metadata);
-    /*
-    CharBuf *merged_file;
-    Obj     *ignore;
-    Hash_Iterate(sub_files);
-    while (Hash_Next(sub_files, (Obj**)&merged_file, &ignore)) {
-        if (!Folder_Delete(folder, merged_file)) {
-            CharBuf *mess = MAKE_MESS("Can't delete '%o'", merged_file);
-            DECREF(sub_files);
-            Err_throw_mess(ERR, mess);
-        }
-    }
-    */
-    DECREF(sub_files);
     for (uint32_t i = 0, max = VA_Get_Size(merged); i < max; i++) {
         CharBuf *merged_file = (CharBuf*)VA_Fetch(merged, i);
         if (!Folder_Delete(folder, merged_file)) {
@@ -176,4 +185,215 @@ S_do_consolidate(CompoundFileWriter *self) {
     DECREF(merged);
 }
 
+/***************************************************************************/
+
+CompoundFileStream*
+CFStream_new() {
+    CompoundFileStream *self
+        = (CompoundFileStream*)VTable_Make_Obj(COMPOUNDFILESTREAM);
+    return CFStream_init(self);
+}
+
+CompoundFileStream*
+CFStream_init(CompoundFileStream *self) {
+    self->file_handle  = NULL;
+    self->records      = Hash_new(0);
+    self->active       = NULL;
+    self->active_start = 0;
+    return self;
+}
+
+void
+CFStream_destroy(CompoundFileStream *self) {
+    DECREF(self->file_handle);
+    DECREF(self->records);
+    DECREF(self->active);
+    SUPER_DESTROY(self, COMPOUNDFILESTREAM);
+}
+
+bool_t
+CFStream_accepts(CompoundFileStream *self, const CharBuf *name,
+                 uint32_t flags) {
+    const uint32_t create_flags = FH_WRITE_ONLY | FH_CREATE;
+    if (self->active)                            { return false; }
+    if ((flags & create_flags) != create_flags)  { return false; }
+    if (CB_Ends_With_Str(name, ".json", 5))      { return false; }
+    if (CB_Ends_With_Str(name, "temp", 4))       { return false; }
+    if (CB_Ends_With_Str(name, ".ix", 3))        { return false; }
+    if (CB_Ends_With_Str(name, ".ixix", 5))      { return false; }
+    if (CB_Ends_With_Str(name, ".skip", 5))      { return false; }
+    if (CB_Equals_Str(name, "cf.dat", 6))        { return false; }
+    if (Hash_Fetch(self->records, (Obj*)name))   { return false; }
+    return true;
+}
+
+bool_t
+CFStream_open_file(CompoundFileStream *self, Folder *folder) {
+    if (!self->file_handle) {
+        CharBuf *cf_file = (CharBuf*)ZCB_WRAP_STR("cf.dat", 6);
+        self->file_handle
+            = Folder_Local_Open_FileHandle(folder, cf_file,
+                                           FH_WRITE_ONLY | FH_CREATE
+                                           | FH_EXCLUSIVE);
+        if (!self->file_handle) {
+            ERR_ADD_FRAME(Err_get_error());
+            return false;
+        }
+    }
+    return true;
+}
+
+FileHandle*
+CFStream_open_sub_file(CompoundFileStream *self, Folder *folder,
+                       const CharBuf *name) {
+    if (self->active) {
+        Err_set_error(Err_new(CB_newf("Can't stream '%o' while '%o' is open",
+                                      name, self->active)));
+        return NULL;
+    }
+    if (!CFStream_Open_File(self, folder)) {
+        ERR_ADD_FRAME(Err_get_error());
+        return NULL;
+    }
+    self->active       = CB_Clone(name);
+    self->active_start = FH_Length(self->file_handle);
+    return (FileHandle*)CFStreamFH_new(self, name);
+}
+
+bool_t
+CFStream_finish_sub_file(CompoundFileStream *self, int64_t len) {
+    static const char zeroes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    Hash *file_data = Hash_new(2);
+    bool_t success  = true;
+
+    // Record offset and length.
+    Hash_Store_Str(file_data, "offset", 6,
+                   (Obj*)CB_newf("%i64", self->active_start));
+    Hash_Store_Str(file_data, "length", 6, (Obj*)CB_newf("%i64", len));
+    Hash_Store(self->records, (Obj*)self->active, (Obj*)file_data);
+    DECREF(self->active);
+    self->active = NULL;
+
+    // Add filler NULL bytes so that every sub-file begins on a file
+    // position multiple of 8.
+    int64_t remainder = FH_Length(self->file_handle) % 8;
+    if (remainder) {
+        success = FH_Write(self->file_handle, zeroes,
+                           (size_t)(8 - remainder));
+    }
+    return success;
+}
+
+CharBuf*
+CFStream_get_active(CompoundFileStream *self) {
+    return self->active;
+}
+
+Hash*
+CFStream_get_records(CompoundFileStream *self) {
+    return self->records;
+}
+
+bool_t
+CFStream_close(CompoundFileStream *self) {
+    if (self->file_handle) {
+        bool_t success = FH_Close(self->file_handle);
+        DECREF(self->file_handle);
+        self->file_handle = NULL;
+        if (!success) {
+            ERR_ADD_FRAME(Err_get_error());
+            return false;
+        }
+    }
+    return true;
+}
+
+/***************************************************************************/
+
+CFStreamFileHandle*
+CFStreamFH_new(CompoundFileStream *stream, const CharBuf *path) {
+    CFStreamFileHandle *self
+        = (CFStreamFileHandle*)VTable_Make_Obj(CFSTREAMFILEHANDLE);
+    return CFStreamFH_init(self, stream, path);
+}
+
+CFStreamFileHandle*
+CFStreamFH_init(CFStreamFileHandle *self, CompoundFileStream *stream,
+                const CharBuf *path) {
+    FH_do_open((FileHandle*)self, path, FH_WRITE_ONLY);
+    self->stream = (CompoundFileStream*)INCREF(stream);
+    self->len    = 0;
+    return self;
+}
+
+void
+CFStreamFH_destroy(CFStreamFileHandle *self) {
+    CFStreamFH_Close(self);
+    SUPER_DESTROY(self, CFSTREAMFILEHANDLE);
+}
+
+bool_t
+CFStreamFH_window(CFStreamFileHandle *self, FileWindow *window,
+                  int64_t offset, int64_t len) {
+    UNUSED_VAR(window);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    Err_set_error(Err_new(CB_newf("Can't read from write-only handle '%o'",
+                                  self->path)));
+    return false;
+}
+
+bool_t
+CFStreamFH_release_window(CFStreamFileHandle *self, FileWindow *window) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(window);
+    return true;
+}
+
+bool_t
+CFStreamFH_read(CFStreamFileHandle *self, char *dest, int64_t offset,
+                size_t len) {
+    UNUSED_VAR(dest);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    Err_set_error(Err_new(CB_newf("Can't read from write-only handle '%o'",
+                                  self->path)));
+    return false;
+}
+
+bool_t
+CFStreamFH_write(CFStreamFileHandle *self, const void *data, size_t len) {
+    if (!self->stream) {
+        Err_set_error(Err_new(CB_newf("Can't write to closed handle '%o'",
+                                      self->path)));
+        return false;
+    }
+    if (!FH_Write(self->stream->file_handle, data, len)) {
+        return false;
+    }
+    self->len += len;
+    return true;
+}
+
+int64_t
+CFStreamFH_length(CFStreamFileHandle *self) {
+    return self->len;
+}
+
+bool_t
+CFStreamFH_close(CFStreamFileHandle *self) {
+    if (self->stream) {
+        // Only the first invocation finishes the sub-file.
+        CompoundFileStream *stream = self->stream;
+        self->stream = NULL;
+        bool_t success = CFStream_Finish_Sub_File(stream, self->len);
+        DECREF(stream);
+        if (!success) {
+            ERR_ADD_FRAME(Err_get_error());
+            return false;
+        }
+    }
+    return true;
+}
+
 
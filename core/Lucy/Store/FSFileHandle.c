@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+// Expose sync_file_range() on Linux.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE
+#endif
+
 #define C_LUCY_FSFILEHANDLE
 #define C_LUCY_FILEWINDOW
 #include "Lucy/Util/ToolSet.h"
@@ -71,10 +76,23 @@ SI_unmap(FSFileHandle *self, char *ptr, int64_t len);
 static INLINE bool_t
 SI_window(FSFileHandle *self, FileWindow *window, int64_t offset, int64_t len);
 
+// Once this many bytes have been written since background writeback was last
+// started, start it again.
+#define WRITE_BEHIND_BYTES (4 * 1024 * 1024)
+
+// Ask the OS to start writing recently written data to disk without waiting
+// for it, so that dirty pages don't pile up until the file is closed.
+static INLINE void
+SI_write_behind(FSFileHandle *self);
+
 // Architecture- and OS- specific initialization for a read-only FSFileHandle.
 static INLINE bool_t
 SI_init_read_only(FSFileHandle *self);
 
+// Ask the OS to begin paging in a region of a read-only file.
+static INLINE bool_t
+SI_prefetch(FSFileHandle *self, int64_t offset, int64_t len);
+
 // Windows-specific routine needed for closing read-only handles.
 #ifdef CHY_HAS_WINDOWS_H
 static INLINE bool_t
@@ -106,6 +124,7 @@ FSFH_do_open(FSFileHandle *self, const CharBuf *path, uint32_t flags) {
             CFISH_DECREF(self);
             return NULL;
         }
+        self->write_behind = 0;
         if (flags & FH_EXCLUSIVE) {
             self->len = 0;
         }
@@ -200,16 +219,42 @@ FSFH_write(FSFileHandle *self, const void *data, size_t len) {
             }
             return false;
         }
+        SI_write_behind(self);
     }
 
     return true;
 }
 
+static INLINE void
+SI_write_behind(FSFileHandle *self) {
+#ifdef SYNC_FILE_RANGE_WRITE
+    const int64_t pending = self->len - self->write_behind;
+    if (pending >= WRITE_BEHIND_BYTES) {
+        // Failure is harmless: the data just gets written later.
+        sync_file_range(self->fd, self->write_behind, pending,
+                        SYNC_FILE_RANGE_WRITE);
+        self->write_behind = self->len;
+    }
+#else
+    UNUSED_VAR(self);
+#endif
+}
+
 int64_t
 FSFH_length(FSFileHandle *self) {
     return self->len;
 }
 
+bool_t
+FSFH_prefetch(FSFileHandle *self, int64_t offset, int64_t len) {
+    // Prefetching is purely advisory, so quietly ignore requests which make
+    // no sense rather than treat them as errors.
+    if (!(self->flags & FH_READ_ONLY)) { return true; }
+    if (offset < 0 || len <= 0 || offset >= self->len) { return true; }
+    if (offset + len > self->len) { len = self->len - offset; }
+    return SI_prefetch(self, offset, len);
+}
+
 bool_t
 FSFH_window(FSFileHandle *self, FileWindow *window, int64_t offset,
             int64_t len) {
@@ -384,6 +429,36 @@ SI_unmap(FSFileHandle *self, char *buf, int64_t len) {
     return true;
 }
 
+static INLINE bool_t
+SI_prefetch(FSFileHandle *self, int64_t offset, int64_t len) {
+#if (IS_64_BIT && defined(MADV_WILLNEED))
+    // The whole file is already mapped; madvise() requires a page-aligned
+    // start address.
+    if (self->buf != NULL) {
+        const int64_t remainder = offset % self->page_size;
+        if (madvise(self->buf + offset - remainder, (size_t)(len + remainder),
+                    MADV_WILLNEED)
+           ) {
+            Err_set_error(Err_new(CB_newf("madvise on '%o' failed: %s",
+                                          self->path, strerror(errno))));
+            return false;
+        }
+    }
+#elif defined(POSIX_FADV_WILLNEED)
+    int check_val = posix_fadvise(self->fd, offset, len, POSIX_FADV_WILLNEED);
+    if (check_val) {
+        Err_set_error(Err_new(CB_newf("posix_fadvise on '%o' failed: %s",
+                                      self->path, strerror(check_val))));
+        return false;
+    }
+#else
+    UNUSED_VAR(self);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+#endif
+    return true;
+}
+
 #if !IS_64_BIT
 bool_t
 FSFH_read(FSFileHandle *self, char *dest, int64_t offset, size_t len) {
@@ -509,6 +584,15 @@ SI_unmap(FSFileHandle *self, char *buf, int64_t len) {
     return true;
 }
 
+static INLINE bool_t
+SI_prefetch(FSFileHandle *self, int64_t offset, int64_t len) {
+    // No portable prefetch hint for mapped views; rely on the OS.
+    UNUSED_VAR(self);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    return true;
+}
+
 static INLINE bool_t
 SI_close_win_handles(FSFileHandle *self) {
     // Close both standard handle and mapping handle.
@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+// Expose sync_file_range() on Linux.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE
+#endif
+
 #define C_LUCY_FSFOLDER
 #include "Lucy/Util/ToolSet.h"
 
@@ -66,6 +71,11 @@ S_is_local_entry(const CharBuf *path);
 bool_t
 S_hard_link(CharBuf *from_path, CharBuf *to_path);
 
+// Force each of the files or directories at the supplied full paths to
+// stable storage, or set Err_error and return false.
+bool_t
+S_sync_paths(VArray *paths, bool_t are_dirs);
+
 FSFolder*
 FSFolder_new(const CharBuf *path) {
     FSFolder *self = (FSFolder*)VTable_Make_Obj(FSFOLDER);
@@ -230,6 +240,9 @@ FSFolder_local_find_folder(FSFolder *self, const CharBuf *name) {
             DECREF(fullpath);
             THROW(ERR, "Failed to open FSFolder at '%o'", fullpath);
         }
+        if (self->block_cache) {
+            Folder_Set_Block_Cache(subfolder, self->block_cache);
+        }
         // Try to open a CompoundFileReader. On failure, just use the
         // existing folder.
         CharBuf *cfmeta_file = (CharBuf*)ZCB_WRAP_STR("cfmeta.json", 11);
@@ -247,6 +260,48 @@ FSFolder_local_find_folder(FSFolder *self, const CharBuf *name) {
     return subfolder;
 }
 
+bool_t
+FSFolder_sync(FSFolder *self, VArray *paths) {
+    VArray *files  = VA_new(VA_Get_Size(paths));
+    VArray *dirs   = VA_new(2);
+    bool_t  result = true;
+
+    for (uint32_t i = 0, max = VA_Get_Size(paths); i < max; i++) {
+        CharBuf *fullpath = S_fullpath(self, (CharBuf*)VA_Fetch(paths, i));
+        if (S_dir_ok(fullpath)) {
+            FSDirHandle *dh = FSDH_open(fullpath);
+            if (!dh) {
+                ERR_ADD_FRAME(Err_get_error());
+                DECREF(fullpath);
+                result = false;
+                break;
+            }
+            CharBuf *entry = FSDH_Get_Entry(dh);
+            while (FSDH_Next(dh)) {
+                if (!FSDH_Entry_Is_Dir(dh)) {
+                    VA_Push(files, (Obj*)CB_newf("%o%s%o", fullpath, DIR_SEP,
+                                                 entry));
+                }
+            }
+            DECREF(dh);
+            VA_Push(dirs, (Obj*)fullpath);
+        }
+        else {
+            VA_Push(files, (Obj*)fullpath);
+        }
+    }
+
+    // Our own directory holds the entries for everything in <paths>.
+    VA_Push(dirs, (Obj*)CB_Clone(self->path));
+
+    if (result) {
+        result = S_sync_paths(files, false) && S_sync_paths(dirs, true);
+    }
+    DECREF(files);
+    DECREF(dirs);
+    return result;
+}
+
 static CharBuf*
 S_fullpath(FSFolder *self, const CharBuf *path) {
     CharBuf *fullpath = CB_newf("%o%s%o", self->path, DIR_SEP, path);
@@ -313,6 +368,40 @@ S_hard_link(CharBuf *from_path, CharBuf *to_path) {
     }
 }
 
+bool_t
+S_sync_paths(VArray *paths, bool_t are_dirs) {
+    // NTFS journals directory entries itself, and Windows offers no way to
+    // flush a directory handle.
+    if (are_dirs) { return true; }
+
+    for (uint32_t i = 0, max = VA_Get_Size(paths); i < max; i++) {
+        CharBuf *path  = (CharBuf*)VA_Fetch(paths, i);
+        HANDLE   fhandle
+            = CreateFile((char*)CB_Get_Ptr8(path), GENERIC_WRITE,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE
+                         | FILE_SHARE_DELETE,
+                         NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fhandle == INVALID_HANDLE_VALUE) {
+            char *win_error = Err_win_error();
+            Err_set_error(Err_new(CB_newf("CreateFile for %o failed: %s",
+                                          path, win_error)));
+            FREEMEM(win_error);
+            return false;
+        }
+        if (!FlushFileBuffers(fhandle)) {
+            char *win_error = Err_win_error();
+            Err_set_error(Err_new(CB_newf("FlushFileBuffers for %o failed: %s",
+                                          path, win_error)));
+            FREEMEM(win_error);
+            CloseHandle(fhandle);
+            return false;
+        }
+        CloseHandle(fhandle);
+    }
+
+    return true;
+}
+
 #elif (defined(CHY_HAS_UNISTD_H))
 
 bool_t
@@ -330,6 +419,62 @@ S_hard_link(CharBuf *from_path, CharBuf *to_path) {
     }
 }
 
+// Number of files held open at once while syncing.
+#define SYNC_BATCH_SIZE 64
+
+bool_t
+S_sync_paths(VArray *paths, bool_t are_dirs) {
+    const uint32_t num_paths = VA_Get_Size(paths);
+    int fds[SYNC_BATCH_SIZE];
+
+    for (uint32_t start = 0; start < num_paths; start += SYNC_BATCH_SIZE) {
+        const uint32_t count = num_paths - start < SYNC_BATCH_SIZE
+                               ? num_paths - start
+                               : SYNC_BATCH_SIZE;
+        uint32_t num_open = 0;
+        bool_t   success  = true;
+
+        // Open the whole batch and start writeback on every file before
+        // waiting on any of them, so the device sees all the writes at once
+        // rather than one file's worth at a time.
+        while (num_open < count) {
+            CharBuf *path = (CharBuf*)VA_Fetch(paths, start + num_open);
+            int fd = open((char*)CB_Get_Ptr8(path), O_RDONLY);
+            if (fd == -1) {
+                Err_set_error(Err_new(CB_newf("Attempt to open '%o' for "
+                                              "syncing failed: %s", path,
+                                              strerror(errno))));
+                success = false;
+                break;
+            }
+#ifdef SYNC_FILE_RANGE_WRITE
+            if (!are_dirs) {
+                sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+            }
+#endif
+            fds[num_open++] = fd;
+        }
+
+        for (uint32_t i = 0; i < num_open; i++) {
+            // Some file systems refuse to sync directories, which is fine:
+            // they don't need it.
+            if (success
+                && fsync(fds[i]) == -1
+                && !(are_dirs && (errno == EINVAL || errno == EBADF))
+               ) {
+                CharBuf *path = (CharBuf*)VA_Fetch(paths, start + i);
+                Err_set_error(Err_new(CB_newf("fsync of '%o' failed: %s",
+                                              path, strerror(errno))));
+                success = false;
+            }
+            close(fds[i]);
+        }
+        if (!success) { return false; }
+    }
+
+    return true;
+}
+
 #else
   #error "Need either windows.h or unistd.h"
 #endif /* CHY_HAS_UNISTD_H vs. CHY_HAS_WINDOWS_H */
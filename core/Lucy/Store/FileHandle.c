@@ -50,6 +50,14 @@ FH_grow(FileHandle *self, int64_t length) {
     return true;
 }
 
+bool_t
+FH_prefetch(FileHandle *self, int64_t offset, int64_t len) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    return true;
+}
+
 void
 FH_set_path(FileHandle *self, const CharBuf *path) {
     CB_Mimic(self->path, (Obj*)path);
@@ -24,18 +24,25 @@
 #endif
 
 #include "Lucy/Store/Folder.h"
+#include "Lucy/Store/BlockCache.h"
+#include "Lucy/Store/CachedFileHandle.h"
 #include "Lucy/Store/CompoundFileReader.h"
 #include "Lucy/Store/CompoundFileWriter.h"
 #include "Lucy/Store/DirHandle.h"
 #include "Lucy/Store/FileHandle.h"
 #include "Lucy/Store/InStream.h"
 #include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RateLimiter.h"
+#include "Lucy/Store/ThrottledFileHandle.h"
 #include "Lucy/Util/IndexFileNames.h"
 
 Folder*
 Folder_init(Folder *self, const CharBuf *path) {
     // Init.
-    self->entries = Hash_new(16);
+    self->entries      = Hash_new(16);
+    self->cf_stream    = NULL;
+    self->block_cache  = NULL;
+    self->rate_limiter = NULL;
 
     // Copy.
     if (path == NULL) {
@@ -57,6 +64,9 @@ void
 Folder_destroy(Folder *self) {
     DECREF(self->path);
     DECREF(self->entries);
+    DECREF(self->cf_stream);
+    DECREF(self->block_cache);
+    DECREF(self->rate_limiter);
     SUPER_DESTROY(self, FOLDER);
 }
 
@@ -86,6 +96,12 @@ InStream*
 Folder_local_open_in(Folder *self, const CharBuf *name) {
     FileHandle *fh = Folder_Local_Open_FileHandle(self, name, FH_READ_ONLY);
     InStream *instream = NULL;
+    if (fh && self->block_cache) {
+        FileHandle *cached_fh
+            = (FileHandle*)CachedFH_open(fh, self->block_cache);
+        DECREF(fh);
+        fh = cached_fh;
+    }
     if (fh) {
         instream = InStream_open((Obj*)fh);
         DECREF(fh);
@@ -104,6 +120,12 @@ Folder_open_out(Folder *self, const CharBuf *path) {
     const uint32_t flags = FH_WRITE_ONLY | FH_CREATE | FH_EXCLUSIVE;
     FileHandle *fh = Folder_Open_FileHandle(self, path, flags);
     OutStream *outstream = NULL;
+    if (fh && self->rate_limiter) {
+        FileHandle *throttled_fh
+            = (FileHandle*)ThrottledFH_open(fh, self->rate_limiter);
+        DECREF(fh);
+        fh = throttled_fh;
+    }
     if (fh) {
         outstream = OutStream_open((Obj*)fh);
         DECREF(fh);
@@ -124,8 +146,15 @@ Folder_open_filehandle(Folder *self, const CharBuf *path, uint32_t flags) {
 
     if (enclosing_folder) {
         ZombieCharBuf *name = IxFileNames_local_part(path, ZCB_BLANK());
-        fh = Folder_Local_Open_FileHandle(enclosing_folder,
-                                          (CharBuf*)name, flags);
+        CompoundFileStream *cf_stream = enclosing_folder->cf_stream;
+        if (cf_stream && CFStream_Accepts(cf_stream, (CharBuf*)name, flags)) {
+            fh = CFStream_Open_Sub_File(cf_stream, enclosing_folder,
+                                        (CharBuf*)name);
+        }
+        else {
+            fh = Folder_Local_Open_FileHandle(enclosing_folder,
+                                              (CharBuf*)name, flags);
+        }
         if (!fh) {
             ERR_ADD_FRAME(Err_get_error());
         }
@@ -388,6 +417,13 @@ Folder_set_path(Folder *self, const CharBuf *path) {
     self->path = CB_Clone(path);
 }
 
+bool_t
+Folder_sync(Folder *self, VArray *paths) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(paths);
+    return true;
+}
+
 void
 Folder_consolidate(Folder *self, const CharBuf *path) {
     Folder *folder = Folder_Find_Folder(self, path);
@@ -412,6 +448,72 @@ Folder_consolidate(Folder *self, const CharBuf *path) {
     }
 }
 
+void
+Folder_stream_compound(Folder *self, const CharBuf *path) {
+    Folder *folder = Folder_Find_Folder(self, path);
+    if (!folder) {
+        THROW(ERR, "Can't stream compound file for %o", path);
+    }
+    else if (Folder_Is_A(folder, COMPOUNDFILEREADER)) {
+        THROW(ERR, "%o has already been consolidated", path);
+    }
+    else if (!folder->cf_stream) {
+        folder->cf_stream = CFStream_new();
+    }
+}
+
+void
+Folder_set_block_cache(Folder *self, BlockCache *block_cache) {
+    if (block_cache == self->block_cache) { return; }
+    BlockCache *old_cache = self->block_cache;
+    self->block_cache = (BlockCache*)INCREF(block_cache);
+
+    // Pass the cache along to subdirectories already opened.
+    Hash *entries = self->entries;
+    Obj  *key;
+    Obj  *value;
+    Hash_Iterate(entries);
+    while (Hash_Next(entries, &key, &value)) {
+        if (value && Obj_Is_A(value, FOLDER)
+            && ((Folder*)value)->block_cache == old_cache
+           ) {
+            Folder_Set_Block_Cache((Folder*)value, block_cache);
+        }
+    }
+    DECREF(old_cache);
+}
+
+BlockCache*
+Folder_get_block_cache(Folder *self) {
+    return self->block_cache;
+}
+
+void
+Folder_set_rate_limiter(Folder *self, RateLimiter *rate_limiter) {
+    if (rate_limiter == self->rate_limiter) { return; }
+    RateLimiter *old_limiter = self->rate_limiter;
+    self->rate_limiter = (RateLimiter*)INCREF(rate_limiter);
+
+    // Pass the limiter along to subdirectories already opened.
+    Hash *entries = self->entries;
+    Obj  *key;
+    Obj  *value;
+    Hash_Iterate(entries);
+    while (Hash_Next(entries, &key, &value)) {
+        if (value && Obj_Is_A(value, FOLDER)
+            && ((Folder*)value)->rate_limiter == old_limiter
+           ) {
+            Folder_Set_Rate_Limiter((Folder*)value, rate_limiter);
+        }
+    }
+    DECREF(old_limiter);
+}
+
+RateLimiter*
+Folder_get_rate_limiter(Folder *self) {
+    return self->rate_limiter;
+}
+
 static Folder*
 S_enclosing_folder(Folder *self, ZombieCharBuf *path) {
     size_t path_component_len = 0;
@@ -437,6 +539,18 @@ S_enclosing_folder(Folder *self, ZombieCharBuf *path) {
 
     Folder *local_folder
         = Folder_Local_Find_Folder(self, (CharBuf*)path_component);
+    if (local_folder
+        && self->block_cache
+        && local_folder->block_cache != self->block_cache
+       ) {
+        Folder_Set_Block_Cache(local_folder, self->block_cache);
+    }
+    if (local_folder
+        && self->rate_limiter
+        && local_folder->rate_limiter != self->rate_limiter
+       ) {
+        Folder_Set_Rate_Limiter(local_folder, self->rate_limiter);
+    }
     if (!local_folder) {
         /* This element of the filepath doesn't exist, or it's not a
          * directory.  However, there are filepath characters left over,
@@ -467,8 +581,16 @@ Folder_find_folder(Folder *self, const CharBuf *path) {
             return NULL;
         }
         else {
-            return Folder_Local_Find_Folder(enclosing_folder,
-                                            (CharBuf*)scratch);
+            Folder *folder = Folder_Local_Find_Folder(enclosing_folder,
+                                                      (CharBuf*)scratch);
+            if (folder
+                && enclosing_folder->rate_limiter
+                && folder->rate_limiter != enclosing_folder->rate_limiter
+               ) {
+                Folder_Set_Rate_Limiter(folder,
+                                        enclosing_folder->rate_limiter);
+            }
+            return folder;
         }
     }
 }
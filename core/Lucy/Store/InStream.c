@@ -260,6 +260,14 @@ InStream_length(InStream *self) {
     return self->len;
 }
 
+void
+InStream_prefetch(InStream *self, int64_t offset, int64_t len) {
+    if (!self->file_handle) { return; }
+    if (offset < 0 || len <= 0 || offset >= self->len) { return; }
+    if (offset + len > self->len) { len = self->len - offset; }
+    FH_Prefetch(self->file_handle, self->offset + offset, len);
+}
+
 char*
 InStream_buf(InStream *self, size_t request) {
     const int64_t bytes_in_buf = PTR_TO_I64(self->limit) - PTR_TO_I64(self->buf);
@@ -25,6 +25,9 @@
 #include "Lucy/Store/RAMFile.h"
 #include "Lucy/Store/RAMFileHandle.h"
 
+// Size of the chunks copied from an InStream's buffer by Absorb_Range.
+#define ABSORB_CHUNK_SIZE 0x10000
+
 // Inlined version of OutStream_Write_Bytes.
 static INLINE void
 SI_write_bytes(OutStream *self, const void *bytes, size_t len);
@@ -120,6 +123,23 @@ OutStream_absorb(OutStream *self, InStream *instream) {
     }
 }
 
+void
+OutStream_absorb_range(OutStream *self, InStream *instream, int64_t offset,
+                       int64_t len) {
+    // Write straight out of the InStream's buffer, skipping the
+    // intermediate copy which Absorb() makes.
+    InStream_Seek(instream, offset);
+    while (len > 0) {
+        const size_t chunk = len < ABSORB_CHUNK_SIZE
+                             ? (size_t)len
+                             : ABSORB_CHUNK_SIZE;
+        char *buf = InStream_Buf(instream, chunk);
+        SI_write_bytes(self, buf, chunk);
+        InStream_Advance_Buf(instream, buf + chunk);
+        len -= (int64_t)chunk;
+    }
+}
+
 void
 OutStream_grow(OutStream *self, int64_t length) {
     if (!FH_Grow(self->file_handle, length)) {
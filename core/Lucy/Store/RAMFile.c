@@ -29,12 +29,15 @@ RAMFile*
 RAMFile_init(RAMFile *self, ByteBuf *contents, bool_t read_only) {
     self->contents = contents ? (ByteBuf*)INCREF(contents) : BB_new(0);
     self->read_only = read_only;
+    self->copy_on_write = false;
+    self->backing = NULL;
     return self;
 }
 
 void
 RAMFile_destroy(RAMFile *self) {
     DECREF(self->contents);
+    DECREF(self->backing);
     SUPER_DESTROY(self, RAMFILE);
 }
 
@@ -43,6 +46,46 @@ RAMFile_get_contents(RAMFile *self) {
     return self->contents;
 }
 
+ByteBuf*
+RAMFile_writable_contents(RAMFile *self) {
+    if (self->backing) {
+        // Contents are a view onto memory which we don't own.
+        ByteBuf *copy = BB_Clone(self->contents);
+        DECREF(self->contents);
+        DECREF(self->backing);
+        self->contents      = copy;
+        self->backing       = NULL;
+        self->copy_on_write = false;
+    }
+    else if (self->copy_on_write) {
+        // Once every other sharer has copied or gone away, the contents are
+        // ours alone and can be modified in place.
+        if (BB_Get_RefCount(self->contents) > 1) {
+            ByteBuf *copy = BB_Clone(self->contents);
+            DECREF(self->contents);
+            self->contents = copy;
+        }
+        self->copy_on_write = false;
+    }
+    return self->contents;
+}
+
+RAMFile*
+RAMFile_fork(RAMFile *self) {
+    RAMFile *twin = RAMFile_new(self->contents, self->read_only);
+    RAMFile_Set_Backing(twin, self->backing);
+    self->copy_on_write = true;
+    twin->copy_on_write = true;
+    return twin;
+}
+
+void
+RAMFile_set_backing(RAMFile *self, Obj *backing) {
+    Obj *temp = self->backing;
+    self->backing = backing ? INCREF(backing) : NULL;
+    DECREF(temp);
+}
+
 bool_t
 RAMFile_read_only(RAMFile *self) {
     return self->read_only;
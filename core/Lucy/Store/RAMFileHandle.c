@@ -137,7 +137,7 @@ RAMFH_write(RAMFileHandle *self, const void *data, size_t len) {
         Err_set_error(Err_new(CB_newf("Attempt to write to read-only RAMFile")));
         return false;
     }
-    BB_Cat_Bytes(self->ram_file->contents, data, len);
+    BB_Cat_Bytes(RAMFile_Writable_Contents(self->ram_file), data, len);
     self->len += len;
     return true;
 }
@@ -155,7 +155,7 @@ RAMFH_grow(RAMFileHandle *self, int64_t len) {
         return false;
     }
     else {
-        BB_Grow(self->ram_file->contents, (size_t)len);
+        BB_Grow(RAMFile_Writable_Contents(self->ram_file), (size_t)len);
         return true;
     }
 }
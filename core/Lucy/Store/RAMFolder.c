@@ -53,6 +53,41 @@ RAMFolder_check(RAMFolder *self) {
     return true;
 }
 
+RAMFolder*
+RAMFolder_fork(RAMFolder *self) {
+    RAMFolder *twin = RAMFolder_new(self->path);
+    CharBuf   *name;
+    Obj       *entry;
+
+    Hash_Iterate(self->entries);
+    while (Hash_Next(self->entries, (Obj**)&name, &entry)) {
+        Obj *copy;
+        if (Obj_Is_A(entry, RAMFILE)) {
+            copy = (Obj*)RAMFile_Fork((RAMFile*)entry);
+        }
+        else if (Obj_Is_A(entry, COMPOUNDFILEREADER)) {
+            // Fork the real folder and present its virtual files, too.
+            RAMFolder *inner_folder = (RAMFolder*)CERTIFY(
+                CFReader_Get_Real_Folder((CompoundFileReader*)entry),
+                RAMFOLDER);
+            RAMFolder *inner_twin = RAMFolder_Fork(inner_folder);
+            copy = (Obj*)CFReader_open((Folder*)inner_twin);
+            DECREF(inner_twin);
+            if (!copy) {
+                DECREF(twin);
+                RETHROW(INCREF(Err_get_error()));
+            }
+        }
+        else {
+            RAMFolder *subfolder = (RAMFolder*)CERTIFY(entry, RAMFOLDER);
+            copy = (Obj*)RAMFolder_Fork(subfolder);
+        }
+        Hash_Store(twin->entries, (Obj*)name, copy);
+    }
+
+    return twin;
+}
+
 bool_t
 RAMFolder_local_mkdir(RAMFolder *self, const CharBuf *name) {
     if (Hash_Fetch(self->entries, (Obj*)name)) {
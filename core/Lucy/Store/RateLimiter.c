@@ -0,0 +1,183 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_RATELIMITER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Store/RateLimiter.h"
+#include "Lucy/Util/Sleep.h"
+
+// Sleeps shorter than this are deferred until the debt grows.
+#define MIN_PAUSE_MS       2.0
+#define ADJUST_INTERVAL_MS 250.0
+
+// How far Adjust() may lower the rate, and how quickly it raises it again.
+#define MIN_RATE_DIVISOR   16.0
+#define RATE_INCREASE      1.25
+
+// Return the current wall clock time in milliseconds.
+static double
+S_now_ms(void);
+
+RateLimiter*
+RateLimiter_new(double mb_per_sec) {
+    RateLimiter *self = (RateLimiter*)VTable_Make_Obj(RATELIMITER);
+    return RateLimiter_init(self, mb_per_sec);
+}
+
+RateLimiter*
+RateLimiter_init(RateLimiter *self, double mb_per_sec) {
+    self->target_latency = 0.0;
+    self->worst_latency  = -1.0;
+    self->next_ms        = 0.0;
+    self->last_adjust_ms = 0.0;
+    self->bytes          = 0;
+    self->paused_ms      = 0;
+    RateLimiter_Set_MB_Per_Sec(self, mb_per_sec);
+    return self;
+}
+
+void
+RateLimiter_pause(RateLimiter *self, int64_t bytes) {
+    const double now = S_now_ms();
+
+    self->bytes += bytes;
+    if (now - self->last_adjust_ms >= ADJUST_INTERVAL_MS
+        || now < self->last_adjust_ms
+       ) {
+        self->last_adjust_ms = now;
+        RateLimiter_Adjust(self);
+    }
+    if (self->mb_per_sec <= 0.0) { return; }
+
+    /* Idle time isn't banked: a writer which has been quiet may not burst.
+     * A schedule running far ahead of the clock means that the clock has
+     * been set back, so start over. */
+    if (self->next_ms < now || self->next_ms > now + MIN_PAUSE_MS) {
+        self->next_ms = now;
+    }
+    self->next_ms += (double)bytes * 1000.0
+                     / (self->mb_per_sec * 1024.0 * 1024.0);
+
+    // Sleep until the schedule catches up.
+    const double wait = self->next_ms - now;
+    if (wait >= MIN_PAUSE_MS) {
+        const uint32_t millis = (uint32_t)wait;
+        Sleep_millisleep(millis);
+        self->paused_ms += millis;
+    }
+}
+
+void
+RateLimiter_report_latency(RateLimiter *self, double millis) {
+    if (millis > self->worst_latency) {
+        self->worst_latency = millis;
+    }
+}
+
+void
+RateLimiter_adjust(RateLimiter *self) {
+    const double worst = self->worst_latency;
+    self->worst_latency = -1.0;
+    if (self->target_latency <= 0.0
+        || self->max_mb_per_sec <= 0.0
+        || worst < 0.0
+       ) {
+        return;
+    }
+
+    if (worst > self->target_latency) {
+        const double floor = self->max_mb_per_sec / MIN_RATE_DIVISOR;
+        self->mb_per_sec /= 2.0;
+        if (self->mb_per_sec < floor) { self->mb_per_sec = floor; }
+    }
+    else {
+        self->mb_per_sec *= RATE_INCREASE;
+        if (self->mb_per_sec > self->max_mb_per_sec) {
+            self->mb_per_sec = self->max_mb_per_sec;
+        }
+    }
+}
+
+void
+RateLimiter_set_mb_per_sec(RateLimiter *self, double mb_per_sec) {
+    if (mb_per_sec < 0.0) {
+        THROW(ERR, "Invalid value for mb_per_sec: %f64", mb_per_sec);
+    }
+    self->mb_per_sec     = mb_per_sec;
+    self->max_mb_per_sec = mb_per_sec;
+}
+
+double
+RateLimiter_get_mb_per_sec(RateLimiter *self) {
+    return self->mb_per_sec;
+}
+
+void
+RateLimiter_set_target_latency(RateLimiter *self, double millis) {
+    if (millis < 0.0) {
+        THROW(ERR, "Invalid value for target latency: %f64", millis);
+    }
+    self->target_latency = millis;
+}
+
+double
+RateLimiter_get_target_latency(RateLimiter *self) {
+    return self->target_latency;
+}
+
+double
+RateLimiter_now_millis() {
+    return S_now_ms();
+}
+
+int64_t
+RateLimiter_get_bytes(RateLimiter *self) {
+    return self->bytes;
+}
+
+int64_t
+RateLimiter_get_paused_millis(RateLimiter *self) {
+    return self->paused_ms;
+}
+
+/********************************* WINDOWS ********************************/
+#ifdef CHY_HAS_WINDOWS_H
+
+#include <windows.h>
+
+static double
+S_now_ms(void) {
+    return (double)GetTickCount();
+}
+
+/********************************* UNIXEN *********************************/
+#elif defined(CHY_HAS_UNISTD_H)
+
+#include <sys/time.h>
+
+static double
+S_now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+}
+
+#else
+  #error "Can't find a known clock API."
+#endif // OS switch.
+
+
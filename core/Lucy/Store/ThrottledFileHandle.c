@@ -0,0 +1,124 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_THROTTLEDFILEHANDLE
+#define C_LUCY_FILEHANDLE
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Store/ThrottledFileHandle.h"
+#include "Lucy/Store/FileWindow.h"
+#include "Lucy/Store/RateLimiter.h"
+
+ThrottledFileHandle*
+ThrottledFH_open(FileHandle *inner, RateLimiter *limiter) {
+    ThrottledFileHandle *self
+        = (ThrottledFileHandle*)VTable_Make_Obj(THROTTLEDFILEHANDLE);
+    return ThrottledFH_do_open(self, inner, limiter);
+}
+
+ThrottledFileHandle*
+ThrottledFH_do_open(ThrottledFileHandle *self, FileHandle *inner,
+                    RateLimiter *limiter) {
+    FH_do_open((FileHandle*)self, FH_Get_Path(inner), FH_WRITE_ONLY);
+    self->inner   = (FileHandle*)INCREF(inner);
+    self->limiter = (RateLimiter*)INCREF(limiter);
+
+    if (!(inner->flags & FH_WRITE_ONLY)) {
+        Err_set_error(Err_new(CB_newf("Can't throttle read-only file '%o'",
+                                      self->path)));
+        DECREF(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+void
+ThrottledFH_destroy(ThrottledFileHandle *self) {
+    // The inner handle closes itself when destroyed.
+    DECREF(self->inner);
+    self->inner = NULL;
+    DECREF(self->limiter);
+    SUPER_DESTROY(self, THROTTLEDFILEHANDLE);
+}
+
+bool_t
+ThrottledFH_window(ThrottledFileHandle *self, FileWindow *window,
+                   int64_t offset, int64_t len) {
+    UNUSED_VAR(window);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    Err_set_error(Err_new(CB_newf("Can't read from write-only handle '%o'",
+                                  self->path)));
+    return false;
+}
+
+bool_t
+ThrottledFH_release_window(ThrottledFileHandle *self, FileWindow *window) {
+    UNUSED_VAR(self);
+    UNUSED_VAR(window);
+    return true;
+}
+
+bool_t
+ThrottledFH_read(ThrottledFileHandle *self, char *dest, int64_t offset,
+                 size_t len) {
+    UNUSED_VAR(dest);
+    UNUSED_VAR(offset);
+    UNUSED_VAR(len);
+    Err_set_error(Err_new(CB_newf("Can't read from write-only handle '%o'",
+                                  self->path)));
+    return false;
+}
+
+bool_t
+ThrottledFH_write(ThrottledFileHandle *self, const void *data, size_t len) {
+    RateLimiter *limiter = self->limiter;
+    RateLimiter_Pause(limiter, (int64_t)len);
+
+    // A write which stalls is a sign that the device is saturated.
+    const bool_t timed = RateLimiter_Get_Target_Latency(limiter) > 0.0;
+    const double start = timed ? RateLimiter_now_millis() : 0.0;
+    if (!FH_Write(self->inner, data, len)) {
+        ERR_ADD_FRAME(Err_get_error());
+        return false;
+    }
+    if (timed) {
+        RateLimiter_Report_Latency(limiter, RateLimiter_now_millis() - start);
+    }
+    return true;
+}
+
+int64_t
+ThrottledFH_length(ThrottledFileHandle *self) {
+    return FH_Length(self->inner);
+}
+
+bool_t
+ThrottledFH_grow(ThrottledFileHandle *self, int64_t len) {
+    return FH_Grow(self->inner, len);
+}
+
+bool_t
+ThrottledFH_close(ThrottledFileHandle *self) {
+    if (self->inner && !FH_Close(self->inner)) {
+        ERR_ADD_FRAME(Err_get_error());
+        return false;
+    }
+    return true;
+}
+
+
@@ -0,0 +1,118 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_TESTBLOOMFILTER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Index/TestBloomFilter.h"
+#include "Lucy/Index/BloomFilter.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RAMFile.h"
+
+#define NUM_KEYS 1000
+
+static BloomFilter*
+S_fill_filter() {
+    BloomFilter *filter  = BloomFilter_new(NUM_KEYS, 10);
+    CharBuf     *term    = CB_new(20);
+    for (int32_t i = 0; i < NUM_KEYS; i++) {
+        CB_setf(term, "id-%i32", i);
+        BloomFilter_Add(filter, (Obj*)term);
+    }
+    DECREF(term);
+    return filter;
+}
+
+static bool_t
+S_contains_all(BloomFilter *filter) {
+    CharBuf *term = CB_new(20);
+    bool_t   retval = true;
+    for (int32_t i = 0; i < NUM_KEYS; i++) {
+        CB_setf(term, "id-%i32", i);
+        if (!BloomFilter_May_Contain(filter, (Obj*)term)) { retval = false; }
+    }
+    DECREF(term);
+    return retval;
+}
+
+static void
+test_membership(TestBatch *batch) {
+    BloomFilter *filter = S_fill_filter();
+    CharBuf     *term   = CB_new(20);
+    int32_t      false_positives = 0;
+
+    TEST_TRUE(batch, S_contains_all(filter), "No false negatives");
+
+    for (int32_t i = 0; i < 10000; i++) {
+        CB_setf(term, "absent-%i32", i);
+        if (BloomFilter_May_Contain(filter, (Obj*)term)) { false_positives++; }
+    }
+    TEST_TRUE(batch, false_positives < 300,
+              "False positive rate is low (%d of 10000)",
+              (int)false_positives);
+
+    Integer32 *num = Int32_new(5);
+    TEST_TRUE(batch, BloomFilter_May_Contain(filter, (Obj*)num),
+              "Terms which aren't text are never ruled out");
+    DECREF(num);
+
+    BloomFilter *empty = BloomFilter_new(0, 10);
+    TEST_FALSE(batch, BloomFilter_May_Contain(empty, (Obj*)term),
+               "Empty filter rules everything out");
+    DECREF(empty);
+
+    DECREF(term);
+    DECREF(filter);
+}
+
+static void
+test_Serialize_and_Deserialize(TestBatch *batch) {
+    BloomFilter *filter    = S_fill_filter();
+    RAMFile     *file      = RAMFile_new(NULL, false);
+    OutStream   *outstream = OutStream_open((Obj*)file);
+    BloomFilter_Serialize(filter, outstream);
+    OutStream_Close(outstream);
+
+    InStream    *instream = InStream_open((Obj*)file);
+    BloomFilter *dupe = BloomFilter_Deserialize(
+                            (BloomFilter*)VTable_Make_Obj(BLOOMFILTER),
+                            instream);
+    TEST_INT_EQ(batch, BloomFilter_Get_Num_Bits(dupe),
+                BloomFilter_Get_Num_Bits(filter), "num_bits round trip");
+    TEST_INT_EQ(batch, BloomFilter_Get_Num_Hashes(dupe),
+                BloomFilter_Get_Num_Hashes(filter), "num_hashes round trip");
+    TEST_TRUE(batch, S_contains_all(dupe),
+              "Deserialized filter holds the same terms");
+
+    DECREF(dupe);
+    DECREF(instream);
+    DECREF(outstream);
+    DECREF(file);
+    DECREF(filter);
+}
+
+void
+TestBloomFilter_run_tests() {
+    TestBatch *batch = TestBatch_new(7);
+    TestBatch_Plan(batch);
+    test_membership(batch);
+    test_Serialize_and_Deserialize(batch);
+    DECREF(batch);
+}
+
+
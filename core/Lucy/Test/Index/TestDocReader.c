@@ -0,0 +1,228 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_TESTDOCREADER
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Index/TestDocReader.h"
+#include "Lucy/Test/TestSchema.h"
+#include "Lucy/Test/Plan/TestArchitecture.h"
+#include "Lucy/Document/Doc.h"
+#include "Lucy/Document/HitDoc.h"
+#include "Lucy/Index/DocReader.h"
+#include "Lucy/Index/IndexManager.h"
+#include "Lucy/Index/IndexReader.h"
+#include "Lucy/Index/Indexer.h"
+#include "Lucy/Index/TieredMergePolicy.h"
+#include "Lucy/Object/I32Array.h"
+#include "Lucy/Search/Hits.h"
+#include "Lucy/Search/IndexSearcher.h"
+#include "Lucy/Search/TermQuery.h"
+#include "Lucy/Store/RAMFolder.h"
+
+#define DOCS_PER_SEG 20
+#define NUM_SEGS     3
+
+static CharBuf*
+S_content(uint32_t num) {
+    const char *marker = num < DOCS_PER_SEG
+                         ? "first"
+                         : num < DOCS_PER_SEG * (NUM_SEGS - 1)
+                         ? "middle"
+                         : "last";
+    CharBuf *content = CB_newf("doc%u32 %s common", num, marker);
+    for (uint32_t i = 0; i <= num % 7; i++) {
+        CB_catf(content, " filler%u32 filler", i);
+    }
+    return content;
+}
+
+static Schema*
+S_create_schema(int32_t doc_block_size) {
+    Schema *schema = (Schema*)TestSchema_new();
+    TestArch_Set_Doc_Block_Size(
+        (TestArchitecture*)Schema_Get_Architecture(schema), doc_block_size);
+    return schema;
+}
+
+// Index docs [first, limit) as a single segment.
+static void
+S_add_docs(Schema *schema, RAMFolder *folder, uint32_t first,
+           uint32_t limit) {
+    // Keep the small segments apart rather than letting them be merged.
+    IndexManager      *manager = IxManager_new(NULL, NULL);
+    TieredMergePolicy *policy  = TieredMP_new();
+    TieredMP_Set_Segs_Per_Tier(policy, 100);
+    IxManager_Set_Merge_Policy(manager, (MergePolicy*)policy);
+    Indexer *indexer = Indexer_new(schema, (Obj*)folder, manager, 0);
+    for (uint32_t num = first; num < limit; num++) {
+        CharBuf *content = S_content(num);
+        Doc *doc = Doc_new(NULL, 0);
+        Doc_Store(doc, (CharBuf*)ZCB_WRAP_STR("content", 7), (Obj*)content);
+        Indexer_Add_Doc(indexer, doc, 1.0f);
+        DECREF(doc);
+        DECREF(content);
+    }
+    Indexer_Commit(indexer);
+    DECREF(indexer);
+    DECREF(policy);
+    DECREF(manager);
+}
+
+static RAMFolder*
+S_create_index(int32_t doc_block_size, bool_t multi_seg) {
+    Schema    *schema = S_create_schema(doc_block_size);
+    RAMFolder *folder = RAMFolder_new(NULL);
+    if (multi_seg) {
+        for (uint32_t i = 0; i < NUM_SEGS; i++) {
+            S_add_docs(schema, folder, i * DOCS_PER_SEG,
+                       (i + 1) * DOCS_PER_SEG);
+        }
+    }
+    else {
+        S_add_docs(schema, folder, 0, NUM_SEGS * DOCS_PER_SEG);
+    }
+    DECREF(schema);
+    return folder;
+}
+
+static bool_t
+S_content_matches(HitDoc *hit_doc, int32_t doc_id) {
+    CharBuf *expected = S_content((uint32_t)doc_id - 1);
+    Obj *got = HitDoc_Extract(hit_doc, (CharBuf*)ZCB_WRAP_STR("content", 7),
+                              (ViewCharBuf*)ZCB_BLANK());
+    bool_t retval = got && CB_Equals(expected, got);
+    DECREF(expected);
+    return retval;
+}
+
+static void
+test_fetch_docs(TestBatch *batch, int32_t doc_block_size) {
+    RAMFolder   *folder = S_create_index(doc_block_size, true);
+    IndexReader *reader = IxReader_open((Obj*)folder, NULL, NULL);
+    DocReader   *doc_reader
+        = (DocReader*)IxReader_Obtain(reader, VTable_Get_Name(DOCREADER));
+    // Out of order, spanning every segment, with a duplicate.
+    int32_t ints[] = { 60, 1, 33, 7, 33, 20, 21, 41, 2 };
+    const uint32_t num_ids = sizeof(ints) / sizeof(int32_t);
+    I32Array *doc_ids = I32Arr_new(ints, num_ids);
+
+    VArray *hit_docs = DocReader_Fetch_Docs(doc_reader, doc_ids);
+    bool_t  all_match = VA_Get_Size(hit_docs) == num_ids;
+    for (uint32_t i = 0; all_match && i < num_ids; i++) {
+        HitDoc *got      = (HitDoc*)VA_Fetch(hit_docs, i);
+        HitDoc *expected = DocReader_Fetch_Doc(doc_reader, ints[i]);
+        if (!HitDoc_Equals(expected, (Obj*)got)
+            || HitDoc_Get_Doc_ID(got) != ints[i]
+            || !S_content_matches(got, ints[i])
+           ) {
+            all_match = false;
+        }
+        DECREF(expected);
+    }
+    TEST_TRUE(batch, all_match,
+              "Fetch_Docs matches Fetch_Doc (doc_block_size %d)",
+              (int)doc_block_size);
+    DECREF(hit_docs);
+
+    DocReader_Prefetch_Docs(doc_reader, doc_ids);
+    all_match = true;
+    for (uint32_t i = 0; i < num_ids; i++) {
+        HitDoc *got = DocReader_Fetch_Doc(doc_reader, ints[i]);
+        if (!S_content_matches(got, ints[i])) { all_match = false; }
+        DECREF(got);
+    }
+    TEST_TRUE(batch, all_match,
+              "Fetch_Doc after Prefetch_Docs (doc_block_size %d)",
+              (int)doc_block_size);
+
+    DECREF(doc_ids);
+    DECREF(reader);
+    DECREF(folder);
+}
+
+// Check that a query gives the same hits, in the same order and with the
+// same scores, from a multi-segment index as from a single segment.
+static void
+S_check_hits(TestBatch *batch, IndexSearcher *multi, IndexSearcher *single,
+             const char *term_str) {
+    CharBuf   *term  = CB_newf("%s", term_str);
+    TermQuery *query = TermQuery_new((CharBuf*)ZCB_WRAP_STR("content", 7),
+                                     (Obj*)term);
+    Hits *multi_hits  = IxSearcher_Hits(multi, (Obj*)query, 0, 100, NULL);
+    Hits *single_hits = IxSearcher_Hits(single, (Obj*)query, 0, 100, NULL);
+    bool_t same = Hits_Total_Hits(multi_hits) > 0
+                  && Hits_Total_Hits(multi_hits)
+                     == Hits_Total_Hits(single_hits);
+    while (same) {
+        HitDoc *got      = Hits_Next(multi_hits);
+        HitDoc *expected = Hits_Next(single_hits);
+        if (!got || !expected) {
+            same = !got && !expected;
+            DECREF(got);
+            DECREF(expected);
+            break;
+        }
+        int32_t doc_id = HitDoc_Get_Doc_ID(got);
+        if (doc_id != HitDoc_Get_Doc_ID(expected)
+            || HitDoc_Get_Score(got) != HitDoc_Get_Score(expected)
+            || !S_content_matches(got, doc_id)
+           ) {
+            same = false;
+        }
+        DECREF(got);
+        DECREF(expected);
+    }
+    TEST_TRUE(batch, same, "Hits across segments for '%s'", term_str);
+    DECREF(single_hits);
+    DECREF(multi_hits);
+    DECREF(query);
+    DECREF(term);
+}
+
+static void
+test_collect(TestBatch *batch) {
+    RAMFolder     *multi_folder  = S_create_index(0, true);
+    RAMFolder     *single_folder = S_create_index(0, false);
+    IndexSearcher *multi  = IxSearcher_new((Obj*)multi_folder);
+    IndexSearcher *single = IxSearcher_new((Obj*)single_folder);
+
+    S_check_hits(batch, multi, single, "common");
+    S_check_hits(batch, multi, single, "first");
+    S_check_hits(batch, multi, single, "last");
+    S_check_hits(batch, multi, single, "doc37");
+
+    DECREF(single);
+    DECREF(multi);
+    DECREF(single_folder);
+    DECREF(multi_folder);
+}
+
+void
+TestDocReader_run_tests() {
+    TestBatch *batch = TestBatch_new(8);
+
+    TestBatch_Plan(batch);
+
+    test_fetch_docs(batch, 0);
+    test_fetch_docs(batch, 256);
+    test_collect(batch);
+
+    DECREF(batch);
+}
+
+
@@ -15,17 +15,233 @@
  */
 
 #define C_LUCY_TESTDOCWRITER
+#define C_LUCY_DEFAULTDOCREADER
 #include "Lucy/Util/ToolSet.h"
 
 #include "Lucy/Test.h"
 #include "Lucy/Test/Index/TestDocWriter.h"
+#include "Lucy/Test/TestSchema.h"
+#include "Lucy/Test/Plan/TestArchitecture.h"
+#include "Lucy/Document/Doc.h"
+#include "Lucy/Document/HitDoc.h"
+#include "Lucy/Index/DocReader.h"
 #include "Lucy/Index/DocWriter.h"
+#include "Lucy/Index/IndexManager.h"
+#include "Lucy/Index/IndexReader.h"
+#include "Lucy/Index/Indexer.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Index/TieredMergePolicy.h"
+#include "Lucy/Store/RAMFolder.h"
+
+#define DOCS_PER_SEG 24
+#define NUM_SEGS     2
+#define NUM_DOCS     (DOCS_PER_SEG * NUM_SEGS)
+
+// Small enough that each source segment spans several blocks.
+#define BLOCK_SIZE 256
+
+static CharBuf*
+S_content(uint32_t num) {
+    // Offset the numbers so that every unique term is the same width.
+    CharBuf *content = CB_newf("uniq%u32 common", num + 10);
+    for (uint32_t i = 0; i < 20 + num % 5; i++) {
+        CB_Cat_Trusted_Str(content, " pad", 4);
+    }
+    return content;
+}
+
+static Schema*
+S_create_schema(int32_t doc_block_size) {
+    Schema *schema = (Schema*)TestSchema_new();
+    TestArch_Set_Doc_Block_Size(
+        (TestArchitecture*)Schema_Get_Architecture(schema), doc_block_size);
+    return schema;
+}
+
+static IndexManager*
+S_create_manager() {
+    // Keep the source segments apart until they are explicitly merged.
+    IndexManager      *manager = IxManager_new(NULL, NULL);
+    TieredMergePolicy *policy  = TieredMP_new();
+    TieredMP_Set_Segs_Per_Tier(policy, 100);
+    IxManager_Set_Merge_Policy(manager, (MergePolicy*)policy);
+    DECREF(policy);
+    return manager;
+}
+
+static void
+S_add_segment(RAMFolder *folder, int32_t doc_block_size, uint32_t first) {
+    Schema       *schema  = S_create_schema(doc_block_size);
+    IndexManager *manager = S_create_manager();
+    Indexer      *indexer = Indexer_new(schema, (Obj*)folder, manager, 0);
+    for (uint32_t num = first; num < first + DOCS_PER_SEG; num++) {
+        CharBuf *content = S_content(num);
+        Doc *doc = Doc_new(NULL, 0);
+        Doc_Store(doc, (CharBuf*)ZCB_WRAP_STR("content", 7), (Obj*)content);
+        Indexer_Add_Doc(indexer, doc, 1.0f);
+        DECREF(doc);
+        DECREF(content);
+    }
+    Indexer_Commit(indexer);
+    DECREF(indexer);
+    DECREF(manager);
+    DECREF(schema);
+}
+
+static DefaultDocReader*
+S_doc_reader(SegReader *seg_reader) {
+    return (DefaultDocReader*)CERTIFY(
+               SegReader_Obtain(seg_reader, VTable_Get_Name(DOCREADER)),
+               DEFAULTDOCREADER);
+}
+
+// Pick deletions which split the segment into runs.  For a compressed
+// segment, they land on block boundaries: one run ends exactly where a block
+// begins, the next starts just after one, and another starts in mid-block.
+static void
+S_pick_deletions(DefaultDocReader *doc_reader, int32_t doc_max,
+                 bool_t *deleted) {
+    const int32_t *block_docs = doc_reader->block_docs;
+    deleted[1]       = true;
+    deleted[doc_max] = true;
+    if (block_docs) {
+        deleted[block_docs[1]]     = true;
+        deleted[block_docs[3] - 1] = true;
+        deleted[block_docs[5] + 1] = true;
+    }
+    else {
+        deleted[5]  = true;
+        deleted[6]  = true;
+        deleted[11] = true;
+    }
+}
+
+static void
+test_merge(TestBatch *batch, int32_t first_block_size,
+           int32_t second_block_size, int32_t merged_block_size) {
+    RAMFolder *folder  = RAMFolder_new(NULL);
+    VArray    *records = VA_new(NUM_DOCS);
+    bool_t     deleted[NUM_DOCS];
+    memset(deleted, 0, sizeof(deleted));
+
+    S_add_segment(folder, first_block_size, 0);
+    S_add_segment(folder, second_block_size, DOCS_PER_SEG);
+
+    // Note each source record's raw bytes, and pick the docs to delete.
+    IndexReader *reader      = IxReader_open((Obj*)folder, NULL, NULL);
+    VArray      *seg_readers = IxReader_Seg_Readers(reader);
+    bool_t       sources_ok  = VA_Get_Size(seg_readers) == NUM_SEGS;
+    for (uint32_t i = 0; sources_ok && i < NUM_SEGS; i++) {
+        SegReader        *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
+        DefaultDocReader *doc_reader = S_doc_reader(seg_reader);
+        int32_t block_size = i == 0 ? first_block_size : second_block_size;
+        int32_t doc_max    = SegReader_Doc_Max(seg_reader);
+        if (doc_max != DOCS_PER_SEG
+            || (block_size != 0) != (doc_reader->block_docs != NULL)
+            || (block_size != 0 && doc_reader->num_blocks < 6)
+           ) {
+            sources_ok = false;
+            break;
+        }
+        for (int32_t doc_id = 1; doc_id <= doc_max; doc_id++) {
+            ByteBuf *record = BB_new(0);
+            DefDocReader_Read_Record(doc_reader, record, doc_id);
+            VA_Push(records, (Obj*)record);
+        }
+        S_pick_deletions(doc_reader, doc_max,
+                         deleted + i * DOCS_PER_SEG - 1);
+    }
+    TEST_TRUE(batch, sources_ok,
+              "Source segments written as %d/%d", (int)first_block_size,
+              (int)second_block_size);
+    DECREF(seg_readers);
+    DECREF(reader);
+
+    // Delete, then merge everything into a single segment.
+    Schema       *schema  = S_create_schema(merged_block_size);
+    IndexManager *manager = S_create_manager();
+    Indexer      *indexer = Indexer_new(schema, (Obj*)folder, manager, 0);
+    uint32_t      num_live = 0;
+    for (uint32_t num = 0; num < NUM_DOCS; num++) {
+        if (deleted[num]) {
+            CharBuf *term = CB_newf("uniq%u32", num + 10);
+            Indexer_Delete_By_Term(indexer,
+                                   (CharBuf*)ZCB_WRAP_STR("content", 7),
+                                   (Obj*)term);
+            DECREF(term);
+        }
+        else {
+            num_live++;
+        }
+    }
+    Indexer_Commit(indexer);
+    DECREF(indexer);
+    indexer = Indexer_new(schema, (Obj*)folder, manager, 0);
+    Indexer_Optimize(indexer);
+    Indexer_Commit(indexer);
+    DECREF(indexer);
+    DECREF(manager);
+    DECREF(schema);
+
+    reader      = IxReader_open((Obj*)folder, NULL, NULL);
+    seg_readers = IxReader_Seg_Readers(reader);
+    SegReader *seg_reader = VA_Get_Size(seg_readers) == 1
+                            ? (SegReader*)VA_Fetch(seg_readers, 0)
+                            : NULL;
+    DefaultDocReader *doc_reader = seg_reader
+                                   ? S_doc_reader(seg_reader)
+                                   : NULL;
+    TEST_TRUE(batch, doc_reader
+              && (merged_block_size != 0) == (doc_reader->block_docs != NULL),
+              "Merged into one segment written as %d",
+              (int)merged_block_size);
+    TEST_INT_EQ(batch, IxReader_Doc_Count(reader), num_live,
+                "Deleted docs purged by merge");
+
+    bool_t   records_ok = doc_reader != NULL;
+    bool_t   fields_ok  = doc_reader != NULL;
+    ByteBuf *record     = BB_new(0);
+    int32_t  doc_id     = 0;
+    for (uint32_t num = 0; doc_reader && num < NUM_DOCS; num++) {
+        if (deleted[num]) { continue; }
+        doc_id++;
+        DefDocReader_Read_Record(doc_reader, record, doc_id);
+        if (!BB_Equals(record, VA_Fetch(records, num))) {
+            records_ok = false;
+        }
+        HitDoc  *hit_doc  = DefDocReader_Fetch_Doc(doc_reader, doc_id);
+        CharBuf *expected = S_content(num);
+        Obj *got = HitDoc_Extract(hit_doc,
+                                  (CharBuf*)ZCB_WRAP_STR("content", 7),
+                                  (ViewCharBuf*)ZCB_BLANK());
+        if (!got || !CB_Equals(expected, got)) { fields_ok = false; }
+        DECREF(expected);
+        DECREF(hit_doc);
+    }
+    TEST_TRUE(batch, records_ok, "Records survive merge byte for byte");
+    TEST_TRUE(batch, fields_ok, "Stored fields survive merge");
+
+    DECREF(record);
+    DECREF(seg_readers);
+    DECREF(reader);
+    DECREF(records);
+    DECREF(folder);
+}
 
 void
 TestDocWriter_run_tests() {
-    TestBatch *batch = TestBatch_new(1);
+    TestBatch *batch = TestBatch_new(25);
     TestBatch_Plan(batch);
-    PASS(batch, "placeholder");
+
+    // Uncompressed to uncompressed.
+    test_merge(batch, 0, 0, 0);
+    // Compressed to compressed, with and without matching block sizes.
+    test_merge(batch, BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE);
+    test_merge(batch, BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE * 4);
+    // Mixed formats.
+    test_merge(batch, 0, BLOCK_SIZE, 0);
+    test_merge(batch, BLOCK_SIZE, 0, BLOCK_SIZE);
+
     DECREF(batch);
 }
 
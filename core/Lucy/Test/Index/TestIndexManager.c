@@ -19,6 +19,7 @@
 #include "Lucy/Test.h"
 #include "Lucy/Test/Index/TestIndexManager.h"
 #include "Lucy/Index/IndexManager.h"
+#include "Lucy/Index/TieredMergePolicy.h"
 
 static void
 test_Choose_Sparse(TestBatch *batch) {
@@ -48,11 +49,75 @@ test_Choose_Sparse(TestBatch *batch) {
     DECREF(manager);
 }
 
+static bool_t
+S_chose(I32Array *chosen, int32_t tick) {
+    for (uint32_t i = 0, max = I32Arr_Get_Size(chosen); i < max; i++) {
+        if (I32Arr_Get(chosen, i) == tick) { return true; }
+    }
+    return false;
+}
+
+static void
+test_TieredMP_Choose_Merge(TestBatch *batch) {
+    TieredMergePolicy *policy = TieredMP_new();
+    int64_t  seg_bytes[20];
+    double   live_ratios[20];
+    I32Array *chosen;
+
+    for (uint32_t i = 0; i < 20; i++) {
+        seg_bytes[i]   = 1000;
+        live_ratios[i] = 1.0;
+    }
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 5);
+    TEST_INT_EQ(batch, I32Arr_Get_Size(chosen), 0,
+                "No merge while within budget");
+    DECREF(chosen);
+
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 20);
+    TEST_INT_EQ(batch, I32Arr_Get_Size(chosen), 10,
+                "Merge Max_Merge_At_Once tiny segments when over budget");
+    DECREF(chosen);
+
+    Hash *stats = TieredMP_Stats(policy);
+    TEST_INT_EQ(batch,
+                Obj_To_I64(Hash_Fetch_Str(stats, "last_chosen", 11)), 10,
+                "Stats report the last decision");
+    DECREF(stats);
+
+    TieredMP_Set_Max_Merged_Seg_Bytes(policy, 100 * 1000 * 1000);
+    seg_bytes[0] = 200 * 1000 * 1000;
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 20);
+    TEST_FALSE(batch, S_chose(chosen, 0), "Leave oversized segments alone");
+    DECREF(chosen);
+
+    for (uint32_t i = 0; i < 20; i++) { seg_bytes[i] = 30 * 1000 * 1000; }
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 20);
+    TEST_TRUE(batch, I32Arr_Get_Size(chosen) >= 2
+              && I32Arr_Get_Size(chosen) <= 3,
+              "Respect Max_Merged_Seg_Bytes");
+    DECREF(chosen);
+
+    live_ratios[2] = 0.5;
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 3);
+    TEST_TRUE(batch, I32Arr_Get_Size(chosen) == 1 && S_chose(chosen, 2),
+              "Reclaim deletions from a single segment");
+    DECREF(chosen);
+
+    live_ratios[2] = 0.9;
+    chosen = TieredMP_Choose_Merge(policy, seg_bytes, live_ratios, 3);
+    TEST_INT_EQ(batch, I32Arr_Get_Size(chosen), 0,
+                "Don't rewrite a segment for a few deletions");
+    DECREF(chosen);
+
+    DECREF(policy);
+}
+
 void
 TestIxManager_run_tests() {
-    TestBatch *batch = TestBatch_new(34);
+    TestBatch *batch = TestBatch_new(41);
     TestBatch_Plan(batch);
     test_Choose_Sparse(batch);
+    test_TieredMP_Choose_Merge(batch);
     DECREF(batch);
 }
 
@@ -0,0 +1,313 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_TESTORDINALMAP
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Index/TestOrdinalMap.h"
+#include "Lucy/Document/Doc.h"
+#include "Lucy/Document/HitDoc.h"
+#include "Lucy/Index/Indexer.h"
+#include "Lucy/Index/IndexManager.h"
+#include "Lucy/Index/IndexReader.h"
+#include "Lucy/Index/OrdinalMap.h"
+#include "Lucy/Index/SegReader.h"
+#include "Lucy/Index/SortCache.h"
+#include "Lucy/Index/SortReader.h"
+#include "Lucy/Index/TieredMergePolicy.h"
+#include "Lucy/Plan/Schema.h"
+#include "Lucy/Plan/StringType.h"
+#include "Lucy/Search/Hits.h"
+#include "Lucy/Search/IndexSearcher.h"
+#include "Lucy/Search/MatchAllQuery.h"
+#include "Lucy/Search/SortRule.h"
+#include "Lucy/Search/SortSpec.h"
+#include "Lucy/Store/RAMFolder.h"
+
+static Schema*
+S_create_schema() {
+    Schema     *schema = Schema_new();
+    StringType *type   = StringType_new();
+    StringType_Set_Sortable(type, true);
+    Schema_Spec_Field(schema, (CharBuf*)ZCB_WRAP_STR("name", 4),
+                      (FieldType*)type);
+    Schema_Spec_Field(schema, (CharBuf*)ZCB_WRAP_STR("other", 5),
+                      (FieldType*)type);
+    DECREF(type);
+    return schema;
+}
+
+// Add one segment.  A NULL value yields a doc without a "name" field.
+static void
+S_add_segment(Schema *schema, RAMFolder *folder, const char **values,
+              uint32_t num_values) {
+    // Keep the small segments apart rather than letting them be merged.
+    IndexManager      *manager = IxManager_new(NULL, NULL);
+    TieredMergePolicy *policy  = TieredMP_new();
+    TieredMP_Set_Segs_Per_Tier(policy, 100);
+    IxManager_Set_Merge_Policy(manager, (MergePolicy*)policy);
+    Indexer *indexer = Indexer_new(schema, (Obj*)folder, manager, 0);
+    for (uint32_t i = 0; i < num_values; i++) {
+        Doc *doc = Doc_new(NULL, 0);
+        if (values[i]) {
+            CharBuf *value = CB_newf("%s", values[i]);
+            Doc_Store(doc, (CharBuf*)ZCB_WRAP_STR("name", 4), (Obj*)value);
+            DECREF(value);
+        }
+        else {
+            Doc_Store(doc, (CharBuf*)ZCB_WRAP_STR("other", 5),
+                      (Obj*)ZCB_WRAP_STR("x", 1));
+        }
+        Indexer_Add_Doc(indexer, doc, 1.0f);
+        DECREF(doc);
+    }
+    Indexer_Commit(indexer);
+    DECREF(indexer);
+    DECREF(policy);
+    DECREF(manager);
+}
+
+static SortCache*
+S_sort_cache(IndexReader *reader, uint32_t seg_tick) {
+    VArray    *seg_readers = IxReader_Seg_Readers(reader);
+    SegReader *seg_reader  = (SegReader*)VA_Fetch(seg_readers, seg_tick);
+    DECREF(seg_readers);
+    SortReader *sort_reader
+        = (SortReader*)SegReader_Fetch(seg_reader,
+                                       VTable_Get_Name(SORTREADER));
+    return sort_reader
+           ? SortReader_Fetch_Sort_Cache(sort_reader,
+                                         (CharBuf*)ZCB_WRAP_STR("name", 4))
+           : NULL;
+}
+
+static OrdinalMap*
+S_ord_map(IndexReader *reader) {
+    PolySortReader *sort_reader
+        = (PolySortReader*)CERTIFY(
+              IxReader_Obtain(reader, VTable_Get_Name(SORTREADER)),
+              POLYSORTREADER);
+    return PolySortReader_Fetch_Ord_Map(sort_reader,
+                                        (CharBuf*)ZCB_WRAP_STR("name", 4));
+}
+
+// Return the global ordinal for a value within one segment, or -1 if the
+// segment doesn't contain the value.
+static int32_t
+S_global_ord(OrdinalMap *ord_map, IndexReader *reader, uint32_t seg_tick,
+             const char *value) {
+    SortCache *cache = S_sort_cache(reader, seg_tick);
+    int32_t    retval = -1;
+    if (cache) {
+        Obj *blank = SortCache_Make_Blank(cache);
+        for (int32_t ord = 0; ord < SortCache_Get_Cardinality(cache); ord++) {
+            Obj *got = SortCache_Value(cache, ord, blank);
+            if (got && CB_Equals_Str((CharBuf*)got, value, strlen(value))) {
+                retval = OrdMap_Global_Ord(ord_map, seg_tick, ord);
+                break;
+            }
+        }
+        DECREF(blank);
+    }
+    return retval;
+}
+
+// Verify that for every doc in every segment, the global ordinal yields the
+// doc's own value, and that global ordinals sort in the same order as the
+// values they stand for.
+static bool_t
+S_consistent(OrdinalMap *ord_map, IndexReader *reader) {
+    VArray  *seg_readers = IxReader_Seg_Readers(reader);
+    Obj     *global_blank = OrdMap_Make_Blank(ord_map);
+    bool_t   retval      = true;
+    CharBuf *last_val    = NULL;
+
+    for (int32_t ord = 0; ord < OrdMap_Get_Cardinality(ord_map); ord++) {
+        Obj *val = OrdMap_Value(ord_map, ord, global_blank);
+        if (!val) {
+            if (ord != OrdMap_Get_Null_Ord(ord_map)) { retval = false; }
+            continue;
+        }
+        if (last_val && CB_Compare_To(last_val, val) >= 0) { retval = false; }
+        DECREF(last_val);
+        last_val = CB_Clone((CharBuf*)val);
+    }
+    DECREF(last_val);
+
+    for (uint32_t i = 0, max = VA_Get_Size(seg_readers); i < max; i++) {
+        SegReader *seg_reader = (SegReader*)VA_Fetch(seg_readers, i);
+        SortCache *cache      = S_sort_cache(reader, i);
+        if (!cache) {
+            if (OrdMap_Seg_Map(ord_map, i) != NULL) { retval = false; }
+            continue;
+        }
+        Obj *local_blank = SortCache_Make_Blank(cache);
+        for (int32_t doc_id = 1; doc_id <= SegReader_Doc_Max(seg_reader);
+             doc_id++
+            ) {
+            int32_t local  = SortCache_Ordinal(cache, doc_id);
+            int32_t global = OrdMap_Global_Ord(ord_map, i, local);
+            Obj *expected  = SortCache_Value(cache, local, local_blank);
+            Obj *got       = OrdMap_Value(ord_map, global, global_blank);
+            if (!expected || !got) {
+                if (expected || got) { retval = false; }
+            }
+            else if (!Obj_Equals(expected, got)) {
+                retval = false;
+            }
+        }
+        DECREF(local_blank);
+    }
+
+    DECREF(global_blank);
+    DECREF(seg_readers);
+    return retval;
+}
+
+static void
+test_overlapping_terms(TestBatch *batch) {
+    Schema     *schema  = S_create_schema();
+    RAMFolder  *folder  = RAMFolder_new(NULL);
+    const char *seg_a[] = { "f", "b", "d" };
+    const char *seg_b[] = { "d", "g", "a", "d" };
+    S_add_segment(schema, folder, seg_a, 3);
+    S_add_segment(schema, folder, seg_b, 4);
+
+    IndexReader *reader  = IxReader_open((Obj*)folder, NULL, NULL);
+    OrdinalMap  *ord_map = S_ord_map(reader);
+    TEST_TRUE(batch, ord_map != NULL, "Fetch_Ord_Map");
+    TEST_INT_EQ(batch, OrdMap_Get_Cardinality(ord_map), 5,
+                "Shared terms counted once");
+    TEST_INT_EQ(batch, OrdMap_Get_Null_Ord(ord_map), 5,
+                "NULL ord follows highest ordinal when no NULLs");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 0, "d"), 2,
+                "Shared term in first segment");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 1, "d"), 2,
+                "Shared term in second segment maps to the same ordinal");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 1, "a"), 0,
+                "Term unique to second segment sorts first");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 0, "b"), 1,
+                "Local ordinal 0 of first segment is shifted");
+    TEST_TRUE(batch, S_consistent(ord_map, reader),
+              "Global ordinals consistent with values (overlap)");
+
+    DECREF(reader);
+    DECREF(folder);
+    DECREF(schema);
+}
+
+static void
+test_disjoint_terms(TestBatch *batch) {
+    Schema     *schema  = S_create_schema();
+    RAMFolder  *folder  = RAMFolder_new(NULL);
+    const char *seg_a[] = { "b", "a" };
+    const char *seg_b[] = { "y", "x" };
+    const char *seg_c[] = { NULL, "m" };
+    const char *seg_d[] = { NULL };
+    S_add_segment(schema, folder, seg_a, 2);
+    S_add_segment(schema, folder, seg_b, 2);
+    S_add_segment(schema, folder, seg_c, 2);
+    S_add_segment(schema, folder, seg_d, 1);
+
+    IndexReader *reader  = IxReader_open((Obj*)folder, NULL, NULL);
+    OrdinalMap  *ord_map = S_ord_map(reader);
+    TEST_INT_EQ(batch, OrdMap_Get_Cardinality(ord_map), 6,
+                "Disjoint terms plus NULL");
+    TEST_INT_EQ(batch, OrdMap_Get_Null_Ord(ord_map), 5, "NULL sorts last");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 1, "x"), 3,
+                "Later segment's terms follow earlier ones");
+    TEST_INT_EQ(batch, S_global_ord(ord_map, reader, 2, "m"), 2,
+                "Interleaved segment");
+    TEST_TRUE(batch, OrdMap_Seg_Map(ord_map, 3) == NULL,
+              "No Seg_Map for segment without values");
+    TEST_INT_EQ(batch, OrdMap_Global_Ord(ord_map, 3, 0), 5,
+                "Segment without values maps to NULL ord");
+    TEST_TRUE(batch, S_consistent(ord_map, reader),
+              "Global ordinals consistent with values (disjoint)");
+
+    DECREF(reader);
+    DECREF(folder);
+    DECREF(schema);
+}
+
+static void
+S_check_sorted(TestBatch *batch, IndexSearcher *searcher, Query *query,
+               SortSpec *sort_spec, uint32_t num_wanted,
+               const char *expected) {
+    CharBuf *name = (CharBuf*)ZCB_WRAP_STR("name", 4);
+    Hits    *hits = IxSearcher_Hits(searcher, (Obj*)query, 0, num_wanted,
+                                    sort_spec);
+    CharBuf *got  = CB_new(8);
+    HitDoc  *hit_doc;
+    while (NULL != (hit_doc = Hits_Next(hits))) {
+        Obj *value = HitDoc_Extract(hit_doc, name, (ViewCharBuf*)ZCB_BLANK());
+        if (value) { CB_Cat(got, (CharBuf*)value); }
+        else       { CB_Cat_Trusted_Str(got, "-", 1); }
+        DECREF(hit_doc);
+    }
+    TEST_TRUE(batch, CB_Equals_Str(got, expected, strlen(expected)),
+              "Sort by text across segments, %d wanted: %s", (int)num_wanted,
+              (char*)CB_Get_Ptr8(got));
+    DECREF(got);
+    DECREF(hits);
+}
+
+static void
+test_sorted_search(TestBatch *batch) {
+    Schema     *schema  = S_create_schema();
+    RAMFolder  *folder  = RAMFolder_new(NULL);
+    CharBuf    *name    = (CharBuf*)ZCB_WRAP_STR("name", 4);
+    // Each segment's local ordinals are 0 and 1, so comparing them directly
+    // across segments would interleave the values incorrectly.
+    const char *seg_a[] = { "d", "b" };
+    const char *seg_b[] = { "c", "a" };
+    const char *seg_c[] = { "e", NULL };
+    S_add_segment(schema, folder, seg_a, 2);
+    S_add_segment(schema, folder, seg_b, 2);
+    S_add_segment(schema, folder, seg_c, 2);
+
+    IndexSearcher *searcher = IxSearcher_new((Obj*)folder);
+    VArray *rules = VA_new(1);
+    VA_Push(rules, (Obj*)SortRule_new(SortRule_FIELD, name, false));
+    SortSpec *sort_spec = SortSpec_new(rules);
+    MatchAllQuery *query = MatchAllQuery_new();
+
+    S_check_sorted(batch, searcher, (Query*)query, sort_spec, 6, "abcde-");
+    S_check_sorted(batch, searcher, (Query*)query, sort_spec, 2, "ab");
+
+    DECREF(query);
+    DECREF(sort_spec);
+    DECREF(rules);
+    DECREF(searcher);
+    DECREF(folder);
+    DECREF(schema);
+}
+
+void
+TestOrdMap_run_tests() {
+    TestBatch *batch = TestBatch_new(17);
+
+    TestBatch_Plan(batch);
+
+    test_overlapping_terms(batch);
+    test_disjoint_terms(batch);
+    test_sorted_search(batch);
+
+    DECREF(batch);
+}
+
+
@@ -0,0 +1,229 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_TESTROARINGBITMAP
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/TestUtils.h"
+#include "Lucy/Test/Object/TestRoaringBitmap.h"
+#include "Lucy/Object/RoaringBitmap.h"
+
+// Span several 65536-tick chunks so that multiple containers get used.
+#define NUM_TICKS 200000
+
+// Populate a RoaringBitmap and a BitVector with the same pseudo-random bits.
+// <code>density</code> picks sparse (array) or dense (bitmap) containers.
+static void
+S_fill(RoaringBitmap *roaring, BitVector *bit_vec, uint32_t density,
+       uint32_t seed) {
+    uint32_t state = seed;
+    for (uint32_t i = 0; i < NUM_TICKS / density; i++) {
+        state = state * 1103515245 + 12345;
+        uint32_t tick = (state >> 8) % NUM_TICKS;
+        Roaring_Set(roaring, tick);
+        BitVec_Set(bit_vec, tick);
+    }
+}
+
+static bool_t
+S_same_bits(RoaringBitmap *roaring, BitVector *bit_vec) {
+    if (Roaring_Count(roaring) != BitVec_Count(bit_vec)) { return false; }
+    int32_t tick     = Roaring_Next_Hit(roaring, 0);
+    int32_t expected = BitVec_Next_Hit(bit_vec, 0);
+    while (expected != -1) {
+        if (tick != expected) { return false; }
+        if (!Roaring_Get(roaring, (uint32_t)tick)) { return false; }
+        tick     = Roaring_Next_Hit(roaring, (uint32_t)tick + 1);
+        expected = BitVec_Next_Hit(bit_vec, (uint32_t)expected + 1);
+    }
+    return tick == -1 ? true : false;
+}
+
+static void
+test_Set_Get_and_Clear(TestBatch *batch) {
+    RoaringBitmap *roaring = Roaring_new();
+    BitVector     *bit_vec = BitVec_new(0);
+
+    S_fill(roaring, bit_vec, 50, 1);
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec), "sparse Set");
+    S_fill(roaring, bit_vec, 2, 2);
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec), "dense Set");
+    TEST_FALSE(batch, Roaring_Get(roaring, NUM_TICKS * 10),
+               "Get beyond highest tick");
+    TEST_TRUE(batch, Roaring_Get_Raw_Bits(roaring) == NULL,
+              "Get_Raw_Bits returns NULL");
+
+    for (uint32_t tick = 0; tick < NUM_TICKS; tick += 3) {
+        Roaring_Clear(roaring, tick);
+        BitVec_Clear(bit_vec, tick);
+    }
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec), "Clear");
+
+    Roaring_Clear_All(roaring);
+    TEST_INT_EQ(batch, Roaring_Count(roaring), 0, "Clear_All");
+    TEST_INT_EQ(batch, Roaring_Next_Hit(roaring, 0), -1,
+                "Next_Hit after Clear_All");
+
+    DECREF(bit_vec);
+    DECREF(roaring);
+}
+
+static void
+test_Flip_Block(TestBatch *batch) {
+    RoaringBitmap *roaring = Roaring_new();
+    BitVector     *bit_vec = BitVec_new(0);
+
+    S_fill(roaring, bit_vec, 20, 3);
+    Roaring_Flip_Block(roaring, 1000, 150000);
+    BitVec_Flip_Block(bit_vec, 1000, 150000);
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec), "Flip_Block");
+    TEST_TRUE(batch, Roaring_Get_Capacity(roaring) >= 151000,
+              "Flip_Block raises capacity");
+
+    Roaring_Flip(roaring, 70000);
+    BitVec_Flip(bit_vec, 70000);
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec), "Flip");
+
+    DECREF(bit_vec);
+    DECREF(roaring);
+}
+
+static void
+test_binary_ops(TestBatch *batch) {
+    const char *names[] = { "And", "Or", "Xor", "And_Not" };
+    for (int op = 0; op < 4; op++) {
+        RoaringBitmap *roaring_a = Roaring_new();
+        RoaringBitmap *roaring_b = Roaring_new();
+        BitVector     *bit_vec_a = BitVec_new(0);
+        BitVector     *bit_vec_b = BitVec_new(0);
+        BitVector     *flat      = BitVec_new(0);
+
+        S_fill(roaring_a, bit_vec_a, 3, 4);
+        S_fill(roaring_b, bit_vec_b, 40, 5);
+        Roaring_Flip_Block(roaring_b, 5000, 70000);
+        BitVec_Flip_Block(bit_vec_b, 5000, 70000);
+        Roaring_Run_Optimize(roaring_b);
+        BitVec_Mimic(flat, (Obj*)bit_vec_a);
+
+        switch (op) {
+            case 0:
+                Roaring_And(roaring_a, (BitVector*)roaring_b);
+                BitVec_And(bit_vec_a, bit_vec_b);
+                BitVec_And(flat, (BitVector*)roaring_b);
+                break;
+            case 1:
+                Roaring_Or(roaring_a, (BitVector*)roaring_b);
+                BitVec_Or(bit_vec_a, bit_vec_b);
+                BitVec_Or(flat, (BitVector*)roaring_b);
+                break;
+            case 2:
+                Roaring_Xor(roaring_a, (BitVector*)roaring_b);
+                BitVec_Xor(bit_vec_a, bit_vec_b);
+                BitVec_Xor(flat, (BitVector*)roaring_b);
+                break;
+            default:
+                Roaring_And_Not(roaring_a, (BitVector*)roaring_b);
+                BitVec_And_Not(bit_vec_a, bit_vec_b);
+                BitVec_And_Not(flat, (BitVector*)roaring_b);
+                break;
+        }
+        TEST_TRUE(batch, S_same_bits(roaring_a, bit_vec_a), "%s",
+                  names[op]);
+        TEST_TRUE(batch, BitVec_Count(flat) == BitVec_Count(bit_vec_a),
+                  "BitVector %s RoaringBitmap", names[op]);
+
+        // Operate against a flat BitVector.
+        Roaring_Mimic(roaring_b, (Obj*)bit_vec_b);
+        TEST_TRUE(batch, S_same_bits(roaring_b, bit_vec_b),
+                  "Mimic BitVector");
+
+        DECREF(flat);
+        DECREF(bit_vec_b);
+        DECREF(bit_vec_a);
+        DECREF(roaring_b);
+        DECREF(roaring_a);
+    }
+}
+
+static void
+test_Run_Optimize(TestBatch *batch) {
+    RoaringBitmap *roaring = Roaring_new();
+    BitVector     *bit_vec = BitVec_new(0);
+
+    Roaring_Flip_Block(roaring, 0, NUM_TICKS);
+    BitVec_Flip_Block(bit_vec, 0, NUM_TICKS);
+    uint64_t before = Roaring_Memory_Usage(roaring);
+    Roaring_Run_Optimize(roaring);
+    TEST_TRUE(batch, Roaring_Memory_Usage(roaring) < before,
+              "Run_Optimize shrinks memory usage");
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec),
+              "Run_Optimize preserves bits");
+
+    Roaring_Clear(roaring, 100);
+    BitVec_Clear(bit_vec, 100);
+    Roaring_Set(roaring, NUM_TICKS + 5);
+    BitVec_Set(bit_vec, NUM_TICKS + 5);
+    TEST_TRUE(batch, S_same_bits(roaring, bit_vec),
+              "modify after Run_Optimize");
+
+    DECREF(bit_vec);
+    DECREF(roaring);
+}
+
+static void
+test_Clone_and_To_Array(TestBatch *batch) {
+    RoaringBitmap *roaring = Roaring_new();
+    BitVector     *bit_vec = BitVec_new(0);
+
+    S_fill(roaring, bit_vec, 10, 6);
+    RoaringBitmap *twin = Roaring_Clone(roaring);
+    TEST_TRUE(batch, S_same_bits(twin, bit_vec), "Clone");
+
+    I32Array *array    = Roaring_To_Array(roaring);
+    I32Array *expected = BitVec_To_Array(bit_vec);
+    TEST_TRUE(batch, I32Arr_Get_Size(array) == I32Arr_Get_Size(expected),
+              "To_Array size");
+    bool_t same = true;
+    for (uint32_t i = 0; i < I32Arr_Get_Size(array); i++) {
+        if (I32Arr_Get(array, i) != I32Arr_Get(expected, i)) {
+            same = false;
+        }
+    }
+    TEST_TRUE(batch, same, "To_Array");
+
+    DECREF(expected);
+    DECREF(array);
+    DECREF(twin);
+    DECREF(bit_vec);
+    DECREF(roaring);
+}
+
+void
+TestRoaringBitmap_run_tests() {
+    TestBatch *batch = TestBatch_new(28);
+
+    TestBatch_Plan(batch);
+    test_Set_Get_and_Clear(batch);
+    test_Flip_Block(batch);
+    test_binary_ops(batch);
+    test_Run_Optimize(batch);
+    test_Clone_and_To_Array(batch);
+
+    DECREF(batch);
+}
+
+
@@ -31,6 +31,7 @@ TestArch_new() {
 TestArchitecture*
 TestArch_init(TestArchitecture *self) {
     Arch_init((Architecture*)self);
+    self->doc_block_size = 0;
     return self;
 }
 
@@ -46,4 +47,14 @@ TestArch_skip_interval(TestArchitecture *self) {
     return 3;
 }
 
+int32_t
+TestArch_doc_block_size(TestArchitecture *self) {
+    return self->doc_block_size;
+}
+
+void
+TestArch_set_doc_block_size(TestArchitecture *self, int32_t doc_block_size) {
+    self->doc_block_size = doc_block_size;
+}
+
 
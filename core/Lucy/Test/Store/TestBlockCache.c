@@ -0,0 +1,247 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_INSTREAM
+#define C_LUCY_FILEWINDOW
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Store/TestBlockCache.h"
+#include "Lucy/Store/BlockCache.h"
+#include "Lucy/Store/CachedFileHandle.h"
+#include "Lucy/Store/CompoundFileReader.h"
+#include "Lucy/Store/FileWindow.h"
+#include "Lucy/Store/InStream.h"
+#include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RAMFile.h"
+#include "Lucy/Store/RAMFileHandle.h"
+#include "Lucy/Store/RAMFolder.h"
+
+#define FILE_LEN   5000
+#define BLOCK_SIZE 512
+
+static RAMFileHandle*
+S_make_file_handle() {
+    RAMFile *file = RAMFile_new(NULL, false);
+    RAMFileHandle *fh = RAMFH_open(NULL, FH_WRITE_ONLY, file);
+    for (uint32_t i = 0; i < FILE_LEN; i++) {
+        char byte = (char)(i % 251);
+        RAMFH_Write(fh, &byte, 1);
+    }
+    DECREF(fh);
+    fh = RAMFH_open(NULL, FH_READ_ONLY, file);
+    DECREF(file);
+    return fh;
+}
+
+static bool_t
+S_contents_ok(const char *buf, int64_t offset, int64_t len) {
+    for (int64_t i = 0; i < len; i++) {
+        if (buf[i] != (char)((offset + i) % 251)) { return false; }
+    }
+    return true;
+}
+
+static void
+test_Window_and_Read(TestBatch *batch) {
+    BlockCache *cache = BlockCache_new(BLOCK_SIZE * 4, BLOCK_SIZE);
+    RAMFileHandle *inner = S_make_file_handle();
+    CachedFileHandle *fh = CachedFH_open((FileHandle*)inner, cache);
+    FileWindow *window = FileWindow_new();
+    char buf[FILE_LEN];
+
+    TEST_TRUE(batch, CachedFH_Length(fh) == FILE_LEN, "Length");
+
+    TEST_TRUE(batch, CachedFH_Window(fh, window, 10, 20),
+              "Window() returns true");
+    TEST_TRUE(batch, window->offset == 0 && window->len == BLOCK_SIZE,
+              "Window() exposes the whole block");
+    TEST_TRUE(batch, S_contents_ok(window->buf, 0, BLOCK_SIZE),
+              "Window() contents");
+    TEST_TRUE(batch, BlockCache_Get_Misses(cache) == 1, "first access misses");
+
+    TEST_TRUE(batch, CachedFH_Window(fh, window, 100, 20),
+              "Window() within the same block");
+    TEST_TRUE(batch, BlockCache_Get_Hits(cache) == 1, "second access hits");
+
+    TEST_TRUE(batch, CachedFH_Window(fh, window, 500, 30),
+              "Window() straddling blocks");
+    TEST_TRUE(batch, window->offset == 500 && window->len == 30,
+              "straddling Window() covers exactly the request");
+    TEST_TRUE(batch, S_contents_ok(window->buf, 500, 30),
+              "straddling Window() contents");
+
+    int64_t misses = BlockCache_Get_Misses(cache);
+    TEST_TRUE(batch, CachedFH_Window(fh, window, 1000, 3000),
+              "Window() larger than a block");
+    TEST_TRUE(batch, window->offset == 1000 && window->len == 3000
+              && S_contents_ok(window->buf, 1000, 3000),
+              "large Window() contents");
+    TEST_TRUE(batch, BlockCache_Get_Misses(cache) == misses
+              && BlockCache_Memory_Usage(cache) <= BLOCK_SIZE * 4,
+              "large Window() bypasses the cache");
+
+    TEST_TRUE(batch, CachedFH_Window(fh, window, 4900, 10),
+              "Window() in last block");
+    TEST_TRUE(batch, window->offset == 4608
+              && window->len == FILE_LEN - 4608,
+              "last block is short");
+
+    TEST_TRUE(batch, CachedFH_Release_Window(fh, window),
+              "Release_Window() returns true");
+    TEST_TRUE(batch, window->buf == NULL, "Release_Window() resets buf");
+
+    Err_set_error(NULL);
+    TEST_FALSE(batch, CachedFH_Window(fh, window, 4990, 20),
+               "Window() past EOF returns false");
+    TEST_TRUE(batch, Err_get_error() != NULL,
+              "Window() past EOF sets error");
+
+    TEST_TRUE(batch, CachedFH_Read(fh, buf, 1000, 3000),
+              "Read() returns true");
+    TEST_TRUE(batch, S_contents_ok(buf, 1000, 3000), "Read() contents");
+
+    Err_set_error(NULL);
+    TEST_FALSE(batch, CachedFH_Read(fh, buf, -1, 4),
+               "Read() with a negative offset returns false");
+    TEST_TRUE(batch, Err_get_error() != NULL,
+              "Read() with a negative offset sets error");
+
+    Err_set_error(NULL);
+    TEST_FALSE(batch, CachedFH_Write(fh, "foo", 3),
+               "Write() returns false");
+    TEST_TRUE(batch, Err_get_error() != NULL, "Write() sets error");
+
+    DECREF(window);
+    DECREF(fh);
+    DECREF(inner);
+    DECREF(cache);
+}
+
+static void
+test_eviction(TestBatch *batch) {
+    BlockCache *cache = BlockCache_new(BLOCK_SIZE * 4, BLOCK_SIZE);
+    RAMFileHandle *inner = S_make_file_handle();
+    CachedFileHandle *fh = CachedFH_open((FileHandle*)inner, cache);
+    FileWindow *window = FileWindow_new();
+    char buf[FILE_LEN];
+
+    // Pin the first block, then read the whole file through the cache.
+    CachedFH_Window(fh, window, 0, 10);
+    TEST_TRUE(batch, CachedFH_Read(fh, buf, 0, FILE_LEN),
+              "Read() entire file through small cache");
+    TEST_TRUE(batch, S_contents_ok(buf, 0, FILE_LEN), "contents");
+    TEST_TRUE(batch, BlockCache_Get_Evictions(cache) > 0, "blocks evicted");
+    TEST_TRUE(batch, BlockCache_Memory_Usage(cache) <= BLOCK_SIZE * 4,
+              "memory stays within capacity");
+    TEST_TRUE(batch, S_contents_ok(window->buf, 0, BLOCK_SIZE),
+              "pinned block survives eviction");
+
+    int64_t hits = BlockCache_Get_Hits(cache);
+    CachedFH_Window(fh, window, 20, 10);
+    TEST_TRUE(batch, BlockCache_Get_Hits(cache) == hits + 1,
+              "pinned block still cached");
+    CachedFH_Release_Window(fh, window);
+
+    DECREF(fh);
+    TEST_TRUE(batch, BlockCache_Memory_Usage(cache) == 0,
+              "destroying the handle purges its blocks");
+
+    DECREF(window);
+    DECREF(inner);
+    DECREF(cache);
+}
+
+static void
+test_priority(TestBatch *batch) {
+    ZombieCharBuf *path = ZCB_BLANK();
+    ZCB_Assign_Str(path, "seg_1/lexicon-3.ix", 18);
+    TEST_INT_EQ(batch, CachedFH_priority((CharBuf*)path), 3, "lexicon");
+    ZCB_Assign_Str(path, "seg_1/postings.skip", 19);
+    TEST_INT_EQ(batch, CachedFH_priority((CharBuf*)path), 3, "skip data");
+    ZCB_Assign_Str(path, "seg_1/postings-3.dat", 20);
+    TEST_INT_EQ(batch, CachedFH_priority((CharBuf*)path), 2, "postings");
+    ZCB_Assign_Str(path, "seg_1/documents.dat", 19);
+    TEST_INT_EQ(batch, CachedFH_priority((CharBuf*)path), 0,
+                "stored documents");
+    ZCB_Assign_Str(path, "seg_1/cf.dat", 12);
+    TEST_INT_EQ(batch, CachedFH_priority((CharBuf*)path), 1, "other");
+}
+
+static void
+test_Folder(TestBatch *batch) {
+    BlockCache *cache  = BlockCache_new(BLOCK_SIZE * 4, BLOCK_SIZE);
+    RAMFolder  *folder = RAMFolder_new(NULL);
+    ZombieCharBuf *seg_1 = ZCB_WRAP_STR("seg_1", 5);
+    ZombieCharBuf *foo   = ZCB_WRAP_STR("seg_1/foo", 9);
+    ZombieCharBuf *bar   = ZCB_WRAP_STR("bar", 3);
+    char buf[3];
+
+    RAMFolder_MkDir(folder, (CharBuf*)seg_1);
+    OutStream *outstream = RAMFolder_Open_Out(folder, (CharBuf*)foo);
+    OutStream_Write_Bytes(outstream, "foo", 3);
+    OutStream_Close(outstream);
+    DECREF(outstream);
+
+    RAMFolder_Set_Block_Cache(folder, cache);
+    TEST_TRUE(batch, RAMFolder_Get_Block_Cache(folder) == cache,
+              "Get_Block_Cache");
+    InStream *instream = RAMFolder_Open_In(folder, (CharBuf*)foo);
+    TEST_TRUE(batch, FH_Is_A(instream->file_handle, CACHEDFILEHANDLE),
+              "Open_In() in a subdirectory reads through the cache");
+    InStream_Read_Bytes(instream, buf, 3);
+    TEST_TRUE(batch, memcmp(buf, "foo", 3) == 0, "cached InStream contents");
+    TEST_TRUE(batch, BlockCache_Get_Misses(cache) == 1, "block was cached");
+    DECREF(instream);
+
+    // Virtual files within a compound file share cf.dat's handle.
+    Folder *sub_folder = RAMFolder_Find_Folder(folder, (CharBuf*)seg_1);
+    outstream = Folder_Open_Out(sub_folder, (CharBuf*)bar);
+    OutStream_Write_Bytes(outstream, "bar", 3);
+    OutStream_Close(outstream);
+    DECREF(outstream);
+    RAMFolder_Consolidate(folder, (CharBuf*)seg_1);
+    CompoundFileReader *cf_reader = CFReader_open(sub_folder);
+    instream = CFReader_Local_Open_In(cf_reader, (CharBuf*)bar);
+    TEST_TRUE(batch, FH_Is_A(instream->file_handle, CACHEDFILEHANDLE),
+              "virtual file reads through the cache");
+    InStream_Read_Bytes(instream, buf, 3);
+    TEST_TRUE(batch, memcmp(buf, "bar", 3) == 0, "virtual file contents");
+    DECREF(instream);
+    DECREF(cf_reader);
+
+    RAMFolder_Set_Block_Cache(folder, NULL);
+    TEST_TRUE(batch, Folder_Get_Block_Cache(sub_folder) == NULL,
+              "Set_Block_Cache() propagates to subdirectories");
+
+    DECREF(folder);
+    DECREF(cache);
+}
+
+void
+TestBlockCache_run_tests() {
+    TestBatch *batch = TestBatch_new(44);
+
+    TestBatch_Plan(batch);
+    test_Window_and_Read(batch);
+    test_eviction(batch);
+    test_priority(batch);
+    test_Folder(batch);
+
+    DECREF(batch);
+}
+
+
@@ -19,8 +19,10 @@
 
 #include "Lucy/Test.h"
 #include "Lucy/Test/Store/TestCompoundFileWriter.h"
+#include "Lucy/Store/CompoundFileReader.h"
 #include "Lucy/Store/CompoundFileWriter.h"
 #include "Lucy/Store/FileHandle.h"
+#include "Lucy/Store/InStream.h"
 #include "Lucy/Store/OutStream.h"
 #include "Lucy/Store/RAMFolder.h"
 #include "Lucy/Util/Json.h"
@@ -31,6 +33,8 @@ static CharBuf cf_file     = ZCB_LITERAL("cf.dat");
 static CharBuf foo         = ZCB_LITERAL("foo");
 static CharBuf bar         = ZCB_LITERAL("bar");
 static CharBuf seg_1       = ZCB_LITERAL("seg_1");
+static CharBuf baz_temp    = ZCB_LITERAL("baz.temp");
+static CharBuf empty       = ZCB_LITERAL("");
 
 static Folder*
 S_folder_with_contents() {
@@ -117,13 +121,79 @@ test_offsets(TestBatch *batch) {
     DECREF(folder);
 }
 
+static bool_t
+S_sub_file_equals(Folder *folder, CharBuf *name, const char *expected) {
+    InStream *instream = Folder_Open_In(folder, name);
+    if (!instream) { return false; }
+    size_t len = strlen(expected);
+    char   buf[10];
+    bool_t result = InStream_Length(instream) == (int64_t)len;
+    if (result) {
+        InStream_Read_Bytes(instream, buf, len);
+        result = memcmp(buf, expected, len) == 0;
+    }
+    DECREF(instream);
+    return result;
+}
+
+static void
+test_streaming(TestBatch *batch) {
+    RAMFolder *folder = RAMFolder_new(&seg_1);
+    RAMFolder_Stream_Compound(folder, &empty);
+
+    // While foo is being streamed into cf.dat, bar has to be written as an
+    // ordinary file.  Scratch files are never streamed.
+    OutStream *foo_out  = RAMFolder_Open_Out(folder, &foo);
+    OutStream *bar_out  = RAMFolder_Open_Out(folder, &bar);
+    OutStream *temp_out = RAMFolder_Open_Out(folder, &baz_temp);
+    OutStream_Write_Bytes(foo_out, "foo", 3);
+    OutStream_Write_Bytes(bar_out, "barbar", 6);
+    OutStream_Close(foo_out);
+    OutStream_Close(bar_out);
+    OutStream_Close(temp_out);
+    DECREF(foo_out);
+    DECREF(bar_out);
+    DECREF(temp_out);
+    TEST_TRUE(batch, Folder_Exists((Folder*)folder, &cf_file),
+              "cf.dat opened for streaming");
+    TEST_FALSE(batch, Folder_Exists((Folder*)folder, &foo),
+               "streamed file not written separately");
+    TEST_TRUE(batch, Folder_Exists((Folder*)folder, &bar),
+              "file opened during streaming written separately");
+    TEST_TRUE(batch, Folder_Exists((Folder*)folder, &baz_temp),
+              "scratch file written separately");
+    RAMFolder_Delete(folder, &baz_temp);
+
+    RAMFolder_Consolidate(folder, &empty);
+    TEST_FALSE(batch, Folder_Exists((Folder*)folder, &bar),
+               "copied file zapped");
+
+    CompoundFileReader *cf_reader = CFReader_open((Folder*)folder);
+    TEST_TRUE(batch, cf_reader != NULL, "streamed compound file readable");
+    if (cf_reader) {
+        TEST_TRUE(batch, S_sub_file_equals((Folder*)cf_reader, &foo, "foo"),
+                  "streamed sub-file intact");
+        TEST_TRUE(batch,
+                  S_sub_file_equals((Folder*)cf_reader, &bar, "barbar"),
+                  "copied sub-file intact");
+        DECREF(cf_reader);
+    }
+    else {
+        FAIL(batch, "streamed sub-file intact");
+        FAIL(batch, "copied sub-file intact");
+    }
+
+    DECREF(folder);
+}
+
 void
 TestCFWriter_run_tests() {
-    TestBatch *batch = TestBatch_new(7);
+    TestBatch *batch = TestBatch_new(15);
 
     TestBatch_Plan(batch);
     test_Consolidate(batch);
     test_offsets(batch);
+    test_streaming(batch);
 
     DECREF(batch);
 }
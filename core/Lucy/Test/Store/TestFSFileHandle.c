@@ -154,6 +154,43 @@ test_Read_Write(TestBatch *batch) {
     remove((char*)CB_Get_Ptr8(test_filename));
 }
 
+static void
+test_large_Write(TestBatch *batch) {
+    CharBuf *test_filename = (CharBuf*)ZCB_WRAP_STR("_fstest", 7);
+    const size_t chunk_size = 64 * 1024;
+    const int    num_chunks = 160; // 10 MB, past the write-behind threshold.
+    char   *chunk = (char*)MALLOCATE(chunk_size);
+    bool_t  success = true;
+
+    remove((char*)CB_Get_Ptr8(test_filename));
+    FSFileHandle *fh = FSFH_open(test_filename,
+                                 FH_CREATE | FH_WRITE_ONLY | FH_EXCLUSIVE);
+    for (int i = 0; i < num_chunks; i++) {
+        memset(chunk, 'a' + (i % 26), chunk_size);
+        if (!FSFH_Write(fh, chunk, chunk_size)) { success = false; }
+    }
+    TEST_TRUE(batch, success, "Large Write returns success");
+    if (!FSFH_Close(fh)) { RETHROW(INCREF(Err_get_error())); }
+    DECREF(fh);
+
+    fh = FSFH_open(test_filename, FH_READ_ONLY);
+    TEST_TRUE(batch, FSFH_Length(fh) == (int64_t)chunk_size * num_chunks,
+              "Length after large Write");
+    for (int i = 0; i < num_chunks; i++) {
+        if (!FSFH_Read(fh, chunk, (int64_t)chunk_size * i, chunk_size)
+            || chunk[0] != 'a' + (i % 26)
+            || chunk[chunk_size - 1] != 'a' + (i % 26)
+           ) {
+            success = false;
+        }
+    }
+    TEST_TRUE(batch, success, "Read back large Write");
+
+    DECREF(fh);
+    FREEMEM(chunk);
+    remove((char*)CB_Get_Ptr8(test_filename));
+}
+
 static void
 test_Close(TestBatch *batch) {
     CharBuf *test_filename = (CharBuf*)ZCB_WRAP_STR("_fstest", 7);
@@ -243,11 +280,12 @@ test_Window(TestBatch *batch) {
 
 void
 TestFSFH_run_tests() {
-    TestBatch *batch = TestBatch_new(46);
+    TestBatch *batch = TestBatch_new(49);
 
     TestBatch_Plan(batch);
     test_open(batch);
     test_Read_Write(batch);
+    test_large_Write(batch);
     test_Close(batch);
     test_Window(batch);
 
@@ -162,9 +162,42 @@ test_disallow_updir(TestBatch *batch) {
     S_tear_down();
 }
 
+static void
+test_Sync(TestBatch *batch) {
+    FSFolder *folder    = (FSFolder*)S_set_up();
+    CharBuf  *foo       = (CharBuf*)ZCB_WRAP_STR("foo", 3);
+    CharBuf  *foo_boffo = (CharBuf*)ZCB_WRAP_STR("foo/boffo", 9);
+    CharBuf  *nope      = (CharBuf*)ZCB_WRAP_STR("nope", 4);
+    VArray   *paths     = VA_new(2);
+
+    FSFolder_MkDir(folder, foo);
+    OutStream *outstream = FSFolder_Open_Out(folder, foo_boffo);
+    OutStream_Write_Bytes(outstream, "blah", 4);
+    OutStream_Close(outstream);
+    DECREF(outstream);
+
+    VA_Push(paths, (Obj*)CB_Clone(foo));
+    VA_Push(paths, (Obj*)CB_Clone(foo_boffo));
+    TEST_TRUE(batch, FSFolder_Sync(folder, paths),
+              "Sync() succeeds for a directory and a file");
+
+    VA_Push(paths, (Obj*)CB_Clone(nope));
+    Err_set_error(NULL);
+    TEST_FALSE(batch, FSFolder_Sync(folder, paths),
+               "Sync() fails when a path doesn't exist");
+    TEST_TRUE(batch, Err_get_error() != NULL,
+              "Sync() sets Err_error on failure");
+
+    DECREF(paths);
+    FSFolder_Delete(folder, foo_boffo);
+    FSFolder_Delete(folder, foo);
+    DECREF(folder);
+    S_tear_down();
+}
+
 void
 TestFSFolder_run_tests() {
-    uint32_t num_tests = TestFolderCommon_num_tests() + 9;
+    uint32_t num_tests = TestFolderCommon_num_tests() + 12;
     TestBatch *batch = TestBatch_new(num_tests);
 
     TestBatch_Plan(batch);
@@ -172,6 +205,7 @@ TestFSFolder_run_tests() {
     TestFolderCommon_run_tests(batch, S_set_up, S_tear_down);
     test_protect_symlinks(batch);
     test_disallow_updir(batch);
+    test_Sync(batch);
 
     DECREF(batch);
 }
@@ -104,9 +104,51 @@ test_Buf(TestBatch *batch) {
     DECREF(file);
 }
 
+static void
+test_Absorb_Range(TestBatch *batch) {
+    RAMFile    *source    = RAMFile_new(NULL, false);
+    RAMFile    *dest      = RAMFile_new(NULL, false);
+    OutStream  *outstream = OutStream_open((Obj*)source);
+    // Large enough that the range is copied in several chunks.
+    int64_t     size      = 0x10000 * 3 + 7;
+    int64_t     offset    = 5;
+    int64_t     len       = size - offset - 3;
+    InStream   *instream;
+
+    for (int64_t i = 0; i < size; i++) {
+        OutStream_Write_U8(outstream, (uint8_t)(i % 251));
+    }
+    OutStream_Close(outstream);
+    DECREF(outstream);
+
+    instream  = InStream_open((Obj*)source);
+    outstream = OutStream_open((Obj*)dest);
+    OutStream_Write_U8(outstream, 'x');
+    OutStream_Absorb_Range(outstream, instream, offset, len);
+    OutStream_Close(outstream);
+    TEST_TRUE(batch, OutStream_Tell(outstream) == len + 1,
+              "Absorb_Range writes the requested length");
+
+    ByteBuf    *contents = RAMFile_Get_Contents(dest);
+    const char *ptr      = BB_Get_Buf(contents) + 1;
+    bool_t      equal    = true;
+    for (int64_t i = 0; i < len; i++) {
+        if ((uint8_t)ptr[i] != (uint8_t)((offset + i) % 251)) {
+            equal = false;
+            break;
+        }
+    }
+    TEST_TRUE(batch, equal, "Absorb_Range copies the requested range");
+
+    DECREF(instream);
+    DECREF(outstream);
+    DECREF(dest);
+    DECREF(source);
+}
+
 void
 TestIOChunks_run_tests() {
-    TestBatch *batch = TestBatch_new(36);
+    TestBatch *batch = TestBatch_new(38);
 
     srand((unsigned int)time((time_t*)NULL));
     TestBatch_Plan(batch);
@@ -114,6 +156,7 @@ TestIOChunks_run_tests() {
     test_Align(batch);
     test_Read_Write_Bytes(batch);
     test_Buf(batch);
+    test_Absorb_Range(batch);
 
     DECREF(batch);
 }
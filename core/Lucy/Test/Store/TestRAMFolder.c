@@ -23,6 +23,7 @@
 #include "Lucy/Store/RAMFolder.h"
 #include "Lucy/Store/DirHandle.h"
 #include "Lucy/Store/RAMDirHandle.h"
+#include "Lucy/Store/RAMFile.h"
 #include "Lucy/Store/RAMFileHandle.h"
 
 static CharBuf foo           = ZCB_LITERAL("foo");
@@ -450,6 +451,55 @@ test_Hard_Link(TestBatch *batch) {
     DECREF(folder);
 }
 
+static RAMFile*
+S_fetch_file(RAMFolder *folder, const CharBuf *dir, const CharBuf *name) {
+    RAMFolder *subfolder = (RAMFolder*)RAMFolder_Find_Folder(folder, dir);
+    return subfolder
+           ? (RAMFile*)Hash_Fetch(subfolder->entries, (Obj*)name)
+           : NULL;
+}
+
+static void
+test_Fork(TestBatch *batch) {
+    RAMFolder *folder = RAMFolder_new(NULL);
+    RAMFolder_MkDir(folder, &foo);
+    FileHandle *fh = RAMFolder_Open_FileHandle(folder, &foo_boffo,
+                                               FH_CREATE | FH_WRITE_ONLY);
+    FH_Write(fh, "abc", 3);
+
+    RAMFolder *twin = RAMFolder_Fork(folder);
+    TEST_TRUE(batch, RAMFolder_Is_Directory(twin, &foo),
+              "Fork copies directories");
+    RAMFile *file      = S_fetch_file(folder, &foo, &boffo);
+    RAMFile *twin_file = S_fetch_file(twin, &foo, &boffo);
+    TEST_TRUE(batch, twin_file && twin_file != file,
+              "Fork gives each folder its own RAMFile");
+    TEST_TRUE(batch, twin_file
+              && RAMFile_Get_Contents(file) == RAMFile_Get_Contents(twin_file),
+              "Fork shares file contents");
+
+    FH_Write(fh, "def", 3);
+    ByteBuf *contents      = RAMFile_Get_Contents(file);
+    ByteBuf *twin_contents = RAMFile_Get_Contents(twin_file);
+    TEST_TRUE(batch, BB_Equals_Bytes(contents, "abcdef", 6),
+              "Write to forked file succeeds");
+    TEST_TRUE(batch, BB_Equals_Bytes(twin_contents, "abc", 3),
+              "Write to forked file is not seen by twin");
+    DECREF(fh);
+
+    RAMFolder_Delete(twin, &foo_boffo);
+    TEST_TRUE(batch, RAMFolder_Exists(folder, &foo_boffo),
+              "Delete in twin doesn't affect original");
+    fh = RAMFolder_Open_FileHandle(folder, &foo_bar,
+                                   FH_CREATE | FH_WRITE_ONLY);
+    DECREF(fh);
+    TEST_FALSE(batch, RAMFolder_Exists(twin, &foo_bar),
+               "New file in original doesn't appear in twin");
+
+    DECREF(twin);
+    DECREF(folder);
+}
+
 static void
 test_Close(TestBatch *batch) {
     RAMFolder *folder = RAMFolder_new(NULL);
@@ -463,7 +513,7 @@ test_Close(TestBatch *batch) {
 
 void
 TestRAMFolder_run_tests() {
-    TestBatch *batch = TestBatch_new(98);
+    TestBatch *batch = TestBatch_new(105);
 
     TestBatch_Plan(batch);
     test_Initialize_and_Check(batch);
@@ -476,6 +526,7 @@ TestRAMFolder_run_tests() {
     test_Local_Delete(batch);
     test_Rename(batch);
     test_Hard_Link(batch);
+    test_Fork(batch);
     test_Close(batch);
 
     DECREF(batch);
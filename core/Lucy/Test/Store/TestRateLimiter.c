@@ -0,0 +1,186 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_OUTSTREAM
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Store/TestRateLimiter.h"
+#include "Lucy/Store/OutStream.h"
+#include "Lucy/Store/RAMFile.h"
+#include "Lucy/Store/RAMFileHandle.h"
+#include "Lucy/Store/RAMFolder.h"
+#include "Lucy/Store/RateLimiter.h"
+#include "Lucy/Store/ThrottledFileHandle.h"
+
+#define MEGABYTE (1024 * 1024)
+
+static void
+test_Pause(TestBatch *batch) {
+    RateLimiter *limiter = RateLimiter_new(0.0);
+
+    RateLimiter_Pause(limiter, MEGABYTE);
+    TEST_TRUE(batch, RateLimiter_Get_Bytes(limiter) == MEGABYTE,
+              "Get_Bytes");
+    TEST_TRUE(batch, RateLimiter_Get_Paused_Millis(limiter) == 0,
+              "unlimited rate never pauses");
+
+    // A megabyte at 4 MB/s should take a quarter of a second.
+    RateLimiter_Set_MB_Per_Sec(limiter, 4.0);
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 4.0,
+              "Set_MB_Per_Sec");
+    RateLimiter_Pause(limiter, MEGABYTE);
+    int64_t paused = RateLimiter_Get_Paused_Millis(limiter);
+    TEST_TRUE(batch, paused >= 200 && paused <= 250,
+              "Pause() sleeps to hold the rate (%ld ms)", (long)paused);
+
+    RateLimiter_Set_MB_Per_Sec(limiter, 0.0);
+    RateLimiter_Pause(limiter, MEGABYTE);
+    TEST_TRUE(batch, RateLimiter_Get_Paused_Millis(limiter) == paused,
+              "rate can be lifted at any time");
+
+    DECREF(limiter);
+}
+
+static void
+test_Adjust(TestBatch *batch) {
+    RateLimiter *limiter = RateLimiter_new(8.0);
+
+    RateLimiter_Report_Latency(limiter, 500.0);
+    RateLimiter_Adjust(limiter);
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 8.0,
+              "no adjustment without a target latency");
+
+    RateLimiter_Set_Target_Latency(limiter, 10.0);
+    TEST_TRUE(batch, RateLimiter_Get_Target_Latency(limiter) == 10.0,
+              "Set_Target_Latency");
+    RateLimiter_Report_Latency(limiter, 2.0);
+    RateLimiter_Report_Latency(limiter, 50.0);
+    RateLimiter_Report_Latency(limiter, 3.0);
+    RateLimiter_Adjust(limiter);
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 4.0,
+              "worst latency over target halves the rate");
+    RateLimiter_Adjust(limiter);
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 4.0,
+              "rate holds when nothing has been reported");
+
+    for (int i = 0; i < 10; i++) {
+        RateLimiter_Report_Latency(limiter, 50.0);
+        RateLimiter_Adjust(limiter);
+    }
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 0.5,
+              "rate never falls below a sixteenth of the configured rate");
+
+    RateLimiter_Report_Latency(limiter, 5.0);
+    RateLimiter_Adjust(limiter);
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 0.625,
+              "latency within target raises the rate");
+    for (int i = 0; i < 20; i++) {
+        RateLimiter_Report_Latency(limiter, 5.0);
+        RateLimiter_Adjust(limiter);
+    }
+    TEST_TRUE(batch, RateLimiter_Get_MB_Per_Sec(limiter) == 8.0,
+              "rate recovers no further than the configured rate");
+
+    DECREF(limiter);
+}
+
+static void
+test_ThrottledFileHandle(TestBatch *batch) {
+    RateLimiter   *limiter = RateLimiter_new(0.0);
+    RAMFile       *file    = RAMFile_new(NULL, false);
+    RAMFileHandle *inner   = RAMFH_open(NULL, FH_WRITE_ONLY, file);
+    ThrottledFileHandle *fh
+        = ThrottledFH_open((FileHandle*)inner, limiter);
+    char buf[3];
+
+    TEST_TRUE(batch, ThrottledFH_Write(fh, "foo", 3), "Write()");
+    TEST_TRUE(batch, ThrottledFH_Length(fh) == 3, "Length()");
+    TEST_TRUE(batch, RateLimiter_Get_Bytes(limiter) == 3,
+              "writes pass through the limiter");
+    TEST_TRUE(batch, memcmp(BB_Get_Buf(RAMFile_Get_Contents(file)),
+                            "foo", 3) == 0,
+              "writes reach the inner handle");
+
+    Err_set_error(NULL);
+    TEST_FALSE(batch, ThrottledFH_Read(fh, buf, 0, 3),
+               "Read() fails on write-only handle");
+    TEST_TRUE(batch, Err_get_error() != NULL, "Read() sets Err_error");
+    DECREF(fh);
+
+    RAMFileHandle *read_fh = RAMFH_open(NULL, FH_READ_ONLY, file);
+    Err_set_error(NULL);
+    fh = ThrottledFH_open((FileHandle*)read_fh, limiter);
+    TEST_TRUE(batch, fh == NULL && Err_get_error() != NULL,
+              "Can't throttle a read-only handle");
+
+    DECREF(read_fh);
+    DECREF(inner);
+    DECREF(file);
+    DECREF(limiter);
+}
+
+static void
+test_Folder(TestBatch *batch) {
+    RateLimiter   *limiter = RateLimiter_new(0.0);
+    RAMFolder     *folder  = RAMFolder_new(NULL);
+    ZombieCharBuf *seg_1   = ZCB_WRAP_STR("seg_1", 5);
+    ZombieCharBuf *foo     = ZCB_WRAP_STR("seg_1/foo", 9);
+    ZombieCharBuf *bar     = ZCB_WRAP_STR("seg_1/bar", 9);
+
+    RAMFolder_MkDir(folder, (CharBuf*)seg_1);
+    RAMFolder_Set_Rate_Limiter(folder, limiter);
+    TEST_TRUE(batch, RAMFolder_Get_Rate_Limiter(folder) == limiter,
+              "Get_Rate_Limiter");
+    Folder *subfolder = RAMFolder_Find_Folder(folder, (CharBuf*)seg_1);
+    TEST_TRUE(batch, Folder_Get_Rate_Limiter(subfolder) == limiter,
+              "limiter is passed along to subdirectories");
+
+    OutStream *outstream = RAMFolder_Open_Out(folder, (CharBuf*)foo);
+    TEST_TRUE(batch, FH_Is_A(outstream->file_handle, THROTTLEDFILEHANDLE),
+              "Open_Out() writes through the limiter");
+    OutStream_Write_Bytes(outstream, "foo", 3);
+    OutStream_Close(outstream);
+    DECREF(outstream);
+    TEST_TRUE(batch, RateLimiter_Get_Bytes(limiter) == 3,
+              "bytes written were counted");
+
+    RAMFolder_Set_Rate_Limiter(folder, NULL);
+    TEST_TRUE(batch, Folder_Get_Rate_Limiter(subfolder) == NULL,
+              "limiter is removed from subdirectories");
+    outstream = RAMFolder_Open_Out(folder, (CharBuf*)bar);
+    TEST_FALSE(batch, FH_Is_A(outstream->file_handle, THROTTLEDFILEHANDLE),
+               "Open_Out() writes at full speed without a limiter");
+    DECREF(outstream);
+
+    DECREF(folder);
+    DECREF(limiter);
+}
+
+void
+TestRateLimiter_run_tests() {
+    TestBatch *batch = TestBatch_new(24);
+
+    TestBatch_Plan(batch);
+    test_Pause(batch);
+    test_Adjust(batch);
+    test_ThrottledFileHandle(batch);
+    test_Folder(batch);
+
+    DECREF(batch);
+}
+
+
@@ -0,0 +1,130 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Lucy/Util/ToolSet.h"
+
+#include "Lucy/Test.h"
+#include "Lucy/Test/Util/TestBlockCodec.h"
+#include "Lucy/Util/BlockCodec.h"
+
+// Compress and decompress <code>len</code> bytes, returning the compressed
+// size, or -1 if the round trip failed.
+static int64_t
+S_round_trip(const char *source, size_t len) {
+    char   *compressed = (char*)MALLOCATE(
+                             BlockCodec_max_compressed_size(len));
+    char   *restored   = (char*)MALLOCATE(len + 1);
+    size_t  comp_len   = BlockCodec_compress(source, len, compressed);
+    int64_t retval     = -1;
+
+    if (comp_len <= BlockCodec_max_compressed_size(len)
+        && BlockCodec_decompress(compressed, comp_len, restored, len)
+        && memcmp(source, restored, len) == 0
+       ) {
+        retval = (int64_t)comp_len;
+    }
+
+    FREEMEM(compressed);
+    FREEMEM(restored);
+    return retval;
+}
+
+static void
+test_round_trip(TestBatch *batch) {
+    const size_t len = 100000;
+    char *buf = (char*)MALLOCATE(len);
+
+    TEST_TRUE(batch, S_round_trip("", 0) != -1, "empty input");
+    TEST_TRUE(batch, S_round_trip("foo", 3) != -1, "input too short to match");
+
+    memset(buf, 'a', len);
+    int64_t comp_len = S_round_trip(buf, len);
+    TEST_TRUE(batch, comp_len != -1, "run of one byte");
+    TEST_TRUE(batch, comp_len < (int64_t)len / 100,
+              "run of one byte compresses well");
+
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = "ab"[i % 2];
+    }
+    TEST_TRUE(batch, S_round_trip(buf, len) != -1,
+              "match overlapping its own output");
+
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = "the quick brown fox jumps over the lazy dog "[i % 44];
+    }
+    comp_len = S_round_trip(buf, len);
+    TEST_TRUE(batch, comp_len != -1 && comp_len < (int64_t)len / 10,
+              "repeated text");
+
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (char)(seed >> 16);
+    }
+    comp_len = S_round_trip(buf, len);
+    TEST_TRUE(batch, comp_len != -1, "incompressible data");
+    TEST_TRUE(batch, comp_len <= (int64_t)BlockCodec_max_compressed_size(len),
+              "incompressible data stays within max_compressed_size");
+
+    bool_t all_ok = true;
+    for (size_t size = 1; size < 300; size++) {
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 1103515245 + 12345;
+            buf[i] = "abcd"[(seed >> 16) % (size % 4 + 1)];
+        }
+        if (S_round_trip(buf, size) == -1) { all_ok = false; }
+    }
+    TEST_TRUE(batch, all_ok, "short inputs of every length");
+
+    FREEMEM(buf);
+}
+
+static void
+test_malformed(TestBatch *batch) {
+    const char *text = "blah blah blah blah blah blah blah blah blah";
+    size_t      len  = strlen(text);
+    char        compressed[100];
+    char        restored[100];
+    size_t      comp_len = BlockCodec_compress(text, len, compressed);
+
+    TEST_FALSE(batch,
+               BlockCodec_decompress(compressed, comp_len - 1, restored, len),
+               "truncated input");
+    TEST_FALSE(batch,
+               BlockCodec_decompress(compressed, comp_len, restored, len - 1),
+               "output buffer too small");
+    TEST_FALSE(batch,
+               BlockCodec_decompress(compressed, comp_len, restored, len + 1),
+               "output shorter than expected");
+
+    // One literal, then a reference reaching back before the start.
+    const char bad_offset[] = { 0x10, 'a', 0x05, 0x00 };
+    TEST_FALSE(batch, BlockCodec_decompress(bad_offset, 4, restored, 5),
+               "offset before start of output");
+}
+
+void
+TestBlockCodec_run_tests() {
+    TestBatch *batch = TestBatch_new(13);
+
+    TestBatch_Plan(batch);
+    test_round_trip(batch);
+    test_malformed(batch);
+
+    DECREF(batch);
+}
+
+
@@ -84,6 +84,34 @@ test_u4(TestBatch *batch) {
     FREEMEM(ints);
 }
 
+static void
+test_packed(TestBatch *batch) {
+    uint32_t widths[] = { 1, 3, 7, 13, 32, 45, 64 };
+    size_t   count    = 100;
+    for (size_t i = 0; i < sizeof(widths) / sizeof(uint32_t); i++) {
+        uint32_t  bits  = widths[i];
+        uint64_t  limit = bits == 64 ? U64_MAX : (((uint64_t)1) << bits);
+        uint64_t *ints  = TestUtils_random_u64s(NULL, count, 0, limit);
+        uint8_t  *array = (uint8_t*)MALLOCATE((count * bits + 7) / 8);
+        bool_t    equal = true;
+
+        // Start with garbage to check that packed_set() clears old bits.
+        memset(array, 0xA5, (count * bits + 7) / 8);
+        for (size_t j = 0; j < count; j++) {
+            NumUtil_packed_set(array, (uint32_t)j, bits, ints[j]);
+        }
+        for (size_t j = 0; j < count; j++) {
+            if (NumUtil_packed_get(array, (uint32_t)j, bits) != ints[j]) {
+                equal = false;
+            }
+        }
+        TEST_TRUE(batch, equal, "packed set/get, %u bits", (unsigned)bits);
+
+        FREEMEM(array);
+        FREEMEM(ints);
+    }
+}
+
 static void
 test_c32(TestBatch *batch) {
     uint64_t  mins[]   = { 0,   0x4000 - 100, (uint32_t)I32_MAX - 100, U32_MAX - 10 };
@@ -346,7 +374,7 @@ test_bigend_f64(TestBatch *batch) {
 
 void
 TestNumUtil_run_tests() {
-    TestBatch *batch = TestBatch_new(1196);
+    TestBatch *batch = TestBatch_new(1203);
 
     TestBatch_Plan(batch);
     srand((unsigned int)time((time_t*)NULL));
@@ -354,6 +382,7 @@ TestNumUtil_run_tests() {
     test_u1(batch);
     test_u2(batch);
     test_u4(batch);
+    test_packed(batch);
     test_c32(batch);
     test_c64(batch);
     test_bigend_u16(batch);
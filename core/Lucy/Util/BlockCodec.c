@@ -0,0 +1,218 @@
+/* Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define C_LUCY_BLOCKCODEC
+#include <string.h>
+
+#define LUCY_USE_SHORT_NAMES
+#define CHY_USE_SHORT_NAMES
+
+#include "Lucy/Util/BlockCodec.h"
+
+// Matches shorter than this aren't worth a token.
+#define MIN_MATCH      4
+
+// The final bytes of a block are always stored as literals, and no match
+// may start within the final MF_LIMIT bytes.  These are the constraints of
+// the LZ4 block format, so that its decoders can read our output.
+#define LAST_LITERALS  5
+#define MF_LIMIT       12
+
+// Back-references are encoded as 16-bit offsets.
+#define MAX_DISTANCE   65535
+
+#define HASH_LOG       12
+#define HASH_SIZE      (1 << HASH_LOG)
+
+#define RUN_MASK       15
+
+static INLINE uint32_t
+SI_read32(const uint8_t *ptr) {
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(uint32_t));
+    return value;
+}
+
+static INLINE uint32_t
+SI_hash(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+// Write a run length which didn't fit in a token nibble.
+static INLINE uint8_t*
+SI_write_length(uint8_t *out, size_t len) {
+    while (len >= 255) {
+        *out++ = 255;
+        len -= 255;
+    }
+    *out++ = (uint8_t)len;
+    return out;
+}
+
+// Write a token and its literals, followed by a back-reference unless
+// <code>match_len</code> is 0.
+static uint8_t*
+S_write_sequence(uint8_t *out, const uint8_t *literals, size_t num_literals,
+                 uint32_t offset, size_t match_len) {
+    uint8_t *token = out++;
+    size_t   match_code = match_len ? match_len - MIN_MATCH : 0;
+
+    if (num_literals >= RUN_MASK) {
+        *token = RUN_MASK << 4;
+        out = SI_write_length(out, num_literals - RUN_MASK);
+    }
+    else {
+        *token = (uint8_t)(num_literals << 4);
+    }
+    memcpy(out, literals, num_literals);
+    out += num_literals;
+
+    if (match_len) {
+        *out++ = (uint8_t)(offset & 0xFF);
+        *out++ = (uint8_t)(offset >> 8);
+        if (match_code >= RUN_MASK) {
+            *token |= RUN_MASK;
+            out = SI_write_length(out, match_code - RUN_MASK);
+        }
+        else {
+            *token |= (uint8_t)match_code;
+        }
+    }
+
+    return out;
+}
+
+size_t
+BlockCodec_max_compressed_size(size_t len) {
+    return len + (len / 255) + 16;
+}
+
+size_t
+BlockCodec_compress(const void *source, size_t len, void *dest) {
+    const uint8_t *const src    = (const uint8_t*)source;
+    const uint8_t       *anchor = src;
+    uint8_t             *out    = (uint8_t*)dest;
+
+    if (len > MF_LIMIT) {
+        const uint8_t *const match_limit = src + len - MF_LIMIT;
+        const uint8_t *const end_limit   = src + len - LAST_LITERALS;
+        const uint8_t       *ip          = src;
+        uint32_t table[HASH_SIZE];
+        memset(table, 0, sizeof(table));
+
+        while (ip < match_limit) {
+            const uint32_t  sequence = SI_read32(ip);
+            const uint32_t  hash     = SI_hash(sequence);
+            const uint8_t  *ref      = src + table[hash];
+            table[hash] = (uint32_t)(ip - src);
+
+            if (ref >= ip
+                || ip - ref > MAX_DISTANCE
+                || SI_read32(ref) != sequence
+               ) {
+                ip++;
+                continue;
+            }
+
+            // Extend the match backwards over pending literals, then
+            // forwards as far as the trailing literals allow.
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            const uint8_t *match_end = ip + MIN_MATCH;
+            const uint8_t *ref_end   = ref + MIN_MATCH;
+            while (match_end < end_limit && *match_end == *ref_end) {
+                match_end++;
+                ref_end++;
+            }
+
+            out = S_write_sequence(out, anchor, (size_t)(ip - anchor),
+                                   (uint32_t)(ip - ref),
+                                   (size_t)(match_end - ip));
+            ip = anchor = match_end;
+        }
+    }
+
+    // Whatever remains goes out as literals.
+    out = S_write_sequence(out, anchor, (size_t)(src + len - anchor), 0, 0);
+    return (size_t)(out - (uint8_t*)dest);
+}
+
+bool_t
+BlockCodec_decompress(const void *source, size_t source_len, void *dest,
+                      size_t dest_len) {
+    const uint8_t       *ip       = (const uint8_t*)source;
+    const uint8_t *const in_end   = ip + source_len;
+    uint8_t       *const out_base = (uint8_t*)dest;
+    uint8_t             *op       = out_base;
+    uint8_t       *const out_end  = op + dest_len;
+
+    while (ip < in_end) {
+        const uint8_t token = *ip++;
+        size_t num_literals = token >> 4;
+        size_t match_len    = token & RUN_MASK;
+
+        // Copy literals.
+        if (num_literals == RUN_MASK) {
+            uint8_t byte;
+            do {
+                if (ip >= in_end) { return false; }
+                byte = *ip++;
+                num_literals += byte;
+            } while (byte == 255);
+        }
+        if (num_literals > (size_t)(in_end - ip)
+            || num_literals > (size_t)(out_end - op)
+           ) {
+            return false;
+        }
+        memcpy(op, ip, num_literals);
+        ip += num_literals;
+        op += num_literals;
+
+        // The last sequence has no back-reference.
+        if (ip == in_end) { break; }
+
+        // Copy the back-reference, which may overlap its own output.
+        if (in_end - ip < 2) { return false; }
+        const size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - out_base)) { return false; }
+        if (match_len == RUN_MASK) {
+            uint8_t byte;
+            do {
+                if (ip >= in_end) { return false; }
+                byte = *ip++;
+                match_len += byte;
+            } while (byte == 255);
+        }
+        match_len += MIN_MATCH;
+        if (match_len > (size_t)(out_end - op)) { return false; }
+        const uint8_t *ref = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, ref, match_len);
+            op += match_len;
+        }
+        else {
+            while (match_len--) { *op++ = *ref++; }
+        }
+    }
+
+    return op == out_end;
+}
+
+
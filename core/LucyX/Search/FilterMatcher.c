@@ -47,12 +47,12 @@ FilterMatcher_destroy(FilterMatcher *self) {
 
 int32_t
 FilterMatcher_next(FilterMatcher* self) {
-    do {
-        if (++self->doc_id > self->doc_max) {
-            self->doc_id--;
-            return 0;
-        }
-    } while (!BitVec_Get(self->bits, self->doc_id));
+    int32_t next_hit = BitVec_Next_Hit(self->bits, self->doc_id + 1);
+    if (next_hit == -1 || next_hit > self->doc_max) {
+        self->doc_id = self->doc_max;
+        return 0;
+    }
+    self->doc_id = next_hit;
     return self->doc_id;
 }
 
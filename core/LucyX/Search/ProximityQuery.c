@@ -315,6 +315,19 @@ ProximityCompiler_make_matcher(ProximityCompiler *self, SegReader *reader,
     return retval;
 }
 
+void
+ProximityCompiler_prefetch(ProximityCompiler *self, SegReader *reader) {
+    ProximityQuery *const parent = (ProximityQuery*)self->parent;
+    PostingListReader *const plist_reader
+        = (PostingListReader*)SegReader_Fetch(
+              reader, VTable_Get_Name(POSTINGLISTREADER));
+    if (!plist_reader) { return; }
+    for (uint32_t i = 0, max = VA_Get_Size(parent->terms); i < max; i++) {
+        Obj *term = VA_Fetch(parent->terms, i);
+        PListReader_Prefetch_Term(plist_reader, parent->field, term);
+    }
+}
+
 VArray*
 ProximityCompiler_highlight_spans(ProximityCompiler *self, Searcher *searcher,
                                   DocVector *doc_vec, const CharBuf *field) {
@@ -22,6 +22,7 @@ $VERSION = eval $VERSION;
 sub bind_all {
     my $class = shift;
     $class->bind_backgroundmerger;
+    $class->bind_bloomfilter;
     $class->bind_datareader;
     $class->bind_datawriter;
     $class->bind_deletionsreader;
@@ -30,6 +31,10 @@ sub bind_all {
     $class->bind_defaultdeletionswriter;
     $class->bind_docreader;
     $class->bind_defaultdocreader;
+    $class->bind_docvalues;
+    $class->bind_docvaluesreader;
+    $class->bind_defaultdocvaluesreader;
+    $class->bind_docvalueswriter;
     $class->bind_docvector;
     $class->bind_docwriter;
     $class->bind_filepurger;
@@ -44,6 +49,7 @@ sub bind_all {
     $class->bind_lexiconreader;
     $class->bind_defaultlexiconreader;
     $class->bind_lexiconwriter;
+    $class->bind_mergepolicy;
     $class->bind_polylexicon;
     $class->bind_polyreader;
     $class->bind_posting;
@@ -67,10 +73,11 @@ sub bind_all {
     $class->bind_sortwriter;
     $class->bind_terminfo;
     $class->bind_termvector;
+    $class->bind_tieredmergepolicy;
 }
 
 sub bind_backgroundmerger {
-    my @exposed = qw( Commit Prepare_Commit Optimize );
+    my @exposed = qw( Commit Prepare_Commit Optimize Set_Rate_Limiter );
 
     my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
     my $synopsis = <<'END_SYNOPSIS';
@@ -98,6 +105,14 @@ END_CONSTRUCTOR
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_bloomfilter {
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::BloomFilter",
+    );
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 sub bind_datareader {
     my @exposed = qw(
         Get_Schema
@@ -229,7 +244,7 @@ sub bind_defaultdeletionswriter {
 }
 
 sub bind_docreader {
-    my @exposed = qw( Fetch_Doc Aggregator );
+    my @exposed = qw( Fetch_Doc Fetch_Doc_Fields Fetch_Docs Aggregator );
 
     my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
     my $synopsis = <<'END_SYNOPSIS';
@@ -256,6 +271,70 @@ sub bind_defaultdocreader {
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_docvalues {
+    my @exposed = qw(
+        Has_Value
+        I64_Value
+        F64_Value
+        Value
+        Get_Field
+        Get_Count
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $dv_reader = $seg_reader->obtain("Lucy::Index::DocValuesReader");
+    my $column    = $dv_reader->fetch_doc_values('price');
+    my $price     = $column->value($doc_id);
+END_SYNOPSIS
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::DocValues",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
+sub bind_docvaluesreader {
+    my @exposed = qw( Value Aggregator );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $dv_reader = $poly_reader->obtain("Lucy::Index::DocValuesReader");
+    my $price = $dv_reader->value( field => 'price', doc_id => $doc_id );
+END_SYNOPSIS
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::DocValuesReader",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
+sub bind_defaultdocvaluesreader {
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::DefaultDocValuesReader",
+    );
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
+sub bind_docvalueswriter {
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::DocValuesWriter",
+    );
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 sub bind_docvector {
     my $binding = Clownfish::CFC::Binding::Perl::Class->new(
         parcel     => "Lucy",
@@ -315,6 +394,12 @@ sub bind_indexmanager {
         Get_Write_Lock_Timeout
         Set_Write_Lock_Interval
         Get_Write_Lock_Interval
+        Set_Durable
+        Get_Durable
+        Set_Merge_Policy
+        Get_Merge_Policy
+        Set_Del_Ratio
+        Get_Del_Ratio
     );
 
     my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
@@ -442,6 +527,7 @@ sub bind_indexer {
         Optimize
         Commit
         Prepare_Commit
+        Open_Reader
         Delete_By_Term
         Delete_By_Query
         Get_Schema
@@ -659,7 +745,7 @@ END_SYNOPSIS
 }
 
 sub bind_lexiconreader {
-    my @exposed = qw( Lexicon Doc_Freq );
+    my @exposed = qw( Lexicon Doc_Freq May_Contain );
 
     my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
     my $synopsis = <<'END_SYNOPSIS';
@@ -694,6 +780,39 @@ sub bind_lexiconwriter {
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_mergepolicy {
+    my @exposed = qw( Recycle Stats );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    package MyMergePolicy;
+    use base qw( Lucy::Index::MergePolicy );
+    sub recycle {
+        my ( $self, %args ) = @_;
+        return [] unless $args{optimize};
+        return $args{reader}->seg_readers;
+    }
+
+    package main;
+    my $manager = Lucy::Index::IndexManager->new;
+    $manager->set_merge_policy( MyMergePolicy->new );
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $policy = MyMergePolicy->new;
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::MergePolicy",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 sub bind_polylexicon {
     my $binding = Clownfish::CFC::Binding::Perl::Class->new(
         parcel     => "Lucy",
@@ -715,6 +834,7 @@ sub bind_polyreader {
     }
 END_SYNOPSIS
     $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_method( method => 'Reopen', alias => 'reopen' );
 
     my $xs_code = <<'END_XS_CODE';
 MODULE = Lucy   PACKAGE = Lucy::Index::PolyReader
@@ -1188,4 +1308,51 @@ sub bind_termvector {
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_tieredmergepolicy {
+    my @exposed = qw(
+        Stats
+        Set_Segs_Per_Tier
+        Get_Segs_Per_Tier
+        Set_Max_Merge_At_Once
+        Get_Max_Merge_At_Once
+        Set_Max_Merged_Seg_Bytes
+        Get_Max_Merged_Seg_Bytes
+        Set_Floor_Seg_Bytes
+        Get_Floor_Seg_Bytes
+        Set_Max_Del_Ratio
+        Get_Max_Del_Ratio
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $policy = Lucy::Index::TieredMergePolicy->new;
+    $policy->set_segs_per_tier(5);
+    $policy->set_max_merged_seg_bytes( 1024 * 1024 * 1024 );
+    my $manager = Lucy::Index::IndexManager->new;
+    $manager->set_merge_policy($policy);
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => '/path/to/index',
+        manager => $manager,
+    );
+    ...
+    $indexer->commit;
+    my $stats = $policy->stats;
+    print "Merged $stats->{bytes_merged} bytes so far\n";
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $policy = Lucy::Index::TieredMergePolicy->new;
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Index::TieredMergePolicy",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 1;
@@ -143,6 +143,12 @@ PPCODE:
         lucy_TestSchema_run_tests();
     }
     // Lucy::Index
+    else if (strEQ(package, "TestBloomFilter")) {
+        lucy_TestBloomFilter_run_tests();
+    }
+    else if (strEQ(package, "TestDocReader")) {
+        lucy_TestDocReader_run_tests();
+    }
     else if (strEQ(package, "TestDocWriter")) {
         lucy_TestDocWriter_run_tests();
     }
@@ -152,6 +158,9 @@ PPCODE:
     else if (strEQ(package, "TestIndexManager")) {
         lucy_TestIxManager_run_tests();
     }
+    else if (strEQ(package, "TestOrdinalMap")) {
+        lucy_TestOrdMap_run_tests();
+    }
     else if (strEQ(package, "TestPolyReader")) {
         lucy_TestPolyReader_run_tests();
     }
@@ -208,6 +217,9 @@ PPCODE:
         lucy_TestTermQuery_run_tests();
     }
     // Lucy::Store
+    else if (strEQ(package, "TestBlockCache")) {
+        lucy_TestBlockCache_run_tests();
+    }
     else if (strEQ(package, "TestCompoundFileReader")) {
         lucy_TestCFReader_run_tests();
     }
@@ -247,6 +259,9 @@ PPCODE:
     else if (strEQ(package, "TestRAMFolder")) {
         lucy_TestRAMFolder_run_tests();
     }
+    else if (strEQ(package, "TestRateLimiter")) {
+        lucy_TestRateLimiter_run_tests();
+    }
     // Lucy::Util
     else if (strEQ(package, "TestAtomic")) {
         lucy_TestAtomic_run_tests();
@@ -254,6 +269,9 @@ PPCODE:
     else if (strEQ(package, "TestBitVector")) {
         lucy_TestBitVector_run_tests();
     }
+    else if (strEQ(package, "TestRoaringBitmap")) {
+        lucy_TestRoaringBitmap_run_tests();
+    }
     else if (strEQ(package, "TestCharBuf")) {
         lucy_TestCB_run_tests();
     }
@@ -269,6 +287,9 @@ PPCODE:
     else if (strEQ(package, "TestIndexFileNames")) {
         lucy_TestIxFileNames_run_tests();
     }
+    else if (strEQ(package, "TestBlockCodec")) {
+        lucy_TestBlockCodec_run_tests();
+    }
     else if (strEQ(package, "TestNumberUtils")) {
         lucy_TestNumUtil_run_tests();
     }
@@ -32,6 +32,7 @@ sub bind_all {
     $class->bind_float32;
     $class->bind_float64;
     $class->bind_obj;
+    $class->bind_roaringbitmap;
     $class->bind_varray;
     $class->bind_vtable;
 }
@@ -716,6 +717,38 @@ END_XS_CODE
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_roaringbitmap {
+    my @exposed = qw(
+        Run_Optimize
+        Memory_Usage
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $bits = Lucy::Object::RoaringBitmap->new;
+    my $collector = Lucy::Search::Collector::BitCollector->new(
+        bit_vector => $bits,
+    );
+    $searcher->collect( query => $query, collector => $collector );
+    $bits->run_optimize;
+    printf( "%d hits in %d bytes\n", $bits->count, $bits->memory_usage );
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $bits = Lucy::Object::RoaringBitmap->new;
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Object::RoaringBitmap",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 sub bind_varray {
     my @hand_rolled = qw(
         Shallow_Copy
@@ -34,7 +34,11 @@ sub bind_all {
 }
 
 sub bind_architecture {
-    my @exposed = qw( Register_Doc_Writer Register_Doc_Reader );
+    my @exposed = qw(
+        Register_Doc_Writer
+        Register_Doc_Reader
+        Doc_Block_Size
+    );
 
     my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
     my $synopsis = <<'END_SYNOPSIS';
@@ -131,6 +135,8 @@ sub bind_fieldtype {
         Indexed
         Stored
         Sortable
+        Doc_Values
+        Bloom_Filter
         Binary
     );
 
@@ -202,6 +208,8 @@ END_SYNOPSIS
         stored        => 1,            # default: true
         sortable      => 1,            # default: false
         highlightable => 1,            # default: false
+        doc_values    => 1,            # default: false
+        bloom_filter  => 1,            # default: false
     );
 END_CONSTRUCTOR
     $pod_spec->set_synopsis($synopsis);
@@ -293,10 +301,12 @@ sub bind_stringtype {
 END_SYNOPSIS
     my $constructor = <<'END_CONSTRUCTOR';
     my $type = Lucy::Plan::StringType->new(
-        boost    => 0.1,    # default: 1.0
-        indexed  => 1,      # default: true
-        stored   => 1,      # default: true
-        sortable => 1,      # default: false
+        boost        => 0.1,    # default: 1.0
+        indexed      => 1,      # default: true
+        stored       => 1,      # default: true
+        sortable     => 1,      # default: false
+        doc_values   => 1,      # default: false
+        bloom_filter => 1,      # default: false
     );
 END_CONSTRUCTOR
     $pod_spec->set_synopsis($synopsis);
@@ -28,6 +28,8 @@ sub bind_all {
     $class->bind_bitcollector;
     $class->bind_offsetcollector;
     $class->bind_sortcollector;
+    $class->bind_facetcollector;
+    $class->bind_facetcount;
     $class->bind_compiler;
     $class->bind_hitqueue;
     $class->bind_hits;
@@ -57,6 +59,7 @@ sub bind_all {
     $class->bind_termquery;
     $class->bind_termcompiler;
     $class->bind_topdocs;
+    $class->bind_warmer;
 }
 
 sub bind_andmatcher {
@@ -182,6 +185,53 @@ sub bind_sortcollector {
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_facetcollector {
+    my @exposed = qw( Top_Values Get_Total_Hits );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $facet_collector = Lucy::Search::Collector::FacetCollector->new(
+        schema => $searcher->get_schema,
+        fields => [qw( category brand )],
+        reader => $searcher->get_reader,
+    );
+    $searcher->collect(
+        collector => $facet_collector,
+        query     => $query,
+    );
+    for my $facet ( @{ $facet_collector->top_values( 'category', 10 ) } ) {
+        printf( "%s (%d)\n", $facet->get_value, $facet->get_count );
+    }
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $facet_collector = Lucy::Search::Collector::FacetCollector->new(
+        schema    => $schema,             # required
+        fields    => \@field_names,       # required
+        reader    => $index_reader,       # default: undef
+        collector => $sort_collector,     # default: undef
+    );
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Search::Collector::FacetCollector",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
+sub bind_facetcount {
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Search::Collector::FacetCount",
+    );
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 sub bind_compiler {
     my @exposed = qw(
         Make_Matcher
@@ -268,6 +318,8 @@ sub bind_indexsearcher {
         Doc_Max
         Doc_Freq
         Fetch_Doc
+        Fetch_Doc_Fields
+        Fetch_Docs
         Get_Schema
         Get_Reader
     );
@@ -285,7 +337,8 @@ sub bind_indexsearcher {
 END_SYNOPSIS
     my $constructor = <<'END_CONSTRUCTOR';
     my $searcher = Lucy::Search::IndexSearcher->new( 
-        index => '/path/to/index' 
+        index  => '/path/to/index',    # required
+        warmer => $warmer,             # default: undef
     );
 END_CONSTRUCTOR
     $pod_spec->set_synopsis($synopsis);
@@ -296,6 +349,7 @@ END_CONSTRUCTOR
         parcel     => "Lucy",
         class_name => "Lucy::Search::IndexSearcher",
     );
+    $binding->bind_constructor( alias => 'new', initializer => 'init2' );
     $binding->set_pod_spec($pod_spec);
 
     Clownfish::CFC::Binding::Perl::Class->register($binding);
@@ -555,6 +609,8 @@ sub bind_polysearcher {
         Doc_Max
         Doc_Freq
         Fetch_Doc
+        Fetch_Doc_Fields
+        Fetch_Docs
         Get_Schema
     );
 
@@ -770,6 +826,8 @@ sub bind_searcher {
         Doc_Max
         Doc_Freq
         Fetch_Doc
+        Fetch_Doc_Fields
+        Fetch_Docs
         Get_Schema
     );
 
@@ -970,4 +1028,45 @@ sub bind_topdocs {
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_warmer {
+    my @exposed = qw(
+        Add_Query
+        Add_Prefetch_Suffix
+        Set_Sort_Caches
+        Get_Sort_Caches
+        Set_Highlight_Data
+        Get_Highlight_Data
+        Set_Num_Wanted
+        Get_Num_Wanted
+        Warm_Seg_Reader
+        Warm_Searcher
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $warmer = Lucy::Search::Warmer->new;
+    $warmer->add_query( query => 'foo' );
+    $warmer->add_query( query => 'bar', sort_spec => $by_date );
+    $warmer->add_prefetch_suffix('.ix');
+    my $searcher = Lucy::Search::IndexSearcher->new(
+        index  => '/path/to/index',
+        warmer => $warmer,
+    );
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $warmer = Lucy::Search::Warmer->new;
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Search::Warmer",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 1;
@@ -21,6 +21,8 @@ $VERSION = eval $VERSION;
 
 sub bind_all {
     my $class = shift;
+    $class->bind_arenafolder;
+    $class->bind_blockcache;
     $class->bind_fsfilehandle;
     $class->bind_fsfolder;
     $class->bind_filehandle;
@@ -35,6 +37,113 @@ sub bind_all {
     $class->bind_ramfile;
     $class->bind_ramfilehandle;
     $class->bind_ramfolder;
+    $class->bind_ratelimiter;
+}
+
+sub bind_arenafolder {
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    # Pack an index into an arena file once...
+    Lucy::Store::ArenaFolder->write_arena(
+        folder => Lucy::Store::FSFolder->new( path => '/path/to/index' ),
+        path   => '/path/to/index.arena',
+    );
+
+    # ... then map it in each serving process.
+    my $folder = Lucy::Store::ArenaFolder->open(
+        path     => '/path/to/index.arena',
+        populate => 1,
+    );
+    my $searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $folder = Lucy::Store::ArenaFolder->open(
+        path     => '/path/to/index.arena',    # required
+        populate => 1,                         # default: 0
+    );
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor(
+        alias       => 'open',
+        initializer => 'do_open',
+        sample      => $constructor,
+    );
+
+    my $xs_code = <<'END_XS_CODE';
+MODULE = Lucy   PACKAGE = Lucy::Store::ArenaFolder
+
+void
+write_arena(unused_sv, ...)
+    SV *unused_sv;
+PPCODE:
+{
+    CHY_UNUSED_VAR(unused_sv);
+    lucy_Folder  *folder = NULL;
+    lucy_CharBuf *path   = NULL;
+    chy_bool_t args_ok
+        = XSBind_allot_params(&(ST(0)), 1, items,
+                              "Lucy::Store::ArenaFolder::write_arena_PARAMS",
+                              ALLOT_OBJ(&folder, "folder", 6, true,
+                                        LUCY_FOLDER, NULL),
+                              ALLOT_OBJ(&path, "path", 4, true,
+                                        LUCY_CHARBUF, alloca(cfish_ZCB_size())),
+                              NULL);
+    if (!args_ok) {
+        CFISH_RETHROW(CFISH_INCREF(cfish_Err_get_error()));
+    }
+    lucy_ArenaFolder_write_arena(folder, path);
+}
+END_XS_CODE
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Store::ArenaFolder",
+    );
+    $binding->bind_constructor( alias => 'open', initializer => 'do_open' );
+    $binding->append_xs($xs_code);
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
+sub bind_blockcache {
+    my @exposed = qw(
+        Get_Hits
+        Get_Misses
+        Get_Evictions
+        Get_Capacity
+        Get_Block_Size
+        Memory_Usage
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $cache = Lucy::Store::BlockCache->new(
+        capacity => 256 * 1024 * 1024,
+    );
+    for my $path (@index_paths) {
+        my $folder = Lucy::Store::FSFolder->new( path => $path );
+        $folder->set_block_cache($cache);
+        push @searchers, Lucy::Search::IndexSearcher->new( index => $folder );
+    }
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $cache = Lucy::Store::BlockCache->new(
+        capacity   => 64 * 1024 * 1024,    # default: 64 MB
+        block_size => 32 * 1024,           # default: 32 kB
+    );
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Store::BlockCache",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
 sub bind_fsfilehandle {
@@ -418,6 +527,7 @@ END_SYNOPSIS
 END_CONSTRUCTOR
     $pod_spec->set_synopsis($synopsis);
     $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => 'Fork', alias => 'fork' );
 
     my $binding = Clownfish::CFC::Binding::Perl::Class->new(
         parcel     => "Lucy",
@@ -428,4 +538,42 @@ END_CONSTRUCTOR
     Clownfish::CFC::Binding::Perl::Class->register($binding);
 }
 
+sub bind_ratelimiter {
+    my @exposed = qw(
+        Set_MB_Per_Sec
+        Get_MB_Per_Sec
+        Get_Bytes
+        Get_Paused_Millis
+        Set_Target_Latency
+        Get_Target_Latency
+        Report_Latency
+        Adjust
+    );
+
+    my $pod_spec = Clownfish::CFC::Binding::Perl::Pod->new;
+    my $synopsis = <<'END_SYNOPSIS';
+    my $limiter = Lucy::Store::RateLimiter->new( mb_per_sec => 20 );
+    $limiter->set_target_latency(50);    # back off if writes stall
+    my $bg_merger = Lucy::Index::BackgroundMerger->new( index => $index );
+    $bg_merger->set_rate_limiter($limiter);
+    $bg_merger->commit;
+END_SYNOPSIS
+    my $constructor = <<'END_CONSTRUCTOR';
+    my $limiter = Lucy::Store::RateLimiter->new(
+        mb_per_sec => 20,    # default: 0 (unlimited)
+    );
+END_CONSTRUCTOR
+    $pod_spec->set_synopsis($synopsis);
+    $pod_spec->add_constructor( alias => 'new', sample => $constructor, );
+    $pod_spec->add_method( method => $_, alias => lc($_) ) for @exposed;
+
+    my $binding = Clownfish::CFC::Binding::Perl::Class->new(
+        parcel     => "Lucy",
+        class_name => "Lucy::Store::RateLimiter",
+    );
+    $binding->set_pod_spec($pod_spec);
+
+    Clownfish::CFC::Binding::Perl::Class->register($binding);
+}
+
 1;
@@ -231,6 +231,17 @@ sub error {$Lucy::Object::Err::error}
     sub DESTROY { }    # leak all
 }
 
+{
+    package Lucy::Store::ArenaFolder;
+    our $VERSION = '0.003000';
+    $VERSION = eval $VERSION;
+
+    our %write_arena_PARAMS = (
+        folder => undef,
+        path   => undef,
+    );
+}
+
 {
     package Lucy::Index::Indexer;
     our $VERSION = '0.003000';
@@ -288,7 +299,8 @@ sub error {$Lucy::Object::Err::error}
     }
 
     sub _try_open_segreaders {
-        my ( $self, $segments ) = @_;
+        my ( $self, %args ) = @_;
+        my ( $segments, $reusable ) = @args{qw( segments reusable )};
         my $schema   = $self->get_schema;
         my $folder   = $self->get_folder;
         my $snapshot = $self->get_snapshot;
@@ -299,7 +311,8 @@ sub error {$Lucy::Object::Err::error}
             # Create a SegReader for each segment in the index.
             my $num_segs = scalar @$segments;
             for ( my $seg_tick = 0; $seg_tick < $num_segs; $seg_tick++ ) {
-                my $seg_reader = Lucy::Index::SegReader->new(
+                my $seg_reader = $reusable ? $reusable->[$seg_tick] : undef;
+                $seg_reader ||= Lucy::Index::SegReader->new(
                     schema   => $schema,
                     folder   => $folder,
                     segments => $segs,
@@ -97,8 +97,7 @@ sub _bits {
 
     # Fill the cache.
     if ( !defined $cached_bits ) {
-        $cached_bits = Lucy::Object::BitVector->new(
-            capacity => $seg_reader->doc_max + 1 );
+        $cached_bits = Lucy::Object::RoaringBitmap->new;
         $self->_store_cached_bits( $seg_reader, $cached_bits );
 
         my $collector = Lucy::Search::Collector::BitCollector->new(
@@ -118,13 +117,14 @@ sub _bits {
             query     => $query{$$self},
             collector => $collector,
         );
+        $cached_bits->run_optimize;
     }
 
     return $cached_bits;
 }
 
-# Store a cached BitVector associated with a particular SegReader.  Store a
-# weak reference to the SegReader as an indicator of cache validity.
+# Store a cached RoaringBitmap associated with a particular SegReader.  Store
+# a weak reference to the SegReader as an indicator of cache validity.
 sub _store_cached_bits {
     my ( $self, $seg_reader, $bits ) = @_;
     my $pair = { seg_reader => $seg_reader, bits => $bits };
@@ -132,9 +132,9 @@ sub _store_cached_bits {
     $cached_bits{$$self}{ $seg_reader->hash_sum } = $pair;
 }
 
-# Retrieve a cached BitVector associated with a particular SegReader.  As a
-# side effect, clear away any BitVectors which are no longer valid because
-# their SegReaders have gone away.
+# Retrieve a cached RoaringBitmap associated with a particular SegReader.  As
+# a side effect, clear away any RoaringBitmaps which are no longer valid
+# because their SegReaders have gone away.
 sub _fetch_cached_bits {
     my ( $self, $seg_reader ) = @_;
     my $cached_bits = $cached_bits{$$self};
@@ -32,7 +32,7 @@ sub recycle {
 
 package main;
 
-use Test::More tests => 16;
+use Test::More tests => 23;
 use Lucy::Test;
 
 my $folder = Lucy::Store::RAMFolder->new;
@@ -103,6 +103,39 @@ $seg_readers = $manager->recycle(
 is( scalar @$seg_readers,
     18, "recycle lots of small segs but leave big ones alone" );
 
+my $policy = Lucy::Index::TieredMergePolicy->new;
+$manager->set_merge_policy($policy);
+$seg_readers = $manager->recycle(
+    reader     => $polyreader,
+    cutoff     => 0,
+    del_writer => $deletions_writer,
+);
+is( scalar @$seg_readers, 10,
+    "tiered policy merges max_merge_at_once small segs when over budget" );
+my $stats = $policy->stats;
+is_deeply(
+    [ @{$stats}{qw( decisions merges last_candidates last_chosen )} ],
+    [ 1, 1, 20, 10 ],
+    "tiered policy stats"
+);
+eval { $policy->set_segs_per_tier(0) };
+like( $@, qr/segs_per_tier/, "tiered policy rejects zero segs_per_tier" );
+eval { $policy->set_max_merge_at_once(1) };
+like( $@, qr/max_merge_at_once/,
+    "tiered policy rejects max_merge_at_once below 2" );
+$manager->set_merge_policy(undef);
+$seg_readers = $manager->recycle(
+    reader     => $polyreader,
+    cutoff     => 0,
+    del_writer => $deletions_writer,
+);
+is( scalar @$seg_readers, 18, "clearing the merge policy restores default" );
+
+$manager->set_del_ratio(0.25);
+is( $manager->get_del_ratio, 0.25, "set/get del ratio" );
+eval { $manager->set_del_ratio(0) };
+like( $@, qr/del_ratio/, "del ratio must be positive" );
+
 $manager->set_write_lock_timeout(1);
 is( $manager->get_write_lock_timeout, 1, "set/get write lock timeout" );
 $manager->set_write_lock_interval(2);
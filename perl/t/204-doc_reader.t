@@ -16,7 +16,7 @@
 use strict;
 use warnings;
 
-use Test::More tests => 5;
+use Test::More tests => 10;
 
 package TestAnalyzer;
 use base qw( Lucy::Analysis::Analyzer );
@@ -85,3 +85,16 @@ is( $doc->{bin},      $bin_val, "bin" );
 is( $doc->{unstored}, undef,    "unstored" );
 is( $doc->{empty},    '',       "empty" );
 is( $doc->{float64},  2.0,      "float64" );
+
+$doc = $doc_reader->fetch_doc_fields(
+    doc_id => 1,
+    fields => [qw( float64 text nope )],
+);
+is( $doc->{text},    $val,  "projected fetch includes requested text" );
+is( $doc->{float64}, 2.0,   "projected fetch includes requested float64" );
+is( $doc->{bin},     undef, "projected fetch skips unrequested field" );
+
+my $searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+$doc = $searcher->fetch_doc_fields( doc_id => 1, fields => ['bin'] );
+is( $doc->{bin},  $bin_val, "Searcher projected fetch" );
+is( $doc->{text}, undef,    "Searcher projected fetch skips other fields" );
@@ -17,7 +17,7 @@ use strict;
 use warnings;
 use lib 'buildlib';
 
-use Test::More tests => 16;
+use Test::More tests => 23;
 use Lucy::Test::TestUtils qw( create_index );
 
 my $folder     = create_index( 'a' .. 'e' );
@@ -177,3 +177,56 @@ $hits = $searcher->hits( query => 'foo' );
 is( $hits->total_hits, 0, "truncate succeeded" );
 $hits = $searcher->hits( query => 'baz' );
 is( $hits->total_hits, 1, "added doc during same session as truncation" );
+
+# Sparse deletions get written as lists of doc ids or runs rather than as
+# bitsets.
+$folder  = Lucy::Store::RAMFolder->new;
+$indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+for my $num ( 1 .. 3000 ) {
+    my $content
+        = $num % 1000 == 500 ? 'lonely'
+        : $num <= 200        ? 'run'
+        :                      'filler';
+    $indexer->add_doc( { content => $content } );
+}
+$indexer->commit;
+
+$indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->delete_by_term( field => 'content', term => 'lonely' );
+$indexer->commit;
+ok( ( grep {/deletions-seg_1\.ids$/} @{ $folder->list_r } ),
+    "scattered deletions written as a list of doc ids" );
+$searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( $searcher->hits( query => 'lonely' )->total_hits,
+    0, "sparse deletions applied" );
+is( $searcher->hits( query => 'filler' )->total_hits,
+    2797, "sparse deletions don't hide live docs" );
+
+$indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->delete_by_term( field => 'content', term => 'run' );
+$indexer->commit;
+ok( ( grep {/deletions-seg_1\.runs$/} @{ $folder->list_r } ),
+    "consecutive deletions written as runs" );
+$searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( $searcher->hits( query => 'filler' )->total_hits,
+    2797, "run-length deletions don't hide live docs" );
+
+$polyreader = Lucy::Index::PolyReader->open( index => $folder );
+$del_reader = $polyreader->seg_readers->[0]
+    ->obtain("Lucy::Index::DeletionsReader");
+$deldocs = $del_reader->read_deletions;
+is( $deldocs->count, 203, "read_deletions expands runs" );
+is_deeply(
+    [ map { $deldocs->get($_) ? 1 : 0 } 1, 200, 201, 500, 501 ],
+    [ 1, 1, 0, 1, 0 ],
+    "expanded runs cover the right docs"
+);
@@ -48,7 +48,7 @@ sub new {
 
 package main;
 use Lucy::Test;
-use Test::More tests => 57;
+use Test::More tests => 60;
 
 # Force frequent flushes.
 Lucy::Index::SortWriter::set_default_mem_thresh(100);
@@ -172,3 +172,30 @@ for my $field (qw( name speed weight home cat wheels )) {
         );
     }
 }
+
+my $sort_metadata = $segment->fetch_metadata('sort');
+like( $sort_metadata->{byte_order}, qr/^(?:little|big)$/,
+    "byte order recorded in sort metadata" );
+
+# Wide ords are written in native byte order and must survive flushed runs.
+$folder  = Lucy::Store::RAMFolder->new;
+$indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->add_doc( { name => "thing$_", speed => sprintf( "%04d", $_ ) } )
+    for reverse 1 .. 300;
+$indexer->commit;
+
+$polyreader  = Lucy::Index::IndexReader->open( index => $folder );
+$seg_reader  = $polyreader->get_seg_readers->[0];
+$sort_reader = $seg_reader->obtain("Lucy::Index::SortReader");
+$doc_reader  = $seg_reader->obtain("Lucy::Index::DocReader");
+$sort_reader->warm;
+my $sort_cache = $sort_reader->fetch_sort_cache('speed');
+is( $sort_cache->get_ord_width, 16, "16-bit ords" );
+my @mismatches = grep {
+    $sort_cache->value( ord => $sort_cache->ordinal($_) ) ne
+        $doc_reader->fetch_doc($_)->{speed}
+} 1 .. $seg_reader->doc_max;
+is( scalar @mismatches, 0, "correct cached values with 16-bit ords" );
@@ -0,0 +1,121 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+
+package MyArchitecture;
+use base qw( Lucy::Plan::Architecture );
+
+# Small enough that each segment spans several blocks.
+sub doc_block_size {1024}
+
+package MySchema;
+use base qw( Lucy::Plan::Schema );
+
+sub architecture { MyArchitecture->new }
+
+sub new {
+    my $self      = shift->SUPER::new(@_);
+    my $tokenizer = Lucy::Analysis::StandardTokenizer->new;
+    my $main_type = Lucy::Plan::FullTextType->new( analyzer => $tokenizer );
+    my $unstored_type = Lucy::Plan::FullTextType->new(
+        analyzer => $tokenizer,
+        stored   => 0,
+    );
+    my $blob_type = Lucy::Plan::BlobType->new( stored => 1 );
+    my $float64   = Lucy::Plan::Float64Type->new( indexed => 0 );
+    $self->spec_field( name => 'content',  type => $main_type );
+    $self->spec_field( name => 'smiley',   type => $main_type );
+    $self->spec_field( name => 'unstored', type => $unstored_type );
+    $self->spec_field( name => 'binary',   type => $blob_type );
+    $self->spec_field( name => 'float64',  type => $float64 );
+    return $self;
+}
+
+package main;
+use Test::More tests => 12;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = MySchema->new;
+
+my $smiley = "\x{263a}";
+my $binary = pack( 'b4', 1, 2, 3, 4 );
+my @words  = map {"word$_"} 1 .. 60;
+
+sub add_to_index {
+    my $indexer = Lucy::Index::Indexer->new(
+        index  => $folder,
+        schema => $schema,
+    );
+    for (@_) {
+        $indexer->add_doc(
+            {   content  => "$_ " . join( ' ', @words ),
+                binary   => $binary,
+                smiley   => $smiley,
+                unstored => $_,
+                float64  => 1.5,
+            }
+        );
+    }
+    $indexer->commit;
+}
+
+sub fetch_content {
+    my ( $searcher, $term ) = @_;
+    my $hits = $searcher->hits( query => $term );
+    my $hit = $hits->next or return;
+    return ( split ' ', $hit->{content} )[0];
+}
+
+add_to_index(qw( a b c d e f g h i j ));
+
+my $segment = Lucy::Index::Segment->new( number => 1 );
+$segment->read_file($folder);
+is( $segment->fetch_metadata('documents')->{format},
+    3, "compressed format recorded in segment metadata" );
+
+my $searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+my $hit = $searcher->hits( query => 'b' )->next;
+is( ( split ' ', $hit->{content} )[0], 'b', "single segment, single hit" );
+is( $hit->{smiley},  $smiley, "utf8 preserved" );
+is( $hit->{binary},  $binary, "blob field binary preserved" );
+is( $hit->{float64}, 1.5,     "float64 preserved" );
+ok( !defined( $hit->{unstored} ), "unstored" );
+
+my @all = map { fetch_content( $searcher, $_ ) } qw( a c e g j );
+is_deeply( \@all, [qw( a c e g j )], "docs in every block" );
+
+add_to_index(qw( k l m n o ));
+add_to_index(qw( p q r s t ));
+
+$searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( fetch_content( $searcher, 'q' ), 'q', "multiple segments, single hit" );
+
+my $indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->delete_by_term( field => 'content', term => $_ ) for qw( b f l );
+$indexer->optimize;
+$indexer->commit;
+
+$searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( fetch_content( $searcher, 'b' ), undef, "doc deleted" );
+is( fetch_content( $searcher, 'c' ), 'c', "map around deleted doc" );
+@all = map { fetch_content( $searcher, $_ ) } qw( a g k m t );
+is_deeply( \@all, [qw( a g k m t )], "merged docs in every block" );
+is( $searcher->doc_max, 17, "merged segment holds surviving docs" );
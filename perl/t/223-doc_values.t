@@ -0,0 +1,134 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package DocValuesSchema;
+use base qw( Lucy::Plan::Schema );
+
+sub new {
+    my $self = shift->SUPER::new(@_);
+    my $string_type = Lucy::Plan::StringType->new( doc_values => 1 );
+    my $int32_type  = Lucy::Plan::Int32Type->new( doc_values => 1 );
+    my $int64_type  = Lucy::Plan::Int64Type->new( doc_values => 1 );
+    my $float_type  = Lucy::Plan::Float64Type->new( doc_values => 1 );
+    my $blob_type   = Lucy::Plan::BlobType->new( stored => 0 );
+    $blob_type->set_doc_values(1);
+    my $plain_type = Lucy::Plan::StringType->new;
+    $self->spec_field( name => 'name',   type => $plain_type );
+    $self->spec_field( name => 'color',  type => $string_type );
+    $self->spec_field( name => 'year',   type => $int32_type );
+    $self->spec_field( name => 'serial', type => $int64_type );
+    $self->spec_field( name => 'price',  type => $float_type );
+    $self->spec_field( name => 'blob',   type => $blob_type );
+    return $self;
+}
+
+package main;
+use Lucy::Test;
+use Test::More tests => 15;
+
+my $folder  = Lucy::Store::RAMFolder->new;
+my $schema  = DocValuesSchema->new;
+my $indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->add_doc(
+    {   name   => 'a',
+        color  => 'red',
+        year   => 1999,
+        serial => -5_000_000_000,
+        price  => 2.5,
+        blob   => "\x00\x01",
+    }
+);
+$indexer->add_doc( { name => 'b', year => 2011 } );
+$indexer->add_doc(
+    {   name   => 'c',
+        color  => 'blue',
+        year   => 2005,
+        serial => 12,
+        price  => -1.25,
+        blob   => "",
+    }
+);
+$indexer->commit;
+
+my $polyreader = Lucy::Index::IndexReader->open( index => $folder );
+my $seg_reader = $polyreader->get_seg_readers->[0];
+my $segment    = $seg_reader->get_segment;
+my $dv_reader  = $seg_reader->obtain("Lucy::Index::DocValuesReader");
+
+my $color_num = $segment->field_num('color');
+ok( $folder->exists("seg_1/docvalues-$color_num.dat"),
+    "doc values file written" );
+my $name_num = $segment->field_num('name');
+ok( !$folder->exists("seg_1/docvalues-$name_num.dat"),
+    "no doc values file for field without doc_values" );
+ok( !defined $dv_reader->fetch_doc_values('name'),
+    "fetch_doc_values returns undef for field without doc_values" );
+
+my $years = $dv_reader->fetch_doc_values('year');
+is_deeply( [ map { $years->value($_) } 1 .. 3 ],
+    [ 1999, 2011, 2005 ], "Int32 values" );
+is( $years->get_count, 3, "get_count" );
+
+my $serials = $dv_reader->fetch_doc_values('serial');
+is( $serials->i64_value(1), -5_000_000_000, "negative Int64 value" );
+ok( !$serials->has_value(2), "has_value false for missing value" );
+ok( !defined $serials->value(2), "value undef for missing value" );
+
+my $prices = $dv_reader->fetch_doc_values('price');
+is_deeply( [ map { $prices->f64_value($_) } 1, 3 ],
+    [ 2.5, -1.25 ], "Float64 values" );
+
+my $colors = $dv_reader->fetch_doc_values('color');
+is_deeply( [ map { $colors->value($_) } 1 .. 3 ],
+    [ 'red', undef, 'blue' ], "text values" );
+
+my $blobs = $dv_reader->fetch_doc_values('blob');
+is( $blobs->value(1), "\x00\x01", "blob value" );
+is( $blobs->value(3), "", "empty blob value distinct from missing" );
+
+# Add a second segment, delete a doc, and merge.
+$indexer = Lucy::Index::Indexer->new( index => $folder );
+$indexer->add_doc( { name => 'd', color => 'green', year => 2020 } );
+$indexer->commit;
+$indexer = Lucy::Index::Indexer->new( index => $folder );
+$indexer->delete_by_term( field => 'name', term => 'a' );
+$indexer->optimize;
+$indexer->commit;
+
+$polyreader = Lucy::Index::IndexReader->open( index => $folder );
+is( scalar @{ $polyreader->get_seg_readers }, 1, "merged into one segment" );
+$dv_reader = $polyreader->obtain("Lucy::Index::DocValuesReader");
+my %color_by_name;
+my $doc_reader = $polyreader->obtain("Lucy::Index::DocReader");
+for my $doc_id ( 1 .. $polyreader->doc_max ) {
+    my $name = $doc_reader->fetch_doc($doc_id)->{name};
+    $color_by_name{$name}
+        = $dv_reader->value( field => 'color', doc_id => $doc_id );
+}
+is_deeply(
+    \%color_by_name,
+    { b => undef, c => 'blue', d => 'green' },
+    "values survive merge with deletions"
+);
+my $last_year
+    = $dv_reader->value( field => 'year', doc_id => $polyreader->doc_max );
+is( $last_year, 2020, "value via PolyDocValuesReader" );
+
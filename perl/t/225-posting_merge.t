@@ -0,0 +1,176 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package NoMergeManager;
+use base qw( Lucy::Index::IndexManager );
+sub recycle { [] }
+
+package main;
+
+use Test::More tests => 10;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+my @docs;
+
+sub add_segment {
+    my ( $seg, $count ) = @_;
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => $folder,
+        schema  => $schema,
+        manager => NoMergeManager->new,
+    );
+    for ( 1 .. $count ) {
+        my $num   = @docs + 1;
+        my @words = ( "doc$num", 'common', "seg$seg" );
+        push @words, 'sparse' if $num % 10 == 0;
+        push @words, 'common' if $num % 3 == 0;
+        push @docs, { words => \@words };
+        $indexer->add_doc( { content => join( ' ', @words ) } );
+    }
+    $indexer->commit;
+}
+
+# Walk every posting list in the index, recording doc ids and positions.
+sub actual_postings {
+    my $polyreader = Lucy::Index::IndexReader->open( index => $folder );
+    my $seg_readers = $polyreader->get_seg_readers;
+    die "Expected a single segment" unless @$seg_readers == 1;
+    my $lex_reader
+        = $seg_readers->[0]->fetch("Lucy::Index::LexiconReader");
+    my $plist_reader
+        = $seg_readers->[0]->fetch("Lucy::Index::PostingListReader");
+    my $lexicon = $lex_reader->lexicon( field => 'content' );
+    my %postings;
+    while ( $lexicon->next ) {
+        my $term  = $lexicon->get_term;
+        my $plist = $plist_reader->posting_list(
+            field => 'content',
+            term  => $term,
+        );
+        while ( my $doc_id = $plist->next ) {
+            push @{ $postings{$term} },
+                [ $doc_id, $plist->get_posting->get_prox ];
+        }
+    }
+    return \%postings;
+}
+
+# Derive the expected postings from the live docs, renumbered in order.
+sub expected_postings {
+    my %postings;
+    my $doc_id = 0;
+    for my $doc (@docs) {
+        next if $doc->{deleted};
+        $doc_id++;
+        my $words = $doc->{words};
+        my %positions;
+        push @{ $positions{ $words->[$_] } }, $_ for 0 .. $#$words;
+        push @{ $postings{$_} }, [ $doc_id, $positions{$_} ]
+            for keys %positions;
+    }
+    $_ = [ sort { $a->[0] <=> $b->[0] } @$_ ] for values %postings;
+    return \%postings;
+}
+
+# Compare advance(), which relies on skip data, against next(), for every
+# term which appears in more than one doc.
+sub skip_data_ok {
+    my $polyreader = Lucy::Index::IndexReader->open( index => $folder );
+    my $seg_reader = $polyreader->get_seg_readers->[0];
+    my $lexicon    = $seg_reader->fetch("Lucy::Index::LexiconReader")
+        ->lexicon( field => 'content' );
+    my $plist_reader
+        = $seg_reader->fetch("Lucy::Index::PostingListReader");
+    my $doc_max = $polyreader->doc_max;
+    while ( $lexicon->next ) {
+        my $term = $lexicon->get_term;
+        next if $term =~ /^doc\d+$/;
+        for my $target ( 1 .. $doc_max ) {
+            my $skipping = $plist_reader->posting_list(
+                field => 'content',
+                term  => $term,
+            );
+            my $plodding = $plist_reader->posting_list(
+                field => 'content',
+                term  => $term,
+            );
+            my $plodding_doc_id;
+            do { $plodding_doc_id = $plodding->next }
+                while ( $plodding_doc_id && $plodding_doc_id < $target );
+            return 0 unless $skipping->advance($target) == $plodding_doc_id;
+        }
+    }
+    return 1;
+}
+
+sub optimize {
+    my @doomed  = @_;
+    my $indexer = Lucy::Index::Indexer->new(
+        index  => $folder,
+        schema => $schema,
+    );
+    for my $num (@doomed) {
+        $indexer->delete_by_term( field => 'content', term => "doc$num" );
+        $docs[ $num - 1 ]{deleted} = 1;
+    }
+    $indexer->optimize;
+    $indexer->commit;
+}
+
+add_segment( $_, 40 ) for 1 .. 3;
+optimize();
+is_deeply( actual_postings(), expected_postings(),
+    "merge of segments without deletions" );
+ok( skip_data_ok(), "skip data valid after merge without deletions" );
+
+optimize( 5, 17, 40, 41, 80, 81 );
+is_deeply( actual_postings(), expected_postings(),
+    "merge of a single segment with deletions" );
+ok( skip_data_ok(), "skip data valid after merge with deletions" );
+
+add_segment( 4, 7 );
+add_segment( 5, 30 );
+optimize( 3, 121 );
+is_deeply( actual_postings(), expected_postings(),
+    "merge of segments with and without deletions" );
+ok( skip_data_ok(), "skip data valid after mixed merge" );
+
+# Short segments leave most sources starting part way through a skip group.
+add_segment( $_, 1 + $_ % 5 ) for 8 .. 14;
+optimize();
+is_deeply( actual_postings(), expected_postings(),
+    "merge of many short segments" );
+ok( skip_data_ok(), "skip data valid after merge of many short segments" );
+
+# Docs added during a session precede the docs of merged segments.
+add_segment( 6, 10 );
+my $indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->add_doc( { content => 'common seg7' } );
+unshift @docs, { words => [qw( common seg7 )] };
+$indexer->optimize;
+$indexer->commit;
+is_deeply( actual_postings(), expected_postings(),
+    "merge alongside freshly added docs" );
+ok( skip_data_ok(), "skip data valid after merge alongside new docs" );
+
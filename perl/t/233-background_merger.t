@@ -22,7 +22,7 @@ use base qw( Lucy::Index::IndexManager );
 sub recycle { [] }
 
 package main;
-use Test::More tests => 15;
+use Test::More tests => 17;
 use Lucy::Test;
 
 my $folder = Lucy::Store::RAMFolder->new;
@@ -52,8 +52,13 @@ $indexer->delete_by_term( field => 'content', term => 'b' );
 $indexer->commit;
 is( count_segs($folder), 4, "Indexer may still merge unclaimed segments" );
 
+my $limiter = Lucy::Store::RateLimiter->new( mb_per_sec => 100 );
+$bg_merger->set_rate_limiter($limiter);
 $bg_merger->commit;
 is( count_segs($folder), 3, "Background merge completes" );
+ok( $limiter->get_bytes > 0, "merge output passed through rate limiter" );
+ok( !defined $folder->get_rate_limiter,
+    "rate limiter removed from Folder after merge" );
 ok( $folder->exists("seg_7/deletions-seg_4.bv"),
     "deletions carried forward" );
 
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package NoMergeManager;
+use base qw( Lucy::Index::IndexManager );
+sub recycle { [] }
+
+package main;
+use Test::More tests => 14;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+
+for my $letter (qw( a b c )) {
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => $folder,
+        schema  => $schema,
+        manager => NoMergeManager->new,
+    );
+    $indexer->add_doc( { content => $letter } );
+    $indexer->commit;
+}
+
+my $indexer = Lucy::Index::Indexer->new(
+    index   => $folder,
+    manager => NoMergeManager->new,
+);
+$indexer->add_doc( { content => 'd' } );
+my $reader = $indexer->open_reader;
+is( $reader->doc_count, 4, "reader sees uncommitted doc" );
+is( hits( $reader, 'd' ), 1, "uncommitted doc is searchable" );
+is( hits( $reader, $_ ), 1, "committed doc $_ is searchable" ) for qw( a b c );
+
+$indexer->delete_by_term( field => 'content', term => 'a' );
+$indexer->add_doc( { content => 'e' } );
+my $fresh = $indexer->open_reader;
+is( hits( $fresh, 'a' ), 0, "reader sees uncommitted deletion" );
+is( hits( $fresh, 'e' ), 1, "reader sees doc added after last reader" );
+is( hits( $reader, 'a' ), 1, "earlier reader is unaffected" );
+
+my $searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( $searcher->hits( query => 'd' )->total_hits,
+    0, "uncommitted doc not visible in index" );
+
+$indexer->commit;
+is( count_segs($folder), 4, "flushed segments folded in at commit" );
+$searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+is( $searcher->hits( query => 'a' )->total_hits, 0, "deletion committed" );
+is( $searcher->hits( query => 'd' )->total_hits
+        + $searcher->hits( query => 'e' )->total_hits,
+    2, "flushed docs committed" );
+is( $searcher->hits( query => 'b' )->total_hits, 1, "old docs committed" );
+
+eval { $indexer->open_reader };
+like( $@, qr/Open_Reader/, "can't open reader after commit" );
+
+sub hits {
+    my ( $reader, $term ) = @_;
+    my $searcher = Lucy::Search::IndexSearcher->new( index => $reader );
+    return $searcher->hits( query => $term )->total_hits;
+}
+
+sub count_segs {
+    my $folder = shift;
+    return scalar grep {m/segmeta\.json/} @{ $folder->list_r };
+}
@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package NoMergeManager;
+use base qw( Lucy::Index::IndexManager );
+sub recycle { [] }
+
+package main;
+use Test::More tests => 11;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+
+add_docs( $schema, $_ ) for qw( a b c );
+
+my $reader = Lucy::Index::PolyReader->open( index => $folder );
+my $same = $reader->reopen;
+is( $$same, $$reader, "reopen returns same reader when index unchanged" );
+
+add_docs( undef, 'd' );
+my $added = $reader->reopen;
+isnt( $$added, $$reader, "reopen returns new reader after commit" );
+is( $added->doc_count, 4, "new reader sees added doc" );
+is( num_shared( $reader, $added ), 3, "unchanged segments are shared" );
+is( $reader->doc_count, 3, "old reader unaffected" );
+
+my $indexer = Lucy::Index::Indexer->new(
+    index   => $folder,
+    manager => NoMergeManager->new,
+);
+$indexer->delete_by_term( field => 'content', term => 'a' );
+$indexer->commit;
+my $deleted = $added->reopen;
+is( $deleted->doc_count, 3, "new reader sees deletion" );
+is( $deleted->del_count, 1, "del_count" );
+is( num_shared( $added, $deleted ),
+    3, "segment with new deletions is not shared" );
+is( hits( $deleted, 'a' ), 0, "deleted doc not found by new reader" );
+is( hits( $added,   'a' ), 1, "deleted doc still found by old reader" );
+
+$indexer = Lucy::Index::Indexer->new( index => $folder );
+$indexer->optimize;
+$indexer->commit;
+my $optimized = $deleted->reopen;
+is( num_shared( $deleted, $optimized ), 0, "merged segments not shared" );
+
+sub add_docs {
+    my ( $schema, $letter ) = @_;
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => $folder,
+        manager => NoMergeManager->new,
+        ( $schema ? ( schema => $schema ) : () ),
+    );
+    $indexer->add_doc( { content => $letter } );
+    $indexer->commit;
+}
+
+sub num_shared {
+    my ( $old, $new ) = @_;
+    my %old = map { $$_ => 1 } @{ $old->seg_readers };
+    return scalar grep { $old{$$_} } @{ $new->seg_readers };
+}
+
+sub hits {
+    my ( $reader, $term ) = @_;
+    my $searcher = Lucy::Search::IndexSearcher->new( index => $reader );
+    return $searcher->hits( query => $term )->total_hits;
+}
@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package NoMergeManager;
+use base qw( Lucy::Index::IndexManager );
+sub recycle { [] }
+
+package CountingWarmer;
+use base qw( Lucy::Search::Warmer );
+
+our $seg_readers = 0;
+our $searchers   = 0;
+
+sub warm_seg_reader {
+    my ( $self, $seg_reader ) = @_;
+    $seg_readers++;
+    $self->SUPER::warm_seg_reader($seg_reader);
+}
+
+sub warm_searcher {
+    my ( $self, $searcher ) = @_;
+    $searchers++;
+    $self->SUPER::warm_searcher($searcher);
+}
+
+package main;
+use Test::More tests => 14;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+
+add_doc( $schema, $_ ) for qw( a b c );
+
+my $warmer = CountingWarmer->new;
+ok( $warmer->get_sort_caches, "sort caches warmed by default" );
+$warmer->add_query( query => 'a' );
+$warmer->add_prefetch_suffix('.ix');
+$warmer->add_prefetch_suffix('.dat');
+
+my $searcher = Lucy::Search::IndexSearcher->new(
+    index  => $folder,
+    warmer => $warmer,
+);
+is( $CountingWarmer::seg_readers, 3, "IndexSearcher warms every segment" );
+is( $CountingWarmer::searchers,   1, "IndexSearcher runs warming queries" );
+is( $searcher->hits( query => 'a' )->total_hits, 1, "searcher works" );
+
+my $reader = Lucy::Index::PolyReader->open( index => $folder );
+my $same = $reader->reopen( warmer => $warmer );
+is( $CountingWarmer::searchers, 1, "no warming when index unchanged" );
+
+add_doc( undef, 'd' );
+my $fresh = $reader->reopen( warmer => $warmer );
+is( $CountingWarmer::seg_readers, 4, "reopen warms only new segments" );
+is( $CountingWarmer::searchers,   2, "reopen runs warming queries" );
+is( $fresh->doc_count, 4, "reopened reader sees new doc" );
+
+my $plain = Lucy::Search::Warmer->new;
+$plain->set_sort_caches(0);
+ok( !$plain->get_sort_caches, "set_sort_caches" );
+ok( $plain->get_highlight_data, "highlight data warmed by default" );
+$plain->set_highlight_data(0);
+ok( !$plain->get_highlight_data, "set_highlight_data" );
+is( $plain->get_num_wanted, 10, "num_wanted defaults to 10" );
+$plain->set_num_wanted(3);
+is( $plain->get_num_wanted, 3, "set_num_wanted" );
+$searcher = Lucy::Search::IndexSearcher->new(
+    index  => $fresh,
+    warmer => $plain,
+);
+is( $searcher->hits( query => 'd' )->total_hits,
+    1, "searcher works with warmer that does nothing" );
+
+sub add_doc {
+    my ( $schema, $letter ) = @_;
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => $folder,
+        manager => NoMergeManager->new,
+        ( $schema ? ( schema => $schema ) : () ),
+    );
+    $indexer->add_doc( { content => $letter } );
+    $indexer->commit;
+}
@@ -0,0 +1,52 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+use Test::More tests => 6;
+use Lucy::Test;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+my $indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->add_doc( { content => $_ } ) for qw( a b c );
+$indexer->commit;
+
+my $fork = $folder->fork;
+isa_ok( $fork, 'Lucy::Store::RAMFolder', "fork" );
+is_deeply( [ sort @{ $fork->list_r } ],
+    [ sort @{ $folder->list_r } ], "fork has the same files" );
+is( hits( $fork, 'b' ), 1, "forked index is searchable" );
+
+$indexer = Lucy::Index::Indexer->new( index => $fork );
+$indexer->add_doc( { content => 'd' } );
+$indexer->delete_by_term( field => 'content', term => 'a' );
+$indexer->optimize;
+$indexer->commit;
+
+is( hits( $fork,   'd' ) + hits( $fork, 'a' ), 1, "fork modified" );
+is( hits( $folder, 'd' ), 0, "original doesn't see doc added to fork" );
+is( hits( $folder, 'a' ), 1, "original doesn't see deletion in fork" );
+
+sub hits {
+    my ( $index, $term ) = @_;
+    my $searcher = Lucy::Search::IndexSearcher->new( index => $index );
+    return $searcher->hits( query => $term )->total_hits;
+}
@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+use Test::More tests => 9;
+use File::Spec::Functions qw( catfile );
+use Lucy::Test;
+use Lucy::Test::TestUtils qw( working_dir );
+
+my $arena_path = catfile( working_dir(), 'test.arena' );
+unlink $arena_path;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = Lucy::Test::TestSchema->new;
+my $indexer = Lucy::Index::Indexer->new(
+    index  => $folder,
+    schema => $schema,
+);
+$indexer->add_doc( { content => $_ } ) for qw( a b c );
+$indexer->commit;
+
+Lucy::Store::ArenaFolder->write_arena(
+    folder => $folder,
+    path   => $arena_path,
+);
+ok( -f $arena_path, "write_arena creates file" );
+
+eval {
+    Lucy::Store::ArenaFolder->write_arena(
+        folder => $folder,
+        path   => $arena_path,
+    );
+};
+ok( $@, "write_arena won't clobber an existing file" );
+
+my $arena = Lucy::Store::ArenaFolder->open( path => $arena_path );
+isa_ok( $arena, 'Lucy::Store::RAMFolder', "ArenaFolder" );
+my @expected = grep { !m#/cf(?:meta\.json|\.dat)$# } @{ $folder->list_r };
+is_deeply( [ sort @{ $arena->list_r } ],
+    [ sort @expected ], "arena holds every file" );
+is( hits( $arena, 'b' ), 1, "index in arena is searchable" );
+
+$arena = Lucy::Store::ArenaFolder->open(
+    path     => $arena_path,
+    populate => 1,
+);
+$indexer = Lucy::Index::Indexer->new( index => $arena );
+$indexer->add_doc( { content => 'd' } );
+$indexer->delete_by_term( field => 'content', term => 'a' );
+$indexer->optimize;
+$indexer->commit;
+is( hits( $arena, 'd' ), 1, "arena index accepts new docs" );
+is( hits( $arena, 'a' ), 0, "arena index accepts deletions" );
+
+my $reopened = Lucy::Store::ArenaFolder->open( path => $arena_path );
+is( hits( $reopened, 'd' ), 0, "arena file unchanged by writes" );
+
+my $not_arena = catfile( working_dir(), 'not.arena' );
+open( my $fh, '>', $not_arena ) or die $!;
+print $fh "x" x 100;
+close $fh or die $!;
+ok( !defined Lucy::Store::ArenaFolder->open( path => $not_arena ),
+    "open fails on non-arena file" );
+
+undef $arena;
+undef $reopened;
+unlink $arena_path, $not_arena;
+
+sub hits {
+    my ( $index, $term ) = @_;
+    my $searcher = Lucy::Search::IndexSearcher->new( index => $index );
+    return $searcher->hits( query => $term )->total_hits;
+}
@@ -0,0 +1,121 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+use strict;
+use warnings;
+use lib 'buildlib';
+
+package BloomSchema;
+use base qw( Lucy::Plan::Schema );
+
+sub new {
+    my $self = shift->SUPER::new(@_);
+    my $id_type   = Lucy::Plan::StringType->new( bloom_filter => 1 );
+    my $text_type = Lucy::Plan::StringType->new;
+    $self->spec_field( name => 'id',    type => $id_type );
+    $self->spec_field( name => 'color', type => $text_type );
+    return $self;
+}
+
+package NoMergeManager;
+use base qw( Lucy::Index::IndexManager );
+sub recycle { [] }
+
+package main;
+use Lucy::Test;
+use Test::More tests => 12;
+
+my $folder = Lucy::Store::RAMFolder->new;
+my $schema = BloomSchema->new;
+
+my $id_type = $schema->fetch_type('id');
+ok( $id_type->bloom_filter, "bloom_filter property" );
+my $loaded = $id_type->load( $id_type->dump );
+ok( $loaded->bloom_filter, "bloom_filter survives dump/load" );
+ok( !$schema->fetch_type('color')->bloom_filter, "off by default" );
+
+# Three segments of 100 ids apiece.
+for my $batch ( 0 .. 2 ) {
+    my $indexer = Lucy::Index::Indexer->new(
+        index   => $folder,
+        schema  => $schema,
+        manager => NoMergeManager->new,
+    );
+    for my $num ( 0 .. 99 ) {
+        $indexer->add_doc( { id => "id-$batch-$num", color => 'red' } );
+    }
+    $indexer->commit;
+}
+
+my $reader      = Lucy::Index::IndexReader->open( index => $folder );
+my $seg_readers = $reader->seg_readers;
+is( scalar @$seg_readers, 3, "three segments" );
+
+my $num_bloom_files = 0;
+my $all_present     = 1;
+my $false_positives = 0;
+for my $seg_reader (@$seg_readers) {
+    my $segment   = $seg_reader->get_segment;
+    my $seg_name  = $seg_reader->get_seg_name;
+    my $id_num    = $segment->field_num('id');
+    my $color_num = $segment->field_num('color');
+    $num_bloom_files++ if $folder->exists("$seg_name/lexicon-$id_num.bloom");
+    $num_bloom_files++
+        if $folder->exists("$seg_name/lexicon-$color_num.bloom");
+
+    my $lex_reader = $seg_reader->obtain("Lucy::Index::LexiconReader");
+    my $docs       = $seg_reader->obtain("Lucy::Index::DocReader");
+    my $batch      = ( split /-/, $docs->fetch_doc(1)->{id} )[1];
+    for my $other ( 0 .. 2 ) {
+        for my $num ( 0 .. 99 ) {
+            my $maybe = $lex_reader->may_contain(
+                field => 'id',
+                term  => "id-$other-$num",
+            );
+            if ( $other == $batch ) { $all_present = 0 unless $maybe }
+            else                    { $false_positives++ if $maybe }
+        }
+    }
+}
+is( $num_bloom_files, 3, "one bloom file per segment, only for id" );
+ok( $all_present, "may_contain true for every id in the segment" );
+cmp_ok( $false_positives, '<', 30,
+    "may_contain rules out most ids in other segments" );
+
+my $poly_lex_reader = $reader->obtain("Lucy::Index::LexiconReader");
+ok( $poly_lex_reader->may_contain( field => 'color', term => 'blue' ),
+    "fields without a bloom filter can't rule terms out" );
+is( $poly_lex_reader->doc_freq( field => 'id', term => 'id-1-50' ),
+    1, "doc_freq still finds ids" );
+is( $poly_lex_reader->doc_freq( field => 'id', term => 'id-9-9' ),
+    0, "doc_freq for absent id" );
+
+my $indexer = Lucy::Index::Indexer->new(
+    index   => $folder,
+    manager => NoMergeManager->new,
+);
+$indexer->delete_by_term( field => 'id', term => 'id-2-7' );
+$indexer->delete_by_term( field => 'id', term => 'id-9-9' );
+$indexer->commit;
+
+$reader = Lucy::Index::IndexReader->open( index => $folder );
+is( $reader->del_count, 1, "delete_by_term removes only the matching doc" );
+my $searcher = Lucy::Search::IndexSearcher->new( index => $reader );
+my $hits = $searcher->hits(
+    query => Lucy::Search::TermQuery->new( field => 'id', term => 'id-2-7' )
+);
+is( $hits->total_hits, 0, "deleted id is gone" );
+
@@ -17,7 +17,7 @@ use strict;
 use warnings;
 use lib 'buildlib';
 
-use Test::More tests => 9;
+use Test::More tests => 11;
 use Lucy::Test;
 use Lucy::Test::TestUtils qw( create_index );
 
@@ -63,3 +63,10 @@ while ( my $hit = $hits->next ) {
 }
 is( scalar @retrieved, 2, "number retrieved with offset" );
 is_deeply( \@retrieved, [ @docs[ 1, 0 ] ], "correct content with offset" );
+
+my $doc_ids = Lucy::Object::I32Array->new( ints => [ 3, 1, 4, 2 ] );
+my $fetched = $searcher->fetch_docs($doc_ids);
+is_deeply( [ map { $_->{content} } @$fetched ],
+    [ @docs[ 2, 0, 3, 1 ] ], "fetch_docs returns docs in requested order" );
+is_deeply( [ map { $_->get_doc_id } @$fetched ],
+    [ 3, 1, 4, 2 ], "fetch_docs sets doc ids" );
@@ -0,0 +1,96 @@
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+use strict;
+use warnings;
+
+use Test::More tests => 9;
+use Lucy::Test;
+
+my $schema = Lucy::Plan::Schema->new;
+my $type = Lucy::Plan::StringType->new( sortable => 1 );
+my $int_type = Lucy::Plan::Int32Type->new( indexed => 0, sortable => 1 );
+$schema->spec_field( name => 'color',  type => $type );
+$schema->spec_field( name => 'size',   type => $int_type );
+$schema->spec_field( name => 'tag',    type => $type );
+$schema->spec_field( name => 'unused', type => $type );
+
+my $folder = Lucy::Store::RAMFolder->new;
+my %expected_colors;
+my %expected_sizes;
+my @colors = qw( red green blue );
+for my $seg ( 0 .. 3 ) {
+    my $indexer = Lucy::Index::Indexer->new(
+        index  => $folder,
+        schema => $schema,
+    );
+    for my $num ( 0 .. 9 ) {
+        my $color = $colors[ ( $seg + $num ) % @colors ];
+        my %doc = ( color => $color, tag => 'all' );
+        $expected_colors{$color}++;
+        if ( $num % 2 ) {
+            $doc{size} = $num;
+            $expected_sizes{$num}++;
+        }
+        $indexer->add_doc( \%doc );
+    }
+    $indexer->commit;
+}
+
+my $searcher = Lucy::Search::IndexSearcher->new( index => $folder );
+my $query = Lucy::Search::TermQuery->new( field => 'tag', term => 'all' );
+my $sort_collector = Lucy::Search::Collector::SortCollector->new(
+    wanted => 5 );
+my $collector = Lucy::Search::Collector::FacetCollector->new(
+    schema    => $schema,
+    fields    => [qw( color size unused )],
+    reader    => $searcher->get_reader,
+    collector => $sort_collector,
+);
+$searcher->collect( query => $query, collector => $collector );
+
+is( $collector->get_total_hits, 40, "total hits" );
+is( scalar @{ $sort_collector->pop_match_docs },
+    5, "inner collector receives hits" );
+
+my %got = map { $_->get_value => $_->get_count }
+    @{ $collector->top_values( 'color', 10 ) };
+is_deeply( \%got, \%expected_colors, "counts merged across segments" );
+
+my $top = $collector->top_values( 'color', 1 );
+is( scalar @$top, 1, "num_wanted limits results" );
+my ($most_common) = sort { $expected_colors{$b} <=> $expected_colors{$a}
+        || $a cmp $b } keys %expected_colors;
+is( $top->[0]->get_value, $most_common, "highest count first" );
+
+%got = map { $_->get_value => $_->get_count }
+    @{ $collector->top_values( 'size', 10 ) };
+is_deeply( \%got, \%expected_sizes, "NULL values are not counted" );
+
+is_deeply( $collector->top_values( 'unused', 10 ),
+    [], "field without values has no facets" );
+
+# Without a reader, counts are merged by value.
+$collector = Lucy::Search::Collector::FacetCollector->new(
+    schema => $schema,
+    fields => ['color'],
+);
+$searcher->collect( query => $query, collector => $collector );
+%got = map { $_->get_value => $_->get_count }
+    @{ $collector->top_values( 'color', 10 ) };
+is_deeply( \%got, \%expected_colors, "counts merged by value" );
+
+eval { $collector->top_values( 'size', 10 ) };
+like( $@, qr/facet field/, "unknown facet field throws" );
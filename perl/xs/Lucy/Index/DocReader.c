@@ -29,20 +29,57 @@
 #include "Lucy/Object/Host.h"
 #include "Lucy/Store/InStream.h"
 
-lucy_HitDoc*
-lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
+// Return true if the field name appears in the array.
+static chy_bool_t
+S_field_wanted(lucy_VArray *fields, const char *name, size_t len) {
+    for (uint32_t i = 0, max = Lucy_VA_Get_Size(fields); i < max; i++) {
+        lucy_CharBuf *field = (lucy_CharBuf*)Lucy_VA_Fetch(fields, i);
+        if (field && Lucy_CB_Equals_Str(field, name, len)) { return true; }
+    }
+    return false;
+}
+
+// Advance the stream past a serialized field value without decoding it.
+static void
+S_skip_value(lucy_InStream *dat_in, lucy_FieldType *type) {
+    switch (Lucy_FType_Primitive_ID(type) & lucy_FType_PRIMITIVE_ID_MASK) {
+        case lucy_FType_TEXT:
+        case lucy_FType_BLOB: {
+                int64_t value_len = Lucy_InStream_Read_C32(dat_in);
+                Lucy_InStream_Seek(dat_in,
+                                   Lucy_InStream_Tell(dat_in) + value_len);
+                break;
+            }
+        case lucy_FType_FLOAT32:
+            Lucy_InStream_Seek(dat_in, Lucy_InStream_Tell(dat_in) + 4);
+            break;
+        case lucy_FType_FLOAT64:
+            Lucy_InStream_Seek(dat_in, Lucy_InStream_Tell(dat_in) + 8);
+            break;
+        case lucy_FType_INT32:
+            Lucy_InStream_Read_C32(dat_in);
+            break;
+        case lucy_FType_INT64:
+            Lucy_InStream_Read_C64(dat_in);
+            break;
+        default:
+            CFISH_THROW(LUCY_ERR, "Unrecognized type: %o", type);
+    }
+}
+
+// Decode the stored fields of a doc.  If <code>wanted</code> is supplied,
+// decode only the fields it names and skip over the rest.
+static lucy_HitDoc*
+S_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id,
+            lucy_VArray *wanted) {
     lucy_Schema   *const schema = self->schema;
-    lucy_InStream *const dat_in = self->dat_in;
-    lucy_InStream *const ix_in  = self->ix_in;
+    lucy_InStream *const dat_in = Lucy_DefDocReader_Seek_Doc(self, doc_id);
     HV *fields = newHV();
-    int64_t start;
     uint32_t num_fields;
+    uint32_t num_left = wanted ? Lucy_VA_Get_Size(wanted) : 0;
     SV *field_name_sv = newSV(1);
 
-    // Get data file pointer from index, read number of fields.
-    Lucy_InStream_Seek(ix_in, (int64_t)doc_id * 8);
-    start = Lucy_InStream_Read_U64(ix_in);
-    Lucy_InStream_Seek(dat_in, start);
+    // Read number of fields.
     num_fields = Lucy_InStream_Read_C32(dat_in);
 
     // Decode stored data and build up the doc field by field.
@@ -67,6 +104,15 @@ lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
         Lucy_ZCB_Assign_Str(field_name_zcb, field_name_ptr, field_name_len);
         type = Lucy_Schema_Fetch_Type(schema, (lucy_CharBuf*)field_name_zcb);
 
+        // Skip unwanted fields, and stop once all wanted fields are found.
+        if (wanted) {
+            if (!S_field_wanted(wanted, field_name_ptr, field_name_len)) {
+                S_skip_value(dat_in, type);
+                continue;
+            }
+            num_left--;
+        }
+
         // Read the field value.
         switch (Lucy_FType_Primitive_ID(type) & lucy_FType_PRIMITIVE_ID_MASK) {
             case lucy_FType_TEXT: {
@@ -114,6 +160,7 @@ lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
 
         // Store the value.
         (void)hv_store_ent(fields, field_name_sv, value_sv, 0);
+        if (wanted && !num_left) { break; }
     }
     SvREFCNT_dec(field_name_sv);
 
@@ -122,4 +169,15 @@ lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
     return retval;
 }
 
+lucy_HitDoc*
+lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
+    return S_fetch_doc(self, doc_id, NULL);
+}
+
+lucy_HitDoc*
+lucy_DefDocReader_fetch_doc_fields(lucy_DefaultDocReader *self,
+                                   int32_t doc_id, lucy_VArray *fields) {
+    return S_fetch_doc(self, doc_id, fields);
+}
+
 
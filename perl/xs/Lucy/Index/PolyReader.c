@@ -22,9 +22,11 @@
 #include "Lucy/Store/Folder.h"
 
 Obj*
-PolyReader_try_open_segreaders(PolyReader *self, VArray *segments) {
-    return Host_callback_obj(self, "_try_open_segreaders", 1,
-                             ARG_OBJ("segments", segments));
+PolyReader_try_open_segreaders(PolyReader *self, VArray *segments,
+                               VArray *reusable) {
+    return Host_callback_obj(self, "_try_open_segreaders", 2,
+                             ARG_OBJ("segments", segments),
+                             ARG_OBJ("reusable", reusable));
 }
 
 CharBuf*
@@ -27,3 +27,10 @@ lucy_DefDocReader_fetch_doc(lucy_DefaultDocReader *self, int32_t doc_id) {
     UNREACHABLE_RETURN(lucy_HitDoc*);
 }
 
+lucy_HitDoc*
+lucy_DefDocReader_fetch_doc_fields(lucy_DefaultDocReader *self,
+                                   int32_t doc_id, lucy_VArray *fields) {
+    THROW(LUCY_ERR, "TODO");
+    UNREACHABLE_RETURN(lucy_HitDoc*);
+}
+
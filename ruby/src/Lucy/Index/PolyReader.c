@@ -22,7 +22,8 @@
 #include "Lucy/Store/Folder.h"
 
 Obj*
-PolyReader_try_open_segreaders(PolyReader *self, VArray *segments) {
+PolyReader_try_open_segreaders(PolyReader *self, VArray *segments,
+                               VArray *reusable) {
     THROW(LUCY_ERR, "TODO");
     UNREACHABLE_RETURN(Obj*);
 }